@@ -0,0 +1,112 @@
+/*--------------------------------------------------------------------*/
+/* atomtable.c                                                        */
+/* author: Julio Lins (jcclb)                                         */
+/*--------------------------------------------------------------------*/
+
+#include "atomtable.h"
+#include "symtable.h"
+#include <assert.h>
+#include <string.h>
+#include <stdlib.h>
+
+/*--------------------------------------------------------------------*/
+
+/* An AtomTable is a SymTable that borrows its keys and whose values
+   are the atoms: each atom is bound to itself, so it is stored only
+   once */
+
+struct AtomTable {
+
+   /* Bindings from each atom to itself. Atoms are owned by the
+      AtomTable */
+   SymTable_T oSymTable;
+};
+
+
+AtomTable_T AtomTable_new(void) {
+
+   AtomTable_T oAtomTable;
+
+
+   oAtomTable = (AtomTable_T)malloc(sizeof(struct AtomTable));
+
+   if (oAtomTable == NULL)
+      return NULL;
+
+
+   oAtomTable->oSymTable = SymTable_newBorrowedKeys();
+
+   if (oAtomTable->oSymTable == NULL) {
+
+      free(oAtomTable);
+      return NULL;
+   }
+
+
+   return oAtomTable;
+}
+
+
+
+void AtomTable_free(AtomTable_T oAtomTable) {
+
+   assert(oAtomTable != NULL);
+
+   /* Each atom is both key and value; the table borrows the key, so
+      freeing the value frees the atom exactly once */
+   SymTable_freeWith(oAtomTable->oSymTable, free);
+   free(oAtomTable);
+}
+
+
+size_t AtomTable_getLength(AtomTable_T oAtomTable) {
+
+   assert(oAtomTable != NULL);
+
+   return SymTable_getLength(oAtomTable->oSymTable);
+}
+
+
+const char *AtomTable_intern(AtomTable_T oAtomTable,
+                             const char *pcString) {
+
+   char *pcAtom;
+
+
+   assert(oAtomTable != NULL);
+   assert(pcString != NULL);
+
+
+   pcAtom = (char*)SymTable_get(oAtomTable->oSymTable, pcString);
+
+   if (pcAtom != NULL)
+      return pcAtom;
+
+
+   pcAtom = (char*)malloc(strlen(pcString) + 1);
+
+   if (pcAtom == NULL)
+      return NULL;
+
+   pcAtom = strcpy(pcAtom, pcString);
+
+
+   if (! SymTable_put(oAtomTable->oSymTable, pcAtom, pcAtom)) {
+
+      free(pcAtom);
+      return NULL;
+   }
+
+
+   return pcAtom;
+}
+
+
+const char *AtomTable_lookup(AtomTable_T oAtomTable,
+                             const char *pcString) {
+
+   assert(oAtomTable != NULL);
+   assert(pcString != NULL);
+
+   return (const char*)SymTable_get(oAtomTable->oSymTable, pcString);
+}
@@ -0,0 +1,62 @@
+/*--------------------------------------------------------------------*/
+/* atomtable.h                                                        */
+/* Author: Julio Lins (jcclb)                                         */
+/*--------------------------------------------------------------------*/
+
+#ifndef ATOMTABLE_H
+#define ATOMTABLE_H
+
+/*--------------------------------------------------------------------*/
+
+#include <stddef.h>
+
+/*--------------------------------------------------------------------*/
+
+/* An AtomTable_T object interns strings: it holds one canonical copy,
+   called an atom, of each distinct string it has been given. Two
+   atoms of the same AtomTable_T object are equal strings if and only
+   if they are the same pointer, so they can be compared and hashed by
+   address (see symtableatom.h). Atoms stay valid until their
+   AtomTable_T object is freed */
+
+typedef struct AtomTable *AtomTable_T;
+
+/*--------------------------------------------------------------------*/
+
+/* Return a new AtomTable_T object, or NULL if insufficient memory is
+   available */
+
+AtomTable_T AtomTable_new(void);
+
+/*--------------------------------------------------------------------*/
+
+/* Free memory allocated by oAtomTable, including all of its atoms */
+
+void AtomTable_free(AtomTable_T oAtomTable);
+
+/*--------------------------------------------------------------------*/
+
+/* Return the number of atoms in oAtomTable */
+
+size_t AtomTable_getLength(AtomTable_T oAtomTable);
+
+/*--------------------------------------------------------------------*/
+
+/* Return the atom of oAtomTable that is equal to pcString, adding a
+   copy of pcString as a new atom if there is none. Return NULL if
+   insufficient memory is available */
+
+const char *AtomTable_intern(AtomTable_T oAtomTable,
+                             const char *pcString);
+
+/*--------------------------------------------------------------------*/
+
+/* Return the atom of oAtomTable that is equal to pcString, or NULL if
+   there is none. oAtomTable is left unchanged */
+
+const char *AtomTable_lookup(AtomTable_T oAtomTable,
+                             const char *pcString);
+
+/*--------------------------------------------------------------------*/
+
+#endif
@@ -27,12 +27,41 @@ SymTable_T SymTable_new(void);
 
 /*--------------------------------------------------------------------*/
 
+/* Return a new SymTable_T object that borrows its keys instead of
+   making defensive copies of them, or NULL if insufficient memory is
+   available. Each key given to SymTable_put is stored as is, so it
+   must stay valid and unchanged for as long as its binding exists,
+   and it is never freed by the SymTable_T object */
+
+SymTable_T SymTable_newBorrowedKeys(void);
+
+/*--------------------------------------------------------------------*/
+
 /* Free memory allocated by oSymTable */
 
 void SymTable_free(SymTable_T oSymTable);
 
 /*--------------------------------------------------------------------*/
 
+/* Free memory allocated by oSymTable, as SymTable_free does, and
+   also call (*pfFreeValue)(pvValue) on the value of each binding
+   during that same pass, unless pfFreeValue is NULL */
+
+void SymTable_freeWith(SymTable_T oSymTable,
+                       void (*pfFreeValue)(void *pvValue));
+
+/*--------------------------------------------------------------------*/
+
+/* Remove every binding from oSymTable, calling
+   (*pfFreeValue)(pvValue) on the value of each one unless pfFreeValue
+   is NULL. oSymTable keeps the memory it has grown, so that it can be
+   filled again without expanding anew */
+
+void SymTable_clear(SymTable_T oSymTable,
+                    void (*pfFreeValue)(void *pvValue));
+
+/*--------------------------------------------------------------------*/
+
 /* Return length of oSymTable (i.e., number of bindings) */
 
 size_t SymTable_getLength(SymTable_T oSymTable);
@@ -90,4 +119,86 @@ void SymTable_map(SymTable_T oSymTable,
 
 /*--------------------------------------------------------------------*/
 
+/* Memory held by a SymTable_T object, in bytes, by kind, as reported
+   by SymTable_memoryUsage */
+
+struct SymTableMemory {
+
+   /* the object itself and its index: bucket array, tree or trie
+      Nodes without bindings, and the like */
+   size_t uTableBytes;
+
+   /* Bindings, or whatever else holds the key and value of each */
+   size_t uBindingBytes;
+
+   /* defensive copies of keys */
+   size_t uKeyBytes;
+
+   /* estimate of the bytes malloc adds to each block: a header word,
+      and rounding up to a multiple of two words of at least four, as
+      in the GNU C library */
+   size_t uOverheadBytes;
+};
+
+/*--------------------------------------------------------------------*/
+
+/* Store in *psMemory the memory held by oSymTable. Room allocated
+   ahead of need is counted; values, which are the client's, are
+   not */
+
+void SymTable_memoryUsage(SymTable_T oSymTable,
+                          struct SymTableMemory *psMemory);
+
+/*--------------------------------------------------------------------*/
+
+/* A SymTableIter is an external cursor over the bindings of a
+   SymTable_T object. It is allocated by the client (typically on the
+   stack), so traversal needs no callback and no memory allocation.
+   pcKey and pvValue hold the current binding while SymTable_iterEnd
+   returns 0 (FALSE). The remaining fields are private to the
+   implementation. Putting or removing bindings invalidates every
+   iterator over the table; SymTable_replace does not. */
+
+struct SymTableIter {
+
+   /* key of the current binding, owned by the SymTable_T object */
+   const char *pcKey;
+
+   /* value of the current binding, owned by client */
+   void *pvValue;
+
+   /* table being traversed */
+   SymTable_T oSymTable;
+
+   /* implementation-defined position */
+   size_t uIndex;
+
+   /* implementation-defined position */
+   void *pvPosition;
+};
+
+/*--------------------------------------------------------------------*/
+
+/* Position psIter at the first binding of oSymTable, if any */
+
+void SymTable_iterBegin(SymTable_T oSymTable,
+                        struct SymTableIter *psIter);
+
+/*--------------------------------------------------------------------*/
+
+/* Advance psIter to the next binding of its table. psIter must not be
+   at its end */
+
+void SymTable_iterNext(struct SymTableIter *psIter);
+
+/*--------------------------------------------------------------------*/
+
+/* Return 1 (TRUE) if psIter has gone past the last binding of its
+   table, 0 (FALSE) otherwise. A client may stop iterating at any time;
+   an iterator holds no resources */
+
+int SymTable_iterEnd(const struct SymTableIter *psIter);
+
+/*--------------------------------------------------------------------*/
+
 #endif
@@ -0,0 +1,886 @@
+/*--------------------------------------------------------------------*/
+/* symtableadaptive.c                                                 */
+/* author: Julio Lins (jcclb)                                         */
+/*--------------------------------------------------------------------*/
+
+#include "symtable.h"
+#include <assert.h>
+#include <string.h>
+#include <stdlib.h>
+
+/*--------------------------------------------------------------------*/
+
+/* Number of bindings a Symble Table keeps inline, in a contiguous
+   array inside struct SymTable, before it becomes a hash table */
+
+enum {INLINE_CAPACITY = 8};
+
+/* Sequence of bucket counts for Symble Table expansion. It starts
+   small, since a table that was just promoted holds few bindings,
+   and goes on past the counts of symtablehash.c for large tables */
+
+static const size_t auBucketCount[] = {31, 61, 127, 251, 509, 1021,
+                                       2039, 4093, 8191, 16381, 32749,
+                                       65521, 131071, 262139, 524287,
+                                       1048573, 2097143, 4194301,
+                                       8388593, 16777213, 33554393,
+                                       67108859};
+
+
+/* Each key and respective value of a small Symble Table are stored
+   in an Entry of its inline array */
+
+struct Entry {
+
+   /* key, owned by implementation through defensive copy unless
+      the table borrows its keys */
+   const char *pcKey;
+
+   /* value, owned by client */
+   void *pvValue;
+};
+
+
+/* Each key and respective value of a promoted Symble Table are stored
+   in a Binding. Bindings whose keys hash to the same code are linked
+   to form a list */
+
+struct Binding {
+
+   /* key, owned by implementation through defensive copy unless
+      the table borrows its keys */
+   const char *pcKey;
+
+   /* value, owned by client */
+   void *pvValue;
+
+   /* full hash code of pcKey, kept so that growing the table never
+      rehashes a key */
+   size_t uHash;
+
+   /* The address of the next Binding on the list of same-hash-code
+      Bindings */
+   struct Binding *pbNext;
+};
+
+
+/* SymTable holds up to INLINE_CAPACITY Entries inline. Once it
+   outgrows them it is promoted to a hash table with separate
+   chaining, and stays one */
+
+struct SymTable {
+
+   /* Pointer to the addresses of separate chains' first Bindings, or
+      NULL while the table has not been promoted */
+   struct Binding **ppbBuckets;
+
+   /* Index of auBucketCount[] leading to current bucket count for
+      a promoted SymTable object */
+   size_t uBucketIndex;
+
+   /* size of Symble Table (total # of Entries or Bindings) */
+   size_t uLength;
+
+   /* Entries of a small Symble Table, the first uLength in use */
+   struct Entry aeInline[INLINE_CAPACITY];
+
+   /* 1 (TRUE) if keys are borrowed from the client rather than
+      owned through defensive copies */
+   int iBorrowsKeys;
+};
+
+
+
+/* Return the full hash code for pcKey, which is the key that will be
+   hashed. The caller reduces it modulo the bucket count */
+
+static size_t SymTable_hash(const char *pcKey)
+{
+   const size_t HASH_MULTIPLIER = 65599;
+   size_t u;
+   size_t uHash = 0;
+
+   assert(pcKey != NULL);
+
+   for (u = 0; pcKey[u] != '\0'; u++)
+      uHash = uHash * HASH_MULTIPLIER + (size_t)pcKey[u];
+
+   return uHash;
+}
+
+
+SymTable_T SymTable_new(void) {
+
+   SymTable_T oSymTable;
+   enum {FALSE, TRUE};
+
+
+   oSymTable = (SymTable_T)malloc(sizeof(struct SymTable));
+
+   if (oSymTable == NULL)
+      return NULL;
+
+   /* No bucket array until the table is promoted */
+   oSymTable->ppbBuckets = NULL;
+   oSymTable->uBucketIndex = 0;
+   oSymTable->uLength = 0;
+   oSymTable->iBorrowsKeys = FALSE;
+
+
+   return oSymTable;
+}
+
+
+
+SymTable_T SymTable_newBorrowedKeys(void) {
+
+   SymTable_T oSymTable;
+   enum {FALSE, TRUE};
+
+   oSymTable = SymTable_new();
+
+   if (oSymTable == NULL)
+      return NULL;
+
+   oSymTable->iBorrowsKeys = TRUE;
+
+   return oSymTable;
+}
+
+
+
+/* Helper function that frees every Entry or Binding of oSymTable and
+   its key, also calling pfFreeValue on its value unless pfFreeValue
+   is NULL. oSymTable is left empty; a promoted table keeps its bucket
+   array */
+
+static void SymTable_freeBindings(SymTable_T oSymTable,
+                                  void (*pfFreeValue)(void *pvValue)) {
+
+   struct Binding *pbCurrent;
+   struct Binding *pbNext;
+   size_t i;
+
+
+   assert(oSymTable != NULL);
+
+
+   if (oSymTable->ppbBuckets == NULL) {
+
+      for (i = 0; i < oSymTable->uLength; i++) {
+
+         if (! oSymTable->iBorrowsKeys)
+            free((void*)oSymTable->aeInline[i].pcKey);
+
+         if (pfFreeValue != NULL)
+            (*pfFreeValue)(oSymTable->aeInline[i].pvValue);
+      }
+
+      oSymTable->uLength = 0;
+      return;
+   }
+
+
+   for (i = 0; i < auBucketCount[oSymTable->uBucketIndex]; i++) {
+
+
+      pbCurrent = oSymTable->ppbBuckets[i];
+
+
+      while (pbCurrent != NULL) {
+
+         /* Save pointer to next Binding before freeing pbCurrent */
+         pbNext = pbCurrent->pbNext;
+
+
+         if (! oSymTable->iBorrowsKeys)
+            free((void*)pbCurrent->pcKey);
+
+         if (pfFreeValue != NULL)
+            (*pfFreeValue)(pbCurrent->pvValue);
+
+         free(pbCurrent);
+
+         pbCurrent = pbNext;
+      }
+
+      oSymTable->ppbBuckets[i] = NULL;
+   }
+
+   oSymTable->uLength = 0;
+}
+
+
+void SymTable_free(SymTable_T oSymTable) {
+
+   assert(oSymTable != NULL);
+
+   SymTable_freeWith(oSymTable, NULL);
+}
+
+
+
+void SymTable_freeWith(SymTable_T oSymTable,
+                       void (*pfFreeValue)(void *pvValue)) {
+
+   assert(oSymTable != NULL);
+
+   SymTable_freeBindings(oSymTable, pfFreeValue);
+
+   free(oSymTable->ppbBuckets);
+   free(oSymTable);
+}
+
+
+
+void SymTable_clear(SymTable_T oSymTable,
+                    void (*pfFreeValue)(void *pvValue)) {
+
+   assert(oSymTable != NULL);
+
+   SymTable_freeBindings(oSymTable, pfFreeValue);
+}
+
+
+size_t SymTable_getLength(SymTable_T oSymTable) {
+
+   assert(oSymTable != NULL);
+
+   return oSymTable->uLength;
+}
+
+
+/* Helper function that promotes oSymTable, whose inline array must
+   be full, to a hash table holding the same bindings. Return 1 (TRUE)
+   if successful, or 0 (FALSE) if not enough memory, in which case
+   oSymTable does not change */
+
+static int SymTable_promote(SymTable_T oSymTable) {
+
+   struct Binding **ppbBuckets;
+   struct Binding *pbNewBinding;
+   size_t uIndex;
+   size_t i;
+   enum {FALSE, TRUE};
+
+   assert(oSymTable != NULL);
+   assert(oSymTable->ppbBuckets == NULL);
+
+
+   ppbBuckets = (struct Binding**)
+      calloc(sizeof(struct Binding*), auBucketCount[0]);
+
+   if (ppbBuckets == NULL)
+      return FALSE;
+
+
+   for (i = 0; i < oSymTable->uLength; i++) {
+
+      pbNewBinding = (struct Binding*)malloc(sizeof(struct Binding));
+
+      if (pbNewBinding == NULL) {
+
+         /* Undo: the keys still belong to aeInline */
+         for (uIndex = 0; uIndex < auBucketCount[0]; uIndex++) {
+
+            while (ppbBuckets[uIndex] != NULL) {
+
+               pbNewBinding = ppbBuckets[uIndex]->pbNext;
+               free(ppbBuckets[uIndex]);
+               ppbBuckets[uIndex] = pbNewBinding;
+            }
+         }
+
+         free(ppbBuckets);
+         return FALSE;
+      }
+
+      pbNewBinding->pcKey = oSymTable->aeInline[i].pcKey;
+      pbNewBinding->pvValue = oSymTable->aeInline[i].pvValue;
+      pbNewBinding->uHash = SymTable_hash(pbNewBinding->pcKey);
+
+      uIndex = pbNewBinding->uHash % auBucketCount[0];
+
+      pbNewBinding->pbNext = ppbBuckets[uIndex];
+      ppbBuckets[uIndex] = pbNewBinding;
+   }
+
+
+   oSymTable->ppbBuckets = ppbBuckets;
+   oSymTable->uBucketIndex = 0;
+
+
+   return TRUE;
+}
+
+
+/* Helper function that expands promoted Symble Table to next bucket
+   count. oSymTable is a pointer to the Symble Table that will be
+   expanded. Bindings are relinked, not copied. If not enough memory
+   for expansion, oSymTable does not change */
+
+static void SymTable_grow(SymTable_T oSymTable) {
+
+   size_t uCurrentCount;
+   size_t uNextCount;
+   size_t uIndex;
+   size_t i;
+
+   struct Binding *pbCurrent;
+   struct Binding *pbNext;
+   struct Binding **ppbNewBuckets;
+
+
+   assert(oSymTable != NULL);
+   assert(oSymTable->ppbBuckets != NULL);
+
+
+   uCurrentCount = auBucketCount[oSymTable->uBucketIndex];
+   uNextCount = auBucketCount[oSymTable->uBucketIndex + 1];
+
+
+   ppbNewBuckets =
+      (struct Binding**)calloc(sizeof(struct Binding*), uNextCount);
+
+   if (ppbNewBuckets == NULL)
+      return;
+
+
+   for (i = 0; i < uCurrentCount; i++) {
+
+      pbCurrent = oSymTable->ppbBuckets[i];
+
+      while (pbCurrent != NULL) {
+
+         pbNext = pbCurrent->pbNext;
+
+         uIndex = pbCurrent->uHash % uNextCount;
+
+         pbCurrent->pbNext = ppbNewBuckets[uIndex];
+         ppbNewBuckets[uIndex] = pbCurrent;
+
+         pbCurrent = pbNext;
+      }
+   }
+
+
+   free(oSymTable->ppbBuckets);
+
+   oSymTable->ppbBuckets = ppbNewBuckets;
+   oSymTable->uBucketIndex++;
+}
+
+
+/* Return the address of the value of the binding whose key is pcKey
+   and whose full hash code is uHash, if found. oSymTable is the
+   Symble Table object of which pcKey might or might not be a key. If
+   a search hit, it returns the address where pcKey's value is stored.
+   Else, it returns NULL */
+
+static void **SymTable_find(SymTable_T oSymTable, const char *pcKey,
+                            size_t uHash) {
+
+   struct Binding *pbCurrent;
+   size_t i;
+   enum {EQUAL};
+
+   /* redundant, but just so that critTer doesn't complain */
+   assert(oSymTable != NULL);
+   assert(pcKey != NULL);
+
+
+   if (oSymTable->ppbBuckets == NULL) {
+
+      for (i = 0; i < oSymTable->uLength; i++)
+         if (strcmp(oSymTable->aeInline[i].pcKey, pcKey) == EQUAL)
+            return &oSymTable->aeInline[i].pvValue;
+
+      return NULL;
+   }
+
+
+   pbCurrent = oSymTable->ppbBuckets[
+      uHash % auBucketCount[oSymTable->uBucketIndex]];
+
+
+   while (pbCurrent != NULL) {
+
+      if ((pbCurrent->uHash == uHash) &&
+          (strcmp(pbCurrent->pcKey, pcKey) == EQUAL))
+         return &pbCurrent->pvValue;
+
+      pbCurrent = pbCurrent->pbNext;
+   }
+
+   return NULL;
+}
+
+
+/* Return the key to store for pcKey in oSymTable: a defensive copy
+   of pcKey, or pcKey itself if oSymTable borrows its keys. Return
+   NULL if there is not enough memory for the copy */
+
+static char *SymTable_copyKey(SymTable_T oSymTable, const char *pcKey) {
+
+   char *pcCopy;
+
+   assert(oSymTable != NULL);
+   assert(pcKey != NULL);
+
+   if (oSymTable->iBorrowsKeys)
+      return (char*)pcKey;
+
+   pcCopy = (char*)malloc(strlen(pcKey) + 1);
+
+   if (pcCopy == NULL)
+      return NULL;
+
+   return strcpy(pcCopy, pcKey);
+}
+
+
+int SymTable_put(SymTable_T oSymTable, const char *pcKey,
+                 const void *pvValue) {
+
+   size_t uMAX_INDEX;
+   size_t uHash;
+   size_t uIndex;
+   char *pcCopy;
+   struct Binding *pbNewBinding;
+   enum {FALSE, TRUE};
+
+
+   assert(oSymTable != NULL);
+   assert(pcKey != NULL);
+
+
+   /* Small tables never look at the hash code */
+   uHash = (oSymTable->ppbBuckets == NULL) ? 0 : SymTable_hash(pcKey);
+
+   if (SymTable_find(oSymTable, pcKey, uHash) != NULL)
+      return FALSE;
+
+
+   pcCopy = SymTable_copyKey(oSymTable, pcKey);
+
+   if (pcCopy == NULL)
+      return FALSE;
+
+
+   if (oSymTable->ppbBuckets == NULL) {
+
+      if (oSymTable->uLength < INLINE_CAPACITY) {
+
+         oSymTable->aeInline[oSymTable->uLength].pcKey = pcCopy;
+         oSymTable->aeInline[oSymTable->uLength].pvValue =
+            (void*)pvValue;
+
+         oSymTable->uLength++;
+
+         return TRUE;
+      }
+
+      /* No room left inline: the table becomes a hash table */
+      if (! SymTable_promote(oSymTable)) {
+
+         if (! oSymTable->iBorrowsKeys)
+            free(pcCopy);
+         return FALSE;
+      }
+
+      uHash = SymTable_hash(pcKey);
+   }
+
+
+   uMAX_INDEX = sizeof(auBucketCount)/sizeof(size_t) - 1;
+
+   if ((oSymTable->uLength == auBucketCount[oSymTable->uBucketIndex])
+       && (oSymTable->uBucketIndex < uMAX_INDEX))
+      SymTable_grow(oSymTable);
+
+
+   pbNewBinding = (struct Binding*)malloc(sizeof(struct Binding));
+
+   if (pbNewBinding == NULL) {
+
+      if (! oSymTable->iBorrowsKeys)
+         free(pcCopy);
+      return FALSE;
+   }
+
+   pbNewBinding->pcKey = pcCopy;
+   pbNewBinding->pvValue = (void*)pvValue;
+   pbNewBinding->uHash = uHash;
+
+
+   uIndex = uHash % auBucketCount[oSymTable->uBucketIndex];
+
+   pbNewBinding->pbNext = oSymTable->ppbBuckets[uIndex];
+   oSymTable->ppbBuckets[uIndex] = pbNewBinding;
+
+
+   oSymTable->uLength++;
+
+
+   return TRUE;
+}
+
+
+void *SymTable_replace(SymTable_T oSymTable, const char *pcKey,
+                       const void *pvValue) {
+
+   void **ppvResult;
+   void *pvPrevious;
+
+
+   assert(oSymTable != NULL);
+   assert(pcKey != NULL);
+
+   ppvResult = SymTable_find(oSymTable, pcKey,
+      (oSymTable->ppbBuckets == NULL) ? 0 : SymTable_hash(pcKey));
+
+   if (ppvResult == NULL) return NULL;
+
+   pvPrevious = *ppvResult;
+   *ppvResult = (void*)pvValue;
+
+   return pvPrevious;
+}
+
+int SymTable_contains(SymTable_T oSymTable, const char *pcKey) {
+
+   enum {NOT_FOUND, FOUND};
+
+   assert(oSymTable != NULL);
+   assert(pcKey != NULL);
+
+   if (SymTable_find(oSymTable, pcKey,
+          (oSymTable->ppbBuckets == NULL) ? 0 : SymTable_hash(pcKey))
+       == NULL)
+      return NOT_FOUND;
+
+   return FOUND;
+}
+
+void *SymTable_get(SymTable_T oSymTable, const char *pcKey) {
+
+   void **ppvResult;
+
+   assert(oSymTable != NULL);
+   assert(pcKey != NULL);
+
+   ppvResult = SymTable_find(oSymTable, pcKey,
+      (oSymTable->ppbBuckets == NULL) ? 0 : SymTable_hash(pcKey));
+
+   if (ppvResult == NULL) return NULL;
+
+   return *ppvResult;
+}
+
+void *SymTable_remove(SymTable_T oSymTable, const char *pcKey) {
+
+   size_t uHash;
+   size_t uIndex;
+   size_t i;
+   void *pvValue;
+   enum {EQUAL};
+
+   struct Binding *pbPrev;
+   struct Binding *pbCurrent;
+
+
+   assert(oSymTable != NULL);
+   assert(pcKey != NULL);
+
+
+   if (oSymTable->ppbBuckets == NULL) {
+
+      for (i = 0; i < oSymTable->uLength; i++) {
+
+         if (strcmp(oSymTable->aeInline[i].pcKey, pcKey) == EQUAL) {
+
+            pvValue = oSymTable->aeInline[i].pvValue;
+
+            if (! oSymTable->iBorrowsKeys)
+               free((void*)oSymTable->aeInline[i].pcKey);
+
+            /* Close the gap, keeping the remaining order */
+            for (; i + 1 < oSymTable->uLength; i++)
+               oSymTable->aeInline[i] = oSymTable->aeInline[i + 1];
+
+            oSymTable->uLength--;
+
+            return pvValue;
+         }
+      }
+
+      return NULL;
+   }
+
+
+   uHash = SymTable_hash(pcKey);
+   uIndex = uHash % auBucketCount[oSymTable->uBucketIndex];
+
+
+   pbCurrent = oSymTable->ppbBuckets[uIndex];
+   pbPrev = NULL;
+
+
+   while (pbCurrent != NULL) {
+
+      if ((pbCurrent->uHash == uHash) &&
+          (strcmp(pbCurrent->pcKey, pcKey) == EQUAL)) {
+
+         /* if Binding is the first on the separate chain */
+         if (pbPrev == NULL)
+            oSymTable->ppbBuckets[uIndex] = pbCurrent->pbNext;
+
+         else
+            pbPrev->pbNext = pbCurrent->pbNext;
+
+
+         pvValue = pbCurrent->pvValue;
+
+         if (! oSymTable->iBorrowsKeys)
+            free((void*)pbCurrent->pcKey);
+
+         free(pbCurrent);
+
+         oSymTable->uLength--;
+
+         return pvValue;
+      }
+
+      pbPrev = pbCurrent;
+      pbCurrent = pbCurrent->pbNext;
+   }
+
+   return NULL;
+}
+
+
+void SymTable_map(SymTable_T oSymTable,
+                  void (*pfApply)(const char *pcKey, void *pvValue,
+                                  void *pvExtra), const void *pvExtra) {
+
+   size_t i;
+   size_t uBucketCount;
+   struct Binding *pbCurrent;
+
+   assert(oSymTable != NULL);
+   assert(pfApply != NULL);
+
+
+   if (oSymTable->ppbBuckets == NULL) {
+
+      for (i = 0; i < oSymTable->uLength; i++)
+         (*pfApply)(oSymTable->aeInline[i].pcKey,
+                    oSymTable->aeInline[i].pvValue,
+                    (void*)pvExtra);
+
+      return;
+   }
+
+
+   uBucketCount = auBucketCount[oSymTable->uBucketIndex];
+
+
+   for (i = 0; i < uBucketCount; i++) {
+
+      pbCurrent = oSymTable->ppbBuckets[i];
+
+
+      while (pbCurrent != NULL) {
+
+         (*pfApply)(pbCurrent->pcKey, pbCurrent->pvValue,
+                    (void*)pvExtra);
+
+         pbCurrent = pbCurrent->pbNext;
+      }
+   }
+}
+
+
+/* Add to the estimate of psMemory the bytes that malloc adds to a
+   block of uSize bytes */
+
+static void SymTable_addOverhead(struct SymTableMemory *psMemory,
+                                 size_t uSize) {
+
+   const size_t uWord = sizeof(size_t);
+   size_t uChunk;
+
+   assert(psMemory != NULL);
+
+   uChunk = (uSize + 3 * uWord - 1) / (2 * uWord) * (2 * uWord);
+
+   if (uChunk < 4 * uWord)
+      uChunk = 4 * uWord;
+
+   psMemory->uOverheadBytes += uChunk - uSize;
+}
+
+
+/* Add to psMemory the copy of pcKey held by oSymTable, if any */
+
+static void SymTable_addKey(SymTable_T oSymTable,
+                            struct SymTableMemory *psMemory,
+                            const char *pcKey) {
+
+   size_t uKeySize;
+
+   assert(oSymTable != NULL);
+   assert(psMemory != NULL);
+   assert(pcKey != NULL);
+
+   if (oSymTable->iBorrowsKeys)
+      return;
+
+   uKeySize = strlen(pcKey) + 1;
+   psMemory->uKeyBytes += uKeySize;
+   SymTable_addOverhead(psMemory, uKeySize);
+}
+
+
+void SymTable_memoryUsage(SymTable_T oSymTable,
+                          struct SymTableMemory *psMemory) {
+
+   struct Binding *pbCurrent;
+   size_t uBucketCount;
+   size_t i;
+
+   assert(oSymTable != NULL);
+   assert(psMemory != NULL);
+
+   /* The inline Entries are part of struct SymTable */
+   psMemory->uTableBytes = sizeof(struct SymTable);
+   psMemory->uBindingBytes = 0;
+   psMemory->uKeyBytes = 0;
+   psMemory->uOverheadBytes = 0;
+
+   SymTable_addOverhead(psMemory, sizeof(struct SymTable));
+
+
+   if (oSymTable->ppbBuckets == NULL) {
+
+      for (i = 0; i < oSymTable->uLength; i++)
+         SymTable_addKey(oSymTable, psMemory,
+                         oSymTable->aeInline[i].pcKey);
+
+      return;
+   }
+
+
+   uBucketCount = auBucketCount[oSymTable->uBucketIndex];
+
+   psMemory->uTableBytes += sizeof(struct Binding*) * uBucketCount;
+   SymTable_addOverhead(psMemory,
+                        sizeof(struct Binding*) * uBucketCount);
+
+   for (i = 0; i < uBucketCount; i++) {
+
+      for (pbCurrent = oSymTable->ppbBuckets[i]; pbCurrent != NULL;
+           pbCurrent = pbCurrent->pbNext) {
+
+         psMemory->uBindingBytes += sizeof(struct Binding);
+         SymTable_addOverhead(psMemory, sizeof(struct Binding));
+         SymTable_addKey(oSymTable, psMemory, pbCurrent->pcKey);
+      }
+   }
+}
+
+
+/* Position psIter at the first binding whose inline position or
+   bucket index is at least uIndex, or at its end if there is no such
+   binding */
+
+static void SymTable_iterSeek(struct SymTableIter *psIter,
+                              size_t uIndex) {
+
+   SymTable_T oSymTable;
+   size_t uBucketCount;
+   struct Binding *pbCurrent;
+
+   assert(psIter != NULL);
+
+   oSymTable = psIter->oSymTable;
+
+   if (oSymTable->ppbBuckets == NULL) {
+
+      if (uIndex < oSymTable->uLength) {
+
+         psIter->uIndex = uIndex;
+         psIter->pvPosition = &oSymTable->aeInline[uIndex];
+         psIter->pcKey = oSymTable->aeInline[uIndex].pcKey;
+         psIter->pvValue = oSymTable->aeInline[uIndex].pvValue;
+         return;
+      }
+   }
+
+   else {
+
+      uBucketCount = auBucketCount[oSymTable->uBucketIndex];
+
+      for (; uIndex < uBucketCount; uIndex++) {
+
+         pbCurrent = oSymTable->ppbBuckets[uIndex];
+
+         if (pbCurrent != NULL) {
+
+            psIter->uIndex = uIndex;
+            psIter->pvPosition = pbCurrent;
+            psIter->pcKey = pbCurrent->pcKey;
+            psIter->pvValue = pbCurrent->pvValue;
+            return;
+         }
+      }
+   }
+
+   psIter->uIndex = uIndex;
+   psIter->pvPosition = NULL;
+   psIter->pcKey = NULL;
+   psIter->pvValue = NULL;
+}
+
+
+void SymTable_iterBegin(SymTable_T oSymTable,
+                        struct SymTableIter *psIter) {
+
+   assert(oSymTable != NULL);
+   assert(psIter != NULL);
+
+   psIter->oSymTable = oSymTable;
+
+   SymTable_iterSeek(psIter, 0);
+}
+
+void SymTable_iterNext(struct SymTableIter *psIter) {
+
+   struct Binding *pbNext;
+
+   assert(psIter != NULL);
+   assert(psIter->pvPosition != NULL);
+
+   /* Stay on the same separate chain while it lasts */
+   if (psIter->oSymTable->ppbBuckets != NULL) {
+
+      pbNext = ((struct Binding*)psIter->pvPosition)->pbNext;
+
+      if (pbNext != NULL) {
+
+         psIter->pvPosition = pbNext;
+         psIter->pcKey = pbNext->pcKey;
+         psIter->pvValue = pbNext->pvValue;
+         return;
+      }
+   }
+
+   SymTable_iterSeek(psIter, psIter->uIndex + 1);
+}
+
+int SymTable_iterEnd(const struct SymTableIter *psIter) {
+
+   assert(psIter != NULL);
+
+   return psIter->pvPosition == NULL;
+}
@@ -0,0 +1,396 @@
+/*--------------------------------------------------------------------*/
+/* symtableatom.c                                                     */
+/* author: Julio Lins (jcclb)                                         */
+/*--------------------------------------------------------------------*/
+
+#include "symtableatom.h"
+#include <assert.h>
+#include <stdlib.h>
+
+/*--------------------------------------------------------------------*/
+
+/* Sequence of bucket counts for Symble Table expansion */
+
+static const size_t auBucketCount[] = {509, 1021, 2039, 4093, 8191,
+                                       16381, 32749, 65521};
+
+
+/* Each atom and respective value are stored in a Binding. Bindings
+   whose atoms hash to the same code are linked to form a list */
+
+struct Binding {
+
+   /* key, owned by client; compared by address */
+   const char *pcAtom;
+
+   /* value, owned by client */
+   void *pvValue;
+
+   /* The address of the next Binding on the list of same-hash-code
+      Bindings */
+   struct Binding *pbNext;
+};
+
+
+/* SymTableAtom is a structure that points to all separate chains'
+   first Bindings */
+
+struct SymTableAtom {
+
+   /* Index of auBucketCount[] leading to current bucket count for
+      SymTableAtom object */
+   size_t uBucketIndex;
+
+   /* Pointer to the addresses of separate chains' first Bindings */
+   struct Binding **ppbBuckets;
+
+   /* size of Symble Table (total # of Bindings) */
+   size_t uLength;
+};
+
+
+
+/* Return a hash code for pcAtom that is between 0 and uBucketCount-1,
+   inclusive. Only the address of pcAtom is used; since uBucketCount
+   is prime, aligned addresses still spread over every bucket */
+
+static size_t SymTableAtom_hash(const char *pcAtom, size_t uBucketCount)
+{
+   assert(pcAtom != NULL);
+
+   return (size_t)pcAtom % uBucketCount;
+}
+
+
+SymTableAtom_T SymTableAtom_new(void) {
+
+   SymTableAtom_T oSymTableAtom;
+
+
+   oSymTableAtom = (SymTableAtom_T)malloc(sizeof(struct SymTableAtom));
+
+   if (oSymTableAtom == NULL)
+      return NULL;
+
+
+   oSymTableAtom->ppbBuckets = (struct Binding**)
+      calloc(sizeof(struct Binding*), auBucketCount[0]);
+
+   if (oSymTableAtom->ppbBuckets == NULL) {
+
+      free(oSymTableAtom);
+      return NULL;
+   }
+
+   oSymTableAtom->uLength = 0;
+   oSymTableAtom->uBucketIndex = 0;
+
+
+   return oSymTableAtom;
+}
+
+
+
+void SymTableAtom_free(SymTableAtom_T oSymTableAtom) {
+
+   struct Binding *pbCurrent;
+   struct Binding *pbNext;
+   size_t i;
+
+
+   assert(oSymTableAtom != NULL);
+
+
+   for (i = 0; i < auBucketCount[oSymTableAtom->uBucketIndex]; i++) {
+
+      pbCurrent = oSymTableAtom->ppbBuckets[i];
+
+      while (pbCurrent != NULL) {
+
+         /* Save pointer to next Binding before freeing pbCurrent */
+         pbNext = pbCurrent->pbNext;
+
+         free(pbCurrent);
+
+         pbCurrent = pbNext;
+      }
+   }
+
+   free(oSymTableAtom->ppbBuckets);
+   free(oSymTableAtom);
+}
+
+
+size_t SymTableAtom_getLength(SymTableAtom_T oSymTableAtom) {
+
+   assert(oSymTableAtom != NULL);
+
+   return oSymTableAtom->uLength;
+}
+
+
+/* Helper function that expands oSymTableAtom to next bucket count,
+   relinking its Bindings. If not enough memory for expansion,
+   oSymTableAtom does not change */
+
+static void SymTableAtom_grow(SymTableAtom_T oSymTableAtom) {
+
+   size_t uCurrentCount;
+   size_t uNextCount;
+   size_t uIndex;
+   size_t i;
+
+   struct Binding *pbCurrent;
+   struct Binding *pbNext;
+   struct Binding **ppbNewBuckets;
+
+
+   assert(oSymTableAtom != NULL);
+
+
+   uCurrentCount = auBucketCount[oSymTableAtom->uBucketIndex];
+   uNextCount = auBucketCount[oSymTableAtom->uBucketIndex + 1];
+
+
+   ppbNewBuckets =
+      (struct Binding**)calloc(sizeof(struct Binding*), uNextCount);
+
+   if (ppbNewBuckets == NULL)
+      return;
+
+
+   for (i = 0; i < uCurrentCount; i++) {
+
+      pbCurrent = oSymTableAtom->ppbBuckets[i];
+
+      while (pbCurrent != NULL) {
+
+         pbNext = pbCurrent->pbNext;
+
+         uIndex = SymTableAtom_hash(pbCurrent->pcAtom, uNextCount);
+
+         pbCurrent->pbNext = ppbNewBuckets[uIndex];
+         ppbNewBuckets[uIndex] = pbCurrent;
+
+         pbCurrent = pbNext;
+      }
+   }
+
+
+   free(oSymTableAtom->ppbBuckets);
+
+   oSymTableAtom->ppbBuckets = ppbNewBuckets;
+   oSymTableAtom->uBucketIndex++;
+}
+
+
+/* Return Binding of corresponding atom, if found. oSymTableAtom is
+   the Symble Table object of which pcAtom might or might not be a
+   key. If a search hit, it returns a pointer to pcAtom's Binding.
+   Else, it returns NULL */
+
+static struct Binding *SymTableAtom_find(SymTableAtom_T oSymTableAtom,
+                                         const char *pcAtom) {
+
+   struct Binding *pbCurrent;
+
+   /* redundant, but just so that critTer doesn't complain */
+   assert(oSymTableAtom != NULL);
+   assert(pcAtom != NULL);
+
+
+   pbCurrent = oSymTableAtom->ppbBuckets[SymTableAtom_hash(pcAtom,
+      auBucketCount[oSymTableAtom->uBucketIndex])];
+
+
+   while (pbCurrent != NULL) {
+
+      if (pbCurrent->pcAtom == pcAtom)
+         return pbCurrent;
+
+      pbCurrent = pbCurrent->pbNext;
+   }
+
+   return NULL;
+}
+
+
+int SymTableAtom_put(SymTableAtom_T oSymTableAtom, const char *pcAtom,
+                     const void *pvValue) {
+
+   size_t uMAX_INDEX;
+   size_t uIndex;
+   struct Binding *pbNewBinding;
+   enum {FALSE, TRUE};
+
+
+   assert(oSymTableAtom != NULL);
+   assert(pcAtom != NULL);
+
+
+   if (SymTableAtom_find(oSymTableAtom, pcAtom) != NULL)
+      return FALSE;
+
+
+   uMAX_INDEX = sizeof(auBucketCount)/sizeof(size_t) - 1;
+
+   if ((oSymTableAtom->uLength ==
+        auBucketCount[oSymTableAtom->uBucketIndex]) &&
+       (oSymTableAtom->uBucketIndex < uMAX_INDEX))
+      SymTableAtom_grow(oSymTableAtom);
+
+
+   pbNewBinding = (struct Binding*)malloc(sizeof(struct Binding));
+
+   if (pbNewBinding == NULL)
+      return FALSE;
+
+   /* No defensive copy: the atom is the key */
+   pbNewBinding->pcAtom = pcAtom;
+   pbNewBinding->pvValue = (void*)pvValue;
+
+
+   uIndex = SymTableAtom_hash(pcAtom,
+      auBucketCount[oSymTableAtom->uBucketIndex]);
+
+   pbNewBinding->pbNext = oSymTableAtom->ppbBuckets[uIndex];
+   oSymTableAtom->ppbBuckets[uIndex] = pbNewBinding;
+
+
+   oSymTableAtom->uLength++;
+
+
+   return TRUE;
+}
+
+
+void *SymTableAtom_replace(SymTableAtom_T oSymTableAtom,
+                           const char *pcAtom, const void *pvValue) {
+
+   struct Binding *pbResult;
+   void *pvPrevious;
+
+
+   assert(oSymTableAtom != NULL);
+   assert(pcAtom != NULL);
+
+   pbResult = SymTableAtom_find(oSymTableAtom, pcAtom);
+
+   if (pbResult == NULL) return NULL;
+
+   pvPrevious = pbResult->pvValue;
+   pbResult->pvValue = (void*)pvValue;
+
+   return pvPrevious;
+}
+
+int SymTableAtom_contains(SymTableAtom_T oSymTableAtom,
+                          const char *pcAtom) {
+
+   enum {NOT_FOUND, FOUND};
+
+   assert(oSymTableAtom != NULL);
+   assert(pcAtom != NULL);
+
+   if (SymTableAtom_find(oSymTableAtom, pcAtom) == NULL)
+      return NOT_FOUND;
+
+   return FOUND;
+}
+
+void *SymTableAtom_get(SymTableAtom_T oSymTableAtom,
+                       const char *pcAtom) {
+
+   struct Binding *pbResult;
+
+   assert(oSymTableAtom != NULL);
+   assert(pcAtom != NULL);
+
+   pbResult = SymTableAtom_find(oSymTableAtom, pcAtom);
+
+   if (pbResult == NULL) return NULL;
+
+   return pbResult->pvValue;
+}
+
+void *SymTableAtom_remove(SymTableAtom_T oSymTableAtom,
+                          const char *pcAtom) {
+
+   size_t uIndex;
+   void *pvValue;
+
+   struct Binding *pbPrev;
+   struct Binding *pbCurrent;
+
+
+   assert(oSymTableAtom != NULL);
+   assert(pcAtom != NULL);
+
+
+   uIndex = SymTableAtom_hash(pcAtom,
+      auBucketCount[oSymTableAtom->uBucketIndex]);
+
+
+   pbCurrent = oSymTableAtom->ppbBuckets[uIndex];
+   pbPrev = NULL;
+
+
+   while (pbCurrent != NULL) {
+
+      if (pbCurrent->pcAtom == pcAtom) {
+
+         /* if Binding is the first on the separate chain */
+         if (pbPrev == NULL)
+            oSymTableAtom->ppbBuckets[uIndex] = pbCurrent->pbNext;
+
+         else
+            pbPrev->pbNext = pbCurrent->pbNext;
+
+
+         pvValue = pbCurrent->pvValue;
+
+         free(pbCurrent);
+
+         oSymTableAtom->uLength--;
+
+         return pvValue;
+      }
+
+      pbPrev = pbCurrent;
+      pbCurrent = pbCurrent->pbNext;
+   }
+
+   return NULL;
+}
+
+
+void SymTableAtom_map(SymTableAtom_T oSymTableAtom,
+                      void (*pfApply)(const char *pcAtom,
+                                      void *pvValue, void *pvExtra),
+                      const void *pvExtra) {
+
+   size_t i;
+   size_t uBucketCount;
+   struct Binding *pbCurrent;
+
+   assert(oSymTableAtom != NULL);
+   assert(pfApply != NULL);
+
+
+   uBucketCount = auBucketCount[oSymTableAtom->uBucketIndex];
+
+
+   for (i = 0; i < uBucketCount; i++) {
+
+      pbCurrent = oSymTableAtom->ppbBuckets[i];
+
+
+      while (pbCurrent != NULL) {
+
+         (*pfApply)(pbCurrent->pcAtom, pbCurrent->pvValue,
+                    (void*)pvExtra);
+
+         pbCurrent = pbCurrent->pbNext;
+      }
+   }
+}
@@ -0,0 +1,101 @@
+/*--------------------------------------------------------------------*/
+/* symtableatom.h                                                     */
+/* Author: Julio Lins (jcclb)                                         */
+/*--------------------------------------------------------------------*/
+
+#ifndef SYMTABLEATOM_H
+#define SYMTABLEATOM_H
+
+/*--------------------------------------------------------------------*/
+
+#include <stddef.h>
+
+/*--------------------------------------------------------------------*/
+
+/* A SymTableAtom_T object is an unordered collection of key-value
+   bindings whose keys are atoms (see atomtable.h). Keys are compared
+   and hashed by address, never by contents, and are not copied: each
+   key must stay valid, and must be the atom of its string, for as
+   long as it is bound. Otherwise its functions behave as their
+   SymTable counterparts in symtable.h */
+
+typedef struct SymTableAtom *SymTableAtom_T;
+
+/*--------------------------------------------------------------------*/
+
+/* Return a new SymTableAtom_T object, or NULL if insufficient memory
+   is available */
+
+SymTableAtom_T SymTableAtom_new(void);
+
+/*--------------------------------------------------------------------*/
+
+/* Free memory allocated by oSymTableAtom. Its keys are not freed */
+
+void SymTableAtom_free(SymTableAtom_T oSymTableAtom);
+
+/*--------------------------------------------------------------------*/
+
+/* Return length of oSymTableAtom (i.e., number of bindings) */
+
+size_t SymTableAtom_getLength(SymTableAtom_T oSymTableAtom);
+
+/*--------------------------------------------------------------------*/
+
+/* Add a binding with pcAtom as key and pvValue as value to
+   oSymTableAtom. Return 1 (TRUE) if insertion is successful, and 0
+   (FALSE) if there is insufficient memory or if there is already a
+   binding whose key is pcAtom, in which case oSymTableAtom is left
+   unchanged */
+
+int SymTableAtom_put(SymTableAtom_T oSymTableAtom, const char *pcAtom,
+                     const void *pvValue);
+
+/*--------------------------------------------------------------------*/
+
+/* If oSymTableAtom contains a binding whose key is pcAtom, assign
+   pvValue as the binding's new value and return its previous value.
+   Else, leave oSymTableAtom unchanged and return NULL */
+
+void *SymTableAtom_replace(SymTableAtom_T oSymTableAtom,
+                           const char *pcAtom, const void *pvValue);
+
+/*--------------------------------------------------------------------*/
+
+/* Return 1 (TRUE) if oSymTableAtom contains a binding whose key is
+   pcAtom, 0 (FALSE) otherwise */
+
+int SymTableAtom_contains(SymTableAtom_T oSymTableAtom,
+                          const char *pcAtom);
+
+/*--------------------------------------------------------------------*/
+
+/* Return the value of the binding within oSymTableAtom whose key is
+   pcAtom, or NULL if no such binding exists */
+
+void *SymTableAtom_get(SymTableAtom_T oSymTableAtom,
+                       const char *pcAtom);
+
+/*--------------------------------------------------------------------*/
+
+/* If oSymTableAtom contains a binding whose key is pcAtom, remove such
+   binding and return its value. Else, leave oSymTableAtom unchanged
+   and return NULL */
+
+void *SymTableAtom_remove(SymTableAtom_T oSymTableAtom,
+                          const char *pcAtom);
+
+/*--------------------------------------------------------------------*/
+
+/* Applies function pfApply to each binding in oSymTableAtom, passing
+   each bindings' key (pcAtom) and value (pvValue) as parameters, as
+   well as pvExtra as en extra parameter */
+
+void SymTableAtom_map(SymTableAtom_T oSymTableAtom,
+                      void (*pfApply)(const char *pcAtom,
+                                      void *pvValue, void *pvExtra),
+                      const void *pvExtra);
+
+/*--------------------------------------------------------------------*/
+
+#endif
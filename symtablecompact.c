@@ -0,0 +1,900 @@
+/*--------------------------------------------------------------------*/
+/* symtablecompact.c                                                  */
+/* author: Julio Lins (jcclb)                                         */
+/*--------------------------------------------------------------------*/
+
+#include "symtable.h"
+#include <assert.h>
+#include <string.h>
+#include <stdlib.h>
+#include <limits.h>
+
+/*--------------------------------------------------------------------*/
+
+/* Bindings, buckets and key copies are addressed by unsigned int
+   indices and offsets, which must have at least 32 bits */
+
+#if UINT_MAX < 0xFFFFFFFFUL
+#error "symtablecompact.c needs an unsigned int of at least 32 bits"
+#endif
+
+/* Sequence of bucket counts for Symble Table expansion. It goes on
+   well past that of symtablehash.c, since this implementation is
+   meant for tables of many millions of bindings */
+
+static const size_t auBucketCount[] = {509, 1021, 2039, 4093, 8191,
+                                       16381, 32749, 65521, 131071,
+                                       262139, 524287, 1048573,
+                                       2097143, 4194301, 8388593,
+                                       16777213, 33554393, 67108859,
+                                       134217689, 268435399, 536870909,
+                                       1073741789};
+
+/* # of Bindings a Symble Table makes room for the first time it needs
+   any, and bytes of key pool likewise */
+
+enum {MIN_BINDING_CAPACITY = 512};
+enum {MIN_POOL_SIZE = 4096};
+
+/* Index stored instead of a Binding index at the end of a separate
+   chain, of the free list, or in an empty bucket */
+
+#define NO_INDEX UINT_MAX
+
+
+/* Each key and respective value are stored in a Binding. Bindings
+   whose keys hash to the same code are linked to form a list, and
+   removed Bindings are linked to form the free list. A Binding is
+   two unsigned ints and a pointer: 16 bytes where pointers have 64
+   bits, against 24 for a Binding of symtablehash.c */
+
+struct Binding {
+
+   /* offset of the key in the key pool, unused if the table borrows
+      its keys */
+   unsigned int uiKey;
+
+   /* The index of the next Binding on the list of same-hash-code
+      Bindings, or on the free list, or NO_INDEX */
+   unsigned int uiNext;
+
+   /* value, owned by client */
+   void *pvValue;
+};
+
+
+/* SymTable is a structure that holds the indices of all separate
+   chains' first Bindings, the pool that holds every Binding and the
+   pool that holds every key copy. Keys are copied end to end, each
+   with its '\0', so a key costs no more than its characters */
+
+struct SymTable {
+
+   /* Index of auBucketCount[] leading to current bucket count for
+      SymTable object */
+   size_t uBucketIndex;
+
+   /* Indices of separate chains' first Bindings */
+   unsigned int *puiBuckets;
+
+   /* size of Symble Table (total # of Bindings in use) */
+   size_t uLength;
+
+   /* all Bindings, in use, free or never used yet */
+   struct Binding *pbBindings;
+
+   /* # of Bindings in pbBindings */
+   size_t uCapacity;
+
+   /* # of Bindings of pbBindings ever used. Those past it have never
+      been */
+   size_t uUsed;
+
+   /* index of the first Binding on the free list, or NO_INDEX */
+   unsigned int uiFree;
+
+   /* key pool */
+   char *pcPool;
+
+   /* # of bytes of the key pool */
+   size_t uPoolSize;
+
+   /* # of bytes of the key pool holding keys, removed ones
+      included */
+   size_t uPoolUsed;
+
+   /* # of bytes of the key pool holding keys of removed Bindings */
+   size_t uPoolDead;
+
+   /* keys of a table that borrows them, at the index of their
+      Binding, or NULL if the table copies its keys. A borrowed key
+      must be given back as the very pointer the client put, so it
+      does not fit in an offset */
+   const char **ppcBorrowed;
+};
+
+
+
+/* Helper function that empties every bucket of oSymTable */
+
+static void SymTable_emptyBuckets(SymTable_T oSymTable) {
+
+   size_t i;
+
+   assert(oSymTable != NULL);
+
+   for (i = 0; i < auBucketCount[oSymTable->uBucketIndex]; i++)
+      oSymTable->puiBuckets[i] = NO_INDEX;
+}
+
+
+
+SymTable_T SymTable_new(void) {
+
+   SymTable_T oSymTable;
+
+
+   oSymTable = (SymTable_T)malloc(sizeof(struct SymTable));
+
+   if (oSymTable == NULL)
+      return NULL;
+
+
+   oSymTable->puiBuckets = (unsigned int*)
+      malloc(sizeof(unsigned int) * auBucketCount[0]);
+
+   if (oSymTable->puiBuckets == NULL) {
+
+      free(oSymTable);
+      return NULL;
+   }
+
+   oSymTable->uBucketIndex = 0;
+   SymTable_emptyBuckets(oSymTable);
+
+   /* Pools are allocated by the first put that needs them */
+   oSymTable->uLength = 0;
+   oSymTable->pbBindings = NULL;
+   oSymTable->uCapacity = 0;
+   oSymTable->uUsed = 0;
+   oSymTable->uiFree = NO_INDEX;
+   oSymTable->pcPool = NULL;
+   oSymTable->uPoolSize = 0;
+   oSymTable->uPoolUsed = 0;
+   oSymTable->uPoolDead = 0;
+   oSymTable->ppcBorrowed = NULL;
+
+   return oSymTable;
+}
+
+
+
+SymTable_T SymTable_newBorrowedKeys(void) {
+
+   SymTable_T oSymTable;
+
+   oSymTable = SymTable_new();
+
+   if (oSymTable == NULL)
+      return NULL;
+
+   /* An empty, non-NULL array marks a table that borrows its keys */
+   oSymTable->ppcBorrowed = (const char**)malloc(sizeof(const char*));
+
+   if (oSymTable->ppcBorrowed == NULL) {
+
+      SymTable_free(oSymTable);
+      return NULL;
+   }
+
+   return oSymTable;
+}
+
+
+
+/* Return the key of the Binding of oSymTable at index uiBinding */
+
+static const char *SymTable_key(SymTable_T oSymTable,
+                                unsigned int uiBinding) {
+
+   assert(oSymTable != NULL);
+   assert(uiBinding < oSymTable->uUsed);
+
+   if (oSymTable->ppcBorrowed != NULL)
+      return oSymTable->ppcBorrowed[uiBinding];
+
+   return oSymTable->pcPool + oSymTable->pbBindings[uiBinding].uiKey;
+}
+
+
+/* Helper function that calls pfFreeValue on the value of every
+   Binding of oSymTable, unless pfFreeValue is NULL, and empties
+   oSymTable. Its buckets and pools are kept for later puts */
+
+static void SymTable_freeBindings(SymTable_T oSymTable,
+                                  void (*pfFreeValue)(void *pvValue)) {
+
+   unsigned int uiCurrent;
+   size_t i;
+
+
+   assert(oSymTable != NULL);
+
+
+   if (pfFreeValue != NULL)
+      for (i = 0; i < auBucketCount[oSymTable->uBucketIndex]; i++)
+         for (uiCurrent = oSymTable->puiBuckets[i];
+              uiCurrent != NO_INDEX;
+              uiCurrent = oSymTable->pbBindings[uiCurrent].uiNext)
+            (*pfFreeValue)(oSymTable->pbBindings[uiCurrent].pvValue);
+
+   SymTable_emptyBuckets(oSymTable);
+
+   oSymTable->uLength = 0;
+   oSymTable->uUsed = 0;
+   oSymTable->uiFree = NO_INDEX;
+   oSymTable->uPoolUsed = 0;
+   oSymTable->uPoolDead = 0;
+}
+
+
+void SymTable_free(SymTable_T oSymTable) {
+
+   assert(oSymTable != NULL);
+
+   SymTable_freeWith(oSymTable, NULL);
+}
+
+
+
+void SymTable_freeWith(SymTable_T oSymTable,
+                       void (*pfFreeValue)(void *pvValue)) {
+
+   assert(oSymTable != NULL);
+
+   SymTable_freeBindings(oSymTable, pfFreeValue);
+
+   free(oSymTable->puiBuckets);
+   free(oSymTable->pbBindings);
+   free(oSymTable->pcPool);
+   free((void*)oSymTable->ppcBorrowed);
+   free(oSymTable);
+}
+
+
+
+void SymTable_clear(SymTable_T oSymTable,
+                    void (*pfFreeValue)(void *pvValue)) {
+
+   assert(oSymTable != NULL);
+
+   SymTable_freeBindings(oSymTable, pfFreeValue);
+}
+
+
+size_t SymTable_getLength(SymTable_T oSymTable) {
+
+   assert(oSymTable != NULL);
+
+   return oSymTable->uLength;
+}
+
+
+
+/* Return a hash code for pcKey that is between 0 and uBucketCount-1,
+   inclusive. pcKey is a pointer to the key which will be hashed.
+   uBucketCount is the current bucket count. */
+
+static size_t SymTable_hash(const char *pcKey, size_t uBucketCount)
+{
+   const size_t HASH_MULTIPLIER = 65599;
+   size_t u;
+   size_t uHash = 0;
+
+   assert(pcKey != NULL);
+
+   for (u = 0; pcKey[u] != '\0'; u++)
+      uHash = uHash * HASH_MULTIPLIER + (size_t)pcKey[u];
+
+   return uHash % uBucketCount;
+}
+
+
+/* Helper function that expands Symble Table to next bucket count,
+   relinking its Bindings by index. oSymTable is a pointer to the
+   Symble Table that will be expanded. If not enough memory for
+   expansion, oSymTable does not change */
+
+static void SymTable_grow(SymTable_T oSymTable) {
+
+   unsigned int *puiNewBuckets;
+   unsigned int uiCurrent;
+   unsigned int uiNext;
+   size_t uNewCount;
+   size_t uIndex;
+   size_t i;
+
+
+   assert(oSymTable != NULL);
+
+   uNewCount = auBucketCount[oSymTable->uBucketIndex + 1];
+
+   puiNewBuckets =
+      (unsigned int*)malloc(sizeof(unsigned int) * uNewCount);
+
+   if (puiNewBuckets == NULL)
+      return;
+
+   for (i = 0; i < uNewCount; i++)
+      puiNewBuckets[i] = NO_INDEX;
+
+
+   for (i = 0; i < auBucketCount[oSymTable->uBucketIndex]; i++) {
+
+      for (uiCurrent = oSymTable->puiBuckets[i]; uiCurrent != NO_INDEX;
+           uiCurrent = uiNext) {
+
+         /* Save index of next Binding before relinking uiCurrent */
+         uiNext = oSymTable->pbBindings[uiCurrent].uiNext;
+
+         uIndex = SymTable_hash(SymTable_key(oSymTable, uiCurrent),
+                                uNewCount);
+
+         oSymTable->pbBindings[uiCurrent].uiNext =
+            puiNewBuckets[uIndex];
+         puiNewBuckets[uIndex] = uiCurrent;
+      }
+   }
+
+   free(oSymTable->puiBuckets);
+
+   oSymTable->puiBuckets = puiNewBuckets;
+   oSymTable->uBucketIndex++;
+}
+
+
+/* Return the index of a Binding of oSymTable that is not in use,
+   taken from the free list or past the Bindings ever used, doubling
+   the Binding pool if it is full. Return NO_INDEX if the pool cannot
+   grow. The Binding is not taken off the free list */
+
+static unsigned int SymTable_spareBinding(SymTable_T oSymTable) {
+
+   size_t uNewCapacity;
+   struct Binding *pbNewBindings;
+   const char **ppcNewBorrowed;
+
+
+   assert(oSymTable != NULL);
+
+
+   if (oSymTable->uiFree != NO_INDEX)
+      return oSymTable->uiFree;
+
+   if (oSymTable->uUsed < oSymTable->uCapacity)
+      return (unsigned int)oSymTable->uUsed;
+
+
+   /* Every index must stay below NO_INDEX */
+   if (oSymTable->uCapacity >= (size_t)NO_INDEX)
+      return NO_INDEX;
+
+   uNewCapacity = oSymTable->uCapacity * 2;
+
+   if (uNewCapacity < MIN_BINDING_CAPACITY)
+      uNewCapacity = MIN_BINDING_CAPACITY;
+
+   if ((uNewCapacity > (size_t)NO_INDEX) ||
+       (uNewCapacity < oSymTable->uCapacity))
+      uNewCapacity = (size_t)NO_INDEX;
+
+   if (uNewCapacity > (size_t)-1 / sizeof(struct Binding))
+      return NO_INDEX;
+
+
+   pbNewBindings = (struct Binding*)realloc(oSymTable->pbBindings,
+      sizeof(struct Binding) * uNewCapacity);
+
+   if (pbNewBindings == NULL)
+      return NO_INDEX;
+
+   oSymTable->pbBindings = pbNewBindings;
+
+
+   /* Borrowed keys grow along, and the capacity only counts once
+      both have */
+   if (oSymTable->ppcBorrowed != NULL) {
+
+      ppcNewBorrowed = (const char**)realloc(
+         (void*)oSymTable->ppcBorrowed,
+         sizeof(const char*) * uNewCapacity);
+
+      if (ppcNewBorrowed == NULL)
+         return NO_INDEX;
+
+      oSymTable->ppcBorrowed = ppcNewBorrowed;
+   }
+
+   oSymTable->uCapacity = uNewCapacity;
+
+   return (unsigned int)oSymTable->uUsed;
+}
+
+
+/* Move the keys of oSymTable that are still bound to the start of a
+   new key pool of uNewSize bytes, which leaves out those of removed
+   Bindings, and update the offsets of their Bindings. Return 1 (TRUE)
+   if successful, or 0 (FALSE) if insufficient memory is available, in
+   which case oSymTable does not change */
+
+static int SymTable_repool(SymTable_T oSymTable, size_t uNewSize) {
+
+   char *pcNewPool;
+   size_t uNewUsed;
+   size_t uKeySize;
+   unsigned int uiCurrent;
+   struct Binding *pbCurrent;
+   size_t i;
+   enum {FALSE, TRUE};
+
+
+   assert(oSymTable != NULL);
+   assert(uNewSize >= oSymTable->uPoolUsed - oSymTable->uPoolDead);
+
+
+   pcNewPool = (char*)malloc(uNewSize);
+
+   if (pcNewPool == NULL)
+      return FALSE;
+
+
+   uNewUsed = 0;
+
+   for (i = 0; i < auBucketCount[oSymTable->uBucketIndex]; i++) {
+
+      for (uiCurrent = oSymTable->puiBuckets[i]; uiCurrent != NO_INDEX;
+           uiCurrent = pbCurrent->uiNext) {
+
+         pbCurrent = &oSymTable->pbBindings[uiCurrent];
+
+         uKeySize = strlen(oSymTable->pcPool + pbCurrent->uiKey) + 1;
+
+         memcpy(pcNewPool + uNewUsed,
+                oSymTable->pcPool + pbCurrent->uiKey, uKeySize);
+
+         pbCurrent->uiKey = (unsigned int)uNewUsed;
+         uNewUsed += uKeySize;
+      }
+   }
+
+   free(oSymTable->pcPool);
+
+   oSymTable->pcPool = pcNewPool;
+   oSymTable->uPoolSize = uNewSize;
+   oSymTable->uPoolUsed = uNewUsed;
+   oSymTable->uPoolDead = 0;
+
+   return TRUE;
+}
+
+
+/* Copy pcKey to the end of the key pool of oSymTable, first moving
+   the keys still bound to a new pool twice their size if pcKey does
+   not fit. Store its offset in *puiKey. Return 1 (TRUE) if
+   successful, or 0 (FALSE) if insufficient memory is available or
+   the pool would outgrow the offsets */
+
+static int SymTable_copyKey(SymTable_T oSymTable, const char *pcKey,
+                            unsigned int *puiKey) {
+
+   size_t uKeySize;
+   size_t uLive;
+   size_t uNewSize;
+   enum {FALSE, TRUE};
+
+
+   assert(oSymTable != NULL);
+   assert(pcKey != NULL);
+   assert(puiKey != NULL);
+
+
+   uKeySize = strlen(pcKey) + 1;
+
+   if (uKeySize > oSymTable->uPoolSize - oSymTable->uPoolUsed) {
+
+      uLive = oSymTable->uPoolUsed - oSymTable->uPoolDead;
+
+      /* Offsets reach at most NO_INDEX - 1 */
+      if (uKeySize > (size_t)NO_INDEX - uLive)
+         return FALSE;
+
+      uNewSize = (uLive + uKeySize) * 2;
+
+      if ((uNewSize > (size_t)NO_INDEX) ||
+          (uNewSize < uLive + uKeySize))
+         uNewSize = (size_t)NO_INDEX;
+
+      if (uNewSize < MIN_POOL_SIZE)
+         uNewSize = MIN_POOL_SIZE;
+
+      if (! SymTable_repool(oSymTable, uNewSize))
+         return FALSE;
+   }
+
+
+   memcpy(oSymTable->pcPool + oSymTable->uPoolUsed, pcKey, uKeySize);
+
+   *puiKey = (unsigned int)oSymTable->uPoolUsed;
+   oSymTable->uPoolUsed += uKeySize;
+
+   return TRUE;
+}
+
+
+
+int SymTable_put(SymTable_T oSymTable, const char *pcKey,
+                 const void *pvValue) {
+
+   size_t uMAX_INDEX;
+   size_t uIndex;
+   unsigned int uiCurrent;
+   unsigned int uiNew;
+   struct Binding *pbNew;
+   enum {FALSE, TRUE};
+   enum {EQUAL};
+
+
+   assert(oSymTable != NULL);
+   assert(pcKey != NULL);
+
+
+   uMAX_INDEX = sizeof(auBucketCount)/sizeof(size_t) - 1;
+
+   if ((oSymTable->uLength == auBucketCount[oSymTable->uBucketIndex])
+       && (oSymTable->uBucketIndex < uMAX_INDEX))
+      SymTable_grow(oSymTable);
+
+
+   uIndex = SymTable_hash(pcKey,
+                          auBucketCount[oSymTable->uBucketIndex]);
+
+
+   for (uiCurrent = oSymTable->puiBuckets[uIndex];
+        uiCurrent != NO_INDEX;
+        uiCurrent = oSymTable->pbBindings[uiCurrent].uiNext)
+      if (strcmp(SymTable_key(oSymTable, uiCurrent), pcKey) == EQUAL)
+         return FALSE;
+
+
+   uiNew = SymTable_spareBinding(oSymTable);
+
+   if (uiNew == NO_INDEX)
+      return FALSE;
+
+   pbNew = &oSymTable->pbBindings[uiNew];
+
+
+   /* Borrowed keys are stored as is */
+   if (oSymTable->ppcBorrowed != NULL) {
+
+      oSymTable->ppcBorrowed[uiNew] = pcKey;
+      pbNew->uiKey = 0;
+   }
+
+   else if (! SymTable_copyKey(oSymTable, pcKey, &pbNew->uiKey))
+      return FALSE;
+
+
+   /* The Binding was spare, so only now does it leave the free
+      list, or join the ones ever used */
+   if (uiNew == oSymTable->uiFree)
+      oSymTable->uiFree = pbNew->uiNext;
+   else
+      oSymTable->uUsed++;
+
+   pbNew->pvValue = (void*)pvValue;
+
+   pbNew->uiNext = oSymTable->puiBuckets[uIndex];
+   oSymTable->puiBuckets[uIndex] = uiNew;
+
+
+   oSymTable->uLength++;
+
+   return TRUE;
+}
+
+/* Return Binding of corresponding key, if found. oSymTable is the
+   Symble Table object of which pcKey might or might not be a key. If
+   a search hit, it returns a pointer to pcKey's Binding. Else, it
+   returns NULL */
+
+static struct Binding *SymTable_find(SymTable_T oSymTable,
+                                     const char *pcKey) {
+
+   size_t uIndex;
+   unsigned int uiCurrent;
+   enum {EQUAL};
+
+   assert(oSymTable != NULL);
+   assert(pcKey != NULL);
+
+
+   uIndex = SymTable_hash(pcKey,
+                          auBucketCount[oSymTable->uBucketIndex]);
+
+
+   for (uiCurrent = oSymTable->puiBuckets[uIndex];
+        uiCurrent != NO_INDEX;
+        uiCurrent = oSymTable->pbBindings[uiCurrent].uiNext)
+      if (strcmp(SymTable_key(oSymTable, uiCurrent), pcKey) == EQUAL)
+         return &oSymTable->pbBindings[uiCurrent];
+
+   return NULL;
+}
+
+
+void *SymTable_replace(SymTable_T oSymTable, const char *pcKey,
+                       const void *pvValue) {
+
+   struct Binding *pbResult;
+   void *pvPrevious;
+
+
+   assert(oSymTable != NULL);
+   assert(pcKey != NULL);
+
+   pbResult = SymTable_find(oSymTable, pcKey);
+
+   if (pbResult == NULL) return NULL;
+
+   pvPrevious = pbResult->pvValue;
+   pbResult->pvValue = (void*)pvValue;
+
+   return pvPrevious;
+
+}
+
+int SymTable_contains(SymTable_T oSymTable, const char *pcKey) {
+
+
+   struct Binding *pbResult;
+   enum {NOT_FOUND, FOUND};
+
+   assert(oSymTable != NULL);
+   assert(pcKey != NULL);
+
+   pbResult = SymTable_find(oSymTable, pcKey);
+
+   if (pbResult == NULL) return NOT_FOUND;
+
+   return FOUND;
+}
+
+void *SymTable_get(SymTable_T oSymTable, const char *pcKey) {
+
+   struct Binding *pbResult;
+
+   assert(oSymTable != NULL);
+   assert(pcKey != NULL);
+
+
+   pbResult = SymTable_find(oSymTable, pcKey);
+
+   if (pbResult == NULL) return NULL;
+
+   return pbResult->pvValue;
+
+}
+
+void *SymTable_remove(SymTable_T oSymTable, const char *pcKey) {
+
+
+   size_t uIndex;
+   unsigned int *puiLink;
+   unsigned int uiCurrent;
+   struct Binding *pbCurrent;
+   enum {EQUAL};
+
+
+   assert(oSymTable != NULL);
+   assert(pcKey != NULL);
+
+
+   uIndex = SymTable_hash(pcKey,
+                          auBucketCount[oSymTable->uBucketIndex]);
+
+
+   /* puiLink is the bucket, or the uiNext, that holds uiCurrent */
+   puiLink = &oSymTable->puiBuckets[uIndex];
+
+
+   while (*puiLink != NO_INDEX) {
+
+      uiCurrent = *puiLink;
+      pbCurrent = &oSymTable->pbBindings[uiCurrent];
+
+      if (strcmp(SymTable_key(oSymTable, uiCurrent), pcKey) == EQUAL) {
+
+         *puiLink = pbCurrent->uiNext;
+
+         /* The key copy stays in the pool until it is repooled */
+         if (oSymTable->ppcBorrowed == NULL)
+            oSymTable->uPoolDead +=
+               strlen(oSymTable->pcPool + pbCurrent->uiKey) + 1;
+
+         /* Binding goes to the free list */
+         pbCurrent->uiNext = oSymTable->uiFree;
+         oSymTable->uiFree = uiCurrent;
+
+         oSymTable->uLength--;
+
+         return pbCurrent->pvValue;
+      }
+
+      puiLink = &pbCurrent->uiNext;
+   }
+
+   return NULL;
+}
+
+
+void SymTable_map(SymTable_T oSymTable,
+                  void (*pfApply)(const char *pcKey, void *pvValue,
+                                  void *pvExtra), const void *pvExtra) {
+
+   size_t i;
+   unsigned int uiCurrent;
+
+   assert(oSymTable != NULL);
+   assert(pfApply != NULL);
+
+
+   for (i = 0; i < auBucketCount[oSymTable->uBucketIndex]; i++) {
+
+      for (uiCurrent = oSymTable->puiBuckets[i];
+           uiCurrent != NO_INDEX;
+           uiCurrent = oSymTable->pbBindings[uiCurrent].uiNext)
+
+         (*pfApply)(SymTable_key(oSymTable, uiCurrent),
+                    oSymTable->pbBindings[uiCurrent].pvValue,
+                    (void*)pvExtra);
+   }
+}
+
+
+/* Add to the estimate of psMemory the bytes that malloc adds to a
+   block of uSize bytes */
+
+static void SymTable_addOverhead(struct SymTableMemory *psMemory,
+                                 size_t uSize) {
+
+   const size_t uWord = sizeof(size_t);
+   size_t uChunk;
+
+   assert(psMemory != NULL);
+
+   uChunk = (uSize + 3 * uWord - 1) / (2 * uWord) * (2 * uWord);
+
+   if (uChunk < 4 * uWord)
+      uChunk = 4 * uWord;
+
+   psMemory->uOverheadBytes += uChunk - uSize;
+}
+
+
+void SymTable_memoryUsage(SymTable_T oSymTable,
+                          struct SymTableMemory *psMemory) {
+
+   size_t uBucketCount;
+   size_t uBorrowedBytes;
+
+   assert(oSymTable != NULL);
+   assert(psMemory != NULL);
+
+   uBucketCount = auBucketCount[oSymTable->uBucketIndex];
+
+   psMemory->uTableBytes = sizeof(struct SymTable) +
+      sizeof(unsigned int) * uBucketCount;
+   psMemory->uBindingBytes =
+      sizeof(struct Binding) * oSymTable->uCapacity;
+   psMemory->uKeyBytes = oSymTable->uPoolSize;
+   psMemory->uOverheadBytes = 0;
+
+   SymTable_addOverhead(psMemory, sizeof(struct SymTable));
+   SymTable_addOverhead(psMemory, sizeof(unsigned int) * uBucketCount);
+
+   if (oSymTable->pbBindings != NULL)
+      SymTable_addOverhead(psMemory, psMemory->uBindingBytes);
+
+   if (oSymTable->pcPool != NULL)
+      SymTable_addOverhead(psMemory, oSymTable->uPoolSize);
+
+   /* Borrowed keys are the client's, but the pointers to them are
+      part of the Bindings */
+   if (oSymTable->ppcBorrowed != NULL) {
+
+      uBorrowedBytes = sizeof(const char*) * oSymTable->uCapacity;
+
+      psMemory->uBindingBytes += uBorrowedBytes;
+      SymTable_addOverhead(psMemory, uBorrowedBytes > 0 ?
+                           uBorrowedBytes : sizeof(const char*));
+   }
+}
+
+
+/* Position psIter at the first Binding found in a bucket whose index
+   is at least uIndex, or at its end if there is no such Binding */
+
+static void SymTable_iterSeek(struct SymTableIter *psIter,
+                              size_t uIndex) {
+
+   SymTable_T oSymTable;
+   size_t uBucketCount;
+   unsigned int uiCurrent;
+
+   assert(psIter != NULL);
+
+   oSymTable = psIter->oSymTable;
+   uBucketCount = auBucketCount[oSymTable->uBucketIndex];
+
+   for (; uIndex < uBucketCount; uIndex++) {
+
+      uiCurrent = oSymTable->puiBuckets[uIndex];
+
+      if (uiCurrent != NO_INDEX) {
+
+         psIter->uIndex = uIndex;
+         psIter->pvPosition = &oSymTable->pbBindings[uiCurrent];
+         psIter->pcKey = SymTable_key(oSymTable, uiCurrent);
+         psIter->pvValue = oSymTable->pbBindings[uiCurrent].pvValue;
+         return;
+      }
+   }
+
+   psIter->uIndex = uBucketCount;
+   psIter->pvPosition = NULL;
+   psIter->pcKey = NULL;
+   psIter->pvValue = NULL;
+}
+
+
+void SymTable_iterBegin(SymTable_T oSymTable,
+                        struct SymTableIter *psIter) {
+
+   assert(oSymTable != NULL);
+   assert(psIter != NULL);
+
+   psIter->oSymTable = oSymTable;
+
+   SymTable_iterSeek(psIter, 0);
+}
+
+void SymTable_iterNext(struct SymTableIter *psIter) {
+
+   SymTable_T oSymTable;
+   unsigned int uiNext;
+
+   assert(psIter != NULL);
+   assert(psIter->pvPosition != NULL);
+
+   oSymTable = psIter->oSymTable;
+   uiNext = ((struct Binding*)psIter->pvPosition)->uiNext;
+
+   /* Stay on the same separate chain while it lasts */
+   if (uiNext != NO_INDEX) {
+
+      psIter->pvPosition = &oSymTable->pbBindings[uiNext];
+      psIter->pcKey = SymTable_key(oSymTable, uiNext);
+      psIter->pvValue = oSymTable->pbBindings[uiNext].pvValue;
+      return;
+   }
+
+   SymTable_iterSeek(psIter, psIter->uIndex + 1);
+}
+
+int SymTable_iterEnd(const struct SymTableIter *psIter) {
+
+   assert(psIter != NULL);
+
+   return psIter->pvPosition == NULL;
+}
@@ -0,0 +1,802 @@
+/*--------------------------------------------------------------------*/
+/* symtablefrozen.c                                                   */
+/* author: Julio Lins (jcclb)                                         */
+/*--------------------------------------------------------------------*/
+
+#include "symtablefrozen.h"
+#include <assert.h>
+#include <string.h>
+#include <stdlib.h>
+#include <ctype.h>
+
+/*--------------------------------------------------------------------*/
+
+/* The perfect hash function follows the hash-and-displace scheme of
+   CHD. Keys are split into buckets of about KEYS_PER_BUCKET keys by a
+   first hash. Buckets are then placed, largest first: each key of a
+   bucket goes to slot (uF1 + uD0 * uF2 + uD1) % uLength, where uF1
+   and uF2 are hashes of the key and (uD0, uD1) is the first pair of
+   displacements that sends every key of the bucket to a free slot.
+   Buckets of a single key take the free slots left, directly */
+
+/* Average # of keys per bucket */
+
+enum {KEYS_PER_BUCKET = 4};
+
+/* # of values of uD0 tried before a bucket is considered unplaceable
+   with the current seed */
+
+enum {MAX_D0 = 16};
+
+/* # of seeds tried before giving up on building the function */
+
+enum {MAX_SEED_COUNT = 32};
+
+/* uD0 of a bucket whose only key is in slot uD1 */
+
+#define DIRECT ((size_t)-1)
+
+
+/* Each key and respective value are stored in an Entry */
+
+struct Entry {
+
+   /* key, within the key pool of the frozen table */
+   const char *pcKey;
+
+   /* value, owned by client */
+   void *pvValue;
+};
+
+
+/* SymTableFrozen holds the Entries, each in the slot the perfect hash
+   function gives its key, and the displacements of each bucket */
+
+struct SymTableFrozen {
+
+   /* size of Symble Table, which is also the # of slots */
+   size_t uLength;
+
+   /* # of buckets */
+   size_t uBucketCount;
+
+   /* seed of the hash functions */
+   size_t uSeed;
+
+   /* Entries indexed by slot */
+   struct Entry *peEntries;
+
+   /* Displacements indexed by bucket */
+   struct SymTableConstDisplacement *pdDisplacements;
+
+   /* copies of all keys, one after the other */
+   char *pcPool;
+};
+
+
+/* Hashes of a key, computed once per seed while building */
+
+struct KeyHash {
+
+   size_t uBucket;
+   size_t uF1;
+   size_t uF2;
+};
+
+
+/* Scratch memory used while building the perfect hash function of a
+   table of uLength keys and uBucketCount buckets */
+
+struct Builder {
+
+   /* keys and values, in no particular order */
+   struct Entry *peKeys;
+
+   /* hashes of each key of peKeys */
+   struct KeyHash *pkhHashes;
+
+   /* positions of puKeys where each bucket's keys start; the last one
+      is uLength */
+   size_t *puStarts;
+
+   /* positions within peKeys, grouped by bucket */
+   size_t *puKeys;
+
+   /* buckets, largest first */
+   size_t *puOrder;
+
+   /* slots chosen for the keys of the bucket being placed; also
+      counts buckets by size before placement */
+   size_t *puSlots;
+
+   /* 1 (TRUE) for each slot already given to a key */
+   char *pcTaken;
+};
+
+
+
+/* Compute the two hash codes of pcKey under seed uSeed in a single
+   pass over pcKey, storing them in *puHashA and *puHashB */
+
+static void SymTable_hashPair(const char *pcKey, size_t uSeed,
+                              size_t *puHashA, size_t *puHashB)
+{
+   const size_t HASH_MULTIPLIER = 65599;
+   const size_t FNV_PRIME = 16777619;
+   size_t u;
+   size_t uHashA = uSeed;
+   size_t uHashB = 2166136261U ^ uSeed;
+
+   assert(pcKey != NULL);
+   assert(puHashA != NULL);
+   assert(puHashB != NULL);
+
+   for (u = 0; pcKey[u] != '\0'; u++) {
+
+      uHashA = uHashA * HASH_MULTIPLIER +
+         (size_t)(unsigned char)pcKey[u];
+      uHashB = (uHashB ^ (size_t)(unsigned char)pcKey[u]) * FNV_PRIME;
+   }
+
+   *puHashA = uHashA;
+   *puHashB = uHashB;
+}
+
+
+/* Compute the bucket and the two slot hashes of pcKey within a table
+   of uLength slots and uBucketCount buckets whose hash functions have
+   seed uSeed, storing them in *pkh. Frozen and constant tables share
+   this function */
+
+static void SymTable_hashKey(size_t uLength, size_t uBucketCount,
+                             size_t uSeed, const char *pcKey,
+                             struct KeyHash *pkh) {
+
+   size_t uHashA;
+   size_t uHashB;
+
+   assert(uLength > 0);
+   assert(uBucketCount > 0);
+   assert(pkh != NULL);
+
+   SymTable_hashPair(pcKey, uSeed, &uHashA, &uHashB);
+
+   pkh->uBucket = uHashA % uBucketCount;
+   pkh->uF1 = uHashB % uLength;
+   pkh->uF2 = (uHashA / uBucketCount) % uLength;
+}
+
+
+/* Return the slot that displacements pd give a key of hashes pkh in
+   a table of uLength slots */
+
+static size_t SymTable_slot(
+   size_t uLength, const struct KeyHash *pkh,
+   const struct SymTableConstDisplacement *pd) {
+
+   assert(uLength > 0);
+   assert(pkh != NULL);
+   assert(pd != NULL);
+
+   if (pd->uD0 == DIRECT)
+      return pd->uD1;
+
+   return (pkh->uF1 + pd->uD0 * pkh->uF2 + pd->uD1) % uLength;
+}
+
+
+/* Helper function that groups the keys of psBuilder by bucket and
+   orders the buckets from largest to smallest */
+
+static void SymTable_sortBuckets(SymTableFrozen_T oSymTableFrozen,
+                                 struct Builder *psBuilder) {
+
+   size_t uLength;
+   size_t uBucketCount;
+   size_t uBucket;
+   size_t uSize;
+   size_t uLarger;
+   size_t uCount;
+   size_t i;
+
+
+   assert(oSymTableFrozen != NULL);
+   assert(psBuilder != NULL);
+
+   uLength = oSymTableFrozen->uLength;
+   uBucketCount = oSymTableFrozen->uBucketCount;
+
+
+   /* Group keys by bucket, using puOrder as a cursor per bucket */
+   for (i = 0; i <= uBucketCount; i++)
+      psBuilder->puStarts[i] = 0;
+
+   for (i = 0; i < uLength; i++)
+      psBuilder->puStarts[psBuilder->pkhHashes[i].uBucket + 1]++;
+
+   for (i = 0; i < uBucketCount; i++) {
+
+      psBuilder->puStarts[i + 1] += psBuilder->puStarts[i];
+      psBuilder->puOrder[i] = psBuilder->puStarts[i];
+   }
+
+   for (i = 0; i < uLength; i++) {
+
+      uBucket = psBuilder->pkhHashes[i].uBucket;
+      psBuilder->puKeys[psBuilder->puOrder[uBucket]++] = i;
+   }
+
+
+   /* Count buckets of each size... */
+   for (i = 0; i <= uLength; i++)
+      psBuilder->puSlots[i] = 0;
+
+   for (i = 0; i < uBucketCount; i++)
+      psBuilder->puSlots[psBuilder->puStarts[i + 1] -
+                         psBuilder->puStarts[i]]++;
+
+   /* ...turn the counts into the position of the first bucket of
+      each size, largest sizes first... */
+   uLarger = 0;
+
+   for (uSize = uLength + 1; uSize > 0; uSize--) {
+
+      uCount = psBuilder->puSlots[uSize - 1];
+      psBuilder->puSlots[uSize - 1] = uLarger;
+      uLarger += uCount;
+   }
+
+   /* ...and place each bucket there */
+   for (i = 0; i < uBucketCount; i++) {
+
+      uSize = psBuilder->puStarts[i + 1] - psBuilder->puStarts[i];
+      psBuilder->puOrder[psBuilder->puSlots[uSize]++] = i;
+   }
+}
+
+
+/* Try to place the keys of bucket uBucket with displacements pd.
+   Return 1 (TRUE) and mark their slots taken if they all go to
+   distinct free slots. Else, it returns 0 (FALSE) and changes
+   nothing */
+
+static int SymTable_tryBucket(
+   SymTableFrozen_T oSymTableFrozen, struct Builder *psBuilder,
+   size_t uBucket, const struct SymTableConstDisplacement *pd) {
+
+   size_t uFirst;
+   size_t uCount;
+   size_t uSlot;
+   size_t i;
+   enum {FALSE, TRUE};
+
+
+   assert(oSymTableFrozen != NULL);
+   assert(psBuilder != NULL);
+   assert(pd != NULL);
+
+   uFirst = psBuilder->puStarts[uBucket];
+   uCount = psBuilder->puStarts[uBucket + 1] - uFirst;
+
+
+   for (i = 0; i < uCount; i++) {
+
+      uSlot = SymTable_slot(oSymTableFrozen->uLength,
+                            &psBuilder->pkhHashes[
+                               psBuilder->puKeys[uFirst + i]], pd);
+
+      if (psBuilder->pcTaken[uSlot]) {
+
+         /* Release the slots this try took */
+         while (i > 0)
+            psBuilder->pcTaken[psBuilder->puSlots[--i]] = FALSE;
+
+         return FALSE;
+      }
+
+      psBuilder->pcTaken[uSlot] = TRUE;
+      psBuilder->puSlots[i] = uSlot;
+   }
+
+
+   return TRUE;
+}
+
+
+/* Find the first displacements pd that place every key of bucket
+   uBucket in a free slot, and mark those slots taken. Return 1 (TRUE)
+   if successful, or 0 (FALSE) if there are none with uD0 below
+   MAX_D0 */
+
+static int SymTable_placeBucket(SymTableFrozen_T oSymTableFrozen,
+                                struct Builder *psBuilder,
+                                size_t uBucket,
+                                struct SymTableConstDisplacement *pd) {
+
+   enum {FALSE, TRUE};
+
+   assert(oSymTableFrozen != NULL);
+   assert(psBuilder != NULL);
+   assert(pd != NULL);
+
+   for (pd->uD0 = 0; pd->uD0 < MAX_D0; pd->uD0++)
+      for (pd->uD1 = 0; pd->uD1 < oSymTableFrozen->uLength; pd->uD1++)
+         if (SymTable_tryBucket(oSymTableFrozen, psBuilder, uBucket,
+                                pd))
+            return TRUE;
+
+   return FALSE;
+}
+
+
+/* Try to build the perfect hash function of oSymTableFrozen with its
+   current seed, filling its Entries and displacements. Return 1
+   (TRUE) if successful, or 0 (FALSE) if some bucket cannot be
+   placed */
+
+static int SymTable_build(SymTableFrozen_T oSymTableFrozen,
+                          struct Builder *psBuilder) {
+
+   struct SymTableConstDisplacement *pd;
+   size_t uLength;
+   size_t uBucket;
+   size_t uFirst;
+   size_t uCount;
+   size_t uFree;
+   size_t i;
+   size_t j;
+   enum {FALSE, TRUE};
+
+
+   assert(oSymTableFrozen != NULL);
+   assert(psBuilder != NULL);
+
+   uLength = oSymTableFrozen->uLength;
+
+
+   for (i = 0; i < uLength; i++)
+      SymTable_hashKey(uLength, oSymTableFrozen->uBucketCount,
+                       oSymTableFrozen->uSeed,
+                       psBuilder->peKeys[i].pcKey,
+                       &psBuilder->pkhHashes[i]);
+
+   SymTable_sortBuckets(oSymTableFrozen, psBuilder);
+
+   for (i = 0; i < uLength; i++)
+      psBuilder->pcTaken[i] = FALSE;
+
+
+   uFree = 0;
+
+   for (i = 0; i < oSymTableFrozen->uBucketCount; i++) {
+
+      uBucket = psBuilder->puOrder[i];
+      uFirst = psBuilder->puStarts[uBucket];
+      uCount = psBuilder->puStarts[uBucket + 1] - uFirst;
+
+      pd = &oSymTableFrozen->pdDisplacements[uBucket];
+      pd->uD0 = 0;
+      pd->uD1 = 0;
+
+      if (uCount == 0)
+         continue;
+
+      if (uCount == 1) {
+
+         /* Take the next free slot */
+         while (psBuilder->pcTaken[uFree])
+            uFree++;
+
+         pd->uD0 = DIRECT;
+         pd->uD1 = uFree;
+         psBuilder->pcTaken[uFree] = TRUE;
+         psBuilder->puSlots[0] = uFree;
+      }
+
+      else if (! SymTable_placeBucket(oSymTableFrozen, psBuilder,
+                                      uBucket, pd))
+         return FALSE;
+
+      for (j = 0; j < uCount; j++)
+         oSymTableFrozen->peEntries[psBuilder->puSlots[j]] =
+            psBuilder->peKeys[psBuilder->puKeys[uFirst + j]];
+   }
+
+
+   return TRUE;
+}
+
+
+/* Helper function that frees the scratch memory of psBuilder */
+
+static void SymTable_freeBuilder(struct Builder *psBuilder) {
+
+   assert(psBuilder != NULL);
+
+   free(psBuilder->peKeys);
+   free(psBuilder->pkhHashes);
+   free(psBuilder->puStarts);
+   free(psBuilder->puKeys);
+   free(psBuilder->puOrder);
+   free(psBuilder->puSlots);
+   free(psBuilder->pcTaken);
+}
+
+
+
+SymTableFrozen_T SymTable_freeze(SymTable_T oSymTable) {
+
+   SymTableFrozen_T oSymTableFrozen;
+   struct SymTableIter sIter;
+   struct Builder sBuilder;
+   size_t uLength;
+   size_t uBucketCount;
+   size_t uPoolSize;
+   size_t uKeySize;
+   size_t i;
+   char *pcNext;
+
+
+   assert(oSymTable != NULL);
+
+
+   oSymTableFrozen =
+      (SymTableFrozen_T)malloc(sizeof(struct SymTableFrozen));
+
+   if (oSymTableFrozen == NULL)
+      return NULL;
+
+
+   uLength = SymTable_getLength(oSymTable);
+   uBucketCount = uLength / KEYS_PER_BUCKET + 1;
+
+   uPoolSize = 0;
+
+   for (SymTable_iterBegin(oSymTable, &sIter);
+        ! SymTable_iterEnd(&sIter);
+        SymTable_iterNext(&sIter))
+      uPoolSize += strlen(sIter.pcKey) + 1;
+
+
+   /* Allocate at least one element of each array, so that an empty
+      table does not depend on what malloc(0) returns */
+   oSymTableFrozen->uLength = uLength;
+   oSymTableFrozen->uBucketCount = uBucketCount;
+   oSymTableFrozen->uSeed = 0;
+   oSymTableFrozen->peEntries = (struct Entry*)
+      malloc(sizeof(struct Entry) * (uLength + 1));
+   oSymTableFrozen->pdDisplacements =
+      (struct SymTableConstDisplacement*)
+      malloc(sizeof(struct SymTableConstDisplacement) * uBucketCount);
+   oSymTableFrozen->pcPool = (char*)malloc(uPoolSize + 1);
+
+   sBuilder.peKeys = (struct Entry*)
+      malloc(sizeof(struct Entry) * (uLength + 1));
+   sBuilder.pkhHashes = (struct KeyHash*)
+      malloc(sizeof(struct KeyHash) * (uLength + 1));
+   sBuilder.puStarts = (size_t*)
+      malloc(sizeof(size_t) * (uBucketCount + 1));
+   sBuilder.puKeys = (size_t*)malloc(sizeof(size_t) * (uLength + 1));
+   sBuilder.puOrder = (size_t*)malloc(sizeof(size_t) * uBucketCount);
+   sBuilder.puSlots = (size_t*)malloc(sizeof(size_t) * (uLength + 1));
+   sBuilder.pcTaken = (char*)malloc(uLength + 1);
+
+   if ((oSymTableFrozen->peEntries == NULL) ||
+       (oSymTableFrozen->pdDisplacements == NULL) ||
+       (oSymTableFrozen->pcPool == NULL) ||
+       (sBuilder.peKeys == NULL) || (sBuilder.pkhHashes == NULL) ||
+       (sBuilder.puStarts == NULL) || (sBuilder.puKeys == NULL) ||
+       (sBuilder.puOrder == NULL) || (sBuilder.puSlots == NULL) ||
+       (sBuilder.pcTaken == NULL)) {
+
+      SymTable_freeBuilder(&sBuilder);
+      SymTableFrozen_free(oSymTableFrozen);
+      return NULL;
+   }
+
+
+   /* Copy the keys into the pool */
+   pcNext = oSymTableFrozen->pcPool;
+   i = 0;
+
+   for (SymTable_iterBegin(oSymTable, &sIter);
+        ! SymTable_iterEnd(&sIter);
+        SymTable_iterNext(&sIter)) {
+
+      uKeySize = strlen(sIter.pcKey) + 1;
+      memcpy(pcNext, sIter.pcKey, uKeySize);
+
+      sBuilder.peKeys[i].pcKey = pcNext;
+      sBuilder.peKeys[i].pvValue = sIter.pvValue;
+
+      pcNext += uKeySize;
+      i++;
+   }
+
+
+   /* A seed fails only if two keys of a bucket hash alike */
+   if (uLength > 0)
+      while (! SymTable_build(oSymTableFrozen, &sBuilder)) {
+
+         oSymTableFrozen->uSeed++;
+
+         if (oSymTableFrozen->uSeed == MAX_SEED_COUNT) {
+
+            SymTable_freeBuilder(&sBuilder);
+            SymTableFrozen_free(oSymTableFrozen);
+            return NULL;
+         }
+      }
+
+
+   SymTable_freeBuilder(&sBuilder);
+
+   return oSymTableFrozen;
+}
+
+
+
+void SymTableFrozen_free(SymTableFrozen_T oSymTableFrozen) {
+
+   assert(oSymTableFrozen != NULL);
+
+   free(oSymTableFrozen->peEntries);
+   free(oSymTableFrozen->pdDisplacements);
+   free(oSymTableFrozen->pcPool);
+   free(oSymTableFrozen);
+}
+
+
+size_t SymTableFrozen_getLength(SymTableFrozen_T oSymTableFrozen) {
+
+   assert(oSymTableFrozen != NULL);
+
+   return oSymTableFrozen->uLength;
+}
+
+
+/* Return the Entry of pcKey within oSymTableFrozen, if found. Else,
+   it returns NULL */
+
+static struct Entry *SymTable_find(SymTableFrozen_T oSymTableFrozen,
+                                   const char *pcKey) {
+
+   struct KeyHash sKeyHash;
+   struct SymTableConstDisplacement *pdBucket;
+   struct Entry *peEntry;
+   enum {EQUAL};
+
+
+   assert(oSymTableFrozen != NULL);
+   assert(pcKey != NULL);
+
+
+   if (oSymTableFrozen->uLength == 0)
+      return NULL;
+
+   SymTable_hashKey(oSymTableFrozen->uLength,
+                    oSymTableFrozen->uBucketCount,
+                    oSymTableFrozen->uSeed, pcKey, &sKeyHash);
+
+   pdBucket = &oSymTableFrozen->pdDisplacements[sKeyHash.uBucket];
+   peEntry = &oSymTableFrozen->peEntries[
+      SymTable_slot(oSymTableFrozen->uLength, &sKeyHash, pdBucket)];
+
+
+   if (strcmp(peEntry->pcKey, pcKey) != EQUAL)
+      return NULL;
+
+   return peEntry;
+}
+
+
+int SymTableFrozen_contains(SymTableFrozen_T oSymTableFrozen,
+                            const char *pcKey) {
+
+   assert(oSymTableFrozen != NULL);
+   assert(pcKey != NULL);
+
+   return SymTable_find(oSymTableFrozen, pcKey) != NULL;
+}
+
+
+void *SymTableFrozen_get(SymTableFrozen_T oSymTableFrozen,
+                         const char *pcKey) {
+
+   struct Entry *peFound;
+
+   assert(oSymTableFrozen != NULL);
+   assert(pcKey != NULL);
+
+   peFound = SymTable_find(oSymTableFrozen, pcKey);
+
+   if (peFound == NULL)
+      return NULL;
+
+   return peFound->pvValue;
+}
+
+
+void SymTableFrozen_map(SymTableFrozen_T oSymTableFrozen,
+                        void (*pfApply)(const char *pcKey,
+                                        void *pvValue,
+                                        void *pvExtra),
+                        const void *pvExtra) {
+
+   size_t i;
+
+   assert(oSymTableFrozen != NULL);
+   assert(pfApply != NULL);
+
+   for (i = 0; i < oSymTableFrozen->uLength; i++)
+      (*pfApply)(oSymTableFrozen->peEntries[i].pcKey,
+                 oSymTableFrozen->peEntries[i].pvValue,
+                 (void*)pvExtra);
+}
+
+
+/* Write c to psFile as a C character constant. Characters that
+   cannot appear in one as is are written as octal escapes */
+
+static void SymTable_writeChar(FILE *psFile, char c) {
+
+   assert(psFile != NULL);
+
+   if ((c == '\'') || (c == '\\'))
+      fprintf(psFile, "'\\%c', ", c);
+   else if (isprint((unsigned char)c))
+      fprintf(psFile, "'%c', ", c);
+   else
+      fprintf(psFile, "'\\%03o', ", (unsigned)(unsigned char)c);
+}
+
+
+int SymTableFrozen_write(SymTableFrozen_T oSymTableFrozen,
+                         FILE *psFile, const char *pcName) {
+
+   const struct SymTableConstDisplacement *pd;
+   const char *pcKey;
+   size_t uOffset;
+   size_t i;
+
+
+   assert(oSymTableFrozen != NULL);
+   assert(psFile != NULL);
+   assert(pcName != NULL);
+
+
+   fprintf(psFile, "/* Generated by SymTableFrozen_write. "
+           "Do not edit */\n\n");
+   fprintf(psFile, "#include \"symtablefrozen.h\"\n\n");
+
+
+   /* Keys, in slot order. A character array rather than a string
+      literal, whose length C90 limits to 509 characters */
+   fprintf(psFile, "static const char acPool[] = {\n");
+
+   for (i = 0; i < oSymTableFrozen->uLength; i++) {
+
+      fprintf(psFile, "   ");
+
+      for (pcKey = oSymTableFrozen->peEntries[i].pcKey; *pcKey != '\0';
+           pcKey++)
+         SymTable_writeChar(psFile, *pcKey);
+
+      fprintf(psFile, "'\\0',\n");
+   }
+
+   if (oSymTableFrozen->uLength == 0)
+      fprintf(psFile, "   '\\0'\n");
+
+   fprintf(psFile, "};\n\n");
+
+
+   /* C90 has no empty arrays, so an empty table gets one unused
+      Entry */
+   fprintf(psFile,
+           "static const struct SymTableConstEntry aeEntries[] = {\n");
+
+   uOffset = 0;
+
+   for (i = 0; i < oSymTableFrozen->uLength; i++) {
+
+      fprintf(psFile, "   {%lu, %d},\n", (unsigned long)uOffset,
+              *(int*)oSymTableFrozen->peEntries[i].pvValue);
+
+      uOffset += strlen(oSymTableFrozen->peEntries[i].pcKey) + 1;
+   }
+
+   if (oSymTableFrozen->uLength == 0)
+      fprintf(psFile, "   {0, 0}\n");
+
+   fprintf(psFile, "};\n\n");
+
+
+   fprintf(psFile, "static const struct SymTableConstDisplacement "
+           "adDisplacements[] = {\n");
+
+   for (i = 0; i < oSymTableFrozen->uBucketCount; i++) {
+
+      pd = &oSymTableFrozen->pdDisplacements[i];
+
+      if (pd->uD0 == DIRECT)
+         fprintf(psFile, "   {(size_t)-1, %lu},\n",
+                 (unsigned long)pd->uD1);
+      else
+         fprintf(psFile, "   {%lu, %lu},\n", (unsigned long)pd->uD0,
+                 (unsigned long)pd->uD1);
+   }
+
+   fprintf(psFile, "};\n\n");
+
+
+   fprintf(psFile, "const struct SymTableConst %s = {\n", pcName);
+   fprintf(psFile, "   %lu, %lu, %lu, aeEntries, adDisplacements, "
+           "acPool\n", (unsigned long)oSymTableFrozen->uLength,
+           (unsigned long)oSymTableFrozen->uBucketCount,
+           (unsigned long)oSymTableFrozen->uSeed);
+   fprintf(psFile, "};\n");
+
+
+   return ! ferror(psFile);
+}
+
+
+/* Return the Entry of pcKey within psTable, if found. Else, it
+   returns NULL */
+
+static const struct SymTableConstEntry *SymTable_findConst(
+   const struct SymTableConst *psTable, const char *pcKey) {
+
+   struct KeyHash sKeyHash;
+   const struct SymTableConstEntry *peEntry;
+   enum {EQUAL};
+
+
+   assert(psTable != NULL);
+   assert(pcKey != NULL);
+
+
+   if (psTable->uLength == 0)
+      return NULL;
+
+   SymTable_hashKey(psTable->uLength, psTable->uBucketCount,
+                    psTable->uSeed, pcKey, &sKeyHash);
+
+   peEntry = &psTable->peEntries[
+      SymTable_slot(psTable->uLength, &sKeyHash,
+                    &psTable->pdDisplacements[sKeyHash.uBucket])];
+
+
+   if (strcmp(psTable->pcPool + peEntry->uKeyOffset, pcKey) != EQUAL)
+      return NULL;
+
+   return peEntry;
+}
+
+
+int SymTableConst_contains(const struct SymTableConst *psTable,
+                           const char *pcKey) {
+
+   assert(psTable != NULL);
+   assert(pcKey != NULL);
+
+   return SymTable_findConst(psTable, pcKey) != NULL;
+}
+
+
+int SymTableConst_get(const struct SymTableConst *psTable,
+                      const char *pcKey) {
+
+   const struct SymTableConstEntry *peFound;
+
+   assert(psTable != NULL);
+   assert(pcKey != NULL);
+
+   peFound = SymTable_findConst(psTable, pcKey);
+
+   if (peFound == NULL)
+      return -1;
+
+   return peFound->iValue;
+}
@@ -0,0 +1,146 @@
+/*--------------------------------------------------------------------*/
+/* symtablefrozen.h                                                   */
+/* Author: Julio Lins (jcclb)                                         */
+/*--------------------------------------------------------------------*/
+
+#ifndef SYMTABLEFROZEN_H
+#define SYMTABLEFROZEN_H
+
+#include "symtable.h"
+#include <stdio.h>
+
+/*--------------------------------------------------------------------*/
+
+/* A SymTableFrozen_T object is a read-only copy of the bindings of a
+   Symble Table, indexed by a minimal perfect hash function: each key
+   has a slot of its own, so a lookup takes one probe and one key
+   comparison. Keys are copied; values are still owned by the
+   client */
+
+typedef struct SymTableFrozen *SymTableFrozen_T;
+
+/*--------------------------------------------------------------------*/
+
+/* A struct SymTableConst is the constant form of a frozen table whose
+   values are ints, as written to a C source file by
+   SymTableFrozen_write. It uses the same perfect hash function, but
+   its keys are offsets into a single string pool, so that all of its
+   data can be const. A source file written on one machine must be
+   compiled for a machine with the same size_t */
+
+struct SymTableConstDisplacement {
+
+   /* multiplier of the second slot hash, or (size_t)-1 */
+   size_t uD0;
+
+   /* offset, or slot if uD0 is (size_t)-1 */
+   size_t uD1;
+};
+
+struct SymTableConstEntry {
+
+   /* offset of the key within pcPool */
+   size_t uKeyOffset;
+
+   /* value */
+   int iValue;
+};
+
+struct SymTableConst {
+
+   /* size of Symble Table, which is also the # of slots */
+   size_t uLength;
+
+   /* # of buckets */
+   size_t uBucketCount;
+
+   /* seed of the hash functions */
+   size_t uSeed;
+
+   /* Entries indexed by slot */
+   const struct SymTableConstEntry *peEntries;
+
+   /* displacements indexed by bucket */
+   const struct SymTableConstDisplacement *pdDisplacements;
+
+   /* keys, each followed by '\0' */
+   const char *pcPool;
+};
+
+/*--------------------------------------------------------------------*/
+
+/* Return a new SymTableFrozen_T object with the bindings that
+   oSymTable contains, or NULL if insufficient memory is available.
+   oSymTable does not change, and later changes to it do not affect
+   the new object */
+
+SymTableFrozen_T SymTable_freeze(SymTable_T oSymTable);
+
+/*--------------------------------------------------------------------*/
+
+/* Free memory allocated by oSymTableFrozen */
+
+void SymTableFrozen_free(SymTableFrozen_T oSymTableFrozen);
+
+/*--------------------------------------------------------------------*/
+
+/* Return length of oSymTableFrozen (i.e., number of bindings) */
+
+size_t SymTableFrozen_getLength(SymTableFrozen_T oSymTableFrozen);
+
+/*--------------------------------------------------------------------*/
+
+/* Return 1 (TRUE) if oSymTableFrozen contains a binding whose key is
+   pcKey, and 0 (FALSE) otherwise */
+
+int SymTableFrozen_contains(SymTableFrozen_T oSymTableFrozen,
+                            const char *pcKey);
+
+/*--------------------------------------------------------------------*/
+
+/* Return the value of the binding within oSymTableFrozen whose key is
+   pcKey, or NULL if no such binding exists */
+
+void *SymTableFrozen_get(SymTableFrozen_T oSymTableFrozen,
+                         const char *pcKey);
+
+/*--------------------------------------------------------------------*/
+
+/* Apply function *pfApply to each binding in oSymTableFrozen, passing
+   pvExtra as an extra parameter */
+
+void SymTableFrozen_map(SymTableFrozen_T oSymTableFrozen,
+                        void (*pfApply)(const char *pcKey,
+                                        void *pvValue,
+                                        void *pvExtra),
+                        const void *pvExtra);
+
+/*--------------------------------------------------------------------*/
+
+/* Write to psFile a C source file that defines a const struct
+   SymTableConst named pcName with the bindings of oSymTableFrozen.
+   The value of each binding must point to an int. Return 1 (TRUE) if
+   successful, or 0 (FALSE) if psFile cannot be written */
+
+int SymTableFrozen_write(SymTableFrozen_T oSymTableFrozen,
+                         FILE *psFile, const char *pcName);
+
+/*--------------------------------------------------------------------*/
+
+/* Return 1 (TRUE) if psTable contains a binding whose key is pcKey,
+   and 0 (FALSE) otherwise */
+
+int SymTableConst_contains(const struct SymTableConst *psTable,
+                           const char *pcKey);
+
+/*--------------------------------------------------------------------*/
+
+/* Return the value of the binding within psTable whose key is pcKey,
+   or -1 if no such binding exists */
+
+int SymTableConst_get(const struct SymTableConst *psTable,
+                      const char *pcKey);
+
+/*--------------------------------------------------------------------*/
+
+#endif
@@ -0,0 +1,141 @@
+/*--------------------------------------------------------------------*/
+/* symtablegen.c                                                      */
+/* author: Julio Lins (jcclb)                                         */
+/*--------------------------------------------------------------------*/
+
+#include "symtablefrozen.h"
+#include <assert.h>
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*--------------------------------------------------------------------*/
+
+/* Longest line of a key file, '\n' included */
+
+enum {MAX_LINE_LENGTH = 256};
+
+
+/* Print pcMessage about line uLineNum of the key file named
+   pcFileName to stderr, and exit with EXIT_FAILURE */
+
+static void fail(const char *pcFileName, size_t uLineNum,
+                 const char *pcMessage)
+{
+   assert(pcFileName != NULL);
+   assert(pcMessage != NULL);
+
+   fprintf(stderr, "%s:%lu: %s\n", pcFileName, (unsigned long)uLineNum,
+           pcMessage);
+   exit(EXIT_FAILURE);
+}
+
+
+/* Read the key file psFile, named pcFileName, into oSymTable. Each
+   line holds a key, optionally followed by its value, a non-negative
+   int; a key without one gets the number of keys read before it.
+   Blank lines and lines that start with '#' are skipped */
+
+static void readKeys(FILE *psFile, const char *pcFileName,
+                     SymTable_T oSymTable)
+{
+   char acLine[MAX_LINE_LENGTH + 1];
+   char *pcKey;
+   char *pcRest;
+   int *piValue;
+   int iKeyCount = 0;
+   size_t uLineNum = 0;
+
+   assert(psFile != NULL);
+   assert(pcFileName != NULL);
+   assert(oSymTable != NULL);
+
+   while (fgets(acLine, sizeof(acLine), psFile) != NULL)
+   {
+      uLineNum++;
+
+      if (strchr(acLine, '\n') == NULL && ! feof(psFile))
+         fail(pcFileName, uLineNum, "line too long");
+
+      /* Split the line into the key and the rest */
+      pcKey = acLine;
+      while (isspace((unsigned char)*pcKey))
+         pcKey++;
+
+      if ((*pcKey == '\0') || (*pcKey == '#'))
+         continue;
+
+      pcRest = pcKey;
+      while ((*pcRest != '\0') && ! isspace((unsigned char)*pcRest))
+         pcRest++;
+
+      if (*pcRest != '\0')
+         *pcRest++ = '\0';
+
+      if (SymTable_contains(oSymTable, pcKey))
+         fail(pcFileName, uLineNum, "duplicate key");
+
+      piValue = (int*)malloc(sizeof(int));
+      if (piValue == NULL)
+         fail(pcFileName, uLineNum, "out of memory");
+
+      if (sscanf(pcRest, "%d", piValue) != 1)
+         *piValue = iKeyCount;
+      else if (*piValue < 0)
+         fail(pcFileName, uLineNum, "negative value");
+
+      if (! SymTable_put(oSymTable, pcKey, piValue))
+         fail(pcFileName, uLineNum, "out of memory");
+
+      iKeyCount++;
+   }
+}
+
+
+/* Generate a C source file that defines a const, perfect-hashed
+   struct SymTableConst (see symtablefrozen.h) from a key file. argv[1]
+   is the name of the key file and argv[2] the name of the struct. The
+   source file is written to stdout. Return 0, or exit with
+   EXIT_FAILURE if the key file cannot be read or is invalid. */
+
+int main(int argc, char *argv[])
+{
+   SymTable_T oSymTable;
+   SymTableFrozen_T oSymTableFrozen;
+   FILE *psFile;
+
+   if (argc != 3)
+   {
+      fprintf(stderr, "Usage: %s keyfile name\n", argv[0]);
+      exit(EXIT_FAILURE);
+   }
+
+   psFile = fopen(argv[1], "r");
+   if (psFile == NULL)
+   {
+      fprintf(stderr, "%s: cannot open %s\n", argv[0], argv[1]);
+      exit(EXIT_FAILURE);
+   }
+
+   oSymTable = SymTable_new();
+   if (oSymTable == NULL)
+      fail(argv[1], 0, "out of memory");
+
+   readKeys(psFile, argv[1], oSymTable);
+   fclose(psFile);
+
+   oSymTableFrozen = SymTable_freeze(oSymTable);
+   if (oSymTableFrozen == NULL)
+      fail(argv[1], 0, "cannot build the perfect hash function");
+
+   if (! SymTableFrozen_write(oSymTableFrozen, stdout, argv[2]))
+   {
+      fprintf(stderr, "%s: cannot write output\n", argv[0]);
+      exit(EXIT_FAILURE);
+   }
+
+   SymTableFrozen_free(oSymTableFrozen);
+   SymTable_freeWith(oSymTable, free);
+   return 0;
+}
@@ -0,0 +1,1250 @@
+/*--------------------------------------------------------------------*/
+/* symtablehamt.c                                                     */
+/* author: Julio Lins (jcclb)                                         */
+/*--------------------------------------------------------------------*/
+
+#include "symtablehamt.h"
+#include <assert.h>
+#include <limits.h>
+#include <string.h>
+#include <stdlib.h>
+
+/*--------------------------------------------------------------------*/
+
+/* Each level of the trie consumes LEVEL_BITS bits of a hash code, so
+   a branch Node has up to BRANCH_WIDTH children. Past the last level,
+   Bindings whose hash codes are equal share a collision Node */
+
+enum {LEVEL_BITS = 5};
+enum {BRANCH_WIDTH = 1 << LEVEL_BITS};
+enum {HASH_BITS = sizeof(size_t) * CHAR_BIT};
+enum {MAX_LEVELS = (HASH_BITS + LEVEL_BITS - 1) / LEVEL_BITS};
+
+/* Reference counts are changed by every thread that holds a table
+   sharing the Node */
+
+#if defined(__GNUC__)
+#define SymTable_atomicAdd(pu, u) __sync_add_and_fetch(pu, u)
+#define SymTable_atomicSub(pu, u) __sync_sub_and_fetch(pu, u)
+#else
+#error "symtablehamt.c needs atomic operations for this compiler"
+#endif
+
+
+/* A Node is either a leaf, which holds one binding, or an interior
+   Node, which holds uCount children. An interior Node above the last
+   level is a branch: bit i of its bitmap is set if it has a child for
+   the hash codes whose bits at its level are i, and its children are
+   in the order of those bits. An interior Node past the last level
+   is a collision Node, whose children are leaves with equal hash
+   codes in no particular order. The children follow the Node in the
+   same block of memory, as does the key of a leaf unless the table
+   borrows its keys. A leaf copied by SymTable_replaceIn shares the
+   key in the block of the leaf it copies, which is freed only once
+   no leaf uses that key */
+
+struct Node {
+
+   /* # of tables and Nodes that point to this Node. A Node pointed to
+      more than once is shared, and must not change */
+   size_t uRefCount;
+
+   /* # of children, or 0 for a leaf */
+   size_t uCount;
+
+   /* bitmap of the children of a branch. For a leaf, the # of leaves
+      using the key in its block, or 0 if its key is in the block of
+      another leaf */
+   unsigned long ulBitmap;
+
+   /* hash code of the key of a leaf */
+   size_t uHash;
+
+   /* key of a leaf, owned by implementation through defensive copy
+      unless the table borrows its keys */
+   const char *pcKey;
+
+   /* value of a leaf, owned by client */
+   void *pvValue;
+};
+
+
+/* SymTable is a structure that points to the root of the trie */
+
+struct SymTable {
+
+   /* root Node, or NULL if the table is empty */
+   struct Node *pnRoot;
+
+   /* size of Symble Table (total # of Bindings) */
+   size_t uLength;
+
+   /* 1 (TRUE) if keys are borrowed from the client rather than
+      owned through defensive copies */
+   int iBorrowsKeys;
+};
+
+
+
+/* Return the array of children of interior Node pn */
+
+static struct Node **SymTable_children(struct Node *pn) {
+
+   assert(pn != NULL);
+
+   return (struct Node**)(pn + 1);
+}
+
+
+/* Return 1 (TRUE) if pn is pointed to more than once, 0 (FALSE)
+   otherwise. Only the holder of a reference to pn may ask */
+
+static int SymTable_isShared(struct Node *pn) {
+
+   assert(pn != NULL);
+
+   return SymTable_atomicAdd(&pn->uRefCount, 0) > 1;
+}
+
+
+/* Add a reference to pn */
+
+static void SymTable_retain(struct Node *pn) {
+
+   assert(pn != NULL);
+
+   SymTable_atomicAdd(&pn->uRefCount, 1);
+}
+
+
+/* Return the leaf whose block holds the key of leaf pn, which must
+   share that key */
+
+static struct Node *SymTable_keyOwner(struct Node *pn) {
+
+   assert(pn != NULL);
+   assert((pn->uCount == 0) && (pn->ulBitmap == 0));
+
+   return (struct Node*)(void*)(char*)pn->pcKey - 1;
+}
+
+
+/* Free leaf pn, no longer pointed to, unless other leaves still use
+   the key in its block. If pn shares the key of another leaf, free pn
+   and drop its use of that key instead */
+
+static void SymTable_freeLeaf(struct Node *pn) {
+
+   struct Node *pnOwner;
+
+   assert(pn != NULL);
+   assert(pn->uCount == 0);
+
+   if (pn->ulBitmap == 0) {
+
+      pnOwner = SymTable_keyOwner(pn);
+      free(pn);
+      pn = pnOwner;
+   }
+
+   if (SymTable_atomicSub(&pn->ulBitmap, 1) == 0)
+      free(pn);
+}
+
+
+/* Drop a reference to pn. If it was the last one, free pn, dropping
+   its references to its children, and call pfFreeValue on the value
+   of a leaf unless pfFreeValue is NULL */
+
+static void SymTable_release(struct Node *pn,
+                             void (*pfFreeValue)(void *pvValue)) {
+
+   size_t u;
+
+   assert(pn != NULL);
+
+   if (SymTable_atomicSub(&pn->uRefCount, 1) != 0)
+      return;
+
+   if (pn->uCount == 0) {
+
+      if (pfFreeValue != NULL)
+         (*pfFreeValue)(pn->pvValue);
+
+      SymTable_freeLeaf(pn);
+      return;
+   }
+
+   for (u = 0; u < pn->uCount; u++)
+      SymTable_release(SymTable_children(pn)[u], pfFreeValue);
+
+   free(pn);
+}
+
+
+/* Return a new interior Node with room for uCount children, or NULL if
+   insufficient memory is available */
+
+static struct Node *SymTable_newInterior(size_t uCount) {
+
+   struct Node *pnNew;
+
+   assert(uCount > 0);
+
+   pnNew = (struct Node*)malloc(sizeof(struct Node) +
+                                uCount * sizeof(struct Node*));
+
+   if (pnNew == NULL)
+      return NULL;
+
+   pnNew->uRefCount = 1;
+   pnNew->uCount = uCount;
+   pnNew->ulBitmap = 0;
+
+   return pnNew;
+}
+
+
+/* Return a new leaf of oSymTable binding pcKey, whose hash code is
+   uHash, to pvValue, or NULL if insufficient memory is available */
+
+static struct Node *SymTable_newLeaf(SymTable_T oSymTable,
+                                     const char *pcKey, size_t uHash,
+                                     const void *pvValue) {
+
+   struct Node *pnNew;
+   size_t uKeySize;
+
+   assert(oSymTable != NULL);
+   assert(pcKey != NULL);
+
+   uKeySize = oSymTable->iBorrowsKeys ? 0 : strlen(pcKey) + 1;
+
+   pnNew = (struct Node*)malloc(sizeof(struct Node) + uKeySize);
+
+   if (pnNew == NULL)
+      return NULL;
+
+   pnNew->uRefCount = 1;
+   pnNew->uCount = 0;
+   pnNew->ulBitmap = 1;
+   pnNew->uHash = uHash;
+   pnNew->pvValue = (void*)pvValue;
+
+   /* Borrowed keys are stored as is */
+   if (oSymTable->iBorrowsKeys)
+      pnNew->pcKey = pcKey;
+   else
+      pnNew->pcKey = strcpy((char*)(pnNew + 1), pcKey);
+
+   return pnNew;
+}
+
+
+/* Return a new leaf of oSymTable with the key and hash code of leaf
+   pn, bound to pvValue, or NULL if insufficient memory is available.
+   Unless the table borrows its keys, the new leaf shares the key of
+   pn rather than copying it, so that the key stays where iterators
+   over a table holding pn saw it */
+
+static struct Node *SymTable_copyLeaf(SymTable_T oSymTable,
+                                      struct Node *pn,
+                                      const void *pvValue) {
+
+   struct Node *pnNew;
+   struct Node *pnOwner;
+
+   assert(oSymTable != NULL);
+   assert(pn != NULL);
+   assert(pn->uCount == 0);
+
+   if (oSymTable->iBorrowsKeys)
+      return SymTable_newLeaf(oSymTable, pn->pcKey, pn->uHash, pvValue);
+
+   pnNew = (struct Node*)malloc(sizeof(struct Node));
+
+   if (pnNew == NULL)
+      return NULL;
+
+   pnOwner = (pn->ulBitmap == 0) ? SymTable_keyOwner(pn) : pn;
+   SymTable_atomicAdd(&pnOwner->ulBitmap, 1);
+
+   pnNew->uRefCount = 1;
+   pnNew->uCount = 0;
+   pnNew->ulBitmap = 0;
+   pnNew->uHash = pn->uHash;
+   pnNew->pcKey = pn->pcKey;
+   pnNew->pvValue = (void*)pvValue;
+
+   return pnNew;
+}
+
+
+/* Return the bit of a branch at the level whose hash code bits start
+   at bit uShift that stands for uHash */
+
+static unsigned long SymTable_bit(size_t uHash, size_t uShift) {
+
+   assert(uShift < HASH_BITS);
+
+   return 1UL << ((uHash >> uShift) & (BRANCH_WIDTH - 1));
+}
+
+
+/* Return the position among the children of branch pn of the child
+   whose bit is ulBit, or would be if pn had it: the # of bits of the
+   bitmap of pn below ulBit */
+
+static size_t SymTable_position(struct Node *pn, unsigned long ulBit) {
+
+   unsigned long ulBelow;
+   size_t uPosition = 0;
+
+   assert(pn != NULL);
+
+   for (ulBelow = pn->ulBitmap & (ulBit - 1); ulBelow != 0;
+        ulBelow &= ulBelow - 1)
+      uPosition++;
+
+   return uPosition;
+}
+
+
+/* Return the position among the children of interior Node pn, at the
+   level whose hash code bits start at bit uShift, of the child that
+   holds pcKey, whose hash code is uHash, or pn->uCount if pcKey can
+   be in no child. Set *pulBit to the bit that stands for uHash in a
+   branch, or to 0 in a collision Node */
+
+static size_t SymTable_childIndex(struct Node *pn, const char *pcKey,
+                                  size_t uHash, size_t uShift,
+                                  unsigned long *pulBit) {
+
+   size_t u;
+   enum {EQUAL};
+
+   assert(pn != NULL);
+   assert(pcKey != NULL);
+   assert(pulBit != NULL);
+
+   if (uShift >= HASH_BITS) {
+
+      *pulBit = 0;
+
+      for (u = 0; u < pn->uCount; u++)
+         if (strcmp(SymTable_children(pn)[u]->pcKey, pcKey) == EQUAL)
+            return u;
+
+      return pn->uCount;
+   }
+
+   *pulBit = SymTable_bit(uHash, uShift);
+
+   if ((pn->ulBitmap & *pulBit) == 0)
+      return pn->uCount;
+
+   return SymTable_position(pn, *pulBit);
+}
+
+
+/* Make *ppn, an interior Node, a Node that only the caller points
+   to, replacing it by a copy of itself if it is shared. Return 1
+   (TRUE) if successful, or 0 (FALSE) if insufficient memory is
+   available, in which case *ppn is left unchanged */
+
+static int SymTable_own(struct Node **ppn) {
+
+   struct Node *pn;
+   struct Node *pnCopy;
+   size_t u;
+   enum {FALSE, TRUE};
+
+   assert(ppn != NULL);
+   assert(*ppn != NULL);
+
+   pn = *ppn;
+
+   if (! SymTable_isShared(pn))
+      return TRUE;
+
+   pnCopy = SymTable_newInterior(pn->uCount);
+
+   if (pnCopy == NULL)
+      return FALSE;
+
+   pnCopy->ulBitmap = pn->ulBitmap;
+
+   for (u = 0; u < pn->uCount; u++) {
+
+      SymTable_children(pnCopy)[u] = SymTable_children(pn)[u];
+      SymTable_retain(SymTable_children(pn)[u]);
+   }
+
+   SymTable_release(pn, NULL);
+   *ppn = pnCopy;
+
+   return TRUE;
+}
+
+
+/* Replace interior Node *ppn by a Node that also has pnChild at
+   position uIndex, setting bit ulBit of its bitmap. Return 1 (TRUE)
+   if successful, or 0 (FALSE) if insufficient memory is available, in
+   which case *ppn is left unchanged */
+
+static int SymTable_addChild(struct Node **ppn, size_t uIndex,
+                             unsigned long ulBit,
+                             struct Node *pnChild) {
+
+   struct Node *pn;
+   struct Node *pnNew;
+   struct Node **ppnChildren;
+   struct Node **ppnNewChildren;
+   int iIsShared;
+   size_t u;
+   enum {FALSE, TRUE};
+
+   assert(ppn != NULL);
+   assert(*ppn != NULL);
+   assert(pnChild != NULL);
+
+   pn = *ppn;
+
+   assert(uIndex <= pn->uCount);
+
+   pnNew = SymTable_newInterior(pn->uCount + 1);
+
+   if (pnNew == NULL)
+      return FALSE;
+
+   pnNew->ulBitmap = pn->ulBitmap | ulBit;
+
+   ppnChildren = SymTable_children(pn);
+   ppnNewChildren = SymTable_children(pnNew);
+
+   for (u = 0; u < uIndex; u++)
+      ppnNewChildren[u] = ppnChildren[u];
+
+   ppnNewChildren[uIndex] = pnChild;
+
+   for (u = uIndex; u < pn->uCount; u++)
+      ppnNewChildren[u + 1] = ppnChildren[u];
+
+   /* The children move to the new Node, unless pn is still used */
+   iIsShared = SymTable_isShared(pn);
+
+   if (iIsShared) {
+
+      for (u = 0; u < pn->uCount; u++)
+         SymTable_retain(ppnChildren[u]);
+
+      SymTable_release(pn, NULL);
+   }
+   else
+      free(pn);
+
+   *ppn = pnNew;
+
+   return TRUE;
+}
+
+
+/* Remove the child at position uIndex of interior Node *ppn, clearing
+   bit ulBit of its bitmap, and drop the reference to it. Return 1
+   (TRUE) if successful, or 0 (FALSE) if *ppn is shared and
+   insufficient memory is available for a copy, in which case *ppn is
+   left unchanged */
+
+static int SymTable_dropChild(struct Node **ppn, size_t uIndex,
+                              unsigned long ulBit) {
+
+   struct Node *pn;
+   struct Node *pnNew;
+   struct Node **ppnChildren;
+   size_t u;
+   enum {FALSE, TRUE};
+
+   assert(ppn != NULL);
+   assert(*ppn != NULL);
+
+   pn = *ppn;
+
+   assert(uIndex < pn->uCount);
+   assert(pn->uCount > 1);
+
+   ppnChildren = SymTable_children(pn);
+
+   /* A Node that is not shared shrinks in place */
+   if (! SymTable_isShared(pn)) {
+
+      SymTable_release(ppnChildren[uIndex], NULL);
+
+      for (u = uIndex + 1; u < pn->uCount; u++)
+         ppnChildren[u - 1] = ppnChildren[u];
+
+      pn->uCount--;
+      pn->ulBitmap &= ~ulBit;
+
+      return TRUE;
+   }
+
+   pnNew = SymTable_newInterior(pn->uCount - 1);
+
+   if (pnNew == NULL)
+      return FALSE;
+
+   pnNew->ulBitmap = pn->ulBitmap & ~ulBit;
+
+   for (u = 0; u < pn->uCount; u++) {
+
+      if (u == uIndex)
+         continue;
+
+      SymTable_children(pnNew)[(u < uIndex) ? u : u - 1] =
+         ppnChildren[u];
+      SymTable_retain(ppnChildren[u]);
+   }
+
+   SymTable_release(pn, NULL);
+   *ppn = pnNew;
+
+   return TRUE;
+}
+
+
+/* Return a new Node at the level whose hash code bits start at bit
+   uShift that holds leaves pnA and pnB, whose keys differ, and takes
+   over the caller's references to them, or NULL if insufficient
+   memory is available. Branches with a single child lead down to the
+   first level at which the hash codes of pnA and pnB differ */
+
+static struct Node *SymTable_pair(struct Node *pnA, struct Node *pnB,
+                                  size_t uShift) {
+
+   struct Node *apnNew[MAX_LEVELS + 1];
+   struct Node *pnTemp;
+   size_t uLevelCount = 0;
+   size_t uBottomShift;
+   size_t u;
+
+   assert(pnA != NULL);
+   assert(pnB != NULL);
+
+   uBottomShift = uShift;
+
+   while ((uBottomShift < HASH_BITS) &&
+          (SymTable_bit(pnA->uHash, uBottomShift) ==
+           SymTable_bit(pnB->uHash, uBottomShift))) {
+
+      uLevelCount++;
+      uBottomShift += LEVEL_BITS;
+   }
+
+   for (u = 0; u <= uLevelCount; u++) {
+
+      apnNew[u] = SymTable_newInterior((u == uLevelCount) ? 2 : 1);
+
+      if (apnNew[u] == NULL) {
+
+         while (u > 0)
+            free(apnNew[--u]);
+
+         return NULL;
+      }
+   }
+
+   /* The bottom Node holds both leaves, in the order of their bits */
+   if (uBottomShift < HASH_BITS) {
+
+      apnNew[uLevelCount]->ulBitmap =
+         SymTable_bit(pnA->uHash, uBottomShift) |
+         SymTable_bit(pnB->uHash, uBottomShift);
+
+      if (SymTable_bit(pnA->uHash, uBottomShift) >
+          SymTable_bit(pnB->uHash, uBottomShift)) {
+
+         pnTemp = pnA;
+         pnA = pnB;
+         pnB = pnTemp;
+      }
+   }
+
+   SymTable_children(apnNew[uLevelCount])[0] = pnA;
+   SymTable_children(apnNew[uLevelCount])[1] = pnB;
+
+   for (u = 0; u < uLevelCount; u++) {
+
+      apnNew[u]->ulBitmap =
+         SymTable_bit(pnA->uHash, uShift + u * LEVEL_BITS);
+      SymTable_children(apnNew[u])[0] = apnNew[u + 1];
+   }
+
+   return apnNew[0];
+}
+
+
+/* Add leaf pnLeaf, whose key is not in the subtrie, to the subtrie
+   whose root is *ppn, at the level whose hash code bits start at bit
+   uShift, copying the shared Nodes on its path. Return 1 (TRUE) if
+   successful, or 0 (FALSE) if insufficient memory is available, in
+   which case the subtrie holds the same bindings as before */
+
+static int SymTable_insert(struct Node **ppn, struct Node *pnLeaf,
+                           size_t uShift) {
+
+   struct Node *pnNew;
+   unsigned long ulBit;
+   size_t uIndex;
+   enum {FALSE, TRUE};
+
+   assert(ppn != NULL);
+   assert(*ppn != NULL);
+   assert(pnLeaf != NULL);
+
+   if ((*ppn)->uCount == 0) {
+
+      pnNew = SymTable_pair(*ppn, pnLeaf, uShift);
+
+      if (pnNew == NULL)
+         return FALSE;
+
+      *ppn = pnNew;
+
+      return TRUE;
+   }
+
+   uIndex = SymTable_childIndex(*ppn, pnLeaf->pcKey, pnLeaf->uHash,
+                                uShift, &ulBit);
+
+   /* A collision Node keeps its leaves in no particular order */
+   if (uShift >= HASH_BITS)
+      return SymTable_addChild(ppn, (*ppn)->uCount, 0, pnLeaf);
+
+   if (uIndex == (*ppn)->uCount)
+      return SymTable_addChild(ppn, SymTable_position(*ppn, ulBit),
+                               ulBit, pnLeaf);
+
+   if (! SymTable_own(ppn))
+      return FALSE;
+
+   return SymTable_insert(&SymTable_children(*ppn)[uIndex], pnLeaf,
+                          uShift + LEVEL_BITS);
+}
+
+
+/* Remove the binding whose key is pcKey, whose hash code is uHash,
+   from the subtrie whose root is interior Node *ppn, at the level
+   whose hash code bits start at bit uShift, copying the shared Nodes
+   on its path, and set *ppvValue to its value. An interior Node left
+   with a single leaf is replaced by that leaf. pcKey must be in the
+   subtrie. Return 1 (TRUE) if successful, or 0 (FALSE) if
+   insufficient memory is available, in which case the subtrie holds
+   the same bindings as before */
+
+static int SymTable_removeFrom(struct Node **ppn, const char *pcKey,
+                               size_t uHash, size_t uShift,
+                               void **ppvValue) {
+
+   struct Node *pnChild;
+   struct Node *pnOther;
+   unsigned long ulBit;
+   size_t uIndex;
+   enum {FALSE, TRUE};
+
+   assert(ppn != NULL);
+   assert(*ppn != NULL);
+   assert(pcKey != NULL);
+   assert(ppvValue != NULL);
+
+   uIndex = SymTable_childIndex(*ppn, pcKey, uHash, uShift, &ulBit);
+
+   assert(uIndex < (*ppn)->uCount);
+
+   pnChild = SymTable_children(*ppn)[uIndex];
+
+   if (pnChild->uCount == 0) {
+
+      *ppvValue = pnChild->pvValue;
+
+      if ((*ppn)->uCount > 2)
+         return SymTable_dropChild(ppn, uIndex, ulBit);
+
+      pnOther = SymTable_children(*ppn)[1 - uIndex];
+
+      if (pnOther->uCount != 0)
+         return SymTable_dropChild(ppn, uIndex, ulBit);
+
+      /* Only a leaf is left: it takes the place of its parent */
+      SymTable_retain(pnOther);
+      SymTable_release(*ppn, NULL);
+      *ppn = pnOther;
+
+      return TRUE;
+   }
+
+   if (! SymTable_own(ppn))
+      return FALSE;
+
+   if (! SymTable_removeFrom(&SymTable_children(*ppn)[uIndex], pcKey,
+                             uHash, uShift + LEVEL_BITS, ppvValue))
+      return FALSE;
+
+   pnOther = SymTable_children(*ppn)[0];
+
+   if (((*ppn)->uCount == 1) && (pnOther->uCount == 0)) {
+
+      SymTable_retain(pnOther);
+      SymTable_release(*ppn, NULL);
+      *ppn = pnOther;
+   }
+
+   return TRUE;
+}
+
+
+/* Set the value of the leaf of the binding whose key is pcKey, whose
+   hash code is uHash, in the subtrie whose root is *ppn, at the level
+   whose hash code bits start at bit uShift, to pvValue, copying the
+   shared Nodes on its path, and set *ppvValue to its previous value.
+   pcKey must be in the subtrie. Return 1 (TRUE) if successful, or 0
+   (FALSE) if insufficient memory is available, in which case the
+   subtrie holds the same bindings as before */
+
+static int SymTable_replaceIn(SymTable_T oSymTable, struct Node **ppn,
+                              const char *pcKey, size_t uHash,
+                              size_t uShift, const void *pvValue,
+                              void **ppvValue) {
+
+   struct Node *pnNew;
+   unsigned long ulBit;
+   size_t uIndex;
+   enum {FALSE, TRUE};
+
+   assert(oSymTable != NULL);
+   assert(ppn != NULL);
+   assert(*ppn != NULL);
+   assert(pcKey != NULL);
+   assert(ppvValue != NULL);
+
+   if ((*ppn)->uCount == 0) {
+
+      *ppvValue = (*ppn)->pvValue;
+
+      if (! SymTable_isShared(*ppn)) {
+
+         (*ppn)->pvValue = (void*)pvValue;
+         return TRUE;
+      }
+
+      pnNew = SymTable_copyLeaf(oSymTable, *ppn, pvValue);
+
+      if (pnNew == NULL)
+         return FALSE;
+
+      SymTable_release(*ppn, NULL);
+      *ppn = pnNew;
+
+      return TRUE;
+   }
+
+   uIndex = SymTable_childIndex(*ppn, pcKey, uHash, uShift, &ulBit);
+
+   assert(uIndex < (*ppn)->uCount);
+
+   if (! SymTable_own(ppn))
+      return FALSE;
+
+   return SymTable_replaceIn(oSymTable,
+                             &SymTable_children(*ppn)[uIndex], pcKey,
+                             uHash, uShift + LEVEL_BITS, pvValue,
+                             ppvValue);
+}
+
+
+
+SymTable_T SymTable_new(void) {
+
+   SymTable_T oSymTable;
+   enum {FALSE, TRUE};
+
+   oSymTable = (SymTable_T)malloc(sizeof(struct SymTable));
+
+   if (oSymTable == NULL)
+      return NULL;
+
+   oSymTable->pnRoot = NULL;
+   oSymTable->uLength = 0;
+   oSymTable->iBorrowsKeys = FALSE;
+
+   return oSymTable;
+}
+
+
+
+SymTable_T SymTable_newBorrowedKeys(void) {
+
+   SymTable_T oSymTable;
+   enum {FALSE, TRUE};
+
+   oSymTable = SymTable_new();
+
+   if (oSymTable == NULL)
+      return NULL;
+
+   oSymTable->iBorrowsKeys = TRUE;
+
+   return oSymTable;
+}
+
+
+
+SymTable_T SymTable_snapshot(SymTable_T oSymTable) {
+
+   SymTable_T oSnapshot;
+
+   assert(oSymTable != NULL);
+
+   oSnapshot = (SymTable_T)malloc(sizeof(struct SymTable));
+
+   if (oSnapshot == NULL)
+      return NULL;
+
+   *oSnapshot = *oSymTable;
+
+   if (oSnapshot->pnRoot != NULL)
+      SymTable_retain(oSnapshot->pnRoot);
+
+   return oSnapshot;
+}
+
+
+
+void SymTable_free(SymTable_T oSymTable) {
+
+   assert(oSymTable != NULL);
+
+   SymTable_freeWith(oSymTable, NULL);
+}
+
+
+
+void SymTable_freeWith(SymTable_T oSymTable,
+                       void (*pfFreeValue)(void *pvValue)) {
+
+   assert(oSymTable != NULL);
+
+   SymTable_clear(oSymTable, pfFreeValue);
+
+   free(oSymTable);
+}
+
+
+
+void SymTable_clear(SymTable_T oSymTable,
+                    void (*pfFreeValue)(void *pvValue)) {
+
+   assert(oSymTable != NULL);
+
+   if (oSymTable->pnRoot != NULL)
+      SymTable_release(oSymTable->pnRoot, pfFreeValue);
+
+   oSymTable->pnRoot = NULL;
+   oSymTable->uLength = 0;
+}
+
+
+
+size_t SymTable_getLength(SymTable_T oSymTable) {
+
+   assert(oSymTable != NULL);
+
+   return oSymTable->uLength;
+}
+
+
+
+/* Return a hash code for pcKey, using every bit of a size_t. pcKey is
+   a pointer to the key which will be hashed */
+
+static size_t SymTable_hash(const char *pcKey)
+{
+   const size_t HASH_MULTIPLIER = 65599;
+   size_t u;
+   size_t uHash = 0;
+
+   assert(pcKey != NULL);
+
+   for (u = 0; pcKey[u] != '\0'; u++)
+      uHash = uHash * HASH_MULTIPLIER + (size_t)pcKey[u];
+
+   return uHash;
+}
+
+
+/* Return the leaf of oSymTable whose key is pcKey, whose hash code is
+   uHash, or NULL if there is none */
+
+static struct Node *SymTable_find(SymTable_T oSymTable,
+                                  const char *pcKey, size_t uHash) {
+
+   struct Node *pnCurrent;
+   unsigned long ulBit;
+   size_t uShift = 0;
+   size_t uIndex;
+   enum {EQUAL};
+
+   assert(oSymTable != NULL);
+   assert(pcKey != NULL);
+
+   pnCurrent = oSymTable->pnRoot;
+
+   while ((pnCurrent != NULL) && (pnCurrent->uCount != 0)) {
+
+      uIndex = SymTable_childIndex(pnCurrent, pcKey, uHash, uShift,
+                                   &ulBit);
+
+      if (uIndex == pnCurrent->uCount)
+         return NULL;
+
+      pnCurrent = SymTable_children(pnCurrent)[uIndex];
+      uShift += LEVEL_BITS;
+   }
+
+   if ((pnCurrent == NULL) || (pnCurrent->uHash != uHash) ||
+       (strcmp(pnCurrent->pcKey, pcKey) != EQUAL))
+      return NULL;
+
+   return pnCurrent;
+}
+
+
+
+int SymTable_put(SymTable_T oSymTable, const char *pcKey,
+                 const void *pvValue) {
+
+   struct Node *pnLeaf;
+   size_t uHash;
+   enum {FALSE, TRUE};
+
+   assert(oSymTable != NULL);
+   assert(pcKey != NULL);
+
+   uHash = SymTable_hash(pcKey);
+
+   if (SymTable_find(oSymTable, pcKey, uHash) != NULL)
+      return FALSE;
+
+   pnLeaf = SymTable_newLeaf(oSymTable, pcKey, uHash, pvValue);
+
+   if (pnLeaf == NULL)
+      return FALSE;
+
+   if (oSymTable->pnRoot == NULL)
+      oSymTable->pnRoot = pnLeaf;
+
+   else if (! SymTable_insert(&oSymTable->pnRoot, pnLeaf, 0)) {
+
+      free(pnLeaf);
+      return FALSE;
+   }
+
+   oSymTable->uLength++;
+
+   return TRUE;
+}
+
+
+
+void *SymTable_replace(SymTable_T oSymTable, const char *pcKey,
+                       const void *pvValue) {
+
+   void *pvPrevious;
+   size_t uHash;
+
+   assert(oSymTable != NULL);
+   assert(pcKey != NULL);
+
+   uHash = SymTable_hash(pcKey);
+
+   if (SymTable_find(oSymTable, pcKey, uHash) == NULL)
+      return NULL;
+
+   if (! SymTable_replaceIn(oSymTable, &oSymTable->pnRoot, pcKey,
+                            uHash, 0, pvValue, &pvPrevious))
+      return NULL;
+
+   return pvPrevious;
+}
+
+
+
+int SymTable_contains(SymTable_T oSymTable, const char *pcKey) {
+
+   enum {NOT_FOUND, FOUND};
+
+   assert(oSymTable != NULL);
+   assert(pcKey != NULL);
+
+   if (SymTable_find(oSymTable, pcKey, SymTable_hash(pcKey)) == NULL)
+      return NOT_FOUND;
+
+   return FOUND;
+}
+
+
+
+void *SymTable_get(SymTable_T oSymTable, const char *pcKey) {
+
+   struct Node *pnLeaf;
+
+   assert(oSymTable != NULL);
+   assert(pcKey != NULL);
+
+   pnLeaf = SymTable_find(oSymTable, pcKey, SymTable_hash(pcKey));
+
+   if (pnLeaf == NULL)
+      return NULL;
+
+   return pnLeaf->pvValue;
+}
+
+
+
+void *SymTable_remove(SymTable_T oSymTable, const char *pcKey) {
+
+   struct Node *pnLeaf;
+   void *pvValue;
+   size_t uHash;
+
+   assert(oSymTable != NULL);
+   assert(pcKey != NULL);
+
+   uHash = SymTable_hash(pcKey);
+
+   pnLeaf = SymTable_find(oSymTable, pcKey, uHash);
+
+   if (pnLeaf == NULL)
+      return NULL;
+
+   if (pnLeaf == oSymTable->pnRoot) {
+
+      pvValue = pnLeaf->pvValue;
+      SymTable_release(pnLeaf, NULL);
+      oSymTable->pnRoot = NULL;
+   }
+
+   else if (! SymTable_removeFrom(&oSymTable->pnRoot, pcKey, uHash, 0,
+                                  &pvValue))
+      return NULL;
+
+   oSymTable->uLength--;
+
+   return pvValue;
+}
+
+
+
+/* Apply pfApply to each binding in the subtrie whose root is pn,
+   passing pvExtra as well */
+
+static void SymTable_walk(struct Node *pn,
+                          void (*pfApply)(const char *pcKey,
+                                          void *pvValue,
+                                          void *pvExtra),
+                          const void *pvExtra) {
+
+   size_t u;
+
+   assert(pn != NULL);
+   assert(pfApply != NULL);
+
+   if (pn->uCount == 0) {
+
+      (*pfApply)(pn->pcKey, pn->pvValue, (void*)pvExtra);
+      return;
+   }
+
+   for (u = 0; u < pn->uCount; u++)
+      SymTable_walk(SymTable_children(pn)[u], pfApply, pvExtra);
+}
+
+
+
+void SymTable_map(SymTable_T oSymTable,
+                  void (*pfApply)(const char *pcKey, void *pvValue,
+                                  void *pvExtra),const void *pvExtra) {
+
+   assert(oSymTable != NULL);
+   assert(pfApply != NULL);
+
+   if (oSymTable->pnRoot != NULL)
+      SymTable_walk(oSymTable->pnRoot, pfApply, pvExtra);
+}
+
+
+
+/* Add to the estimate of psMemory the bytes that malloc adds to a
+   block of uSize bytes */
+
+static void SymTable_addOverhead(struct SymTableMemory *psMemory,
+                                 size_t uSize) {
+
+   const size_t uWord = sizeof(size_t);
+   size_t uChunk;
+
+   assert(psMemory != NULL);
+
+   uChunk = (uSize + 3 * uWord - 1) / (2 * uWord) * (2 * uWord);
+
+   if (uChunk < 4 * uWord)
+      uChunk = 4 * uWord;
+
+   psMemory->uOverheadBytes += uChunk - uSize;
+}
+
+
+/* Add to psMemory the Nodes of the subtrie whose root is pn, which
+   belongs to oSymTable */
+
+static void SymTable_addNodes(SymTable_T oSymTable, struct Node *pn,
+                              struct SymTableMemory *psMemory) {
+
+   size_t uKeySize;
+   size_t u;
+
+   assert(oSymTable != NULL);
+   assert(pn != NULL);
+   assert(psMemory != NULL);
+
+   if (pn->uCount == 0) {
+
+      /* A shared key is counted with the leaf whose block holds it */
+      uKeySize = (oSymTable->iBorrowsKeys || (pn->ulBitmap == 0)) ? 0 :
+         strlen(pn->pcKey) + 1;
+
+      psMemory->uBindingBytes += sizeof(struct Node);
+      psMemory->uKeyBytes += uKeySize;
+      SymTable_addOverhead(psMemory, sizeof(struct Node) + uKeySize);
+      return;
+   }
+
+   psMemory->uTableBytes +=
+      sizeof(struct Node) + pn->uCount * sizeof(struct Node*);
+   SymTable_addOverhead(psMemory, sizeof(struct Node) +
+                        pn->uCount * sizeof(struct Node*));
+
+   for (u = 0; u < pn->uCount; u++)
+      SymTable_addNodes(oSymTable, SymTable_children(pn)[u], psMemory);
+}
+
+
+
+void SymTable_memoryUsage(SymTable_T oSymTable,
+                          struct SymTableMemory *psMemory) {
+
+   assert(oSymTable != NULL);
+   assert(psMemory != NULL);
+
+   /* Nodes shared with snapshots are counted in full */
+   psMemory->uTableBytes = sizeof(struct SymTable);
+   psMemory->uBindingBytes = 0;
+   psMemory->uKeyBytes = 0;
+   psMemory->uOverheadBytes = 0;
+
+   SymTable_addOverhead(psMemory, sizeof(struct SymTable));
+
+   if (oSymTable->pnRoot != NULL)
+      SymTable_addNodes(oSymTable, oSymTable->pnRoot, psMemory);
+}
+
+
+
+/* Point psIter at the first leaf of the subtrie whose root is pn, or
+   at its end if pn is NULL. uIndex holds the hash code of the key of
+   the leaf */
+
+static void SymTable_iterSeek(struct SymTableIter *psIter,
+                              struct Node *pn) {
+
+   assert(psIter != NULL);
+
+   psIter->uIndex = 0;
+
+   if (pn == NULL) {
+
+      psIter->pvPosition = NULL;
+      psIter->pcKey = NULL;
+      psIter->pvValue = NULL;
+      return;
+   }
+
+   while (pn->uCount != 0)
+      pn = SymTable_children(pn)[0];
+
+   psIter->uIndex = pn->uHash;
+   psIter->pvPosition = pn;
+   psIter->pcKey = pn->pcKey;
+   psIter->pvValue = pn->pvValue;
+}
+
+
+
+void SymTable_iterBegin(SymTable_T oSymTable,
+                        struct SymTableIter *psIter) {
+
+   assert(oSymTable != NULL);
+   assert(psIter != NULL);
+
+   psIter->oSymTable = oSymTable;
+
+   SymTable_iterSeek(psIter, oSymTable->pnRoot);
+}
+
+
+
+void SymTable_iterNext(struct SymTableIter *psIter) {
+
+   struct Node *pnCurrent;
+   struct Node *pnNext = NULL;
+   unsigned long ulBit;
+   size_t uShift = 0;
+   size_t uIndex;
+   enum {EQUAL};
+
+   assert(psIter != NULL);
+   assert(psIter->pvPosition != NULL);
+
+   /* Nodes have no parent links, so follow the path of the current
+      key from the root, and go on from the deepest Node on it that
+      has a child after the path. SymTable_replace may have put a copy
+      of the current leaf in its place if a snapshot shares it, so the
+      leaf is found by its key rather than by its address */
+   pnCurrent = psIter->oSymTable->pnRoot;
+
+   while (pnCurrent->uCount != 0) {
+
+      uIndex = SymTable_childIndex(pnCurrent, psIter->pcKey,
+                                   psIter->uIndex, uShift, &ulBit);
+
+      assert(uIndex < pnCurrent->uCount);
+
+      if (uIndex + 1 < pnCurrent->uCount)
+         pnNext = SymTable_children(pnCurrent)[uIndex + 1];
+
+      pnCurrent = SymTable_children(pnCurrent)[uIndex];
+      uShift += LEVEL_BITS;
+   }
+
+   assert(strcmp(pnCurrent->pcKey, psIter->pcKey) == EQUAL);
+
+   SymTable_iterSeek(psIter, pnNext);
+}
+
+
+
+int SymTable_iterEnd(const struct SymTableIter *psIter) {
+
+   assert(psIter != NULL);
+
+   return psIter->pvPosition == NULL;
+}
@@ -0,0 +1,43 @@
+/*--------------------------------------------------------------------*/
+/* symtablehamt.h                                                     */
+/* Author: Julio Lins (jcclb)                                         */
+/*--------------------------------------------------------------------*/
+
+#ifndef SYMTABLEHAMT_H
+#define SYMTABLEHAMT_H
+
+/*--------------------------------------------------------------------*/
+
+#include "symtable.h"
+
+/*--------------------------------------------------------------------*/
+
+/* Operations provided by the hash array mapped trie implementation of
+   symtable.h (symtablehamt.c). Its Nodes are shared between a table
+   and its snapshots and copied only when one of them changes a Node
+   that another still uses, so a snapshot costs O(1) to take and each
+   later change copies at most one path of the trie.
+
+   A value is the client's, as in every implementation, and a value
+   replaced or removed from a table may still be bound in a snapshot.
+   SymTable_freeWith and SymTable_clear only call pfFreeValue on the
+   values of bindings that no other table still holds. Since a change
+   to a shared Node needs a copy, SymTable_replace and SymTable_remove
+   can fail for lack of memory once a snapshot is taken; they then
+   leave the table unchanged and return NULL.
+
+   Tables that share Nodes may be used by different threads, each
+   table by one thread at a time */
+
+/*--------------------------------------------------------------------*/
+
+/* Return a new SymTable_T object with the bindings oSymTable has now,
+   or NULL if insufficient memory is available. Later changes to either
+   table are not seen by the other. The snapshot borrows its keys if
+   oSymTable does, and must be freed as any other table */
+
+SymTable_T SymTable_snapshot(SymTable_T oSymTable);
+
+/*--------------------------------------------------------------------*/
+
+#endif
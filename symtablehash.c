@@ -3,10 +3,14 @@
 /* author: Julio Lins (jcclb)                                         */
 /*--------------------------------------------------------------------*/
 
-#include "symtable.h"
+/* Threads are POSIX, not ANSI C */
+#define _POSIX_C_SOURCE 200112L
+
+#include "symtablehash.h"
 #include <assert.h>
 #include <string.h>
 #include <stdlib.h>
+#include <pthread.h>
 
 /*--------------------------------------------------------------------*/
 
@@ -21,7 +25,8 @@ static const size_t auBucketCount[] = {509, 1021, 2039, 4093, 8191,
 
 struct Binding {
 
-   /* key, owned by implementation through defensive copy */
+   /* key, owned by implementation through defensive copy unless
+      the table borrows its keys */
    const char *pcKey;
 
    /* value, owned by client */
@@ -48,13 +53,22 @@ struct SymTable {
 
    /* size of Symble Table (total # of Bindings) */
    size_t uLength;
+
+   /* 1 (TRUE) if keys are borrowed from the client rather than
+      owned through defensive copies */
+   int iBorrowsKeys;
 };
 
 
 
-SymTable_T SymTable_new(void) {
+/* Return a new, empty Symble Table whose bucket count is
+   auBucketCount[uBucketIndex], or NULL if insufficient memory is
+   available */
+
+static SymTable_T SymTable_newWithIndex(size_t uBucketIndex) {
 
    SymTable_T oSymTable;
+   enum {FALSE, TRUE};
 
 
    oSymTable = (SymTable_T)malloc(sizeof(struct SymTable));
@@ -64,7 +78,7 @@ SymTable_T SymTable_new(void) {
 
 
    oSymTable->ppbBuckets = (struct Binding**)
-      calloc(sizeof(struct Binding*), auBucketCount[0]);
+      calloc(sizeof(struct Binding*), auBucketCount[uBucketIndex]);
 
    if (oSymTable->ppbBuckets == NULL) {
       
@@ -73,7 +87,8 @@ SymTable_T SymTable_new(void) {
    }
 
    oSymTable->uLength = 0;
-   oSymTable->uBucketIndex = 0;
+   oSymTable->uBucketIndex = uBucketIndex;
+   oSymTable->iBorrowsKeys = FALSE;
 
    
    return oSymTable;
@@ -81,7 +96,36 @@ SymTable_T SymTable_new(void) {
 
 
 
-void SymTable_free(SymTable_T oSymTable) {
+SymTable_T SymTable_new(void) {
+
+   return SymTable_newWithIndex(0);
+}
+
+
+
+SymTable_T SymTable_newBorrowedKeys(void) {
+
+   SymTable_T oSymTable;
+   enum {FALSE, TRUE};
+
+   oSymTable = SymTable_new();
+
+   if (oSymTable == NULL)
+      return NULL;
+
+   oSymTable->iBorrowsKeys = TRUE;
+
+   return oSymTable;
+}
+
+
+
+/* Helper function that frees every Binding of oSymTable and its key,
+   also calling pfFreeValue on its value unless pfFreeValue is NULL.
+   oSymTable is left empty, with its bucket array in place */
+
+static void SymTable_freeBindings(SymTable_T oSymTable,
+                                  void (*pfFreeValue)(void *pvValue)) {
 
    struct Binding *pbCurrent;
    struct Binding *pbNext;
@@ -103,19 +147,55 @@ void SymTable_free(SymTable_T oSymTable) {
          pbNext = pbCurrent->pbNext;
 
          
-         free((void*)pbCurrent->pcKey);
+         if (! oSymTable->iBorrowsKeys)
+            free((void*)pbCurrent->pcKey);
+
+         if (pfFreeValue != NULL)
+            (*pfFreeValue)(pbCurrent->pvValue);
 
          free(pbCurrent);
 
          pbCurrent = pbNext;
       }
+
+      oSymTable->ppbBuckets[i] = NULL;
    }
 
+   oSymTable->uLength = 0;
+}
+
+
+void SymTable_free(SymTable_T oSymTable) {
+
+   assert(oSymTable != NULL);
+
+   SymTable_freeWith(oSymTable, NULL);
+}
+
+
+
+void SymTable_freeWith(SymTable_T oSymTable,
+                       void (*pfFreeValue)(void *pvValue)) {
+
+   assert(oSymTable != NULL);
+
+   SymTable_freeBindings(oSymTable, pfFreeValue);
+
    free(oSymTable->ppbBuckets);
    free(oSymTable);
 }
 
 
+
+void SymTable_clear(SymTable_T oSymTable,
+                    void (*pfFreeValue)(void *pvValue)) {
+
+   assert(oSymTable != NULL);
+
+   SymTable_freeBindings(oSymTable, pfFreeValue);
+}
+
+
 size_t SymTable_getLength(SymTable_T oSymTable) {
 
    assert(oSymTable != NULL);
@@ -144,83 +224,67 @@ static size_t SymTable_hash(const char *pcKey, size_t uBucketCount)
 }
 
 
-/* Helper function that expands Symble Table to next bucket count.
-   oSymTable is a pointer to the Symble Table that will be expanded. 
-   If not enough memory for expansion, oSymTable does not change */
+/* Move every Binding of oSymTable to a new bucket array whose bucket
+   count is auBucketCount[uBucketIndex], relinking the Bindings rather
+   than copying them. Return 1 (TRUE) if successful, or 0 (FALSE) if
+   insufficient memory is available, in which case oSymTable does not
+   change */
 
-static void SymTable_grow(SymTable_T oSymTable) {
+static int SymTable_rehash(SymTable_T oSymTable, size_t uBucketIndex) {
 
-   size_t uCurrentIndex;
-   size_t uNextIndex;
-   size_t uNextCount;
+   struct Binding **ppbNewBuckets;
+   struct Binding *pbCurrent;
+   struct Binding *pbNext;
+   size_t uNewCount;
+   size_t uIndex;
    size_t i;
- 
-   struct Binding* pbCurrent;
-   struct Binding** ppbTemp;
-
-   /* oTempSymTable is a placeholder SymTable_T object. We will
-      put all oSymTable Bindings into it, but with the new hash codes */
-   
-   SymTable_T oTempSymTable;
-
-
-   uCurrentIndex = oSymTable->uBucketIndex; 
-   uNextIndex = uCurrentIndex + 1;
-   uNextCount = auBucketCount[uNextIndex];
-
-
-   oTempSymTable = (SymTable_T)malloc(sizeof(struct SymTable));
-   
+   enum {FALSE, TRUE};
 
-   if (oTempSymTable == NULL)
-      return;
 
-   
-   oTempSymTable->ppbBuckets =
-      (struct Binding**)calloc(sizeof(struct Binding*), uNextCount);
+   assert(oSymTable != NULL);
 
-   if (oTempSymTable->ppbBuckets == NULL) {
+   uNewCount = auBucketCount[uBucketIndex];
 
-      free(oTempSymTable);
-      return;
-   }
+   ppbNewBuckets =
+      (struct Binding**)calloc(sizeof(struct Binding*), uNewCount);
 
-  
-   oTempSymTable->uLength = 0;
-   oTempSymTable->uBucketIndex = uNextIndex;
+   if (ppbNewBuckets == NULL)
+      return FALSE;
 
-   /* Reinserts all key-value pairs into placeholder, but now hashing
-      from 0 to uNextCount - 1 */
 
-   for (i = 0; i < auBucketCount[uCurrentIndex]; i++) {
-  
-      pbCurrent = oSymTable->ppbBuckets[i];
+   for (i = 0; i < auBucketCount[oSymTable->uBucketIndex]; i++) {
 
-      
-      while (pbCurrent != NULL) {
+      for (pbCurrent = oSymTable->ppbBuckets[i]; pbCurrent != NULL;
+           pbCurrent = pbNext) {
 
-         SymTable_put(oTempSymTable, pbCurrent->pcKey,
-                      pbCurrent->pvValue);
+         /* Save pointer to next Binding before relinking pbCurrent */
+         pbNext = pbCurrent->pbNext;
 
-         pbCurrent = pbCurrent->pbNext;
+         uIndex = SymTable_hash(pbCurrent->pcKey, uNewCount);
 
+         pbCurrent->pbNext = ppbNewBuckets[uIndex];
+         ppbNewBuckets[uIndex] = pbCurrent;
       }
    }
 
-   /* Assigns expanded hash table to client's oSymTable. Frees
-      both the old hash table and the placeholder oTempSymTable */
+   free(oSymTable->ppbBuckets);
 
-   ppbTemp = oSymTable->ppbBuckets;
-   oSymTable->ppbBuckets = oTempSymTable->ppbBuckets;
-   oTempSymTable->ppbBuckets = ppbTemp;
+   oSymTable->ppbBuckets = ppbNewBuckets;
+   oSymTable->uBucketIndex = uBucketIndex;
 
+   return TRUE;
+}
 
-   oSymTable->uBucketIndex = uNextIndex;
-   oTempSymTable->uBucketIndex = uCurrentIndex;
-   
-   SymTable_free(oTempSymTable);
 
+/* Helper function that expands Symble Table to next bucket count.
+   oSymTable is a pointer to the Symble Table that will be expanded. 
+   If not enough memory for expansion, oSymTable does not change */
+
+static void SymTable_grow(SymTable_T oSymTable) {
+
+   assert(oSymTable != NULL);
 
+   (void)SymTable_rehash(oSymTable, oSymTable->uBucketIndex + 1);
 }
 
 
@@ -286,17 +350,24 @@ int SymTable_put(SymTable_T oSymTable, const char *pcKey,
       return FALSE;
 
    
-   pcCopy = (char*)malloc(strlen(pcKey) + 1);
-   
-   if (pcCopy == NULL) {
+   /* Borrowed keys are stored as is */
+   if (oSymTable->iBorrowsKeys)
+      pcCopy = (char*)pcKey;
 
-      free(pbNewBinding);
+   else {
 
-      return FALSE;
-   }
+      pcCopy = (char*)malloc(strlen(pcKey) + 1);
+
+      if (pcCopy == NULL) {
 
+         free(pbNewBinding);
 
-   pcCopy = strcpy(pcCopy, pcKey);
+         return FALSE;
+      }
+
+
+      pcCopy = strcpy(pcCopy, pcKey);
+   }
 
    
    pbNewBinding->pcKey = pcCopy;
@@ -449,7 +520,8 @@ void *SymTable_remove(SymTable_T oSymTable, const char *pcKey) {
          
          pvValue = pbCurrent->pvValue;
 
-         free((void*)pbCurrent->pcKey);
+         if (! oSymTable->iBorrowsKeys)
+            free((void*)pbCurrent->pcKey);
          
          free(pbCurrent);
 
@@ -497,3 +569,697 @@ void SymTable_map(SymTable_T oSymTable,
       }
    }
 }
+
+
+/* Add to the estimate of psMemory the bytes that malloc adds to a
+   block of uSize bytes */
+
+static void SymTable_addOverhead(struct SymTableMemory *psMemory,
+                                 size_t uSize) {
+
+   const size_t uWord = sizeof(size_t);
+   size_t uChunk;
+
+   assert(psMemory != NULL);
+
+   uChunk = (uSize + 3 * uWord - 1) / (2 * uWord) * (2 * uWord);
+
+   if (uChunk < 4 * uWord)
+      uChunk = 4 * uWord;
+
+   psMemory->uOverheadBytes += uChunk - uSize;
+}
+
+
+void SymTable_memoryUsage(SymTable_T oSymTable,
+                          struct SymTableMemory *psMemory) {
+
+   struct Binding *pbCurrent;
+   size_t uBucketCount;
+   size_t uKeySize;
+   size_t i;
+
+   assert(oSymTable != NULL);
+   assert(psMemory != NULL);
+
+   uBucketCount = auBucketCount[oSymTable->uBucketIndex];
+
+   psMemory->uTableBytes = sizeof(struct SymTable) +
+      sizeof(struct Binding*) * uBucketCount;
+   psMemory->uBindingBytes = 0;
+   psMemory->uKeyBytes = 0;
+   psMemory->uOverheadBytes = 0;
+
+   SymTable_addOverhead(psMemory, sizeof(struct SymTable));
+   SymTable_addOverhead(psMemory,
+                        sizeof(struct Binding*) * uBucketCount);
+
+   for (i = 0; i < uBucketCount; i++) {
+
+      for (pbCurrent = oSymTable->ppbBuckets[i]; pbCurrent != NULL;
+           pbCurrent = pbCurrent->pbNext) {
+
+         psMemory->uBindingBytes += sizeof(struct Binding);
+         SymTable_addOverhead(psMemory, sizeof(struct Binding));
+
+         if (oSymTable->iBorrowsKeys)
+            continue;
+
+         uKeySize = strlen(pbCurrent->pcKey) + 1;
+         psMemory->uKeyBytes += uKeySize;
+         SymTable_addOverhead(psMemory, uKeySize);
+      }
+   }
+}
+
+
+/* Position psIter at the first Binding found in a bucket whose index
+   is at least uIndex, or at its end if there is no such Binding */
+
+static void SymTable_iterSeek(struct SymTableIter *psIter,
+                              size_t uIndex) {
+
+   size_t uBucketCount;
+   struct Binding *pbCurrent;
+
+   assert(psIter != NULL);
+
+   uBucketCount = auBucketCount[psIter->oSymTable->uBucketIndex];
+
+   for (; uIndex < uBucketCount; uIndex++) {
+
+      pbCurrent = psIter->oSymTable->ppbBuckets[uIndex];
+
+      if (pbCurrent != NULL) {
+
+         psIter->uIndex = uIndex;
+         psIter->pvPosition = pbCurrent;
+         psIter->pcKey = pbCurrent->pcKey;
+         psIter->pvValue = pbCurrent->pvValue;
+         return;
+      }
+   }
+
+   psIter->uIndex = uBucketCount;
+   psIter->pvPosition = NULL;
+   psIter->pcKey = NULL;
+   psIter->pvValue = NULL;
+}
+
+
+void SymTable_iterBegin(SymTable_T oSymTable,
+                        struct SymTableIter *psIter) {
+
+   assert(oSymTable != NULL);
+   assert(psIter != NULL);
+
+   psIter->oSymTable = oSymTable;
+
+   SymTable_iterSeek(psIter, 0);
+}
+
+void SymTable_iterNext(struct SymTableIter *psIter) {
+
+   struct Binding *pbNext;
+
+   assert(psIter != NULL);
+   assert(psIter->pvPosition != NULL);
+
+   pbNext = ((struct Binding*)psIter->pvPosition)->pbNext;
+
+   /* Stay on the same separate chain while it lasts */
+   if (pbNext != NULL) {
+
+      psIter->pvPosition = pbNext;
+      psIter->pcKey = pbNext->pcKey;
+      psIter->pvValue = pbNext->pvValue;
+      return;
+   }
+
+   SymTable_iterSeek(psIter, psIter->uIndex + 1);
+}
+
+int SymTable_iterEnd(const struct SymTableIter *psIter) {
+
+   assert(psIter != NULL);
+
+   return psIter->pvPosition == NULL;
+}
+
+
+/* A BuildTask is the share of SymTable_buildParallel's work done by
+   one thread: first hashing the entries from uFirst up to, but not
+   including, uLast, then binding the entries whose bucket is from
+   uFirst up to, but not including, uLast. Those entries are listed,
+   in order, from puOrder[uEntryFirst] up to, but not including,
+   puOrder[uEntryLast] */
+
+struct BuildTask {
+
+   /* table being built */
+   SymTable_T oSymTable;
+
+   /* keys and values (or NULL) */
+   const char *const *ppcKeys;
+   void *const *ppvValues;
+
+   /* bucket of each entry */
+   size_t *puIndices;
+
+   /* range of entries or buckets */
+   size_t uFirst;
+   size_t uLast;
+
+   /* entries sorted by task, and the range of puOrder of the task */
+   size_t *puOrder;
+   size_t uEntryFirst;
+   size_t uEntryLast;
+
+   /* # of Bindings made by the task */
+   size_t uBound;
+
+   /* 0 (FALSE) if the task ran out of memory */
+   int iSuccessful;
+};
+
+
+/* Store the bucket of each entry in the range of the BuildTask
+   pvTask. Return NULL */
+
+static void *SymTable_hashTask(void *pvTask) {
+
+   struct BuildTask *psTask;
+   size_t uBucketCount;
+   size_t i;
+
+   assert(pvTask != NULL);
+
+   psTask = (struct BuildTask*)pvTask;
+   uBucketCount = auBucketCount[psTask->oSymTable->uBucketIndex];
+
+   for (i = psTask->uFirst; i < psTask->uLast; i++)
+      psTask->puIndices[i] =
+         SymTable_hash(psTask->ppcKeys[i], uBucketCount);
+
+   return NULL;
+}
+
+
+/* Bind, in order, the entries whose bucket is in the range of the
+   BuildTask pvTask, as SymTable_put would. Only the task touches the
+   chains of those buckets, so no locking is needed, and it visits no
+   other entries. Return NULL */
+
+static void *SymTable_bindTask(void *pvTask) {
+
+   struct BuildTask *psTask;
+   struct Binding **ppbBuckets;
+   struct Binding *pbCurrent;
+   struct Binding *pbNewBinding;
+   char *pcCopy;
+   size_t uIndex;
+   size_t u;
+   size_t i;
+   enum {FALSE, TRUE};
+   enum {EQUAL};
+
+
+   assert(pvTask != NULL);
+
+   psTask = (struct BuildTask*)pvTask;
+   ppbBuckets = psTask->oSymTable->ppbBuckets;
+
+
+   for (u = psTask->uEntryFirst; u < psTask->uEntryLast; u++) {
+
+      i = psTask->puOrder[u];
+      uIndex = psTask->puIndices[i];
+
+      assert((uIndex >= psTask->uFirst) && (uIndex < psTask->uLast));
+
+
+      /* Of equal keys, only the first is bound */
+      for (pbCurrent = ppbBuckets[uIndex]; pbCurrent != NULL;
+           pbCurrent = pbCurrent->pbNext)
+         if (strcmp(pbCurrent->pcKey, psTask->ppcKeys[i]) == EQUAL)
+            break;
+
+      if (pbCurrent != NULL)
+         continue;
+
+
+      pbNewBinding = (struct Binding*)malloc(sizeof(struct Binding));
+      pcCopy = (char*)malloc(strlen(psTask->ppcKeys[i]) + 1);
+
+      if ((pbNewBinding == NULL) || (pcCopy == NULL)) {
+
+         free(pbNewBinding);
+         free(pcCopy);
+         psTask->iSuccessful = FALSE;
+         return NULL;
+      }
+
+
+      pbNewBinding->pcKey = strcpy(pcCopy, psTask->ppcKeys[i]);
+      pbNewBinding->pvValue = (psTask->ppvValues == NULL) ? NULL :
+         psTask->ppvValues[i];
+
+      pbNewBinding->pbNext = ppbBuckets[uIndex];
+      ppbBuckets[uIndex] = pbNewBinding;
+
+      psTask->uBound++;
+   }
+
+   return NULL;
+}
+
+
+/* Split the range from 0 up to, but not including, uCount into
+   uTaskCount consecutive ranges of almost equal sizes, one for each
+   of the BuildTasks of psTasks */
+
+static void SymTable_split(struct BuildTask *psTasks,
+                           size_t uTaskCount, size_t uCount) {
+
+   size_t uSize;
+   size_t uLarger;
+   size_t i;
+
+   assert(psTasks != NULL);
+   assert(uTaskCount > 0);
+
+   /* The first uLarger ranges take one more */
+   uSize = uCount / uTaskCount;
+   uLarger = uCount % uTaskCount;
+
+   for (i = 0; i < uTaskCount; i++) {
+
+      psTasks[i].uFirst = (i == 0) ? 0 : psTasks[i - 1].uLast;
+      psTasks[i].uLast = psTasks[i].uFirst + uSize +
+         ((i < uLarger) ? 1 : 0);
+   }
+}
+
+
+/* Return the position among the uTaskCount BuildTasks of psTasks of
+   the one whose range holds uIndex. The ranges must be those of
+   SymTable_split */
+
+static size_t SymTable_taskOf(const struct BuildTask *psTasks,
+                              size_t uTaskCount, size_t uIndex) {
+
+   size_t uLow = 0;
+   size_t uHigh;
+   size_t uMiddle;
+
+   assert(psTasks != NULL);
+   assert(uTaskCount > 0);
+
+   /* Ranges are consecutive, so search for the first that ends past
+      uIndex */
+   uHigh = uTaskCount - 1;
+
+   while (uLow < uHigh) {
+
+      uMiddle = uLow + (uHigh - uLow) / 2;
+
+      if (psTasks[uMiddle].uLast > uIndex)
+         uHigh = uMiddle;
+      else
+         uLow = uMiddle + 1;
+   }
+
+   return uLow;
+}
+
+
+/* Sort the uLength entries of the table being built by the
+   uTaskCount BuildTasks of psTasks into the puOrder they share,
+   grouped by the task whose range of buckets holds theirs, and in
+   their own order within a task. Set the range of puOrder of each
+   task */
+
+static void SymTable_sortEntries(struct BuildTask *psTasks,
+                                 size_t uTaskCount, size_t uLength) {
+
+   size_t uTask;
+   size_t uStart;
+   size_t uCount;
+   size_t i;
+
+   assert(psTasks != NULL);
+   assert(uTaskCount > 0);
+
+   /* Count the entries of each task... */
+   for (uTask = 0; uTask < uTaskCount; uTask++)
+      psTasks[uTask].uEntryLast = 0;
+
+   for (i = 0; i < uLength; i++)
+      psTasks[SymTable_taskOf(psTasks, uTaskCount,
+                              psTasks[0].puIndices[i])].uEntryLast++;
+
+   uStart = 0;
+
+   for (uTask = 0; uTask < uTaskCount; uTask++) {
+
+      uCount = psTasks[uTask].uEntryLast;
+      psTasks[uTask].uEntryFirst = uStart;
+      psTasks[uTask].uEntryLast = uStart;
+      uStart += uCount;
+   }
+
+   /* ...then list each one after those of its task */
+   for (i = 0; i < uLength; i++) {
+
+      uTask = SymTable_taskOf(psTasks, uTaskCount,
+                              psTasks[0].puIndices[i]);
+      psTasks[uTask].puOrder[psTasks[uTask].uEntryLast++] = i;
+   }
+}
+
+
+/* Run (*pfTask) on each of the uTaskCount BuildTasks of psTasks, each
+   on a thread of its own but the first, which runs on the calling
+   thread, as does any task whose thread cannot be created. Return
+   once every task is done */
+
+static void SymTable_runTasks(void *(*pfTask)(void *pvTask),
+                              struct BuildTask *psTasks,
+                              size_t uTaskCount) {
+
+   pthread_t *psThreads;
+   int *piStarted;
+   size_t i;
+   enum {FALSE, TRUE};
+
+
+   assert(pfTask != NULL);
+   assert(psTasks != NULL);
+   assert(uTaskCount > 0);
+
+
+   psThreads = (pthread_t*)malloc(sizeof(pthread_t) * uTaskCount);
+   piStarted = (int*)calloc(sizeof(int), uTaskCount);
+
+
+   for (i = 1; i < uTaskCount; i++)
+      if ((psThreads != NULL) && (piStarted != NULL) &&
+          (pthread_create(&psThreads[i], NULL, pfTask,
+                          &psTasks[i]) == 0))
+         piStarted[i] = TRUE;
+
+      else
+         (*pfTask)(&psTasks[i]);
+
+
+   (*pfTask)(&psTasks[0]);
+
+
+   for (i = 1; i < uTaskCount; i++)
+      if ((piStarted != NULL) && piStarted[i])
+         pthread_join(psThreads[i], NULL);
+
+   free(psThreads);
+   free(piStarted);
+}
+
+
+
+/* Return the index of auBucketCount[] of the bucket count that
+   SymTable_put would have grown a table of uLength Bindings to */
+
+static size_t SymTable_indexFor(size_t uLength) {
+
+   size_t uMaxIndex;
+   size_t uBucketIndex;
+
+   uMaxIndex = sizeof(auBucketCount)/sizeof(size_t) - 1;
+
+   for (uBucketIndex = 0; uBucketIndex < uMaxIndex; uBucketIndex++)
+      if (auBucketCount[uBucketIndex] >= uLength)
+         break;
+
+   return uBucketIndex;
+}
+
+
+
+SymTable_T SymTable_buildParallel(const char *const *ppcKeys,
+                                  void *const *ppvValues,
+                                  size_t uLength, size_t uThreadCount) {
+
+   SymTable_T oSymTable;
+   struct BuildTask *psTasks;
+   size_t *puIndices;
+   size_t *puOrder;
+   size_t uBucketIndex;
+   size_t uBucketCount;
+   size_t i;
+   int iSuccessful;
+   enum {FALSE, TRUE};
+
+
+   assert((ppcKeys != NULL) || (uLength == 0));
+
+   if (uThreadCount == 0)
+      uThreadCount = 1;
+
+
+   uBucketIndex = SymTable_indexFor(uLength);
+   uBucketCount = auBucketCount[uBucketIndex];
+
+   if (uLength >= (size_t)-1 / sizeof(size_t))
+      return NULL;
+
+
+   oSymTable = SymTable_newWithIndex(uBucketIndex);
+
+   if (oSymTable == NULL)
+      return NULL;
+
+   psTasks = (struct BuildTask*)
+      malloc(sizeof(struct BuildTask) * uThreadCount);
+   puIndices = (size_t*)malloc(sizeof(size_t) * (uLength + 1));
+   puOrder = (size_t*)malloc(sizeof(size_t) * (uLength + 1));
+
+   if ((psTasks == NULL) || (puIndices == NULL) || (puOrder == NULL)) {
+
+      free(psTasks);
+      free(puIndices);
+      free(puOrder);
+      SymTable_free(oSymTable);
+      return NULL;
+   }
+
+
+   for (i = 0; i < uThreadCount; i++) {
+
+      psTasks[i].oSymTable = oSymTable;
+      psTasks[i].ppcKeys = ppcKeys;
+      psTasks[i].ppvValues = ppvValues;
+      psTasks[i].puIndices = puIndices;
+      psTasks[i].puOrder = puOrder;
+      psTasks[i].uBound = 0;
+      psTasks[i].iSuccessful = TRUE;
+   }
+
+   SymTable_split(psTasks, uThreadCount, uLength);
+   SymTable_runTasks(SymTable_hashTask, psTasks, uThreadCount);
+
+   /* Partition the buckets, rather than the entries, among tasks,
+      and give each task the entries of its buckets alone */
+   SymTable_split(psTasks, uThreadCount, uBucketCount);
+   SymTable_sortEntries(psTasks, uThreadCount, uLength);
+   SymTable_runTasks(SymTable_bindTask, psTasks, uThreadCount);
+
+
+   iSuccessful = TRUE;
+
+   for (i = 0; i < uThreadCount; i++) {
+
+      oSymTable->uLength += psTasks[i].uBound;
+
+      if (! psTasks[i].iSuccessful)
+         iSuccessful = FALSE;
+   }
+
+   free(psTasks);
+   free(puIndices);
+   free(puOrder);
+
+
+   if (! iSuccessful) {
+
+      SymTable_free(oSymTable);
+      return NULL;
+   }
+
+   return oSymTable;
+}
+
+
+
+/* Return a new Binding of oSymTable with pcKey as key and pvValue as
+   value, its key copied unless oSymTable borrows its keys, or NULL if
+   insufficient memory is available. The Binding is not linked */
+
+static struct Binding *SymTable_newBinding(SymTable_T oSymTable,
+                                           const char *pcKey,
+                                           const void *pvValue) {
+
+   struct Binding *pbNewBinding;
+   char *pcCopy;
+   size_t uKeySize;
+
+
+   assert(oSymTable != NULL);
+   assert(pcKey != NULL);
+
+   pbNewBinding = (struct Binding*)malloc(sizeof(struct Binding));
+
+   if (pbNewBinding == NULL)
+      return NULL;
+
+
+   /* Borrowed keys are stored as is */
+   if (oSymTable->iBorrowsKeys)
+      pcCopy = (char*)pcKey;
+
+   else {
+
+      uKeySize = strlen(pcKey) + 1;
+      pcCopy = (char*)malloc(uKeySize);
+
+      if (pcCopy == NULL) {
+
+         free(pbNewBinding);
+         return NULL;
+      }
+
+      memcpy(pcCopy, pcKey, uKeySize);
+   }
+
+   pbNewBinding->pcKey = pcCopy;
+   pbNewBinding->pvValue = (void*)pvValue;
+   pbNewBinding->pbNext = NULL;
+
+   return pbNewBinding;
+}
+
+
+
+SymTable_T SymTable_clone(SymTable_T oSymTable) {
+
+   SymTable_T oClone;
+   struct Binding *pbCurrent;
+   struct Binding **ppbLast;
+   size_t i;
+
+
+   assert(oSymTable != NULL);
+
+   oClone = SymTable_newWithIndex(oSymTable->uBucketIndex);
+
+   if (oClone == NULL)
+      return NULL;
+
+   oClone->iBorrowsKeys = oSymTable->iBorrowsKeys;
+
+
+   /* Each chain is copied in order, onto the end of its copy */
+   for (i = 0; i < auBucketCount[oSymTable->uBucketIndex]; i++) {
+
+      ppbLast = &oClone->ppbBuckets[i];
+
+      for (pbCurrent = oSymTable->ppbBuckets[i]; pbCurrent != NULL;
+           pbCurrent = pbCurrent->pbNext) {
+
+         *ppbLast = SymTable_newBinding(oClone, pbCurrent->pcKey,
+                                        pbCurrent->pvValue);
+
+         if (*ppbLast == NULL) {
+
+            SymTable_free(oClone);
+            return NULL;
+         }
+
+         ppbLast = &(*ppbLast)->pbNext;
+         oClone->uLength++;
+      }
+   }
+
+   return oClone;
+}
+
+
+
+int SymTable_merge(SymTable_T oDst, SymTable_T oSrc,
+                   enum SymTableMerge eMerge) {
+
+   struct Binding *pbCurrent;
+   struct Binding *pbFound;
+   struct Binding *pbNewBinding;
+   size_t uBucketIndex;
+   size_t uBucketCount;
+   size_t uIndex;
+   size_t i;
+   int iSameCount;
+   enum {FALSE, TRUE};
+   enum {EQUAL};
+
+
+   assert(oDst != NULL);
+   assert(oSrc != NULL);
+   assert(oDst != oSrc);
+   assert((eMerge == SYMTABLE_KEEP) || (eMerge == SYMTABLE_REPLACE));
+
+
+   /* Grow once, as if no key were bound in both tables */
+   uBucketIndex = SymTable_indexFor(oDst->uLength + oSrc->uLength);
+
+   if ((uBucketIndex > oDst->uBucketIndex) &&
+       (! SymTable_rehash(oDst, uBucketIndex)))
+      return FALSE;
+
+   uBucketCount = auBucketCount[oDst->uBucketIndex];
+   iSameCount = (oDst->uBucketIndex == oSrc->uBucketIndex);
+
+
+   for (i = 0; i < auBucketCount[oSrc->uBucketIndex]; i++) {
+
+      for (pbCurrent = oSrc->ppbBuckets[i]; pbCurrent != NULL;
+           pbCurrent = pbCurrent->pbNext) {
+
+         /* With equal bucket counts, a key keeps its bucket */
+         uIndex = iSameCount ? i :
+            SymTable_hash(pbCurrent->pcKey, uBucketCount);
+
+         for (pbFound = oDst->ppbBuckets[uIndex]; pbFound != NULL;
+              pbFound = pbFound->pbNext)
+            if (strcmp(pbFound->pcKey, pbCurrent->pcKey) == EQUAL)
+               break;
+
+         if (pbFound != NULL) {
+
+            if (eMerge == SYMTABLE_REPLACE)
+               pbFound->pvValue = pbCurrent->pvValue;
+
+            continue;
+         }
+
+
+         pbNewBinding = SymTable_newBinding(oDst, pbCurrent->pcKey,
+                                            pbCurrent->pvValue);
+
+         if (pbNewBinding == NULL)
+            return FALSE;
+
+         pbNewBinding->pbNext = oDst->ppbBuckets[uIndex];
+         oDst->ppbBuckets[uIndex] = pbNewBinding;
+
+         oDst->uLength++;
+      }
+   }
+
+   return TRUE;
+}
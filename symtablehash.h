@@ -0,0 +1,68 @@
+/*--------------------------------------------------------------------*/
+/* symtablehash.h                                                     */
+/* Author: Julio Lins (jcclb)                                         */
+/*--------------------------------------------------------------------*/
+
+#ifndef SYMTABLEHASH_H
+#define SYMTABLEHASH_H
+
+/*--------------------------------------------------------------------*/
+
+#include "symtable.h"
+
+/*--------------------------------------------------------------------*/
+
+/* Bulk operations provided by the hash table implementation of
+   symtable.h (symtablehash.c) */
+
+/*--------------------------------------------------------------------*/
+
+/* Return a new SymTable_T object with a binding for each of the
+   uLength keys of ppcKeys, whose value is the element of ppvValues
+   at the same position, or NULL if ppvValues is NULL, or return NULL
+   if insufficient memory is available. The result is the same as
+   putting every key in order into an empty table, so of equal keys
+   only the first is bound, but its bucket count is chosen up front
+   and the work is split among uThreadCount threads. Fewer threads
+   are used if some cannot be created */
+
+SymTable_T SymTable_buildParallel(const char *const *ppcKeys,
+                                  void *const *ppvValues,
+                                  size_t uLength, size_t uThreadCount);
+
+/*--------------------------------------------------------------------*/
+
+/* Return a new SymTable_T object with the bindings of oSymTable, or
+   NULL if insufficient memory is available. The copy has the bucket
+   count of oSymTable and keeps each Binding in the same bucket, so no
+   key is hashed and the copy never grows along the way. If oSymTable
+   borrows its keys, the copy borrows the same keys */
+
+SymTable_T SymTable_clone(SymTable_T oSymTable);
+
+/*--------------------------------------------------------------------*/
+
+/* What SymTable_merge does with a key bound in both tables:
+   SYMTABLE_KEEP leaves the binding of the destination as is, and
+   SYMTABLE_REPLACE gives it the value of the source */
+
+enum SymTableMerge {SYMTABLE_KEEP, SYMTABLE_REPLACE};
+
+/*--------------------------------------------------------------------*/
+
+/* Put each binding of oSrc into oDst, which must be another table,
+   dealing with keys bound in both as eMerge says. oDst grows at most
+   once, up front, to the bucket count that fits both tables, and
+   Bindings of oSrc are placed by their bucket in oSrc whenever the
+   two tables have the same bucket count. A replaced value is dropped,
+   not freed. If oDst borrows its keys, it borrows those of oSrc,
+   which must then outlive their bindings in oDst. Return 1 (TRUE) if
+   successful, or 0 (FALSE) if insufficient memory is available, in
+   which case oDst holds the bindings merged so far */
+
+int SymTable_merge(SymTable_T oDst, SymTable_T oSrc,
+                   enum SymTableMerge eMerge);
+
+/*--------------------------------------------------------------------*/
+
+#endif
@@ -0,0 +1,479 @@
+/*--------------------------------------------------------------------*/
+/* symtableint.c                                                      */
+/* author: Julio Lins (jcclb)                                         */
+/*--------------------------------------------------------------------*/
+
+#include "symtableint.h"
+#include <assert.h>
+#include <stdlib.h>
+#include <limits.h>
+
+/*--------------------------------------------------------------------*/
+
+/* Sequence of bucket counts for Symble Table expansion, that of
+   symtablehash.c */
+
+static const size_t auBucketCount[] = {509, 1021, 2039, 4093, 8191,
+                                       16381, 32749, 65521};
+
+
+/* Each key and respective value are stored in a Binding. Bindings
+   whose keys hash to the same code are linked to form a list */
+
+struct Binding {
+
+   /* key, stored in the Binding */
+   unsigned long ulKey;
+
+   /* value, owned by client */
+   void *pvValue;
+
+   /* The address of the next Binding on the list of same-hash-code
+      Bindings */
+   struct Binding *pbNext;
+};
+
+
+/* SymTableInt is a structure that points to all separate chains'
+   first Bindings. That is, to all Bindings that are first on their
+   list of same-hash-code Bindings */
+
+struct SymTableInt {
+
+   /* Index of auBucketCount[] leading to current bucket count for
+      SymTableInt object */
+   size_t uBucketIndex;
+
+   /* Pointer to the addresses of separate chains' first Bindings */
+   struct Binding **ppbBuckets;
+
+   /* size of Symble Table (total # of Bindings) */
+   size_t uLength;
+};
+
+
+
+SymTableInt_T SymTableInt_new(void) {
+
+   SymTableInt_T oSymTableInt;
+
+
+   oSymTableInt = (SymTableInt_T)malloc(sizeof(struct SymTableInt));
+
+   if (oSymTableInt == NULL)
+      return NULL;
+
+
+   oSymTableInt->ppbBuckets = (struct Binding**)
+      calloc(sizeof(struct Binding*), auBucketCount[0]);
+
+   if (oSymTableInt->ppbBuckets == NULL) {
+
+      free(oSymTableInt);
+      return NULL;
+   }
+
+   oSymTableInt->uLength = 0;
+   oSymTableInt->uBucketIndex = 0;
+
+   return oSymTableInt;
+}
+
+
+
+void SymTableInt_free(SymTableInt_T oSymTableInt) {
+
+   assert(oSymTableInt != NULL);
+
+   SymTableInt_freeWith(oSymTableInt, NULL);
+}
+
+
+
+void SymTableInt_freeWith(SymTableInt_T oSymTableInt,
+                          void (*pfFreeValue)(void *pvValue)) {
+
+   struct Binding *pbCurrent;
+   struct Binding *pbNext;
+   size_t i;
+
+
+   assert(oSymTableInt != NULL);
+
+
+   for (i = 0; i < auBucketCount[oSymTableInt->uBucketIndex]; i++) {
+
+      for (pbCurrent = oSymTableInt->ppbBuckets[i]; pbCurrent != NULL;
+           pbCurrent = pbNext) {
+
+         /* Save pointer to next Binding before freeing pbCurrent */
+         pbNext = pbCurrent->pbNext;
+
+         if (pfFreeValue != NULL)
+            (*pfFreeValue)(pbCurrent->pvValue);
+
+         free(pbCurrent);
+      }
+   }
+
+   free(oSymTableInt->ppbBuckets);
+   free(oSymTableInt);
+}
+
+
+size_t SymTableInt_getLength(SymTableInt_T oSymTableInt) {
+
+   assert(oSymTableInt != NULL);
+
+   return oSymTableInt->uLength;
+}
+
+
+
+/* Return a hash code for ulKey that is between 0 and uBucketCount-1,
+   inclusive. The bits of ulKey are mixed first, with the finalizer
+   of MurmurHash3, so that keys that differ by a multiple of the
+   bucket count, as strided keys do, still spread over the buckets */
+
+static size_t SymTableInt_hash(unsigned long ulKey,
+                               size_t uBucketCount) {
+
+#if ULONG_MAX > 0xFFFFFFFFUL
+   ulKey ^= ulKey >> 33;
+   ulKey *= 0xff51afd7ed558ccdUL;
+   ulKey ^= ulKey >> 33;
+   ulKey *= 0xc4ceb9fe1a85ec53UL;
+   ulKey ^= ulKey >> 33;
+#else
+   ulKey ^= ulKey >> 16;
+   ulKey *= 0x85ebca6bUL;
+   ulKey ^= ulKey >> 13;
+   ulKey *= 0xc2b2ae35UL;
+   ulKey ^= ulKey >> 16;
+#endif
+
+   return (size_t)(ulKey % uBucketCount);
+}
+
+
+/* Helper function that expands Symble Table to next bucket count,
+   relinking its Bindings rather than copying them. oSymTableInt is a
+   pointer to the Symble Table that will be expanded. If not enough
+   memory for expansion, oSymTableInt does not change */
+
+static void SymTableInt_grow(SymTableInt_T oSymTableInt) {
+
+   struct Binding **ppbNewBuckets;
+   struct Binding *pbCurrent;
+   struct Binding *pbNext;
+   size_t uNewCount;
+   size_t uIndex;
+   size_t i;
+
+
+   assert(oSymTableInt != NULL);
+
+   uNewCount = auBucketCount[oSymTableInt->uBucketIndex + 1];
+
+   ppbNewBuckets =
+      (struct Binding**)calloc(sizeof(struct Binding*), uNewCount);
+
+   if (ppbNewBuckets == NULL)
+      return;
+
+
+   for (i = 0; i < auBucketCount[oSymTableInt->uBucketIndex]; i++) {
+
+      for (pbCurrent = oSymTableInt->ppbBuckets[i]; pbCurrent != NULL;
+           pbCurrent = pbNext) {
+
+         /* Save pointer to next Binding before relinking pbCurrent */
+         pbNext = pbCurrent->pbNext;
+
+         uIndex = SymTableInt_hash(pbCurrent->ulKey, uNewCount);
+
+         pbCurrent->pbNext = ppbNewBuckets[uIndex];
+         ppbNewBuckets[uIndex] = pbCurrent;
+      }
+   }
+
+   free(oSymTableInt->ppbBuckets);
+
+   oSymTableInt->ppbBuckets = ppbNewBuckets;
+   oSymTableInt->uBucketIndex++;
+}
+
+
+int SymTableInt_put(SymTableInt_T oSymTableInt, unsigned long ulKey,
+                    const void *pvValue) {
+
+   size_t uMAX_INDEX;
+   size_t uIndex;
+   struct Binding *pbCurrent;
+   struct Binding *pbNewBinding;
+   enum {FALSE, TRUE};
+
+
+   assert(oSymTableInt != NULL);
+
+
+   uMAX_INDEX = sizeof(auBucketCount)/sizeof(size_t) - 1;
+
+   if ((oSymTableInt->uLength ==
+        auBucketCount[oSymTableInt->uBucketIndex]) &&
+       (oSymTableInt->uBucketIndex < uMAX_INDEX))
+      SymTableInt_grow(oSymTableInt);
+
+
+   uIndex = SymTableInt_hash(ulKey,
+                             auBucketCount[oSymTableInt->uBucketIndex]);
+
+
+   for (pbCurrent = oSymTableInt->ppbBuckets[uIndex]; pbCurrent != NULL;
+        pbCurrent = pbCurrent->pbNext)
+      if (pbCurrent->ulKey == ulKey)
+         return FALSE;
+
+
+   pbNewBinding = (struct Binding*)malloc(sizeof(struct Binding));
+
+   if (pbNewBinding == NULL)
+      return FALSE;
+
+
+   pbNewBinding->ulKey = ulKey;
+   pbNewBinding->pvValue = (void*)pvValue;
+
+   pbNewBinding->pbNext = oSymTableInt->ppbBuckets[uIndex];
+   oSymTableInt->ppbBuckets[uIndex] = pbNewBinding;
+
+
+   oSymTableInt->uLength++;
+
+   return TRUE;
+}
+
+/* Return Binding of corresponding key, if found. oSymTableInt is the
+   Symble Table object of which ulKey might or might not be a key. If
+   a search hit, it returns a pointer to ulKey's Binding. Else, it
+   returns NULL */
+
+static struct Binding *SymTableInt_find(SymTableInt_T oSymTableInt,
+                                        unsigned long ulKey) {
+
+   size_t uIndex;
+   struct Binding *pbCurrent;
+
+   assert(oSymTableInt != NULL);
+
+
+   uIndex = SymTableInt_hash(ulKey,
+                             auBucketCount[oSymTableInt->uBucketIndex]);
+
+
+   for (pbCurrent = oSymTableInt->ppbBuckets[uIndex]; pbCurrent != NULL;
+        pbCurrent = pbCurrent->pbNext)
+      if (pbCurrent->ulKey == ulKey)
+         return pbCurrent;
+
+   return NULL;
+}
+
+
+void *SymTableInt_replace(SymTableInt_T oSymTableInt,
+                          unsigned long ulKey, const void *pvValue) {
+
+   struct Binding *pbResult;
+   void *pvPrevious;
+
+
+   assert(oSymTableInt != NULL);
+
+   pbResult = SymTableInt_find(oSymTableInt, ulKey);
+
+   if (pbResult == NULL) return NULL;
+
+   pvPrevious = pbResult->pvValue;
+   pbResult->pvValue = (void*)pvValue;
+
+   return pvPrevious;
+
+}
+
+int SymTableInt_contains(SymTableInt_T oSymTableInt,
+                         unsigned long ulKey) {
+
+
+   struct Binding *pbResult;
+   enum {NOT_FOUND, FOUND};
+
+   assert(oSymTableInt != NULL);
+
+   pbResult = SymTableInt_find(oSymTableInt, ulKey);
+
+   if (pbResult == NULL) return NOT_FOUND;
+
+   return FOUND;
+}
+
+void *SymTableInt_get(SymTableInt_T oSymTableInt, unsigned long ulKey) {
+
+   struct Binding *pbResult;
+
+   assert(oSymTableInt != NULL);
+
+
+   pbResult = SymTableInt_find(oSymTableInt, ulKey);
+
+   if (pbResult == NULL) return NULL;
+
+   return pbResult->pvValue;
+
+}
+
+void *SymTableInt_remove(SymTableInt_T oSymTableInt,
+                         unsigned long ulKey) {
+
+
+   size_t uIndex;
+   void *pvValue;
+
+   struct Binding *pbPrev;
+   struct Binding *pbCurrent;
+
+
+   assert(oSymTableInt != NULL);
+
+
+   uIndex = SymTableInt_hash(ulKey,
+                             auBucketCount[oSymTableInt->uBucketIndex]);
+
+
+   pbCurrent = oSymTableInt->ppbBuckets[uIndex];
+   pbPrev = NULL;
+
+
+   while (pbCurrent != NULL) {
+
+      if (pbCurrent->ulKey == ulKey) {
+
+         /* if Binding is the first on the separate chain */
+         if (pbPrev == NULL)
+            oSymTableInt->ppbBuckets[uIndex] = pbCurrent->pbNext;
+
+         else
+            pbPrev->pbNext = pbCurrent->pbNext;
+
+
+         pvValue = pbCurrent->pvValue;
+
+         free(pbCurrent);
+
+         oSymTableInt->uLength--;
+
+         return pvValue;
+      }
+
+      pbPrev = pbCurrent;
+      pbCurrent = pbCurrent->pbNext;
+   }
+
+   return NULL;
+}
+
+
+void SymTableInt_map(SymTableInt_T oSymTableInt,
+                     void (*pfApply)(unsigned long ulKey,
+                                     void *pvValue, void *pvExtra),
+                     const void *pvExtra) {
+
+   size_t i;
+   struct Binding *pbCurrent;
+
+   assert(oSymTableInt != NULL);
+   assert(pfApply != NULL);
+
+
+   for (i = 0; i < auBucketCount[oSymTableInt->uBucketIndex]; i++) {
+
+      for (pbCurrent = oSymTableInt->ppbBuckets[i]; pbCurrent != NULL;
+           pbCurrent = pbCurrent->pbNext)
+
+         (*pfApply)(pbCurrent->ulKey, pbCurrent->pvValue,
+                    (void*)pvExtra);
+   }
+}
+
+
+/* Position psIter at the first Binding found in a bucket whose index
+   is at least uIndex, or at its end if there is no such Binding */
+
+static void SymTableInt_iterSeek(struct SymTableIntIter *psIter,
+                                 size_t uIndex) {
+
+   size_t uBucketCount;
+   struct Binding *pbCurrent;
+
+   assert(psIter != NULL);
+
+   uBucketCount = auBucketCount[psIter->oSymTableInt->uBucketIndex];
+
+   for (; uIndex < uBucketCount; uIndex++) {
+
+      pbCurrent = psIter->oSymTableInt->ppbBuckets[uIndex];
+
+      if (pbCurrent != NULL) {
+
+         psIter->uIndex = uIndex;
+         psIter->pvPosition = pbCurrent;
+         psIter->ulKey = pbCurrent->ulKey;
+         psIter->pvValue = pbCurrent->pvValue;
+         return;
+      }
+   }
+
+   psIter->uIndex = uBucketCount;
+   psIter->pvPosition = NULL;
+   psIter->ulKey = 0;
+   psIter->pvValue = NULL;
+}
+
+
+void SymTableInt_iterBegin(SymTableInt_T oSymTableInt,
+                           struct SymTableIntIter *psIter) {
+
+   assert(oSymTableInt != NULL);
+   assert(psIter != NULL);
+
+   psIter->oSymTableInt = oSymTableInt;
+
+   SymTableInt_iterSeek(psIter, 0);
+}
+
+void SymTableInt_iterNext(struct SymTableIntIter *psIter) {
+
+   struct Binding *pbNext;
+
+   assert(psIter != NULL);
+   assert(psIter->pvPosition != NULL);
+
+   pbNext = ((struct Binding*)psIter->pvPosition)->pbNext;
+
+   /* Stay on the same separate chain while it lasts */
+   if (pbNext != NULL) {
+
+      psIter->pvPosition = pbNext;
+      psIter->ulKey = pbNext->ulKey;
+      psIter->pvValue = pbNext->pvValue;
+      return;
+   }
+
+   SymTableInt_iterSeek(psIter, psIter->uIndex + 1);
+}
+
+int SymTableInt_iterEnd(const struct SymTableIntIter *psIter) {
+
+   assert(psIter != NULL);
+
+   return psIter->pvPosition == NULL;
+}
@@ -0,0 +1,160 @@
+/*--------------------------------------------------------------------*/
+/* symtableint.h                                                      */
+/* Author: Julio Lins (jcclb)                                         */
+/*--------------------------------------------------------------------*/
+
+#ifndef SYMTABLEINT_H
+#define SYMTABLEINT_H
+
+/*--------------------------------------------------------------------*/
+
+#include <stddef.h>
+
+/*--------------------------------------------------------------------*/
+
+/* A SymTableInt_T object is an unordered collection of key-value
+   bindings whose keys are integers. It is the hash table of
+   symtablehash.c with keys stored in the Bindings themselves instead
+   of formatted into strings: it grows through the same bucket counts,
+   and its map and iterator visit bindings in the same way.
+
+   Keys are unsigned long, the widest unsigned type of ANSI C, which
+   has 64 bits on the LP64 platforms we build for */
+
+typedef struct SymTableInt *SymTableInt_T;
+
+/*--------------------------------------------------------------------*/
+
+/* Return a new SymTableInt_T object, or NULL if insufficient memory
+   is available */
+
+SymTableInt_T SymTableInt_new(void);
+
+/*--------------------------------------------------------------------*/
+
+/* Free memory allocated by oSymTableInt */
+
+void SymTableInt_free(SymTableInt_T oSymTableInt);
+
+/*--------------------------------------------------------------------*/
+
+/* Free memory allocated by oSymTableInt, as SymTableInt_free does,
+   and also call (*pfFreeValue)(pvValue) on the value of each binding
+   during that same pass, unless pfFreeValue is NULL */
+
+void SymTableInt_freeWith(SymTableInt_T oSymTableInt,
+                          void (*pfFreeValue)(void *pvValue));
+
+/*--------------------------------------------------------------------*/
+
+/* Return length of oSymTableInt (i.e., number of bindings) */
+
+size_t SymTableInt_getLength(SymTableInt_T oSymTableInt);
+
+/*--------------------------------------------------------------------*/
+
+/* Add a binding with ulKey as key and pvValue as value to
+   oSymTableInt. Return 1 (TRUE) if insertion is successful, and 0
+   (FALSE) if there is insufficient memory or if there is already a
+   binding whose key is ulKey, in which case oSymTableInt is left
+   unchanged */
+
+int SymTableInt_put(SymTableInt_T oSymTableInt, unsigned long ulKey,
+                    const void *pvValue);
+
+/*--------------------------------------------------------------------*/
+
+/* If oSymTableInt contains a binding whose key is ulKey, assign
+   pvValue as the binding's new value and return its previous value.
+   Else, leave oSymTableInt unchanged and return NULL */
+
+void *SymTableInt_replace(SymTableInt_T oSymTableInt,
+                          unsigned long ulKey, const void *pvValue);
+
+/*--------------------------------------------------------------------*/
+
+/* Return 1 (TRUE) if oSymTableInt contains a binding whose key is
+   ulKey, 0 (FALSE) otherwise */
+
+int SymTableInt_contains(SymTableInt_T oSymTableInt,
+                         unsigned long ulKey);
+
+/*--------------------------------------------------------------------*/
+
+/* Return the value of the binding within oSymTableInt whose key is
+   ulKey, or NULL if no such binding exists */
+
+void *SymTableInt_get(SymTableInt_T oSymTableInt, unsigned long ulKey);
+
+/*--------------------------------------------------------------------*/
+
+/* If oSymTableInt contains a binding whose key is ulKey, remove such
+   binding and return its value. Else, leave oSymTableInt unchanged
+   and return NULL */
+
+void *SymTableInt_remove(SymTableInt_T oSymTableInt,
+                         unsigned long ulKey);
+
+/*--------------------------------------------------------------------*/
+
+/* Applies function pfApply to each binding in oSymTableInt, passing
+   each bindings' key (ulKey) and value (pvValue) as parameters, as
+   well as pvExtra as an extra parameter */
+
+void SymTableInt_map(SymTableInt_T oSymTableInt,
+                     void (*pfApply)(unsigned long ulKey,
+                                     void *pvValue, void *pvExtra),
+                     const void *pvExtra);
+
+/*--------------------------------------------------------------------*/
+
+/* A SymTableIntIter is an external cursor over the bindings of a
+   SymTableInt_T object, used as a SymTableIter is used over a
+   SymTable_T object. ulKey and pvValue hold the current binding while
+   SymTableInt_iterEnd returns 0 (FALSE). The remaining fields are
+   private to the implementation. Putting or removing bindings
+   invalidates every iterator over the table; SymTableInt_replace
+   does not. */
+
+struct SymTableIntIter {
+
+   /* key of the current binding */
+   unsigned long ulKey;
+
+   /* value of the current binding, owned by client */
+   void *pvValue;
+
+   /* table being traversed */
+   SymTableInt_T oSymTableInt;
+
+   /* index of the current bucket */
+   size_t uIndex;
+
+   /* current Binding, or NULL at the end */
+   void *pvPosition;
+};
+
+/*--------------------------------------------------------------------*/
+
+/* Position psIter at the first binding of oSymTableInt, if any */
+
+void SymTableInt_iterBegin(SymTableInt_T oSymTableInt,
+                           struct SymTableIntIter *psIter);
+
+/*--------------------------------------------------------------------*/
+
+/* Advance psIter to the next binding of its table. psIter must not be
+   at its end */
+
+void SymTableInt_iterNext(struct SymTableIntIter *psIter);
+
+/*--------------------------------------------------------------------*/
+
+/* Return 1 (TRUE) if psIter has gone past the last binding of its
+   table, 0 (FALSE) otherwise */
+
+int SymTableInt_iterEnd(const struct SymTableIntIter *psIter);
+
+/*--------------------------------------------------------------------*/
+
+#endif
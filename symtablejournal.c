@@ -0,0 +1,633 @@
+/*--------------------------------------------------------------------*/
+/* symtablejournal.c                                                  */
+/* author: Julio Lins (jcclb)                                         */
+/*--------------------------------------------------------------------*/
+
+/* open, fdatasync and friends are POSIX, not ANSI C */
+#define _POSIX_C_SOURCE 200112L
+
+#include "symtablejournal.h"
+#include <assert.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+
+/*--------------------------------------------------------------------*/
+
+/* A journal file starts with acMagic and sizeof(size_t) on the
+   machine that wrote it, followed by the records. A record is its
+   type, as one byte, the size of its key, '\0' included, and the size
+   of its value, both as size_t, then the key, the value and the
+   checksum of all the bytes before it, as size_t */
+
+/* Tag at the start of every journal file */
+
+static const char acMagic[8] = "SYMWAL1";
+
+/* Types of records */
+
+enum {RECORD_PUT = 'P', RECORD_REPLACE = 'R', RECORD_REMOVE = 'D'};
+
+/* # of bytes of a record before its key */
+
+enum {HEADER_SIZE = 1 + 2 * sizeof(size_t)};
+
+/* # of bytes of records buffered before they are written */
+
+enum {BUFFER_SIZE = 1 << 16};
+
+
+/* SymTableJournal is a structure that holds the table, the journal
+   file and the records not yet written to it */
+
+struct SymTableJournal {
+
+   /* table, owned by client */
+   SymTable_T oSymTable;
+
+   /* file descriptor of the journal file */
+   int iFd;
+
+   /* records not yet written */
+   char *pcBuffer;
+
+   /* # of bytes in pcBuffer */
+   size_t uBuffered;
+
+   /* 1 (TRUE) once a write to the file failed */
+   int iError;
+};
+
+
+
+/* Return the checksum of the uLength bytes at pc, continuing from
+   the checksum uSum of the bytes before them */
+
+static size_t SymTable_checksum(const char *pc, size_t uLength,
+                                size_t uSum)
+{
+   const size_t HASH_MULTIPLIER = 65599;
+   size_t u;
+
+   assert((pc != NULL) || (uLength == 0));
+
+   for (u = 0; u < uLength; u++)
+      uSum = uSum * HASH_MULTIPLIER + (size_t)(unsigned char)pc[u];
+
+   return uSum;
+}
+
+
+/* Write the uLength bytes at pc to the file descriptor iFd, retrying
+   partial writes. Return 1 (TRUE) if successful, or 0 (FALSE)
+   otherwise */
+
+static int SymTable_writeAll(int iFd, const char *pc, size_t uLength) {
+
+   ssize_t iWritten;
+   enum {FALSE, TRUE};
+
+   assert((pc != NULL) || (uLength == 0));
+
+   while (uLength > 0) {
+
+      iWritten = write(iFd, pc, uLength);
+
+      if (iWritten == -1) {
+
+         if (errno == EINTR)
+            continue;
+
+         return FALSE;
+      }
+
+      pc += iWritten;
+      uLength -= (size_t)iWritten;
+   }
+
+   return TRUE;
+}
+
+
+/* Write the records buffered by oSymTableJournal to its file, unless
+   a write already failed */
+
+static void SymTable_flush(SymTableJournal_T oSymTableJournal) {
+
+   enum {FALSE, TRUE};
+
+   assert(oSymTableJournal != NULL);
+
+   if (! oSymTableJournal->iError &&
+       ! SymTable_writeAll(oSymTableJournal->iFd,
+                           oSymTableJournal->pcBuffer,
+                           oSymTableJournal->uBuffered))
+      oSymTableJournal->iError = TRUE;
+
+   oSymTableJournal->uBuffered = 0;
+}
+
+
+/* Append the uLength bytes at pc to the records of
+   oSymTableJournal, writing the buffered ones first if they do not
+   fit */
+
+static void SymTable_append(SymTableJournal_T oSymTableJournal,
+                            const char *pc, size_t uLength) {
+
+   enum {FALSE, TRUE};
+
+   assert(oSymTableJournal != NULL);
+   assert((pc != NULL) || (uLength == 0));
+
+   if (uLength == 0)
+      return;
+
+   if (uLength > BUFFER_SIZE - oSymTableJournal->uBuffered)
+      SymTable_flush(oSymTableJournal);
+
+   /* Too large to buffer at all */
+   if (uLength > BUFFER_SIZE) {
+
+      if (! oSymTableJournal->iError &&
+          ! SymTable_writeAll(oSymTableJournal->iFd, pc, uLength))
+         oSymTableJournal->iError = TRUE;
+
+      return;
+   }
+
+   memcpy(oSymTableJournal->pcBuffer + oSymTableJournal->uBuffered, pc,
+          uLength);
+   oSymTableJournal->uBuffered += uLength;
+}
+
+
+/* Append a record of type iType, key pcKey and the uValueSize bytes
+   at pvValue to the records of oSymTableJournal */
+
+static void SymTable_record(SymTableJournal_T oSymTableJournal,
+                            int iType, const char *pcKey,
+                            const void *pvValue, size_t uValueSize) {
+
+   char acHeader[HEADER_SIZE];
+   size_t uKeySize;
+   size_t uSum;
+
+
+   assert(oSymTableJournal != NULL);
+   assert(pcKey != NULL);
+   assert((pvValue != NULL) || (uValueSize == 0));
+
+
+   uKeySize = strlen(pcKey) + 1;
+
+   acHeader[0] = (char)iType;
+   memcpy(acHeader + 1, &uKeySize, sizeof(size_t));
+   memcpy(acHeader + 1 + sizeof(size_t), &uValueSize, sizeof(size_t));
+
+   uSum = SymTable_checksum(acHeader, HEADER_SIZE, 0);
+   uSum = SymTable_checksum(pcKey, uKeySize, uSum);
+   uSum = SymTable_checksum((const char*)pvValue, uValueSize, uSum);
+
+   SymTable_append(oSymTableJournal, acHeader, HEADER_SIZE);
+   SymTable_append(oSymTableJournal, pcKey, uKeySize);
+   SymTable_append(oSymTableJournal, (const char*)pvValue, uValueSize);
+   SymTable_append(oSymTableJournal, (const char*)&uSum,
+                   sizeof(size_t));
+}
+
+
+/* Apply the record of type iType, key pcKey and the uValueSize bytes
+   at pcValue to oSymTable, making and freeing values as described
+   for SymTableJournal_open. Return 1 (TRUE) if successful, or 0
+   (FALSE) if the record does not fit oSymTable or insufficient
+   memory is available */
+
+static int SymTable_replay(SymTable_T oSymTable, int iType,
+                           const char *pcKey, const char *pcValue,
+                           size_t uValueSize,
+                           void *(*pfMakeValue)(const char *pcKey,
+                                                const char *pcValue,
+                                                size_t uValueSize,
+                                                void *pvExtra),
+                           void (*pfFreeValue)(void *pvValue),
+                           void *pvExtra) {
+
+   void *pvValue;
+   enum {FALSE, TRUE};
+
+
+   assert(oSymTable != NULL);
+   assert(pcKey != NULL);
+   assert(pcValue != NULL);
+
+
+   if ((iType != RECORD_PUT) && ! SymTable_contains(oSymTable, pcKey))
+      return FALSE;
+
+   if (iType == RECORD_REMOVE) {
+
+      pvValue = SymTable_remove(oSymTable, pcKey);
+
+      if (pfFreeValue != NULL)
+         (*pfFreeValue)(pvValue);
+
+      return TRUE;
+   }
+
+
+   pvValue = NULL;
+
+   if (pfMakeValue != NULL)
+      pvValue = (*pfMakeValue)(pcKey, pcValue, uValueSize, pvExtra);
+
+
+   if (iType == RECORD_PUT) {
+
+      if (SymTable_put(oSymTable, pcKey, pvValue))
+         return TRUE;
+
+      if (pfFreeValue != NULL)
+         (*pfFreeValue)(pvValue);
+
+      return FALSE;
+   }
+
+
+   pvValue = SymTable_replace(oSymTable, pcKey, pvValue);
+
+   if (pfFreeValue != NULL)
+      (*pfFreeValue)(pvValue);
+
+   return TRUE;
+}
+
+
+/* Replay the records of psFile, positioned right after the tag of a
+   journal file of uFileSize bytes, into oSymTable as described for
+   SymTableJournal_open. Set *puGoodSize to the # of bytes of the file
+   up to the end of the last whole record. Return 1 (TRUE) if
+   successful, or 0 (FALSE) if a record cannot be replayed or
+   insufficient memory is available */
+
+static int SymTable_replayFile(FILE *psFile, size_t uFileSize,
+                               size_t *puGoodSize,
+                               SymTable_T oSymTable,
+                               void *(*pfMakeValue)(
+                                  const char *pcKey,
+                                  const char *pcValue,
+                                  size_t uValueSize, void *pvExtra),
+                               void (*pfFreeValue)(void *pvValue),
+                               void *pvExtra) {
+
+   char acHeader[HEADER_SIZE];
+   char *pcRecord;
+   char *pcLarger;
+   size_t uRecordSize;
+   size_t uCapacity;
+   size_t uKeySize;
+   size_t uValueSize;
+   size_t uSum;
+   size_t uRemaining;
+   int iSuccessful;
+   enum {FALSE, TRUE};
+
+
+   assert(psFile != NULL);
+   assert(puGoodSize != NULL);
+   assert(oSymTable != NULL);
+
+
+   pcRecord = NULL;
+   uCapacity = 0;
+   iSuccessful = TRUE;
+
+   while (fread(acHeader, 1, HEADER_SIZE, psFile) == HEADER_SIZE) {
+
+      memcpy(&uKeySize, acHeader + 1, sizeof(size_t));
+      memcpy(&uValueSize, acHeader + 1 + sizeof(size_t),
+             sizeof(size_t));
+
+      /* Sizes beyond the end of the file were cut short */
+      uRemaining = uFileSize - *puGoodSize - HEADER_SIZE;
+
+      if ((uKeySize == 0) || (uKeySize > uRemaining) ||
+          (uValueSize > uRemaining - uKeySize) ||
+          (sizeof(size_t) > uRemaining - uKeySize - uValueSize))
+         break;
+
+      uRecordSize = uKeySize + uValueSize + sizeof(size_t);
+
+      if (uRecordSize > uCapacity) {
+
+         pcLarger = (char*)realloc(pcRecord, uRecordSize);
+
+         if (pcLarger == NULL) {
+
+            iSuccessful = FALSE;
+            break;
+         }
+
+         pcRecord = pcLarger;
+         uCapacity = uRecordSize;
+      }
+
+      if (fread(pcRecord, 1, uRecordSize, psFile) != uRecordSize)
+         break;
+
+
+      uSum = SymTable_checksum(acHeader, HEADER_SIZE, 0);
+      uSum = SymTable_checksum(pcRecord, uKeySize + uValueSize, uSum);
+
+      if ((memcmp(&uSum, pcRecord + uKeySize + uValueSize,
+                  sizeof(size_t)) != 0) ||
+          ((acHeader[0] != RECORD_PUT) &&
+           (acHeader[0] != RECORD_REPLACE) &&
+           (acHeader[0] != RECORD_REMOVE)) ||
+          (pcRecord[uKeySize - 1] != '\0') ||
+          (strlen(pcRecord) != uKeySize - 1))
+         break;
+
+
+      if (! SymTable_replay(oSymTable, acHeader[0], pcRecord,
+                            pcRecord + uKeySize, uValueSize,
+                            pfMakeValue, pfFreeValue, pvExtra)) {
+
+         iSuccessful = FALSE;
+         break;
+      }
+
+      *puGoodSize += HEADER_SIZE + uRecordSize;
+   }
+
+   free(pcRecord);
+
+   return iSuccessful && ! ferror(psFile);
+}
+
+
+/* Flush to disk the directory that holds the file named pcFileName,
+   so that the entry of a file just created in it survives a crash.
+   Return 1 (TRUE) if successful, or 0 (FALSE) otherwise */
+
+static int SymTable_syncDirectory(const char *pcFileName) {
+
+   const char *pcSlash;
+   char *pcDirectory;
+   size_t uLength;
+   int iFd;
+   int iSuccessful;
+   enum {FALSE, TRUE};
+
+   assert(pcFileName != NULL);
+
+   /* A name without a slash is in the working directory, and the
+      root keeps its slash */
+   pcSlash = strrchr(pcFileName, '/');
+
+   if (pcSlash == NULL) {
+
+      pcFileName = ".";
+      uLength = 1;
+   }
+   else if (pcSlash == pcFileName)
+      uLength = 1;
+   else
+      uLength = (size_t)(pcSlash - pcFileName);
+
+   pcDirectory = (char*)malloc(uLength + 1);
+
+   if (pcDirectory == NULL)
+      return FALSE;
+
+   memcpy(pcDirectory, pcFileName, uLength);
+   pcDirectory[uLength] = '\0';
+
+   iFd = open(pcDirectory, O_RDONLY);
+   free(pcDirectory);
+
+   if (iFd == -1)
+      return FALSE;
+
+   iSuccessful = (fsync(iFd) == 0);
+
+   if (close(iFd) == -1)
+      iSuccessful = FALSE;
+
+   return iSuccessful;
+}
+
+
+
+SymTableJournal_T SymTableJournal_open(
+   SymTable_T oSymTable, const char *pcFileName,
+   void *(*pfMakeValue)(const char *pcKey, const char *pcValue,
+                        size_t uValueSize, void *pvExtra),
+   void (*pfFreeValue)(void *pvValue), const void *pvExtra) {
+
+   SymTableJournal_T oSymTableJournal;
+   FILE *psFile;
+   struct stat sStat;
+   char acTag[sizeof(acMagic) + sizeof(size_t)];
+   size_t uWordSize;
+   size_t uFileSize;
+   size_t uGoodSize;
+   int iFd;
+   int iSuccessful;
+   enum {FALSE, TRUE};
+   enum {EQUAL};
+
+
+   assert(oSymTable != NULL);
+   assert(pcFileName != NULL);
+
+
+   oSymTableJournal =
+      (SymTableJournal_T)malloc(sizeof(struct SymTableJournal));
+
+   if (oSymTableJournal == NULL)
+      return NULL;
+
+   oSymTableJournal->pcBuffer = (char*)malloc(BUFFER_SIZE);
+
+   if (oSymTableJournal->pcBuffer == NULL) {
+
+      free(oSymTableJournal);
+      return NULL;
+   }
+
+
+   iFd = open(pcFileName, O_RDWR | O_CREAT | O_APPEND,
+              S_IRUSR | S_IWUSR);
+
+   if ((iFd == -1) || (fstat(iFd, &sStat) == -1)) {
+
+      if (iFd != -1)
+         close(iFd);
+      free(oSymTableJournal->pcBuffer);
+      free(oSymTableJournal);
+      return NULL;
+   }
+
+   oSymTableJournal->oSymTable = oSymTable;
+   oSymTableJournal->iFd = iFd;
+   oSymTableJournal->uBuffered = 0;
+   oSymTableJournal->iError = FALSE;
+
+   uFileSize = (size_t)sStat.st_size;
+   uWordSize = sizeof(size_t);
+
+
+   /* A new file gets its tag at once, and its directory entry is
+      made durable */
+   if (uFileSize == 0) {
+
+      memcpy(acTag, acMagic, sizeof(acMagic));
+      memcpy(acTag + sizeof(acMagic), &uWordSize, sizeof(size_t));
+
+      if (! SymTable_writeAll(iFd, acTag, sizeof(acTag)) ||
+          (fdatasync(iFd) == -1) ||
+          ! SymTable_syncDirectory(pcFileName)) {
+
+         SymTableJournal_close(oSymTableJournal);
+         return NULL;
+      }
+
+      return oSymTableJournal;
+   }
+
+
+   /* The records are read through a stream of a descriptor of their
+      own, so that reading does not move the one written to */
+   psFile = fopen(pcFileName, "rb");
+
+   if (psFile == NULL) {
+
+      SymTableJournal_close(oSymTableJournal);
+      return NULL;
+   }
+
+   uGoodSize = sizeof(acTag);
+
+   iSuccessful = (fread(acTag, 1, sizeof(acTag), psFile) ==
+                  sizeof(acTag)) &&
+      (memcmp(acTag, acMagic, sizeof(acMagic)) == EQUAL) &&
+      (memcmp(acTag + sizeof(acMagic), &uWordSize,
+              sizeof(size_t)) == EQUAL) &&
+      SymTable_replayFile(psFile, uFileSize, &uGoodSize, oSymTable,
+                          pfMakeValue, pfFreeValue, (void*)pvExtra);
+
+   fclose(psFile);
+
+
+   /* Bytes after the last whole record are discarded */
+   if (iSuccessful && (uGoodSize < uFileSize))
+      iSuccessful = (ftruncate(iFd, (off_t)uGoodSize) == 0) &&
+         (fdatasync(iFd) == 0);
+
+   if (! iSuccessful) {
+
+      SymTableJournal_close(oSymTableJournal);
+      return NULL;
+   }
+
+   return oSymTableJournal;
+}
+
+
+
+int SymTableJournal_close(SymTableJournal_T oSymTableJournal) {
+
+   int iSuccessful;
+
+   assert(oSymTableJournal != NULL);
+
+   iSuccessful = SymTableJournal_commit(oSymTableJournal);
+
+   if (close(oSymTableJournal->iFd) == -1)
+      iSuccessful = 0;
+
+   free(oSymTableJournal->pcBuffer);
+   free(oSymTableJournal);
+
+   return iSuccessful;
+}
+
+
+
+int SymTableJournal_commit(SymTableJournal_T oSymTableJournal) {
+
+   enum {FALSE, TRUE};
+
+   assert(oSymTableJournal != NULL);
+
+   SymTable_flush(oSymTableJournal);
+
+   /* One synchronization covers every record written since the last
+      commit */
+   if (! oSymTableJournal->iError &&
+       (fdatasync(oSymTableJournal->iFd) == -1))
+      oSymTableJournal->iError = TRUE;
+
+   return ! oSymTableJournal->iError;
+}
+
+
+
+int SymTableJournal_put(SymTableJournal_T oSymTableJournal,
+                        const char *pcKey, const void *pvValue,
+                        size_t uValueSize) {
+
+   enum {FALSE, TRUE};
+
+   assert(oSymTableJournal != NULL);
+   assert(pcKey != NULL);
+
+   if (! SymTable_put(oSymTableJournal->oSymTable, pcKey, pvValue))
+      return FALSE;
+
+   SymTable_record(oSymTableJournal, RECORD_PUT, pcKey, pvValue,
+                   uValueSize);
+
+   return TRUE;
+}
+
+
+
+void *SymTableJournal_replace(SymTableJournal_T oSymTableJournal,
+                              const char *pcKey, const void *pvValue,
+                              size_t uValueSize) {
+
+   assert(oSymTableJournal != NULL);
+   assert(pcKey != NULL);
+
+   /* SymTable_replace also returns NULL for a NULL value */
+   if (! SymTable_contains(oSymTableJournal->oSymTable, pcKey))
+      return NULL;
+
+   SymTable_record(oSymTableJournal, RECORD_REPLACE, pcKey, pvValue,
+                   uValueSize);
+
+   return SymTable_replace(oSymTableJournal->oSymTable, pcKey, pvValue);
+}
+
+
+
+void *SymTableJournal_remove(SymTableJournal_T oSymTableJournal,
+                             const char *pcKey) {
+
+   assert(oSymTableJournal != NULL);
+   assert(pcKey != NULL);
+
+   if (! SymTable_contains(oSymTableJournal->oSymTable, pcKey))
+      return NULL;
+
+   SymTable_record(oSymTableJournal, RECORD_REMOVE, pcKey, NULL, 0);
+
+   return SymTable_remove(oSymTableJournal->oSymTable, pcKey);
+}
@@ -0,0 +1,101 @@
+/*--------------------------------------------------------------------*/
+/* symtablejournal.h                                                  */
+/* Author: Julio Lins (jcclb)                                         */
+/*--------------------------------------------------------------------*/
+
+#ifndef SYMTABLEJOURNAL_H
+#define SYMTABLEJOURNAL_H
+
+#include "symtable.h"
+
+/*--------------------------------------------------------------------*/
+
+/* A SymTableJournal_T object makes the changes to a Symble Table
+   durable by appending a record of each one to a journal file, a
+   write-ahead log. The records are buffered, so that the changes made
+   between two calls of SymTableJournal_commit are written together
+   and synchronized to disk once. When a journal is opened, the
+   records already in its file are replayed into the table, so that
+   the table is as it was after the last commit before a restart.
+
+   A record holds the key and a copy of the value of a change, so each
+   value is given along with its size, in bytes. When records are
+   replayed, values are made back from those bytes by the client.
+
+   The table must only be changed through its journal while the
+   journal is open. The file can only be replayed on a machine with
+   the same word size and byte order as the one that wrote it */
+
+typedef struct SymTableJournal *SymTableJournal_T;
+
+/*--------------------------------------------------------------------*/
+
+/* Open the journal file named pcFileName, creating it if it does not
+   exist, and replay its records into oSymTable, which must hold the
+   bindings it held when the file was created: usually none. The value
+   of each binding replayed is (*pfMakeValue)(pcKey, pcValue,
+   uValueSize, pvExtra), where pcValue points to the uValueSize bytes
+   recorded; it is only valid during the call. Values replaced or
+   removed while replaying are passed to pfFreeValue, unless it is
+   NULL. A record cut short by a crash, and any bytes after it, are
+   discarded, as is a record whose checksum does not match. A file
+   created is on disk, with its directory entry, once the call
+   returns. Return a journal of oSymTable, or NULL if the file cannot
+   be opened or read, a record cannot be replayed, or insufficient
+   memory is available; oSymTable then holds the bindings replayed so
+   far */
+
+SymTableJournal_T SymTableJournal_open(
+   SymTable_T oSymTable, const char *pcFileName,
+   void *(*pfMakeValue)(const char *pcKey, const char *pcValue,
+                        size_t uValueSize, void *pvExtra),
+   void (*pfFreeValue)(void *pvValue), const void *pvExtra);
+
+/*--------------------------------------------------------------------*/
+
+/* Commit oSymTableJournal and close its file. The table stays with
+   the client. Return 1 (TRUE) if every change was committed, or 0
+   (FALSE) otherwise */
+
+int SymTableJournal_close(SymTableJournal_T oSymTableJournal);
+
+/*--------------------------------------------------------------------*/
+
+/* Write the records of every change made since the last commit to
+   the file of oSymTableJournal and wait until they reach the disk.
+   Return 1 (TRUE) if successful, or 0 (FALSE) if the file cannot be
+   written, now or at an earlier write. Once a write fails, the file
+   no longer follows the table and every later commit fails */
+
+int SymTableJournal_commit(SymTableJournal_T oSymTableJournal);
+
+/*--------------------------------------------------------------------*/
+
+/* As SymTable_put on the table of oSymTableJournal, also recording
+   the uValueSize bytes at pvValue if the binding is added */
+
+int SymTableJournal_put(SymTableJournal_T oSymTableJournal,
+                        const char *pcKey, const void *pvValue,
+                        size_t uValueSize);
+
+/*--------------------------------------------------------------------*/
+
+/* As SymTable_replace on the table of oSymTableJournal, also
+   recording the uValueSize bytes at pvValue if the value is
+   replaced */
+
+void *SymTableJournal_replace(SymTableJournal_T oSymTableJournal,
+                              const char *pcKey, const void *pvValue,
+                              size_t uValueSize);
+
+/*--------------------------------------------------------------------*/
+
+/* As SymTable_remove on the table of oSymTableJournal, also recording
+   the removal if a binding is removed */
+
+void *SymTableJournal_remove(SymTableJournal_T oSymTableJournal,
+                             const char *pcKey);
+
+/*--------------------------------------------------------------------*/
+
+#endif
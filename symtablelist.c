@@ -10,13 +10,39 @@
 
 /*--------------------------------------------------------------------*/
 
+/* Number of bindings a Symble Table keeps inline, in a contiguous
+   array inside struct SymTable, before it moves them to Nodes */
+
+enum {INLINE_CAPACITY = 8};
+
+/* Define SYMTABLE_MOVE_TO_FRONT (e.g., CFLAGS = -D
+   SYMTABLE_MOVE_TO_FRONT) to move each binding found by a lookup to
+   the front of the table, so that hot keys are compared first. It is
+   off by default because lookups then reorder the table, which
+   invalidates iterators */
+
+
+/* Each key and respective value of a small Symble Table are stored in
+   a Binding of its inline array */
+
+struct Binding {
+
+   /* key, owned by implementation through defensive copy unless
+      the table borrows its keys */
+   const char *pcKey;
+
+   /* value, owned by client */
+   void *pvValue;
+};
+
 
 /* Each key and respective value are stored in a Node. Nodes are linked
    to form a list */
 
 struct Node {
 
-   /* key, owned by implementation through defensive copy */
+   /* key, owned by implementation through defensive copy unless
+      the table borrows its keys */
    const char *pcKey;
 
    /* value, owned by client */
@@ -27,115 +53,313 @@ struct Node {
 };
 
 
-/* SymTable is a structure that points to the first Node */
+/* SymTable is a structure that holds up to INLINE_CAPACITY Bindings
+   inline, or points to the first Node once it has outgrown them */
 
 struct SymTable {
 
-   /* Address of the list's first Node */
+   /* Address of the list's first Node, NULL while iIsList is 0 */
    struct Node *pnFirst;
 
-   /* size of Symble Table (total # of Nodes) */
+   /* size of Symble Table (total # of Bindings or Nodes) */
    size_t uLength;
+
+   /* 1 (TRUE) if bindings are stored in Nodes, 0 (FALSE) if they are
+      stored in abInline */
+   int iIsList;
+
+   /* 1 (TRUE) if keys are borrowed from the client rather than
+      owned through defensive copies */
+   int iBorrowsKeys;
+
+   /* Bindings of a small Symble Table, the first uLength in use */
+   struct Binding abInline[INLINE_CAPACITY];
 };
 
 
 SymTable_T SymTable_new(void) {
 
    SymTable_T oSymTable;
+   enum {FALSE, TRUE};
 
    oSymTable = (SymTable_T)malloc(sizeof(struct SymTable));
 
    if (oSymTable == NULL)
       return NULL;
-   
+
    oSymTable->pnFirst = NULL;
    oSymTable->uLength = 0;
-   
+   oSymTable->iIsList = FALSE;
+   oSymTable->iBorrowsKeys = FALSE;
+
    return oSymTable;
 }
 
 
-void SymTable_free(SymTable_T oSymTable) {
+SymTable_T SymTable_newBorrowedKeys(void) {
+
+   SymTable_T oSymTable;
+   enum {FALSE, TRUE};
+
+   oSymTable = SymTable_new();
+
+   if (oSymTable == NULL)
+      return NULL;
+
+   oSymTable->iBorrowsKeys = TRUE;
+
+   return oSymTable;
+}
+
+
+/* Helper function that frees every binding of oSymTable and its key,
+   also calling pfFreeValue on its value unless pfFreeValue is NULL.
+   oSymTable is left empty, with its bindings back inline */
+
+static void SymTable_freeBindings(SymTable_T oSymTable,
+                                  void (*pfFreeValue)(void *pvValue)) {
 
    struct Node *pnNext;
    struct Node *pnCurrent;
+   size_t i;
+   enum {FALSE, TRUE};
+
 
-   
    assert(oSymTable != NULL);
 
-   
+
+   if (! oSymTable->iIsList) {
+
+      for (i = 0; i < oSymTable->uLength; i++) {
+
+         if (! oSymTable->iBorrowsKeys)
+            free((void*)oSymTable->abInline[i].pcKey);
+
+         if (pfFreeValue != NULL)
+            (*pfFreeValue)(oSymTable->abInline[i].pvValue);
+      }
+
+      oSymTable->uLength = 0;
+      return;
+   }
+
+
    pnCurrent = oSymTable->pnFirst;
 
-   
+
    while (pnCurrent != NULL) {
 
       /* Save pointer to next Node before freeing pnCurrent */
       pnNext = pnCurrent->pnNext;
 
-      
-      free((void*)pnCurrent->pcKey);
-      
+
+      if (! oSymTable->iBorrowsKeys)
+         free((void*)pnCurrent->pcKey);
+
+      if (pfFreeValue != NULL)
+         (*pfFreeValue)(pnCurrent->pvValue);
+
       free(pnCurrent);
 
       pnCurrent = pnNext;
    }
-   
+
+   oSymTable->pnFirst = NULL;
+   oSymTable->uLength = 0;
+   oSymTable->iIsList = FALSE;
+}
+
+
+void SymTable_free(SymTable_T oSymTable) {
+
+   assert(oSymTable != NULL);
+
+   SymTable_freeWith(oSymTable, NULL);
+}
+
+
+
+void SymTable_freeWith(SymTable_T oSymTable,
+                       void (*pfFreeValue)(void *pvValue)) {
+
+   assert(oSymTable != NULL);
+
+   SymTable_freeBindings(oSymTable, pfFreeValue);
+
    free(oSymTable);
 }
 
 
+
+void SymTable_clear(SymTable_T oSymTable,
+                    void (*pfFreeValue)(void *pvValue)) {
+
+   assert(oSymTable != NULL);
+
+   SymTable_freeBindings(oSymTable, pfFreeValue);
+}
+
+
 size_t SymTable_getLength(SymTable_T oSymTable) {
 
    assert(oSymTable != NULL);
-   
+
    return oSymTable->uLength;
 }
 
 
+/* Helper function that moves the inline Bindings of oSymTable, which
+   must be full, to a list of Nodes. Return 1 (TRUE) if successful, or
+   0 (FALSE) if not enough memory, in which case oSymTable does not
+   change */
+
+static int SymTable_spill(SymTable_T oSymTable) {
+
+   struct Node *pnFirst;
+   struct Node *pnNewNode;
+   size_t i;
+   enum {FALSE, TRUE};
+
+   assert(oSymTable != NULL);
+   assert(! oSymTable->iIsList);
+
+   pnFirst = NULL;
+
+   for (i = oSymTable->uLength; i > 0; i--) {
+
+      pnNewNode = (struct Node*)malloc(sizeof(struct Node));
+
+      if (pnNewNode == NULL) {
+
+         /* Undo: the keys still belong to abInline */
+         while (pnFirst != NULL) {
+
+            pnNewNode = pnFirst->pnNext;
+            free(pnFirst);
+            pnFirst = pnNewNode;
+         }
+
+         return FALSE;
+      }
+
+      /* Built back to front, so the list keeps the inline order */
+      pnNewNode->pcKey = oSymTable->abInline[i - 1].pcKey;
+      pnNewNode->pvValue = oSymTable->abInline[i - 1].pvValue;
+      pnNewNode->pnNext = pnFirst;
+
+      pnFirst = pnNewNode;
+   }
+
+   oSymTable->pnFirst = pnFirst;
+   oSymTable->iIsList = TRUE;
+
+   return TRUE;
+}
+
+
+/* Return the key to store for pcKey in oSymTable: a defensive copy
+   of pcKey, or pcKey itself if oSymTable borrows its keys. Return
+   NULL if there is not enough memory for the copy */
+
+static char *SymTable_copyKey(SymTable_T oSymTable, const char *pcKey) {
+
+   char *pcCopy;
+
+   assert(oSymTable != NULL);
+   assert(pcKey != NULL);
+
+   if (oSymTable->iBorrowsKeys)
+      return (char*)pcKey;
+
+   pcCopy = (char*)malloc(strlen(pcKey) + 1);
+
+   if (pcCopy == NULL)
+      return NULL;
+
+   return strcpy(pcCopy, pcKey);
+}
+
+
 int SymTable_put(SymTable_T oSymTable, const char *pcKey,
                  const void *pvValue) {
 
    struct Node *pnNewNode;
    struct Node *pnCurrent;
    char *pcCopy;
+   size_t i;
    enum {FALSE, TRUE};
    enum {EQUAL};
 
-   
+
    assert(oSymTable != NULL);
    assert(pcKey != NULL);
 
-   
-   pnCurrent = oSymTable->pnFirst;
-   
-   
-   while(pnCurrent != NULL) {
+
+   if (! oSymTable->iIsList) {
 
       /* if key is already stored, do not put it again */
-      if (strcmp(pnCurrent->pcKey, pcKey) == EQUAL)
+      for (i = 0; i < oSymTable->uLength; i++)
+         if (strcmp(oSymTable->abInline[i].pcKey, pcKey) == EQUAL)
+            return FALSE;
+
+      pcCopy = SymTable_copyKey(oSymTable, pcKey);
+
+      if (pcCopy == NULL)
          return FALSE;
 
-      pnCurrent = pnCurrent->pnNext;
+
+      if (oSymTable->uLength < INLINE_CAPACITY) {
+
+         oSymTable->abInline[oSymTable->uLength].pcKey = pcCopy;
+         oSymTable->abInline[oSymTable->uLength].pvValue =
+            (void*)pvValue;
+
+         oSymTable->uLength++;
+
+         return TRUE;
+      }
+
+
+      /* No room left inline: the table becomes a list */
+      if (! SymTable_spill(oSymTable)) {
+
+         if (! oSymTable->iBorrowsKeys)
+            free(pcCopy);
+         return FALSE;
+      }
+   }
+
+   else {
+
+      pnCurrent = oSymTable->pnFirst;
+
+
+      while(pnCurrent != NULL) {
+
+         /* if key is already stored, do not put it again */
+         if (strcmp(pnCurrent->pcKey, pcKey) == EQUAL)
+            return FALSE;
+
+         pnCurrent = pnCurrent->pnNext;
+      }
+
+      pcCopy = SymTable_copyKey(oSymTable, pcKey);
+
+      if (pcCopy == NULL)
+         return FALSE;
    }
 
-   
+
    pnNewNode = (struct Node*)malloc(sizeof(struct Node));
 
-   if (pnNewNode == NULL)
-      return FALSE;
+   if (pnNewNode == NULL) {
 
-   /* Makes and assigns defensive copy */
-   pcCopy = (char*)malloc(strlen(pcKey) + 1);
-   
-   if (pcCopy == NULL) {
+      if (! oSymTable->iBorrowsKeys)
+         free(pcCopy);
 
-      free(pnNewNode);
-      
       return FALSE;
    }
 
-   pcCopy = strcpy(pcCopy, pcKey);
-   
    pnNewNode->pcKey = pcCopy;
 
 
@@ -145,35 +369,79 @@ int SymTable_put(SymTable_T oSymTable, const char *pcKey,
    pnNewNode->pnNext = oSymTable->pnFirst;
    oSymTable->pnFirst = pnNewNode;
 
-   
+
    oSymTable->uLength++;
 
 
    return TRUE;
 }
 
-/* Return Node of corresponding key, if found. oSymTable is the Symble
-   Table object of which pcKey might or might not be a key. If a search
-   hit, it returns a pointer to pcKey's Node. Else, it returns NULL */
+/* Return the address of the value of the binding whose key is pcKey,
+   if found. oSymTable is the Symble Table object of which pcKey might
+   or might not be a key. If a search hit, it returns the address
+   where pcKey's value is stored. Else, it returns NULL */
 
-static struct Node *SymTable_find(SymTable_T oSymTable,
-                                 const char *pcKey) {
+static void **SymTable_find(SymTable_T oSymTable, const char *pcKey) {
 
    enum {EQUAL};
    struct Node *pnCurrent;
+   size_t i;
+#ifdef SYMTABLE_MOVE_TO_FRONT
+   struct Node *pnPrev;
+   struct Binding bHit;
+#endif
 
 
    /* Redundant, but just so that critTer doesn't complain */
    assert(oSymTable != NULL);
    assert(pcKey != NULL);
 
+
+   if (! oSymTable->iIsList) {
+
+      for (i = 0; i < oSymTable->uLength; i++) {
+
+         if (strcmp(oSymTable->abInline[i].pcKey, pcKey) == EQUAL) {
+
+#ifdef SYMTABLE_MOVE_TO_FRONT
+            bHit = oSymTable->abInline[i];
+
+            for (; i > 0; i--)
+               oSymTable->abInline[i] = oSymTable->abInline[i - 1];
+
+            oSymTable->abInline[0] = bHit;
+#endif
+            return &oSymTable->abInline[i].pvValue;
+         }
+      }
+
+      return NULL;
+   }
+
+
    pnCurrent = oSymTable->pnFirst;
+#ifdef SYMTABLE_MOVE_TO_FRONT
+   pnPrev = NULL;
+#endif
 
    while (pnCurrent != NULL) {
 
-      if (strcmp(pnCurrent->pcKey, pcKey) == EQUAL)
-         return pnCurrent; 
+      if (strcmp(pnCurrent->pcKey, pcKey) == EQUAL) {
+
+#ifdef SYMTABLE_MOVE_TO_FRONT
+         if (pnPrev != NULL) {
 
+            pnPrev->pnNext = pnCurrent->pnNext;
+            pnCurrent->pnNext = oSymTable->pnFirst;
+            oSymTable->pnFirst = pnCurrent;
+         }
+#endif
+         return &pnCurrent->pvValue;
+      }
+
+#ifdef SYMTABLE_MOVE_TO_FRONT
+      pnPrev = pnCurrent;
+#endif
       pnCurrent = pnCurrent->pnNext;
    }
 
@@ -183,19 +451,19 @@ static struct Node *SymTable_find(SymTable_T oSymTable,
 void *SymTable_replace(SymTable_T oSymTable, const char *pcKey,
                        const void *pvValue) {
 
-   struct Node *pnResult;
+   void **ppvResult;
    void *pvPrevious;
-   
+
    assert(oSymTable != NULL);
    assert(pcKey != NULL);
-   
 
-   pnResult = SymTable_find(oSymTable, pcKey);
 
-   if (pnResult == NULL) return NULL;
+   ppvResult = SymTable_find(oSymTable, pcKey);
+
+   if (ppvResult == NULL) return NULL;
 
-   pvPrevious = pnResult->pvValue;
-   pnResult->pvValue = (void*)pvValue;
+   pvPrevious = *ppvResult;
+   *ppvResult = (void*)pvValue;
 
    return pvPrevious;
 }
@@ -203,28 +471,28 @@ void *SymTable_replace(SymTable_T oSymTable, const char *pcKey,
 int SymTable_contains(SymTable_T oSymTable, const char *pcKey) {
 
    enum {NOT_FOUND, FOUND};
-   
+
    assert(oSymTable != NULL);
    assert(pcKey != NULL);
 
    if (SymTable_find(oSymTable, pcKey) == NULL) return NOT_FOUND;
 
    return FOUND;
-   
+
 }
 
 void *SymTable_get(SymTable_T oSymTable, const char *pcKey) {
 
-   struct Node *pnResult;
-   
+   void **ppvResult;
+
    assert(oSymTable != NULL);
    assert(pcKey != NULL);
 
-   pnResult = SymTable_find(oSymTable, pcKey);
+   ppvResult = SymTable_find(oSymTable, pcKey);
 
-   if (pnResult == NULL) return NULL;
+   if (ppvResult == NULL) return NULL;
 
-   return pnResult->pvValue;
+   return *ppvResult;
 }
 
 void *SymTable_remove(SymTable_T oSymTable, const char *pcKey) {
@@ -232,18 +500,45 @@ void *SymTable_remove(SymTable_T oSymTable, const char *pcKey) {
    struct Node *pnPrev;
    struct Node *pnCurrent;
    void *pvValue;
+   size_t i;
+   enum {FALSE, TRUE};
    enum {EQUAL};
-   
-   
+
+
    assert(oSymTable != NULL);
    assert(pcKey != NULL);
 
-   
+
+   if (! oSymTable->iIsList) {
+
+      for (i = 0; i < oSymTable->uLength; i++) {
+
+         if (strcmp(oSymTable->abInline[i].pcKey, pcKey) == EQUAL) {
+
+            pvValue = oSymTable->abInline[i].pvValue;
+
+            if (! oSymTable->iBorrowsKeys)
+               free((void*)oSymTable->abInline[i].pcKey);
+
+            /* Close the gap, keeping the remaining order */
+            for (; i + 1 < oSymTable->uLength; i++)
+               oSymTable->abInline[i] = oSymTable->abInline[i + 1];
+
+            oSymTable->uLength--;
+
+            return pvValue;
+         }
+      }
+
+      return NULL;
+   }
+
+
    pnCurrent = oSymTable->pnFirst;
 
-   
+
    pnPrev = NULL;
-   
+
    while (pnCurrent != NULL) {
 
       if (strcmp(pnCurrent->pcKey, pcKey) == EQUAL) {
@@ -254,17 +549,22 @@ void *SymTable_remove(SymTable_T oSymTable, const char *pcKey) {
 
          else
             pnPrev->pnNext = pnCurrent->pnNext;
-         
-         
+
+
          pvValue = pnCurrent->pvValue;
 
-         
-         free((void*)pnCurrent->pcKey);
+
+         if (! oSymTable->iBorrowsKeys)
+            free((void*)pnCurrent->pcKey);
 
          free(pnCurrent);
 
          oSymTable->uLength--;
 
+         /* An emptied list starts over with the inline array */
+         if (oSymTable->uLength == 0)
+            oSymTable->iIsList = FALSE;
+
          return pvValue;
       }
 
@@ -273,7 +573,7 @@ void *SymTable_remove(SymTable_T oSymTable, const char *pcKey) {
    }
 
    return NULL;
-   
+
 }
 
 void SymTable_map(SymTable_T oSymTable,
@@ -281,14 +581,26 @@ void SymTable_map(SymTable_T oSymTable,
                                   void *pvExtra), const void *pvExtra) {
 
    struct Node *pnCurrent;
-   
+   size_t i;
+
    assert(oSymTable != NULL);
    assert(pfApply != NULL);
 
-   
+
+   if (! oSymTable->iIsList) {
+
+      for (i = 0; i < oSymTable->uLength; i++)
+         (*pfApply)(oSymTable->abInline[i].pcKey,
+                    oSymTable->abInline[i].pvValue,
+                    (void*)pvExtra);
+
+      return;
+   }
+
+
    pnCurrent = oSymTable->pnFirst;
 
-   
+
    while (pnCurrent != NULL) {
 
       (*pfApply)((void*)pnCurrent->pcKey,
@@ -298,3 +610,170 @@ void SymTable_map(SymTable_T oSymTable,
       pnCurrent = pnCurrent->pnNext;
    }
 }
+
+
+/* Add to the estimate of psMemory the bytes that malloc adds to a
+   block of uSize bytes */
+
+static void SymTable_addOverhead(struct SymTableMemory *psMemory,
+                                 size_t uSize) {
+
+   const size_t uWord = sizeof(size_t);
+   size_t uChunk;
+
+   assert(psMemory != NULL);
+
+   uChunk = (uSize + 3 * uWord - 1) / (2 * uWord) * (2 * uWord);
+
+   if (uChunk < 4 * uWord)
+      uChunk = 4 * uWord;
+
+   psMemory->uOverheadBytes += uChunk - uSize;
+}
+
+
+/* Add to psMemory the copy of pcKey held by oSymTable, if any */
+
+static void SymTable_addKey(SymTable_T oSymTable,
+                            struct SymTableMemory *psMemory,
+                            const char *pcKey) {
+
+   size_t uKeySize;
+
+   assert(oSymTable != NULL);
+   assert(psMemory != NULL);
+   assert(pcKey != NULL);
+
+   if (oSymTable->iBorrowsKeys)
+      return;
+
+   uKeySize = strlen(pcKey) + 1;
+   psMemory->uKeyBytes += uKeySize;
+   SymTable_addOverhead(psMemory, uKeySize);
+}
+
+
+void SymTable_memoryUsage(SymTable_T oSymTable,
+                          struct SymTableMemory *psMemory) {
+
+   struct Node *pnCurrent;
+   size_t i;
+
+   assert(oSymTable != NULL);
+   assert(psMemory != NULL);
+
+   /* The inline Bindings are part of struct SymTable */
+   psMemory->uTableBytes = sizeof(struct SymTable);
+   psMemory->uBindingBytes = 0;
+   psMemory->uKeyBytes = 0;
+   psMemory->uOverheadBytes = 0;
+
+   SymTable_addOverhead(psMemory, sizeof(struct SymTable));
+
+
+   if (! oSymTable->iIsList) {
+
+      for (i = 0; i < oSymTable->uLength; i++)
+         SymTable_addKey(oSymTable, psMemory,
+                         oSymTable->abInline[i].pcKey);
+
+      return;
+   }
+
+
+   for (pnCurrent = oSymTable->pnFirst; pnCurrent != NULL;
+        pnCurrent = pnCurrent->pnNext) {
+
+      psMemory->uBindingBytes += sizeof(struct Node);
+      SymTable_addOverhead(psMemory, sizeof(struct Node));
+      SymTable_addKey(oSymTable, psMemory, pnCurrent->pcKey);
+   }
+}
+
+
+/* Position psIter at Node pnCurrent, or at its end if pnCurrent is
+   NULL */
+
+static void SymTable_iterSeek(struct SymTableIter *psIter,
+                              struct Node *pnCurrent) {
+
+   assert(psIter != NULL);
+
+   psIter->pvPosition = pnCurrent;
+
+   if (pnCurrent == NULL) {
+
+      psIter->pcKey = NULL;
+      psIter->pvValue = NULL;
+      return;
+   }
+
+   psIter->pcKey = pnCurrent->pcKey;
+   psIter->pvValue = pnCurrent->pvValue;
+}
+
+/* Position psIter at inline Binding uIndex of its table, or at its
+   end if there is no such Binding */
+
+static void SymTable_iterSeekInline(struct SymTableIter *psIter,
+                                    size_t uIndex) {
+
+   SymTable_T oSymTable;
+
+   assert(psIter != NULL);
+
+   oSymTable = psIter->oSymTable;
+   psIter->uIndex = uIndex;
+
+   if (uIndex >= oSymTable->uLength) {
+
+      psIter->pvPosition = NULL;
+      psIter->pcKey = NULL;
+      psIter->pvValue = NULL;
+      return;
+   }
+
+   psIter->pvPosition = &oSymTable->abInline[uIndex];
+   psIter->pcKey = oSymTable->abInline[uIndex].pcKey;
+   psIter->pvValue = oSymTable->abInline[uIndex].pvValue;
+}
+
+void SymTable_iterBegin(SymTable_T oSymTable,
+                        struct SymTableIter *psIter) {
+
+   assert(oSymTable != NULL);
+   assert(psIter != NULL);
+
+   psIter->oSymTable = oSymTable;
+   psIter->uIndex = 0;
+
+   if (! oSymTable->iIsList) {
+
+      SymTable_iterSeekInline(psIter, 0);
+      return;
+   }
+
+   SymTable_iterSeek(psIter, oSymTable->pnFirst);
+}
+
+void SymTable_iterNext(struct SymTableIter *psIter) {
+
+   assert(psIter != NULL);
+   assert(psIter->pvPosition != NULL);
+
+   if (! psIter->oSymTable->iIsList) {
+
+      SymTable_iterSeekInline(psIter, psIter->uIndex + 1);
+      return;
+   }
+
+   SymTable_iterSeek(psIter,
+                     ((struct Node*)psIter->pvPosition)->pnNext);
+}
+
+int SymTable_iterEnd(const struct SymTableIter *psIter) {
+
+   assert(psIter != NULL);
+
+   return psIter->pvPosition == NULL;
+}
@@ -0,0 +1,500 @@
+/*--------------------------------------------------------------------*/
+/* symtableload.c                                                     */
+/* author: Julio Lins (jcclb)                                         */
+/*--------------------------------------------------------------------*/
+
+/* Threads are POSIX, not ANSI C */
+#define _POSIX_C_SOURCE 200112L
+
+#include "symtableload.h"
+#include <assert.h>
+#include <string.h>
+#include <stdlib.h>
+#include <pthread.h>
+
+/*--------------------------------------------------------------------*/
+
+/* # of bytes of the file read at a time */
+
+enum {CHUNK_SIZE = 1 << 20};
+
+/* # of bytes of the longest line, its newline not included, or record
+   accepted */
+
+enum {MAX_RECORD_SIZE = 1 << 16};
+
+
+/* A Chunk is one of the two buffers the file is read into. Its data
+   is preceded by MAX_RECORD_SIZE bytes, where the incomplete line or
+   record at the end of the other Chunk is moved, and followed by one
+   byte for a '\0' */
+
+struct Chunk {
+
+   /* first byte read into the Chunk */
+   char *pcData;
+
+   /* # of bytes read into the Chunk, less than CHUNK_SIZE only for the
+      last one */
+   size_t uLength;
+
+   /* 1 (TRUE) if the Chunk was read and not yet parsed */
+   int iFull;
+};
+
+
+/* A Loader is shared by the thread that reads the file and the one
+   that parses it and adds bindings */
+
+struct Loader {
+
+   /* table the bindings are added to */
+   SymTable_T oSymTable;
+
+   /* file being read */
+   FILE *psFile;
+
+   /* format of psFile */
+   enum SymTableFormat eFormat;
+
+   /* function that makes each value, or NULL */
+   void *(*pfMakeValue)(const char *pcKey, const char *pcValue,
+                        size_t uValueSize, void *pvExtra);
+
+   /* extra parameter of pfMakeValue */
+   void *pvExtra;
+
+   /* buffers used in turns by both threads */
+   struct Chunk asChunks[2];
+
+   /* guards the fields below and iFull of asChunks */
+   pthread_mutex_t sMutex;
+
+   /* signaled whenever a Chunk is filled or emptied, or iStop set */
+   pthread_cond_t sCond;
+
+   /* 1 (TRUE) once the parsing thread needs no more Chunks */
+   int iStop;
+
+   /* 1 (TRUE) if the file could not be read */
+   int iError;
+};
+
+
+
+/* Read the file of the Loader pvLoader into its Chunks, in turns,
+   each once it is empty, until the end of the file or until the
+   parsing thread stops. Return NULL */
+
+static void *SymTable_readChunks(void *pvLoader) {
+
+   struct Loader *psLoader;
+   struct Chunk *psChunk;
+   size_t uLength;
+   int i;
+   int iLast;
+   enum {FALSE, TRUE};
+
+
+   assert(pvLoader != NULL);
+
+   psLoader = (struct Loader*)pvLoader;
+
+
+   i = 0;
+
+   do {
+
+      psChunk = &psLoader->asChunks[i];
+
+      pthread_mutex_lock(&psLoader->sMutex);
+
+      while (psChunk->iFull && ! psLoader->iStop)
+         pthread_cond_wait(&psLoader->sCond, &psLoader->sMutex);
+
+      iLast = psLoader->iStop;
+
+      pthread_mutex_unlock(&psLoader->sMutex);
+
+      if (iLast)
+         break;
+
+
+      uLength = fread(psChunk->pcData, 1, CHUNK_SIZE, psLoader->psFile);
+      iLast = (uLength < CHUNK_SIZE);
+
+
+      pthread_mutex_lock(&psLoader->sMutex);
+
+      psChunk->uLength = uLength;
+      psChunk->iFull = TRUE;
+
+      if (iLast && ferror(psLoader->psFile))
+         psLoader->iError = TRUE;
+
+      pthread_cond_broadcast(&psLoader->sCond);
+      pthread_mutex_unlock(&psLoader->sMutex);
+
+      i = 1 - i;
+
+   } while (! iLast);
+
+
+   return NULL;
+}
+
+
+/* Bind pcKey in the table of psLoader to the value made of the
+   uValueSize bytes at pcValue. Return 1 (TRUE) if successful, or 0
+   (FALSE) if pcKey is already bound or insufficient memory is
+   available */
+
+static int SymTable_bind(struct Loader *psLoader, const char *pcKey,
+                         const char *pcValue, size_t uValueSize) {
+
+   enum {FALSE, TRUE};
+
+   assert(psLoader != NULL);
+   assert(pcKey != NULL);
+   assert(pcValue != NULL);
+
+   /* The value is only made once the key is known to be new */
+   if (! SymTable_put(psLoader->oSymTable, pcKey, NULL))
+      return FALSE;
+
+   if (psLoader->pfMakeValue != NULL)
+      SymTable_replace(psLoader->oSymTable, pcKey,
+                       (*psLoader->pfMakeValue)(pcKey, pcValue,
+                                                uValueSize,
+                                                psLoader->pvExtra));
+
+   return TRUE;
+}
+
+
+/* Bind the complete lines from pcStart up to pcEnd, where a '\0'
+   must be stored, which is the last byte of the file if iLast is
+   TRUE. Set *ppcRest to the first byte not parsed. Return 1 (TRUE)
+   if successful, or 0 (FALSE) if a line is too long or cannot be
+   bound */
+
+static int SymTable_parseText(struct Loader *psLoader, char *pcStart,
+                              char *pcEnd, int iLast, char **ppcRest) {
+
+   char *pcLine;
+   char *pcNewline;
+   char *pcValue;
+   enum {FALSE, TRUE};
+
+
+   assert(psLoader != NULL);
+   assert(pcStart != NULL);
+   assert(pcEnd != NULL);
+   assert(ppcRest != NULL);
+
+
+   pcLine = pcStart;
+
+   while (pcLine < pcEnd) {
+
+      pcNewline = (char*)memchr(pcLine, '\n', (size_t)(pcEnd - pcLine));
+
+      /* The last line may end with the file instead */
+      if (pcNewline == NULL) {
+
+         if (! iLast)
+            break;
+
+         pcNewline = pcEnd;
+      }
+
+      if ((size_t)(pcNewline - pcLine) > MAX_RECORD_SIZE) {
+
+         *ppcRest = pcLine;
+         return FALSE;
+      }
+
+      *pcNewline = '\0';
+
+
+      if (pcNewline > pcLine) {
+
+         pcValue = (char*)memchr(pcLine, '\t',
+                                 (size_t)(pcNewline - pcLine));
+
+         if (pcValue == NULL)
+            pcValue = pcNewline;
+
+         else
+            *pcValue++ = '\0';
+
+         if (! SymTable_bind(psLoader, pcLine, pcValue,
+                             (size_t)(pcNewline - pcValue))) {
+
+            *ppcRest = pcLine;
+            return FALSE;
+         }
+      }
+
+      pcLine = pcNewline + 1;
+   }
+
+
+   *ppcRest = (pcLine < pcEnd) ? pcLine : pcEnd;
+
+   return TRUE;
+}
+
+
+/* Bind the complete records from pcStart up to pcEnd, which is the
+   end of the file if iLast is TRUE. Set *ppcRest to the first byte
+   not parsed. Return 1 (TRUE) if successful, or 0 (FALSE) if a
+   record is malformed, too long or cannot be bound */
+
+static int SymTable_parseBinary(struct Loader *psLoader,
+                                char *pcStart, char *pcEnd, int iLast,
+                                char **ppcRest) {
+
+   char *pcRecord;
+   char *pcKey;
+   size_t uKeySize;
+   size_t uValueSize;
+   size_t uAvailable;
+   enum {FALSE, TRUE};
+
+
+   assert(psLoader != NULL);
+   assert(pcStart != NULL);
+   assert(pcEnd != NULL);
+   assert(ppcRest != NULL);
+
+
+   pcRecord = pcStart;
+   *ppcRest = pcRecord;
+
+   while ((size_t)(pcEnd - pcRecord) >= 2 * sizeof(size_t)) {
+
+      memcpy(&uKeySize, pcRecord, sizeof(size_t));
+      memcpy(&uValueSize, pcRecord + sizeof(size_t), sizeof(size_t));
+
+      /* The whole record, sizes included, must fit */
+      if ((uKeySize == 0) ||
+          (uKeySize > MAX_RECORD_SIZE - 2 * sizeof(size_t)) ||
+          (uValueSize >
+           MAX_RECORD_SIZE - 2 * sizeof(size_t) - uKeySize))
+         return FALSE;
+
+      /* The rest of the record is still to be read */
+      uAvailable = (size_t)(pcEnd - pcRecord) - 2 * sizeof(size_t);
+
+      if (uKeySize + uValueSize > uAvailable)
+         break;
+
+
+      pcKey = pcRecord + 2 * sizeof(size_t);
+
+      if ((pcKey[uKeySize - 1] != '\0') ||
+          (strlen(pcKey) != uKeySize - 1))
+         return FALSE;
+
+      if (! SymTable_bind(psLoader, pcKey, pcKey + uKeySize,
+                          uValueSize))
+         return FALSE;
+
+
+      pcRecord = pcKey + uKeySize + uValueSize;
+      *ppcRest = pcRecord;
+   }
+
+
+   /* The file must not end within a record */
+   return ! iLast || (pcRecord == pcEnd);
+}
+
+
+/* Mark psChunk, a Chunk of psLoader, as parsed, so that it can be
+   read into again */
+
+static void SymTable_release(struct Loader *psLoader,
+                             struct Chunk *psChunk) {
+
+   enum {FALSE, TRUE};
+
+   assert(psLoader != NULL);
+   assert(psChunk != NULL);
+
+   pthread_mutex_lock(&psLoader->sMutex);
+
+   psChunk->iFull = FALSE;
+
+   pthread_cond_broadcast(&psLoader->sCond);
+   pthread_mutex_unlock(&psLoader->sMutex);
+}
+
+
+/* Parse the Chunks of psLoader, in turns, as they are read. Return 1
+   (TRUE) if every line or record was bound, or 0 (FALSE) otherwise */
+
+static int SymTable_parseChunks(struct Loader *psLoader) {
+
+   struct Chunk *psChunk;
+   struct Chunk *psPrevious;
+   char *pcStart;
+   char *pcEnd;
+   char *pcRest;
+   size_t uRestLength;
+   int i;
+   int iLast;
+   int iSuccessful;
+   enum {FALSE, TRUE};
+
+
+   assert(psLoader != NULL);
+
+
+   psPrevious = NULL;
+   pcRest = NULL;
+   uRestLength = 0;
+   iLast = FALSE;
+   iSuccessful = TRUE;
+
+   for (i = 0; iSuccessful && ! iLast; i = 1 - i) {
+
+      psChunk = &psLoader->asChunks[i];
+
+      pthread_mutex_lock(&psLoader->sMutex);
+
+      while (! psChunk->iFull)
+         pthread_cond_wait(&psLoader->sCond, &psLoader->sMutex);
+
+      pthread_mutex_unlock(&psLoader->sMutex);
+
+      iLast = (psChunk->uLength < CHUNK_SIZE);
+
+
+      /* The incomplete line or record of the other Chunk goes right
+         before the data of this one, and then the other Chunk may be
+         read into again */
+      pcStart = psChunk->pcData - uRestLength;
+
+      if (uRestLength > 0)
+         memcpy(pcStart, pcRest, uRestLength);
+
+      if (psPrevious != NULL)
+         SymTable_release(psLoader, psPrevious);
+
+
+      pcEnd = psChunk->pcData + psChunk->uLength;
+      *pcEnd = '\0';
+
+      if (psLoader->eFormat == SYMTABLE_TEXT)
+         iSuccessful = SymTable_parseText(psLoader, pcStart, pcEnd,
+                                          iLast, &pcRest);
+      else
+         iSuccessful = SymTable_parseBinary(psLoader, pcStart, pcEnd,
+                                            iLast, &pcRest);
+
+      uRestLength = (size_t)(pcEnd - pcRest);
+
+      if (uRestLength > MAX_RECORD_SIZE)
+         iSuccessful = FALSE;
+
+      psPrevious = psChunk;
+   }
+
+   return iSuccessful;
+}
+
+
+
+int SymTable_loadStream(SymTable_T oSymTable, FILE *psFile,
+                        enum SymTableFormat eFormat,
+                        void *(*pfMakeValue)(const char *pcKey,
+                                             const char *pcValue,
+                                             size_t uValueSize,
+                                             void *pvExtra),
+                        const void *pvExtra) {
+
+   struct Loader sLoader;
+   pthread_t sThread;
+   char *pcBlock;
+   size_t uChunkSize;
+   int i;
+   int iSuccessful;
+   enum {FALSE, TRUE};
+
+
+   assert(oSymTable != NULL);
+   assert(psFile != NULL);
+   assert((eFormat == SYMTABLE_TEXT) || (eFormat == SYMTABLE_BINARY));
+
+
+   /* Both Chunks share one block */
+   uChunkSize = MAX_RECORD_SIZE + CHUNK_SIZE + 1;
+
+   pcBlock = (char*)malloc(2 * uChunkSize);
+
+   if (pcBlock == NULL)
+      return FALSE;
+
+   for (i = 0; i < 2; i++) {
+
+      sLoader.asChunks[i].pcData =
+         pcBlock + i * uChunkSize + MAX_RECORD_SIZE;
+      sLoader.asChunks[i].uLength = 0;
+      sLoader.asChunks[i].iFull = FALSE;
+   }
+
+   sLoader.oSymTable = oSymTable;
+   sLoader.psFile = psFile;
+   sLoader.eFormat = eFormat;
+   sLoader.pfMakeValue = pfMakeValue;
+   sLoader.pvExtra = (void*)pvExtra;
+   sLoader.iStop = FALSE;
+   sLoader.iError = FALSE;
+
+
+   if (pthread_mutex_init(&sLoader.sMutex, NULL) != 0) {
+
+      free(pcBlock);
+      return FALSE;
+   }
+
+   if (pthread_cond_init(&sLoader.sCond, NULL) != 0) {
+
+      pthread_mutex_destroy(&sLoader.sMutex);
+      free(pcBlock);
+      return FALSE;
+   }
+
+   if (pthread_create(&sThread, NULL, SymTable_readChunks,
+                      &sLoader) != 0) {
+
+      pthread_cond_destroy(&sLoader.sCond);
+      pthread_mutex_destroy(&sLoader.sMutex);
+      free(pcBlock);
+      return FALSE;
+   }
+
+
+   iSuccessful = SymTable_parseChunks(&sLoader);
+
+
+   /* The reading thread may be waiting for a Chunk to be parsed */
+   pthread_mutex_lock(&sLoader.sMutex);
+   sLoader.iStop = TRUE;
+   pthread_cond_broadcast(&sLoader.sCond);
+   pthread_mutex_unlock(&sLoader.sMutex);
+
+   pthread_join(sThread, NULL);
+
+   if (sLoader.iError)
+      iSuccessful = FALSE;
+
+
+   pthread_cond_destroy(&sLoader.sCond);
+   pthread_mutex_destroy(&sLoader.sMutex);
+   free(pcBlock);
+
+   return iSuccessful;
+}
@@ -0,0 +1,65 @@
+/*--------------------------------------------------------------------*/
+/* symtableload.h                                                     */
+/* Author: Julio Lins (jcclb)                                         */
+/*--------------------------------------------------------------------*/
+
+#ifndef SYMTABLELOAD_H
+#define SYMTABLELOAD_H
+
+#include "symtable.h"
+#include <stdio.h>
+
+/*--------------------------------------------------------------------*/
+
+/* Formats of the files read by SymTable_loadStream.
+
+   A SYMTABLE_TEXT file is a sequence of lines, each made of a key, a
+   tab and a value; a line without a tab has an empty value, and empty
+   lines are skipped. The last line need not end with a newline.
+
+   A SYMTABLE_BINARY file is a sequence of records, each made of the
+   size of the key, '\0' included, and the size of the value, both as
+   size_t, followed by the key, with its '\0', and the value. It can
+   only be read on a machine with the same word size and byte order
+   as the one that wrote it.
+
+   A line, its newline not included, or a record, its sizes included,
+   may take at most 64 KiB */
+
+enum SymTableFormat {SYMTABLE_TEXT, SYMTABLE_BINARY};
+
+/*--------------------------------------------------------------------*/
+
+/* Add a binding to oSymTable for each line or record of psFile,
+   which is in format eFormat, until the end of psFile. The value of
+   each binding is (*pfMakeValue)(pcKey, pcValue, uValueSize,
+   pvExtra), where pcValue points to the uValueSize bytes of the value
+   as read, or NULL if pfMakeValue is NULL. pcKey and pcValue are only
+   valid during the call, so oSymTable must not borrow its keys;
+   pcValue is followed by '\0' in a SYMTABLE_TEXT file, but it need
+   not be aligned. pfMakeValue is called only for keys that have just
+   been bound.
+
+   psFile is read by a second thread while bindings are added, in
+   large blocks that are parsed where they were read. For the fastest
+   load of a large file, oSymTable should already have room for every
+   binding, as a table of symtablestatic.c made by SymTable_newFixed
+   does.
+
+   Return 1 (TRUE) if every line or record was bound. Return 0 (FALSE)
+   if psFile cannot be read, a line or record is too long or
+   malformed, a key is already in oSymTable, or insufficient memory
+   is available; the bindings of the lines or records before the one
+   that failed stay in oSymTable */
+
+int SymTable_loadStream(SymTable_T oSymTable, FILE *psFile,
+                        enum SymTableFormat eFormat,
+                        void *(*pfMakeValue)(const char *pcKey,
+                                             const char *pcValue,
+                                             size_t uValueSize,
+                                             void *pvExtra),
+                        const void *pvExtra);
+
+/*--------------------------------------------------------------------*/
+
+#endif
@@ -0,0 +1,641 @@
+/*--------------------------------------------------------------------*/
+/* symtablemapped.c                                                   */
+/* author: Julio Lins (jcclb)                                         */
+/*--------------------------------------------------------------------*/
+
+/* mmap and friends are POSIX, not ANSI C */
+#define _POSIX_C_SOURCE 200112L
+
+#include "symtablemapped.h"
+#include <assert.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+/*--------------------------------------------------------------------*/
+
+/* An image is laid out as a Header, the bucket start array, the
+   Bindings grouped by bucket, the values and the key pool. Every
+   reference within it is an offset from the start of the image */
+
+/* Tag at the start of every image. Images tagged "SYMTAB1" hashed
+   characters as char, signed on some machines, and are not read */
+
+static const char acMagic[8] = "SYMTAB2";
+
+/* Values are placed at multiples of VALUE_ALIGNMENT within the image,
+   so that clients may store any type as a value */
+
+enum {VALUE_ALIGNMENT = 16};
+
+/* Offset stored instead of a value offset for a NULL value */
+
+#define OFFSET_NULL ((size_t)-1)
+
+/* Room for the suffix that SymTable_save adds to the name of an image
+   to name the file it writes first: '.', the process ID, ".tmp" and
+   a '\0' */
+
+enum {TEMP_SUFFIX_LENGTH = 32};
+
+
+struct Header {
+
+   /* acMagic */
+   char acMagic[8];
+
+   /* sizeof(size_t) on the machine that wrote the image */
+   size_t uWordSize;
+
+   /* # of bytes in the image */
+   size_t uImageSize;
+
+   /* size of Symble Table (total # of Bindings) */
+   size_t uLength;
+
+   /* # of buckets */
+   size_t uBucketCount;
+};
+
+
+/* Each key and respective value are referred to by a Binding. The
+   Bindings of bucket i are those from position puStarts[i] up to,
+   but not including, position puStarts[i + 1] */
+
+struct Binding {
+
+   /* full hash code of the key */
+   size_t uHash;
+
+   /* offset of the key in the key pool */
+   size_t uKeyOffset;
+
+   /* offset of the value, or OFFSET_NULL */
+   size_t uValueOffset;
+};
+
+
+/* SymTableMapped is a structure that locates the parts of a mapped
+   image */
+
+struct SymTableMapped {
+
+   /* first byte of the mapped image */
+   const char *pcImage;
+
+   /* # of bytes mapped */
+   size_t uImageSize;
+
+   /* # of buckets */
+   size_t uBucketCount;
+
+   /* size of Symble Table (total # of Bindings) */
+   size_t uLength;
+
+   /* bucket start array, with uBucketCount + 1 elements */
+   const size_t *puStarts;
+
+   /* Bindings grouped by bucket */
+   const struct Binding *pbBindings;
+};
+
+
+/* A binding of the Symble Table being saved, in the bucket order of
+   its image */
+
+struct SaveEntry {
+
+   /* key, owned by the Symble Table being saved */
+   const char *pcKey;
+
+   /* value, owned by client */
+   const void *pvValue;
+
+   /* full hash code of pcKey */
+   size_t uHash;
+
+   /* # of bytes of the value */
+   size_t uValueSize;
+};
+
+
+
+/* Return the full hash code for pcKey, which is the key that will be
+   hashed. The caller reduces it modulo the bucket count. Characters
+   are hashed as unsigned, so that the code, which images depend on,
+   is the same whether or not char is signed */
+
+static size_t SymTable_hash(const char *pcKey)
+{
+   const size_t HASH_MULTIPLIER = 65599;
+   size_t u;
+   size_t uHash = 0;
+
+   assert(pcKey != NULL);
+
+   for (u = 0; pcKey[u] != '\0'; u++)
+      uHash = uHash * HASH_MULTIPLIER + (size_t)(unsigned char)pcKey[u];
+
+   return uHash;
+}
+
+
+/* Return uOffset rounded up to the next multiple of VALUE_ALIGNMENT */
+
+static size_t SymTable_align(size_t uOffset) {
+
+   return (uOffset + VALUE_ALIGNMENT - 1) / VALUE_ALIGNMENT *
+      VALUE_ALIGNMENT;
+}
+
+
+/* Write uCount zero bytes to psFile. Return 1 (TRUE) if successful,
+   or 0 (FALSE) otherwise */
+
+static int SymTable_pad(FILE *psFile, size_t uCount) {
+
+   static const char acZeros[VALUE_ALIGNMENT] = {0};
+
+   assert(psFile != NULL);
+   assert(uCount <= VALUE_ALIGNMENT);
+
+   return fwrite(acZeros, 1, uCount, psFile) == uCount;
+}
+
+
+/* Helper function that writes the image of the uLength SaveEntries of
+   pseEntries, already grouped into the uBucketCount buckets described
+   by puStarts, to psFile. Return 1 (TRUE) if successful, or 0 (FALSE)
+   if the file cannot be written */
+
+static int SymTable_writeImage(FILE *psFile,
+                               const struct SaveEntry *pseEntries,
+                               size_t uLength, const size_t *puStarts,
+                               size_t uBucketCount) {
+
+   struct Header sHeader;
+   struct Binding sBinding;
+   size_t uValuesOffset;
+   size_t uKeysOffset;
+   size_t uValueOffset;
+   size_t uKeyOffset;
+   size_t uOffset;
+   size_t i;
+   enum {FALSE, TRUE};
+
+
+   assert(psFile != NULL);
+   assert(puStarts != NULL);
+
+
+   /* Values follow the Bindings, and keys follow the values */
+   uValuesOffset = SymTable_align(sizeof(struct Header) +
+                                  sizeof(size_t) * (uBucketCount + 1) +
+                                  sizeof(struct Binding) * uLength);
+
+   uKeysOffset = uValuesOffset;
+
+   for (i = 0; i < uLength; i++)
+      if (pseEntries[i].pvValue != NULL)
+         uKeysOffset = SymTable_align(uKeysOffset +
+                                      pseEntries[i].uValueSize);
+
+   uOffset = uKeysOffset;
+
+   for (i = 0; i < uLength; i++)
+      uOffset += strlen(pseEntries[i].pcKey) + 1;
+
+
+   memcpy(sHeader.acMagic, acMagic, sizeof(acMagic));
+   sHeader.uWordSize = sizeof(size_t);
+   sHeader.uImageSize = uOffset;
+   sHeader.uLength = uLength;
+   sHeader.uBucketCount = uBucketCount;
+
+   if (fwrite(&sHeader, sizeof(struct Header), 1, psFile) != 1)
+      return FALSE;
+
+   if (fwrite(puStarts, sizeof(size_t), uBucketCount + 1, psFile) !=
+       uBucketCount + 1)
+      return FALSE;
+
+
+   uValueOffset = uValuesOffset;
+   uKeyOffset = uKeysOffset;
+
+   for (i = 0; i < uLength; i++) {
+
+      sBinding.uHash = pseEntries[i].uHash;
+      sBinding.uKeyOffset = uKeyOffset;
+
+      if (pseEntries[i].pvValue == NULL)
+         sBinding.uValueOffset = OFFSET_NULL;
+
+      else {
+
+         sBinding.uValueOffset = uValueOffset;
+         uValueOffset = SymTable_align(uValueOffset +
+                                       pseEntries[i].uValueSize);
+      }
+
+      uKeyOffset += strlen(pseEntries[i].pcKey) + 1;
+
+      if (fwrite(&sBinding, sizeof(struct Binding), 1, psFile) != 1)
+         return FALSE;
+   }
+
+
+   uOffset = sizeof(struct Header) + sizeof(size_t) *
+      (uBucketCount + 1) + sizeof(struct Binding) * uLength;
+
+   if (! SymTable_pad(psFile, uValuesOffset - uOffset))
+      return FALSE;
+
+   for (i = 0; i < uLength; i++) {
+
+      if (pseEntries[i].pvValue == NULL)
+         continue;
+
+      if (fwrite(pseEntries[i].pvValue, 1, pseEntries[i].uValueSize,
+                 psFile) != pseEntries[i].uValueSize)
+         return FALSE;
+
+      if (! SymTable_pad(psFile,
+                         SymTable_align(pseEntries[i].uValueSize) -
+                         pseEntries[i].uValueSize))
+         return FALSE;
+   }
+
+   for (i = 0; i < uLength; i++)
+      if (fputs(pseEntries[i].pcKey, psFile) == EOF ||
+          putc('\0', psFile) == EOF)
+         return FALSE;
+
+
+   return TRUE;
+}
+
+
+
+int SymTable_save(SymTable_T oSymTable, const char *pcFileName,
+                  size_t (*pfValueSize)(const char *pcKey,
+                                        const void *pvValue)) {
+
+   struct SymTableIter sIter;
+   struct SaveEntry *pseEntries;
+   size_t *puStarts;
+   size_t *puNext;
+   size_t uLength;
+   size_t uBucketCount;
+   size_t uBucket;
+   size_t uHash;
+   size_t i;
+   char *pcTempName;
+   FILE *psFile;
+   int iFd;
+   int iSuccessful;
+   enum {FALSE, TRUE};
+
+
+   assert(oSymTable != NULL);
+   assert(pcFileName != NULL);
+   assert(pfValueSize != NULL);
+
+
+   uLength = SymTable_getLength(oSymTable);
+
+   /* One bucket per binding keeps chains short */
+   uBucketCount = (uLength > 0) ? uLength : 1;
+
+
+   pseEntries = (struct SaveEntry*)
+      malloc(sizeof(struct SaveEntry) * ((uLength > 0) ? uLength : 1));
+   puStarts = (size_t*)calloc(uBucketCount + 1, sizeof(size_t));
+   puNext = (size_t*)malloc(sizeof(size_t) * uBucketCount);
+   pcTempName = (char*)malloc(strlen(pcFileName) + TEMP_SUFFIX_LENGTH);
+
+   if ((pseEntries == NULL) || (puStarts == NULL) || (puNext == NULL) ||
+       (pcTempName == NULL)) {
+
+      free(pseEntries);
+      free(puStarts);
+      free(puNext);
+      free(pcTempName);
+      return FALSE;
+   }
+
+
+   /* Count the bindings of each bucket... */
+   for (SymTable_iterBegin(oSymTable, &sIter);
+        ! SymTable_iterEnd(&sIter);
+        SymTable_iterNext(&sIter))
+      puStarts[SymTable_hash(sIter.pcKey) % uBucketCount + 1]++;
+
+   for (i = 0; i < uBucketCount; i++) {
+
+      puStarts[i + 1] += puStarts[i];
+      puNext[i] = puStarts[i];
+   }
+
+   /* ...then place each binding within its bucket */
+   for (SymTable_iterBegin(oSymTable, &sIter);
+        ! SymTable_iterEnd(&sIter);
+        SymTable_iterNext(&sIter)) {
+
+      uHash = SymTable_hash(sIter.pcKey);
+      uBucket = uHash % uBucketCount;
+
+      pseEntries[puNext[uBucket]].pcKey = sIter.pcKey;
+      pseEntries[puNext[uBucket]].pvValue = sIter.pvValue;
+      pseEntries[puNext[uBucket]].uHash = uHash;
+      pseEntries[puNext[uBucket]].uValueSize =
+         (sIter.pvValue == NULL) ? 0 :
+         (*pfValueSize)(sIter.pcKey, sIter.pvValue);
+
+      puNext[uBucket]++;
+   }
+
+
+   /* Processes may have the file mapped, so it is never written in
+      place: the image goes to a file of its own, which is renamed
+      over the old one once it is on disk */
+   sprintf(pcTempName, "%s.%ld.tmp", pcFileName, (long)getpid());
+
+   psFile = NULL;
+   iFd = open(pcTempName, O_WRONLY | O_CREAT | O_TRUNC, 0666);
+
+   if (iFd != -1) {
+
+      psFile = fdopen(iFd, "wb");
+
+      if (psFile == NULL)
+         close(iFd);
+   }
+
+   if (psFile == NULL)
+      iSuccessful = FALSE;
+
+   else {
+
+      iSuccessful = SymTable_writeImage(psFile, pseEntries, uLength,
+                                        puStarts, uBucketCount) &&
+         (fflush(psFile) != EOF) && (fsync(fileno(psFile)) != -1);
+
+      if (fclose(psFile) == EOF)
+         iSuccessful = FALSE;
+
+      if (iSuccessful && (rename(pcTempName, pcFileName) != 0))
+         iSuccessful = FALSE;
+
+      if (! iSuccessful)
+         (void)remove(pcTempName);
+   }
+
+
+   free(pseEntries);
+   free(puStarts);
+   free(puNext);
+   free(pcTempName);
+
+   return iSuccessful;
+}
+
+
+/* Return 1 (TRUE) if the uImageSize bytes at pcImage hold a
+   consistent image, or 0 (FALSE) otherwise */
+
+static int SymTable_checkImage(const char *pcImage, size_t uImageSize) {
+
+   const struct Header *psHeader;
+   const size_t *puStarts;
+   const struct Binding *pbBindings;
+   size_t uTablesSize;
+   size_t i;
+   enum {FALSE, TRUE};
+   enum {EQUAL};
+
+
+   assert(pcImage != NULL);
+
+
+   if (uImageSize < sizeof(struct Header))
+      return FALSE;
+
+   psHeader = (const struct Header*)(const void*)pcImage;
+
+   if ((memcmp(psHeader->acMagic, acMagic, sizeof(acMagic)) != EQUAL) ||
+       (psHeader->uWordSize != sizeof(size_t)) ||
+       (psHeader->uImageSize != uImageSize) ||
+       (psHeader->uBucketCount == 0))
+      return FALSE;
+
+
+   /* Bucket start array and Bindings must fit, without overflow */
+   if ((psHeader->uBucketCount > uImageSize / sizeof(size_t)) ||
+       (psHeader->uLength > uImageSize / sizeof(struct Binding)))
+      return FALSE;
+
+   uTablesSize = sizeof(struct Header) +
+      sizeof(size_t) * (psHeader->uBucketCount + 1) +
+      sizeof(struct Binding) * psHeader->uLength;
+
+   if (uTablesSize > uImageSize)
+      return FALSE;
+
+
+   /* The key pool, and so the image, ends with a key's '\0' */
+   if ((psHeader->uLength > 0) && (pcImage[uImageSize - 1] != '\0'))
+      return FALSE;
+
+
+   puStarts = (const size_t*)(const void*)
+      (pcImage + sizeof(struct Header));
+   pbBindings = (const struct Binding*)(const void*)
+      (puStarts + psHeader->uBucketCount + 1);
+
+
+   /* Buckets must follow one another, from the first Binding to the
+      last, so that a lookup stays within the Bindings */
+   if ((puStarts[0] != 0) ||
+       (puStarts[psHeader->uBucketCount] != psHeader->uLength))
+      return FALSE;
+
+   for (i = 0; i < psHeader->uBucketCount; i++)
+      if ((puStarts[i + 1] < puStarts[i]) ||
+          (puStarts[i + 1] > psHeader->uLength))
+         return FALSE;
+
+
+   /* Keys and values must be past the tables and within the image.
+      Since the image ends with a '\0', so does every key */
+   for (i = 0; i < psHeader->uLength; i++) {
+
+      if ((pbBindings[i].uKeyOffset < uTablesSize) ||
+          (pbBindings[i].uKeyOffset >= uImageSize))
+         return FALSE;
+
+      if ((pbBindings[i].uValueOffset != OFFSET_NULL) &&
+          ((pbBindings[i].uValueOffset < uTablesSize) ||
+           (pbBindings[i].uValueOffset >= uImageSize) ||
+           (pbBindings[i].uValueOffset % VALUE_ALIGNMENT != 0)))
+         return FALSE;
+   }
+
+
+   return TRUE;
+}
+
+
+
+SymTableMapped_T SymTable_openMapped(const char *pcFileName) {
+
+   SymTableMapped_T oSymTableMapped;
+   const struct Header *psHeader;
+   struct stat sStat;
+   void *pvImage;
+   size_t uImageSize;
+   int iFd;
+
+
+   assert(pcFileName != NULL);
+
+
+   iFd = open(pcFileName, O_RDONLY);
+
+   if (iFd == -1)
+      return NULL;
+
+   if ((fstat(iFd, &sStat) == -1) || (sStat.st_size <= 0)) {
+
+      close(iFd);
+      return NULL;
+   }
+
+   uImageSize = (size_t)sStat.st_size;
+
+   pvImage = mmap(NULL, uImageSize, PROT_READ, MAP_SHARED, iFd, 0);
+
+   /* The mapping stays valid once the file is closed */
+   close(iFd);
+
+   if (pvImage == MAP_FAILED)
+      return NULL;
+
+
+   if (! SymTable_checkImage((const char*)pvImage, uImageSize)) {
+
+      munmap(pvImage, uImageSize);
+      return NULL;
+   }
+
+
+   oSymTableMapped =
+      (SymTableMapped_T)malloc(sizeof(struct SymTableMapped));
+
+   if (oSymTableMapped == NULL) {
+
+      munmap(pvImage, uImageSize);
+      return NULL;
+   }
+
+
+   psHeader = (const struct Header*)pvImage;
+
+   oSymTableMapped->pcImage = (const char*)pvImage;
+   oSymTableMapped->uImageSize = uImageSize;
+   oSymTableMapped->uBucketCount = psHeader->uBucketCount;
+   oSymTableMapped->uLength = psHeader->uLength;
+   oSymTableMapped->puStarts = (const size_t*)(const void*)
+      (oSymTableMapped->pcImage + sizeof(struct Header));
+   oSymTableMapped->pbBindings = (const struct Binding*)(const void*)
+      (oSymTableMapped->puStarts + psHeader->uBucketCount + 1);
+
+
+   return oSymTableMapped;
+}
+
+
+
+void SymTableMapped_close(SymTableMapped_T oSymTableMapped) {
+
+   assert(oSymTableMapped != NULL);
+
+   munmap((void*)oSymTableMapped->pcImage, oSymTableMapped->uImageSize);
+   free(oSymTableMapped);
+}
+
+
+size_t SymTableMapped_getLength(SymTableMapped_T oSymTableMapped) {
+
+   assert(oSymTableMapped != NULL);
+
+   return oSymTableMapped->uLength;
+}
+
+
+/* Return the Binding of pcKey within oSymTableMapped, if found.
+   Else, it returns NULL */
+
+static const struct Binding *SymTable_find(
+   SymTableMapped_T oSymTableMapped, const char *pcKey) {
+
+   const struct Binding *pbCurrent;
+   const struct Binding *pbEnd;
+   size_t uHash;
+   size_t uBucket;
+   enum {EQUAL};
+
+
+   assert(oSymTableMapped != NULL);
+   assert(pcKey != NULL);
+
+
+   uHash = SymTable_hash(pcKey);
+   uBucket = uHash % oSymTableMapped->uBucketCount;
+
+   pbCurrent = oSymTableMapped->pbBindings +
+      oSymTableMapped->puStarts[uBucket];
+   pbEnd = oSymTableMapped->pbBindings +
+      oSymTableMapped->puStarts[uBucket + 1];
+
+
+   for (; pbCurrent < pbEnd; pbCurrent++)
+      if ((pbCurrent->uHash == uHash) &&
+          (strcmp(oSymTableMapped->pcImage + pbCurrent->uKeyOffset,
+                  pcKey) == EQUAL))
+         return pbCurrent;
+
+
+   return NULL;
+}
+
+
+int SymTableMapped_contains(SymTableMapped_T oSymTableMapped,
+                            const char *pcKey) {
+
+   assert(oSymTableMapped != NULL);
+   assert(pcKey != NULL);
+
+   return SymTable_find(oSymTableMapped, pcKey) != NULL;
+}
+
+
+const void *SymTableMapped_get(SymTableMapped_T oSymTableMapped,
+                               const char *pcKey) {
+
+   const struct Binding *pbFound;
+
+   assert(oSymTableMapped != NULL);
+   assert(pcKey != NULL);
+
+   pbFound = SymTable_find(oSymTableMapped, pcKey);
+
+   if ((pbFound == NULL) || (pbFound->uValueOffset == OFFSET_NULL))
+      return NULL;
+
+   return oSymTableMapped->pcImage + pbFound->uValueOffset;
+}
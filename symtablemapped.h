@@ -0,0 +1,80 @@
+/*--------------------------------------------------------------------*/
+/* symtablemapped.h                                                   */
+/* Author: Julio Lins (jcclb)                                         */
+/*--------------------------------------------------------------------*/
+
+#ifndef SYMTABLEMAPPED_H
+#define SYMTABLEMAPPED_H
+
+#include "symtable.h"
+
+/*--------------------------------------------------------------------*/
+
+/* A SymTableMapped_T object is a read-only view of a Symble Table
+   image written by SymTable_save. The image is mapped into memory
+   as is and lookups are served straight from it: keys and values are
+   never copied or deserialized. An image holds offsets instead of
+   pointers, so it can be mapped at any address, but it can only be
+   read on a machine with the same word size and byte order as the
+   one that wrote it */
+
+typedef struct SymTableMapped *SymTableMapped_T;
+
+/*--------------------------------------------------------------------*/
+
+/* Write an image of oSymTable to the file named pcFileName, replacing
+   it. Each value is stored as the (*pfValueSize)(pcKey, pvValue)
+   bytes that pvValue points to; a NULL value is stored as NULL. The
+   image is written to a file of its own in the same directory first,
+   and renamed over pcFileName once on disk, so that processes that
+   have the old image mapped go on reading it. Return 1 (TRUE) if
+   successful, or 0 (FALSE) if insufficient memory is available or the
+   file cannot be written, in which case pcFileName is unchanged */
+
+int SymTable_save(SymTable_T oSymTable, const char *pcFileName,
+                  size_t (*pfValueSize)(const char *pcKey,
+                                        const void *pvValue));
+
+/*--------------------------------------------------------------------*/
+
+/* Map the image in the file named pcFileName read-only and return a
+   SymTableMapped_T object that serves lookups from it, or NULL if
+   the file cannot be mapped or does not hold a valid image. Every
+   offset in the image is checked, so that lookups in it stay within
+   it; this takes time linear in the size of the image */
+
+SymTableMapped_T SymTable_openMapped(const char *pcFileName);
+
+/*--------------------------------------------------------------------*/
+
+/* Unmap the image of oSymTableMapped and free memory allocated by
+   it. Keys and values obtained from it must no longer be used */
+
+void SymTableMapped_close(SymTableMapped_T oSymTableMapped);
+
+/*--------------------------------------------------------------------*/
+
+/* Return length of oSymTableMapped (i.e., number of bindings) */
+
+size_t SymTableMapped_getLength(SymTableMapped_T oSymTableMapped);
+
+/*--------------------------------------------------------------------*/
+
+/* Return 1 (TRUE) if oSymTableMapped contains a binding whose key is
+   pcKey, and 0 (FALSE) otherwise */
+
+int SymTableMapped_contains(SymTableMapped_T oSymTableMapped,
+                            const char *pcKey);
+
+/*--------------------------------------------------------------------*/
+
+/* Return the value of the binding within oSymTableMapped whose key
+   is pcKey, or NULL if no such binding exists. The value lies inside
+   the mapped image and must not be modified */
+
+const void *SymTableMapped_get(SymTableMapped_T oSymTableMapped,
+                               const char *pcKey);
+
+/*--------------------------------------------------------------------*/
+
+#endif
@@ -0,0 +1,676 @@
+/*--------------------------------------------------------------------*/
+/* symtableordered.c                                                  */
+/* author: Julio Lins (jcclb)                                         */
+/*--------------------------------------------------------------------*/
+
+#include "symtableordered.h"
+#include <assert.h>
+#include <string.h>
+#include <stdlib.h>
+
+/*--------------------------------------------------------------------*/
+
+/* Initial number of Entries a Symble Table has room for. Must be a
+   power of 2 */
+
+enum {MIN_ENTRY_CAPACITY = 8};
+
+/* Markers stored in the index table instead of an Entry index */
+
+#define INDEX_EMPTY ((size_t)-1)
+#define INDEX_DELETED ((size_t)-2)
+
+
+/* Each key and respective value are stored in an Entry. Entries are
+   kept in a dense array in insertion order, so that traversals read
+   memory sequentially */
+
+struct Entry {
+
+   /* key, owned by implementation through defensive copy unless
+      the table borrows its keys. NULL if the Entry's binding has
+      been removed */
+   const char *pcKey;
+
+   /* value, owned by client */
+   void *pvValue;
+
+   /* full hash code of pcKey, kept so that the index table can be
+      rebuilt without rehashing keys */
+   size_t uHash;
+};
+
+
+/* SymTable is a dense array of Entries plus an open-addressing index
+   table whose slots hold positions within that array, as in a compact
+   dictionary */
+
+struct SymTable {
+
+   /* Entries in insertion order, including removed ones */
+   struct Entry *peEntries;
+
+   /* # of Entries in use, including removed ones */
+   size_t uEntryCount;
+
+   /* # of Entries peEntries has room for (power of 2) */
+   size_t uEntryCapacity;
+
+   /* Index table: each slot is INDEX_EMPTY, INDEX_DELETED or the
+      position of an Entry in peEntries */
+   size_t *puIndices;
+
+   /* # of slots in puIndices (twice uEntryCapacity) */
+   size_t uIndexCount;
+
+   /* size of Symble Table (total # of live Entries) */
+   size_t uLength;
+
+   /* 1 (TRUE) if keys are borrowed from the client rather than
+      owned through defensive copies */
+   int iBorrowsKeys;
+};
+
+
+
+/* Return the full hash code for pcKey, which is the key that will be
+   hashed. The caller reduces it to a slot of the index table */
+
+static size_t SymTable_hash(const char *pcKey)
+{
+   const size_t HASH_MULTIPLIER = 65599;
+   size_t u;
+   size_t uHash = 0;
+
+   assert(pcKey != NULL);
+
+   for (u = 0; pcKey[u] != '\0'; u++)
+      uHash = uHash * HASH_MULTIPLIER + (size_t)pcKey[u];
+
+   return uHash;
+}
+
+
+/* Return the index table slot of the live Entry whose key is pcKey
+   and whose hash code is uHash, or INDEX_EMPTY if there is none.
+   oSymTable is the Symble Table to search */
+
+static size_t SymTable_findSlot(SymTable_T oSymTable,
+                                const char *pcKey, size_t uHash) {
+
+   size_t uMask;
+   size_t uSlot;
+   size_t uEntry;
+   struct Entry *peEntry;
+   enum {EQUAL};
+
+   assert(oSymTable != NULL);
+   assert(pcKey != NULL);
+
+   uMask = oSymTable->uIndexCount - 1;
+   uSlot = uHash & uMask;
+
+   /* Linear probing; the table is never more than half full, so an
+      empty slot always ends the probe */
+   while ((uEntry = oSymTable->puIndices[uSlot]) != INDEX_EMPTY) {
+
+      if (uEntry != INDEX_DELETED) {
+
+         peEntry = &oSymTable->peEntries[uEntry];
+
+         if ((peEntry->uHash == uHash) &&
+             (strcmp(peEntry->pcKey, pcKey) == EQUAL))
+            return uSlot;
+      }
+
+      uSlot = (uSlot + 1) & uMask;
+   }
+
+   return INDEX_EMPTY;
+}
+
+
+/* Record in the index table of oSymTable that the Entry at position
+   uEntry has hash code uHash. There must be no such key yet */
+
+static void SymTable_insertIndex(SymTable_T oSymTable, size_t uEntry,
+                                 size_t uHash) {
+
+   size_t uMask;
+   size_t uSlot;
+
+   assert(oSymTable != NULL);
+
+   uMask = oSymTable->uIndexCount - 1;
+   uSlot = uHash & uMask;
+
+   while ((oSymTable->puIndices[uSlot] != INDEX_EMPTY) &&
+          (oSymTable->puIndices[uSlot] != INDEX_DELETED))
+      uSlot = (uSlot + 1) & uMask;
+
+   oSymTable->puIndices[uSlot] = uEntry;
+}
+
+
+/* Helper function that rebuilds oSymTable with room for uCapacity
+   Entries, squeezing out removed Entries while keeping insertion
+   order. uCapacity must be a power of 2 no smaller than the length of
+   oSymTable. Return 1 (TRUE) if successful, or 0 (FALSE) if not
+   enough memory, in which case oSymTable does not change */
+
+static int SymTable_rebuild(SymTable_T oSymTable, size_t uCapacity) {
+
+   struct Entry *peNewEntries;
+   size_t *puNewIndices;
+   size_t uNewCount;
+   size_t i;
+   enum {FALSE, TRUE};
+
+   assert(oSymTable != NULL);
+   assert(uCapacity >= oSymTable->uLength);
+
+   peNewEntries = (struct Entry*)
+      malloc(sizeof(struct Entry) * uCapacity);
+
+   if (peNewEntries == NULL)
+      return FALSE;
+
+   puNewIndices = (size_t*)malloc(sizeof(size_t) * 2 * uCapacity);
+
+   if (puNewIndices == NULL) {
+
+      free(peNewEntries);
+      return FALSE;
+   }
+
+   /* Copy live Entries in order */
+   uNewCount = 0;
+
+   for (i = 0; i < oSymTable->uEntryCount; i++)
+      if (oSymTable->peEntries[i].pcKey != NULL)
+         peNewEntries[uNewCount++] = oSymTable->peEntries[i];
+
+   free(oSymTable->peEntries);
+   free(oSymTable->puIndices);
+
+   oSymTable->peEntries = peNewEntries;
+   oSymTable->uEntryCount = uNewCount;
+   oSymTable->uEntryCapacity = uCapacity;
+   oSymTable->puIndices = puNewIndices;
+   oSymTable->uIndexCount = 2 * uCapacity;
+
+   for (i = 0; i < oSymTable->uIndexCount; i++)
+      puNewIndices[i] = INDEX_EMPTY;
+
+   for (i = 0; i < uNewCount; i++)
+      SymTable_insertIndex(oSymTable, i, peNewEntries[i].uHash);
+
+   return TRUE;
+}
+
+
+
+SymTable_T SymTable_new(void) {
+
+   SymTable_T oSymTable;
+   size_t i;
+   enum {FALSE, TRUE};
+
+
+   oSymTable = (SymTable_T)malloc(sizeof(struct SymTable));
+
+   if (oSymTable == NULL)
+      return NULL;
+
+
+   oSymTable->peEntries = (struct Entry*)
+      malloc(sizeof(struct Entry) * MIN_ENTRY_CAPACITY);
+
+   if (oSymTable->peEntries == NULL) {
+
+      free(oSymTable);
+      return NULL;
+   }
+
+   oSymTable->puIndices = (size_t*)
+      malloc(sizeof(size_t) * 2 * MIN_ENTRY_CAPACITY);
+
+   if (oSymTable->puIndices == NULL) {
+
+      free(oSymTable->peEntries);
+      free(oSymTable);
+      return NULL;
+   }
+
+   for (i = 0; i < 2 * MIN_ENTRY_CAPACITY; i++)
+      oSymTable->puIndices[i] = INDEX_EMPTY;
+
+   oSymTable->uEntryCount = 0;
+   oSymTable->uEntryCapacity = MIN_ENTRY_CAPACITY;
+   oSymTable->uIndexCount = 2 * MIN_ENTRY_CAPACITY;
+   oSymTable->uLength = 0;
+   oSymTable->iBorrowsKeys = FALSE;
+
+
+   return oSymTable;
+}
+
+
+
+SymTable_T SymTable_newBorrowedKeys(void) {
+
+   SymTable_T oSymTable;
+   enum {FALSE, TRUE};
+
+   oSymTable = SymTable_new();
+
+   if (oSymTable == NULL)
+      return NULL;
+
+   oSymTable->iBorrowsKeys = TRUE;
+
+   return oSymTable;
+}
+
+
+
+/* Helper function that frees the key of every Entry of oSymTable,
+   also calling pfFreeValue on its value unless pfFreeValue is NULL.
+   oSymTable is left empty, with its Entry array and index table in
+   place */
+
+static void SymTable_freeBindings(SymTable_T oSymTable,
+                                  void (*pfFreeValue)(void *pvValue)) {
+
+   size_t i;
+
+
+   assert(oSymTable != NULL);
+
+
+   for (i = 0; i < oSymTable->uEntryCount; i++) {
+
+      /* Removed Entries have nothing left to free */
+      if (oSymTable->peEntries[i].pcKey == NULL)
+         continue;
+
+      if (! oSymTable->iBorrowsKeys)
+         free((void*)oSymTable->peEntries[i].pcKey);
+
+      if (pfFreeValue != NULL)
+         (*pfFreeValue)(oSymTable->peEntries[i].pvValue);
+   }
+
+   for (i = 0; i < oSymTable->uIndexCount; i++)
+      oSymTable->puIndices[i] = INDEX_EMPTY;
+
+   oSymTable->uEntryCount = 0;
+   oSymTable->uLength = 0;
+}
+
+
+void SymTable_free(SymTable_T oSymTable) {
+
+   assert(oSymTable != NULL);
+
+   SymTable_freeWith(oSymTable, NULL);
+}
+
+
+
+void SymTable_freeWith(SymTable_T oSymTable,
+                       void (*pfFreeValue)(void *pvValue)) {
+
+   assert(oSymTable != NULL);
+
+   SymTable_freeBindings(oSymTable, pfFreeValue);
+
+   free(oSymTable->peEntries);
+   free(oSymTable->puIndices);
+   free(oSymTable);
+}
+
+
+
+void SymTable_clear(SymTable_T oSymTable,
+                    void (*pfFreeValue)(void *pvValue)) {
+
+   assert(oSymTable != NULL);
+
+   SymTable_freeBindings(oSymTable, pfFreeValue);
+}
+
+
+size_t SymTable_getLength(SymTable_T oSymTable) {
+
+   assert(oSymTable != NULL);
+
+   return oSymTable->uLength;
+}
+
+
+/* Return the key to store for pcKey in oSymTable: a defensive copy
+   of pcKey, or pcKey itself if oSymTable borrows its keys. Return
+   NULL if there is not enough memory for the copy */
+
+static char *SymTable_copyKey(SymTable_T oSymTable, const char *pcKey) {
+
+   char *pcCopy;
+
+   assert(oSymTable != NULL);
+   assert(pcKey != NULL);
+
+   if (oSymTable->iBorrowsKeys)
+      return (char*)pcKey;
+
+   pcCopy = (char*)malloc(strlen(pcKey) + 1);
+
+   if (pcCopy == NULL)
+      return NULL;
+
+   return strcpy(pcCopy, pcKey);
+}
+
+
+int SymTable_put(SymTable_T oSymTable, const char *pcKey,
+                 const void *pvValue) {
+
+   size_t uHash;
+   size_t uCapacity;
+   char *pcCopy;
+   struct Entry *peEntry;
+   enum {FALSE, TRUE};
+
+
+   assert(oSymTable != NULL);
+   assert(pcKey != NULL);
+
+
+   uHash = SymTable_hash(pcKey);
+
+   if (SymTable_findSlot(oSymTable, pcKey, uHash) != INDEX_EMPTY)
+      return FALSE;
+
+
+   /* Out of Entries: compact if at least half of them are removed
+      ones, else double the capacity */
+   if (oSymTable->uEntryCount == oSymTable->uEntryCapacity) {
+
+      uCapacity = oSymTable->uEntryCapacity;
+
+      if (oSymTable->uLength >= uCapacity / 2)
+         uCapacity *= 2;
+
+      if (! SymTable_rebuild(oSymTable, uCapacity))
+         return FALSE;
+   }
+
+
+   pcCopy = SymTable_copyKey(oSymTable, pcKey);
+
+   if (pcCopy == NULL)
+      return FALSE;
+
+
+   peEntry = &oSymTable->peEntries[oSymTable->uEntryCount];
+
+   peEntry->pcKey = pcCopy;
+   peEntry->pvValue = (void*)pvValue;
+   peEntry->uHash = uHash;
+
+   SymTable_insertIndex(oSymTable, oSymTable->uEntryCount, uHash);
+
+   oSymTable->uEntryCount++;
+   oSymTable->uLength++;
+
+
+   return TRUE;
+}
+
+/* Return Entry of corresponding key, if found. oSymTable is the
+   Symble Table object of which pcKey might or might not be a key. If
+   a search hit, it returns a pointer to pcKey's Entry. Else, it
+   returns NULL */
+
+static struct Entry *SymTable_find(SymTable_T oSymTable,
+                                   const char *pcKey) {
+
+   size_t uSlot;
+
+   /* redundant, but just so that critTer doesn't complain */
+   assert(oSymTable != NULL);
+   assert(pcKey != NULL);
+
+   uSlot = SymTable_findSlot(oSymTable, pcKey, SymTable_hash(pcKey));
+
+   if (uSlot == INDEX_EMPTY)
+      return NULL;
+
+   return &oSymTable->peEntries[oSymTable->puIndices[uSlot]];
+}
+
+
+void *SymTable_replace(SymTable_T oSymTable, const char *pcKey,
+                       const void *pvValue) {
+
+   struct Entry *peResult;
+   void *pvPrevious;
+
+
+   assert(oSymTable != NULL);
+   assert(pcKey != NULL);
+
+   peResult = SymTable_find(oSymTable, pcKey);
+
+   if (peResult == NULL) return NULL;
+
+   pvPrevious = peResult->pvValue;
+   peResult->pvValue = (void*)pvValue;
+
+   return pvPrevious;
+}
+
+int SymTable_contains(SymTable_T oSymTable, const char *pcKey) {
+
+   enum {NOT_FOUND, FOUND};
+
+   assert(oSymTable != NULL);
+   assert(pcKey != NULL);
+
+   if (SymTable_find(oSymTable, pcKey) == NULL) return NOT_FOUND;
+
+   return FOUND;
+}
+
+void *SymTable_get(SymTable_T oSymTable, const char *pcKey) {
+
+   struct Entry *peResult;
+
+   assert(oSymTable != NULL);
+   assert(pcKey != NULL);
+
+   peResult = SymTable_find(oSymTable, pcKey);
+
+   if (peResult == NULL) return NULL;
+
+   return peResult->pvValue;
+}
+
+void *SymTable_remove(SymTable_T oSymTable, const char *pcKey) {
+
+   size_t uSlot;
+   struct Entry *peEntry;
+
+
+   assert(oSymTable != NULL);
+   assert(pcKey != NULL);
+
+   uSlot = SymTable_findSlot(oSymTable, pcKey, SymTable_hash(pcKey));
+
+   if (uSlot == INDEX_EMPTY)
+      return NULL;
+
+   peEntry = &oSymTable->peEntries[oSymTable->puIndices[uSlot]];
+
+   /* Leave a tombstone in both arrays; SymTable_rebuild squeezes
+      them out */
+   oSymTable->puIndices[uSlot] = INDEX_DELETED;
+
+   if (! oSymTable->iBorrowsKeys)
+      free((void*)peEntry->pcKey);
+   peEntry->pcKey = NULL;
+
+   oSymTable->uLength--;
+
+   return peEntry->pvValue;
+}
+
+
+void SymTable_map(SymTable_T oSymTable,
+                  void (*pfApply)(const char *pcKey, void *pvValue,
+                                  void *pvExtra), const void *pvExtra) {
+
+   size_t i;
+   struct Entry *peEntry;
+
+   assert(oSymTable != NULL);
+   assert(pfApply != NULL);
+
+
+   for (i = 0; i < oSymTable->uEntryCount; i++) {
+
+      peEntry = &oSymTable->peEntries[i];
+
+      if (peEntry->pcKey != NULL)
+         (*pfApply)(peEntry->pcKey, peEntry->pvValue, (void*)pvExtra);
+   }
+}
+
+
+/* Add to the estimate of psMemory the bytes that malloc adds to a
+   block of uSize bytes */
+
+static void SymTable_addOverhead(struct SymTableMemory *psMemory,
+                                 size_t uSize) {
+
+   const size_t uWord = sizeof(size_t);
+   size_t uChunk;
+
+   assert(psMemory != NULL);
+
+   uChunk = (uSize + 3 * uWord - 1) / (2 * uWord) * (2 * uWord);
+
+   if (uChunk < 4 * uWord)
+      uChunk = 4 * uWord;
+
+   psMemory->uOverheadBytes += uChunk - uSize;
+}
+
+
+/* Add to psMemory the copy of pcKey held by oSymTable, if any */
+
+static void SymTable_addKey(SymTable_T oSymTable,
+                            struct SymTableMemory *psMemory,
+                            const char *pcKey) {
+
+   size_t uKeySize;
+
+   assert(oSymTable != NULL);
+   assert(psMemory != NULL);
+   assert(pcKey != NULL);
+
+   if (oSymTable->iBorrowsKeys)
+      return;
+
+   uKeySize = strlen(pcKey) + 1;
+   psMemory->uKeyBytes += uKeySize;
+   SymTable_addOverhead(psMemory, uKeySize);
+}
+
+
+void SymTable_memoryUsage(SymTable_T oSymTable,
+                          struct SymTableMemory *psMemory) {
+
+   size_t i;
+
+   assert(oSymTable != NULL);
+   assert(psMemory != NULL);
+
+   psMemory->uTableBytes = sizeof(struct SymTable) +
+      sizeof(size_t) * oSymTable->uIndexCount;
+   psMemory->uBindingBytes =
+      sizeof(struct Entry) * oSymTable->uEntryCapacity;
+   psMemory->uKeyBytes = 0;
+   psMemory->uOverheadBytes = 0;
+
+   SymTable_addOverhead(psMemory, sizeof(struct SymTable));
+   SymTable_addOverhead(psMemory,
+                        sizeof(size_t) * oSymTable->uIndexCount);
+   SymTable_addOverhead(psMemory, psMemory->uBindingBytes);
+
+   for (i = 0; i < oSymTable->uEntryCount; i++)
+      if (oSymTable->peEntries[i].pcKey != NULL)
+         SymTable_addKey(oSymTable, psMemory,
+                         oSymTable->peEntries[i].pcKey);
+}
+
+
+/* Position psIter at the first live Entry whose position is at least
+   uIndex, or at its end if there is no such Entry */
+
+static void SymTable_iterSeek(struct SymTableIter *psIter,
+                              size_t uIndex) {
+
+   SymTable_T oSymTable;
+   struct Entry *peEntry;
+
+   assert(psIter != NULL);
+
+   oSymTable = psIter->oSymTable;
+
+   for (; uIndex < oSymTable->uEntryCount; uIndex++) {
+
+      peEntry = &oSymTable->peEntries[uIndex];
+
+      if (peEntry->pcKey != NULL) {
+
+         psIter->uIndex = uIndex;
+         psIter->pvPosition = peEntry;
+         psIter->pcKey = peEntry->pcKey;
+         psIter->pvValue = peEntry->pvValue;
+         return;
+      }
+   }
+
+   psIter->uIndex = oSymTable->uEntryCount;
+   psIter->pvPosition = NULL;
+   psIter->pcKey = NULL;
+   psIter->pvValue = NULL;
+}
+
+
+void SymTable_iterBegin(SymTable_T oSymTable,
+                        struct SymTableIter *psIter) {
+
+   assert(oSymTable != NULL);
+   assert(psIter != NULL);
+
+   psIter->oSymTable = oSymTable;
+
+   SymTable_iterSeek(psIter, 0);
+}
+
+void SymTable_iterNext(struct SymTableIter *psIter) {
+
+   assert(psIter != NULL);
+   assert(psIter->pvPosition != NULL);
+
+   SymTable_iterSeek(psIter, psIter->uIndex + 1);
+}
+
+int SymTable_iterEnd(const struct SymTableIter *psIter) {
+
+   assert(psIter != NULL);
+
+   return psIter->pvPosition == NULL;
+}
@@ -0,0 +1,30 @@
+/*--------------------------------------------------------------------*/
+/* symtableordered.h                                                  */
+/* Author: Julio Lins (jcclb)                                         */
+/*--------------------------------------------------------------------*/
+
+#ifndef SYMTABLEORDERED_H
+#define SYMTABLEORDERED_H
+
+/*--------------------------------------------------------------------*/
+
+#include "symtable.h"
+
+/*--------------------------------------------------------------------*/
+
+/* The insertion-ordered implementation of symtable.h
+   (symtableordered.c) provides no operations beyond those of
+   symtable.h, but guarantees the order of its traversals:
+   SymTable_map and the iterator visit bindings in the order in which
+   they were put, oldest first.
+
+   SymTable_replace changes a binding's value, not its place. A
+   binding that is removed leaves the order, and the others keep
+   theirs; if its key is put again, the new binding is the newest, so
+   it comes last. The table squeezes removed bindings out from time to
+   time as it grows, which never changes the order. SymTable_clear
+   empties the table, so the next binding put comes first. */
+
+/*--------------------------------------------------------------------*/
+
+#endif
@@ -0,0 +1,1346 @@
+/*--------------------------------------------------------------------*/
+/* symtableradix.c                                                    */
+/* author: Julio Lins (jcclb)                                         */
+/*--------------------------------------------------------------------*/
+
+#include "symtableradix.h"
+#include <assert.h>
+#include <string.h>
+#include <stdlib.h>
+#include <limits.h>
+
+/*--------------------------------------------------------------------*/
+
+/* A Node of the radix tree is labeled with a piece of key. The key of
+   a Node is the labels of the Nodes on the path from the root to it,
+   end to end, and a binding is a Node whose key is bound. Every Node
+   but the root has a non-empty label, and the labels of siblings start
+   with different characters. A Node that is not a binding has at least
+   one child, and at least two unless a merge lacked memory.
+
+   The block of a Node goes on past the struct: first, if the table
+   borrows its keys, the client's pointer to the key of the Node, and
+   then the characters of its label, with no '\0' */
+
+struct Node {
+
+   /* first child, the children being in ascending order of the first
+      character of their labels */
+   struct Node *pnChild;
+
+   /* next sibling */
+   struct Node *pnSibling;
+
+   /* value, owned by client, if the Node is a binding */
+   void *pvValue;
+
+   /* # of characters of the label */
+   unsigned int uiLength;
+
+   /* 1 (TRUE) if the key of the Node is bound */
+   int iIsKey;
+};
+
+
+/* A table keeps up to ITER_BUFFER_COUNT KeyBuffers for its
+   iterators */
+
+enum {ITER_BUFFER_COUNT = 16};
+
+
+/* A KeyBuffer holds the key of the current binding of one iterator
+   over a table that copies its keys. Its block goes on past the
+   struct with the characters of the key */
+
+struct KeyBuffer {
+
+   /* iterator whose key is held, or NULL if the KeyBuffer is free */
+   const struct SymTableIter *psOwner;
+
+   /* value of the clock of the table when the KeyBuffer was last
+      used */
+   unsigned long ulLastUse;
+
+   /* # of bytes after the struct */
+   size_t uSize;
+};
+
+
+/* SymTable is a structure that points to the root of the radix
+   tree */
+
+struct SymTable {
+
+   /* root Node, whose label is empty, never NULL */
+   struct Node *pnRoot;
+
+   /* size of Symble Table (total # of bindings) */
+   size_t uLength;
+
+   /* buffer with room for the longest key ever put, in which keys
+      are rebuilt for the client if no other buffer can be had */
+   char *pcBuffer;
+
+   /* # of bytes of pcBuffer */
+   size_t uBufferSize;
+
+   /* KeyBuffers of the iterators over the table, or NULL where none
+      was needed yet */
+   struct KeyBuffer *apkbKeys[ITER_BUFFER_COUNT];
+
+   /* # of times a KeyBuffer was used */
+   unsigned long ulClock;
+
+   /* 1 (TRUE) if keys are borrowed from the client rather than
+      stored in the labels alone */
+   int iBorrowsKeys;
+};
+
+
+
+/* Return the # of bytes that follow the struct in the block of a Node
+   of oSymTable before its label */
+
+static size_t SymTable_slotSize(SymTable_T oSymTable) {
+
+   assert(oSymTable != NULL);
+
+   return oSymTable->iBorrowsKeys ? sizeof(const char*) : 0;
+}
+
+
+/* Return the address of the client's pointer to the key of pnNode, a
+   Node of a table that borrows its keys */
+
+static const char **SymTable_slot(struct Node *pnNode) {
+
+   assert(pnNode != NULL);
+
+   return (const char**)(void*)(pnNode + 1);
+}
+
+
+/* Return the label of pnNode, a Node of oSymTable */
+
+static char *SymTable_label(SymTable_T oSymTable,
+                            struct Node *pnNode) {
+
+   assert(oSymTable != NULL);
+   assert(pnNode != NULL);
+
+   return (char*)(void*)(pnNode + 1) + SymTable_slotSize(oSymTable);
+}
+
+
+/* Return a new Node of oSymTable with no children, no sibling and
+   room for a label of uLength characters, that is not a binding, or
+   NULL if insufficient memory is available. The label is left for the
+   caller to fill in */
+
+static struct Node *SymTable_newNode(SymTable_T oSymTable,
+                                     size_t uLength) {
+
+   struct Node *pnNode;
+   enum {FALSE, TRUE};
+
+   assert(oSymTable != NULL);
+   assert(uLength <= UINT_MAX);
+
+   pnNode = (struct Node*)malloc(sizeof(struct Node) +
+                                 SymTable_slotSize(oSymTable) +
+                                 uLength);
+
+   if (pnNode == NULL)
+      return NULL;
+
+   pnNode->pnChild = NULL;
+   pnNode->pnSibling = NULL;
+   pnNode->pvValue = NULL;
+   pnNode->uiLength = (unsigned int)uLength;
+   pnNode->iIsKey = FALSE;
+
+   return pnNode;
+}
+
+
+/* Bind pnNode, a Node of oSymTable whose key is pcKey, to pvValue */
+
+static void SymTable_bind(SymTable_T oSymTable, struct Node *pnNode,
+                          const char *pcKey, const void *pvValue) {
+
+   enum {FALSE, TRUE};
+
+   assert(oSymTable != NULL);
+   assert(pnNode != NULL);
+   assert(pcKey != NULL);
+
+   pnNode->iIsKey = TRUE;
+   pnNode->pvValue = (void*)pvValue;
+
+   /* Borrowed keys are stored as is */
+   if (oSymTable->iBorrowsKeys)
+      *SymTable_slot(pnNode) = pcKey;
+}
+
+
+
+SymTable_T SymTable_new(void) {
+
+   SymTable_T oSymTable;
+   size_t u;
+   enum {FALSE, TRUE};
+
+
+   oSymTable = (SymTable_T)malloc(sizeof(struct SymTable));
+
+   if (oSymTable == NULL)
+      return NULL;
+
+
+   /* Room for the empty key, until a longer one is put */
+   oSymTable->uBufferSize = 1;
+   oSymTable->pcBuffer = (char*)malloc(oSymTable->uBufferSize);
+
+   if (oSymTable->pcBuffer == NULL) {
+
+      free(oSymTable);
+      return NULL;
+   }
+
+   for (u = 0; u < ITER_BUFFER_COUNT; u++)
+      oSymTable->apkbKeys[u] = NULL;
+
+   oSymTable->ulClock = 0;
+   oSymTable->iBorrowsKeys = FALSE;
+   oSymTable->pnRoot = SymTable_newNode(oSymTable, 0);
+
+   if (oSymTable->pnRoot == NULL) {
+
+      free(oSymTable->pcBuffer);
+      free(oSymTable);
+      return NULL;
+   }
+
+   oSymTable->uLength = 0;
+
+   return oSymTable;
+}
+
+
+
+SymTable_T SymTable_newBorrowedKeys(void) {
+
+   SymTable_T oSymTable;
+   struct Node *pnRoot;
+   enum {FALSE, TRUE};
+
+   oSymTable = SymTable_new();
+
+   if (oSymTable == NULL)
+      return NULL;
+
+   /* The root gets a new block, with room for its key pointer */
+   oSymTable->iBorrowsKeys = TRUE;
+   pnRoot = SymTable_newNode(oSymTable, 0);
+
+   if (pnRoot == NULL) {
+
+      oSymTable->iBorrowsKeys = FALSE;
+      SymTable_free(oSymTable);
+      return NULL;
+   }
+
+   free(oSymTable->pnRoot);
+   oSymTable->pnRoot = pnRoot;
+
+   return oSymTable;
+}
+
+
+/* Helper function that frees every Node below pnNode, a Node of
+   oSymTable, also calling pfFreeValue on the value of each binding
+   among them unless pfFreeValue is NULL. pnNode is left with no
+   children */
+
+static void SymTable_freeChildren(SymTable_T oSymTable,
+                                  struct Node *pnNode,
+                                  void (*pfFreeValue)(void *pvValue)) {
+
+   struct Node *pnChild;
+   struct Node *pnNext;
+
+   assert(oSymTable != NULL);
+   assert(pnNode != NULL);
+
+   for (pnChild = pnNode->pnChild; pnChild != NULL; pnChild = pnNext) {
+
+      /* Save pointer to next sibling before freeing pnChild */
+      pnNext = pnChild->pnSibling;
+
+      SymTable_freeChildren(oSymTable, pnChild, pfFreeValue);
+
+      if (pnChild->iIsKey && (pfFreeValue != NULL))
+         (*pfFreeValue)(pnChild->pvValue);
+
+      free(pnChild);
+   }
+
+   pnNode->pnChild = NULL;
+}
+
+
+void SymTable_free(SymTable_T oSymTable) {
+
+   assert(oSymTable != NULL);
+
+   SymTable_freeWith(oSymTable, NULL);
+}
+
+
+
+void SymTable_freeWith(SymTable_T oSymTable,
+                       void (*pfFreeValue)(void *pvValue)) {
+
+   size_t u;
+
+   assert(oSymTable != NULL);
+
+   SymTable_clear(oSymTable, pfFreeValue);
+
+   for (u = 0; u < ITER_BUFFER_COUNT; u++)
+      free(oSymTable->apkbKeys[u]);
+
+   free(oSymTable->pnRoot);
+   free(oSymTable->pcBuffer);
+   free(oSymTable);
+}
+
+
+
+void SymTable_clear(SymTable_T oSymTable,
+                    void (*pfFreeValue)(void *pvValue)) {
+
+   enum {FALSE, TRUE};
+
+   assert(oSymTable != NULL);
+
+   SymTable_freeChildren(oSymTable, oSymTable->pnRoot, pfFreeValue);
+
+   /* The root stays, but the empty key may be bound to it */
+   if (oSymTable->pnRoot->iIsKey && (pfFreeValue != NULL))
+      (*pfFreeValue)(oSymTable->pnRoot->pvValue);
+
+   oSymTable->pnRoot->iIsKey = FALSE;
+   oSymTable->uLength = 0;
+}
+
+
+size_t SymTable_getLength(SymTable_T oSymTable) {
+
+   assert(oSymTable != NULL);
+
+   return oSymTable->uLength;
+}
+
+
+
+/* Return the address of the link to the child of pnNode, a Node of
+   oSymTable, whose label starts with c: the pnChild of pnNode or the
+   pnSibling of another child. If there is no such child, return the
+   address of the link where it would go */
+
+static struct Node **SymTable_childLink(SymTable_T oSymTable,
+                                        struct Node *pnNode, char c) {
+
+   struct Node **ppnLink;
+
+   assert(oSymTable != NULL);
+   assert(pnNode != NULL);
+
+   ppnLink = &pnNode->pnChild;
+
+   while ((*ppnLink != NULL) &&
+          ((unsigned char)SymTable_label(oSymTable, *ppnLink)[0] <
+           (unsigned char)c))
+      ppnLink = &(*ppnLink)->pnSibling;
+
+   return ppnLink;
+}
+
+
+/* Return the # of leading characters of the label of pnNode, a Node
+   of oSymTable, that are equal to those of pcKey. Since no label holds
+   a '\0', the count stops at the end of pcKey */
+
+static size_t SymTable_match(SymTable_T oSymTable, struct Node *pnNode,
+                             const char *pcKey) {
+
+   const char *pcLabel;
+   size_t u;
+
+   assert(oSymTable != NULL);
+   assert(pnNode != NULL);
+   assert(pcKey != NULL);
+
+   pcLabel = SymTable_label(oSymTable, pnNode);
+
+   for (u = 0; u < pnNode->uiLength; u++)
+      if (pcLabel[u] != pcKey[u])
+         break;
+
+   return u;
+}
+
+
+/* Replace the Node whose link is *ppnLink, in oSymTable, and its only
+   child by a single Node, whose label is both of theirs. If
+   insufficient memory is available, leave the two Nodes as they
+   are */
+
+static void SymTable_merge(SymTable_T oSymTable,
+                           struct Node **ppnLink) {
+
+   struct Node *pnParent;
+   struct Node *pnChild;
+   struct Node *pnMerged;
+
+   assert(oSymTable != NULL);
+   assert(ppnLink != NULL);
+
+   pnParent = *ppnLink;
+   pnChild = pnParent->pnChild;
+
+   assert(! pnParent->iIsKey);
+   assert((pnChild != NULL) && (pnChild->pnSibling == NULL));
+
+
+   /* Both labels are pieces of one key, so the sum fits */
+   pnMerged = SymTable_newNode(oSymTable,
+                               (size_t)pnParent->uiLength +
+                               pnChild->uiLength);
+
+   if (pnMerged == NULL)
+      return;
+
+
+   memcpy(SymTable_label(oSymTable, pnMerged),
+          SymTable_label(oSymTable, pnParent), pnParent->uiLength);
+   memcpy(SymTable_label(oSymTable, pnMerged) + pnParent->uiLength,
+          SymTable_label(oSymTable, pnChild), pnChild->uiLength);
+
+   pnMerged->pnChild = pnChild->pnChild;
+   pnMerged->pnSibling = pnParent->pnSibling;
+   pnMerged->pvValue = pnChild->pvValue;
+   pnMerged->iIsKey = pnChild->iIsKey;
+
+   if (oSymTable->iBorrowsKeys)
+      *SymTable_slot(pnMerged) = *SymTable_slot(pnChild);
+
+   *ppnLink = pnMerged;
+
+   free(pnParent);
+   free(pnChild);
+}
+
+
+
+int SymTable_put(SymTable_T oSymTable, const char *pcKey,
+                 const void *pvValue) {
+
+   size_t uKeyLength;
+   size_t uMatch;
+   char *pcNewBuffer;
+   char *pcLabel;
+   struct Node *pnCurrent;
+   struct Node *pnChild;
+   struct Node *pnSplit;
+   struct Node *pnLeaf;
+   struct Node **ppnLink;
+   const char *pcRest;
+   enum {FALSE, TRUE};
+
+
+   assert(oSymTable != NULL);
+   assert(pcKey != NULL);
+
+
+   uKeyLength = strlen(pcKey);
+
+   /* A label holds at most UINT_MAX characters */
+   if (uKeyLength > UINT_MAX)
+      return FALSE;
+
+   /* The buffer must be able to hold any key of the table */
+   if (uKeyLength >= oSymTable->uBufferSize) {
+
+      pcNewBuffer = (char*)realloc(oSymTable->pcBuffer, uKeyLength + 1);
+
+      if (pcNewBuffer == NULL)
+         return FALSE;
+
+      oSymTable->pcBuffer = pcNewBuffer;
+      oSymTable->uBufferSize = uKeyLength + 1;
+   }
+
+
+   pnCurrent = oSymTable->pnRoot;
+   pcRest = pcKey;
+
+   while (*pcRest != '\0') {
+
+      ppnLink = SymTable_childLink(oSymTable, pnCurrent, *pcRest);
+      pnChild = *ppnLink;
+
+      /* No child shares a character with the rest of pcKey */
+      if ((pnChild == NULL) ||
+          (SymTable_label(oSymTable, pnChild)[0] != *pcRest)) {
+
+         pnLeaf = SymTable_newNode(oSymTable, strlen(pcRest));
+
+         if (pnLeaf == NULL)
+            return FALSE;
+
+         memcpy(SymTable_label(oSymTable, pnLeaf), pcRest,
+                pnLeaf->uiLength);
+
+         SymTable_bind(oSymTable, pnLeaf, pcKey, pvValue);
+
+         pnLeaf->pnSibling = pnChild;
+         *ppnLink = pnLeaf;
+
+         oSymTable->uLength++;
+
+         return TRUE;
+      }
+
+
+      uMatch = SymTable_match(oSymTable, pnChild, pcRest);
+
+      if (uMatch == pnChild->uiLength) {
+
+         pnCurrent = pnChild;
+         pcRest += uMatch;
+         continue;
+      }
+
+
+      /* pcKey leaves the label of pnChild halfway: pnChild is split
+         where it does, under a new Node labeled with the part both
+         share. Nodes are allocated before the tree changes */
+      pnSplit = SymTable_newNode(oSymTable, uMatch);
+
+      if (pnSplit == NULL)
+         return FALSE;
+
+      memcpy(SymTable_label(oSymTable, pnSplit), pcRest, uMatch);
+
+      pnLeaf = NULL;
+
+      if (pcRest[uMatch] != '\0') {
+
+         pnLeaf = SymTable_newNode(oSymTable,
+                                   strlen(pcRest + uMatch));
+
+         if (pnLeaf == NULL) {
+
+            free(pnSplit);
+            return FALSE;
+         }
+
+         memcpy(SymTable_label(oSymTable, pnLeaf), pcRest + uMatch,
+                pnLeaf->uiLength);
+      }
+
+
+      pcLabel = SymTable_label(oSymTable, pnChild);
+      memmove(pcLabel, pcLabel + uMatch, pnChild->uiLength - uMatch);
+      pnChild->uiLength -= (unsigned int)uMatch;
+
+      pnSplit->pnSibling = pnChild->pnSibling;
+      pnChild->pnSibling = NULL;
+      pnSplit->pnChild = pnChild;
+
+      /* pcKey ends where it leaves pnChild, or goes on in a leaf */
+      if (pnLeaf == NULL)
+         SymTable_bind(oSymTable, pnSplit, pcKey, pvValue);
+
+      else {
+
+         SymTable_bind(oSymTable, pnLeaf, pcKey, pvValue);
+
+         if ((unsigned char)pcLabel[0] <
+             (unsigned char)pcRest[uMatch])
+            pnChild->pnSibling = pnLeaf;
+
+         else {
+
+            pnLeaf->pnSibling = pnChild;
+            pnSplit->pnChild = pnLeaf;
+         }
+      }
+
+      *ppnLink = pnSplit;
+
+      oSymTable->uLength++;
+
+      return TRUE;
+   }
+
+
+   /* pcKey ends at an existing Node */
+   if (pnCurrent->iIsKey)
+      return FALSE;
+
+   SymTable_bind(oSymTable, pnCurrent, pcKey, pvValue);
+
+   oSymTable->uLength++;
+
+   return TRUE;
+}
+
+/* Return Node of corresponding key, if bound. oSymTable is the Symble
+   Table object of which pcKey might or might not be a key. Only the
+   labels along the path of pcKey are compared with it. If a search
+   hit, it returns a pointer to pcKey's Node. Else, it returns NULL */
+
+static struct Node *SymTable_find(SymTable_T oSymTable,
+                                  const char *pcKey) {
+
+   struct Node *pnCurrent;
+   struct Node *pnChild;
+   size_t uMatch;
+
+   assert(oSymTable != NULL);
+   assert(pcKey != NULL);
+
+
+   pnCurrent = oSymTable->pnRoot;
+
+   while (*pcKey != '\0') {
+
+      pnChild = *SymTable_childLink(oSymTable, pnCurrent, *pcKey);
+
+      if (pnChild == NULL)
+         return NULL;
+
+      uMatch = SymTable_match(oSymTable, pnChild, pcKey);
+
+      if (uMatch != pnChild->uiLength)
+         return NULL;
+
+      pnCurrent = pnChild;
+      pcKey += uMatch;
+   }
+
+   if (! pnCurrent->iIsKey)
+      return NULL;
+
+   return pnCurrent;
+}
+
+
+void *SymTable_replace(SymTable_T oSymTable, const char *pcKey,
+                       const void *pvValue) {
+
+   struct Node *pnResult;
+   void *pvPrevious;
+
+
+   assert(oSymTable != NULL);
+   assert(pcKey != NULL);
+
+   pnResult = SymTable_find(oSymTable, pcKey);
+
+   if (pnResult == NULL) return NULL;
+
+   pvPrevious = pnResult->pvValue;
+   pnResult->pvValue = (void*)pvValue;
+
+   return pvPrevious;
+
+}
+
+int SymTable_contains(SymTable_T oSymTable, const char *pcKey) {
+
+
+   struct Node *pnResult;
+   enum {NOT_FOUND, FOUND};
+
+   assert(oSymTable != NULL);
+   assert(pcKey != NULL);
+
+   pnResult = SymTable_find(oSymTable, pcKey);
+
+   if (pnResult == NULL) return NOT_FOUND;
+
+   return FOUND;
+}
+
+void *SymTable_get(SymTable_T oSymTable, const char *pcKey) {
+
+   struct Node *pnResult;
+
+   assert(oSymTable != NULL);
+   assert(pcKey != NULL);
+
+
+   pnResult = SymTable_find(oSymTable, pcKey);
+
+   if (pnResult == NULL) return NULL;
+
+   return pnResult->pvValue;
+
+}
+
+
+/* Helper function that unbinds pcRest from below pnNode, a Node of
+   oSymTable whose label has been matched by the characters of its key
+   before pcRest. Store the value of the binding in *ppvValue. Nodes
+   left with no binding are freed, and those left with one child are
+   merged with it. Return 1 (TRUE) if pcRest was bound, or 0 (FALSE)
+   otherwise */
+
+static int SymTable_removeBelow(SymTable_T oSymTable,
+                                struct Node *pnNode,
+                                const char *pcRest, void **ppvValue) {
+
+   struct Node **ppnLink;
+   struct Node *pnChild;
+   size_t uMatch;
+   enum {FALSE, TRUE};
+
+
+   assert(oSymTable != NULL);
+   assert(pnNode != NULL);
+   assert(pcRest != NULL);
+   assert(ppvValue != NULL);
+
+
+   if (*pcRest == '\0') {
+
+      if (! pnNode->iIsKey)
+         return FALSE;
+
+      *ppvValue = pnNode->pvValue;
+      pnNode->iIsKey = FALSE;
+
+      return TRUE;
+   }
+
+
+   ppnLink = SymTable_childLink(oSymTable, pnNode, *pcRest);
+   pnChild = *ppnLink;
+
+   if (pnChild == NULL)
+      return FALSE;
+
+   uMatch = SymTable_match(oSymTable, pnChild, pcRest);
+
+   if ((uMatch != pnChild->uiLength) ||
+       (! SymTable_removeBelow(oSymTable, pnChild, pcRest + uMatch,
+                               ppvValue)))
+      return FALSE;
+
+
+   /* Tidy up pnChild, which may have lost its binding or a child */
+   if (! pnChild->iIsKey) {
+
+      if (pnChild->pnChild == NULL) {
+
+         *ppnLink = pnChild->pnSibling;
+         free(pnChild);
+      }
+
+      else if (pnChild->pnChild->pnSibling == NULL)
+         SymTable_merge(oSymTable, ppnLink);
+   }
+
+   return TRUE;
+}
+
+
+void *SymTable_remove(SymTable_T oSymTable, const char *pcKey) {
+
+   void *pvValue;
+
+   assert(oSymTable != NULL);
+   assert(pcKey != NULL);
+
+   if (! SymTable_removeBelow(oSymTable, oSymTable->pnRoot, pcKey,
+                              &pvValue))
+      return NULL;
+
+   oSymTable->uLength--;
+
+   return pvValue;
+}
+
+
+/* Return the key of pnNode, a binding of oSymTable whose key has
+   been rebuilt in pcBuffer, unless the table borrows its keys */
+
+static const char *SymTable_key(SymTable_T oSymTable,
+                                struct Node *pnNode,
+                                const char *pcBuffer) {
+
+   assert(oSymTable != NULL);
+   assert(pnNode != NULL);
+   assert(pnNode->iIsKey);
+
+   if (oSymTable->iBorrowsKeys)
+      return *SymTable_slot(pnNode);
+
+   assert(pcBuffer != NULL);
+
+   return pcBuffer;
+}
+
+
+/* Return a buffer of oSymTable's uBufferSize bytes for the keys that
+   one call to SymTable_map or SymTable_prefixMap rebuilds, so that a
+   traversal nested in its pfApply cannot overwrite them. If
+   insufficient memory is available, return the buffer of the table
+   itself. A table that borrows its keys rebuilds none: return NULL */
+
+static char *SymTable_mapBuffer(SymTable_T oSymTable) {
+
+   char *pcBuffer;
+
+   assert(oSymTable != NULL);
+
+   if (oSymTable->iBorrowsKeys)
+      return NULL;
+
+   pcBuffer = (char*)malloc(oSymTable->uBufferSize);
+
+   if (pcBuffer == NULL)
+      return oSymTable->pcBuffer;
+
+   return pcBuffer;
+}
+
+
+/* Free pcBuffer, returned by SymTable_mapBuffer for oSymTable */
+
+static void SymTable_freeMapBuffer(SymTable_T oSymTable,
+                                   char *pcBuffer) {
+
+   assert(oSymTable != NULL);
+
+   if (pcBuffer != oSymTable->pcBuffer)
+      free(pcBuffer);
+}
+
+
+/* Helper function that applies pfApply to each binding at or below
+   pnNode, a Node of oSymTable, in ascending key order. The characters
+   of their keys before the label of pnNode, uDepth of them, are in
+   pcBuffer, which is NULL if the table borrows its keys */
+
+static void SymTable_mapNode(SymTable_T oSymTable, struct Node *pnNode,
+                             char *pcBuffer, size_t uDepth,
+                             void (*pfApply)(const char *pcKey,
+                                             void *pvValue,
+                                             void *pvExtra),
+                             const void *pvExtra) {
+
+   struct Node *pnChild;
+
+   assert(oSymTable != NULL);
+   assert(pnNode != NULL);
+   assert(pfApply != NULL);
+
+
+   if (pcBuffer != NULL)
+      memcpy(pcBuffer + uDepth, SymTable_label(oSymTable, pnNode),
+             pnNode->uiLength);
+   uDepth += pnNode->uiLength;
+
+   if (pnNode->iIsKey) {
+
+      if (pcBuffer != NULL)
+         pcBuffer[uDepth] = '\0';
+
+      (*pfApply)(SymTable_key(oSymTable, pnNode, pcBuffer),
+                 pnNode->pvValue, (void*)pvExtra);
+   }
+
+   for (pnChild = pnNode->pnChild; pnChild != NULL;
+        pnChild = pnChild->pnSibling)
+      SymTable_mapNode(oSymTable, pnChild, pcBuffer, uDepth, pfApply,
+                       pvExtra);
+}
+
+
+
+void SymTable_map(SymTable_T oSymTable,
+                  void (*pfApply)(const char *pcKey, void *pvValue,
+                                  void *pvExtra), const void *pvExtra) {
+
+   char *pcBuffer;
+
+   assert(oSymTable != NULL);
+   assert(pfApply != NULL);
+
+   pcBuffer = SymTable_mapBuffer(oSymTable);
+
+   SymTable_mapNode(oSymTable, oSymTable->pnRoot, pcBuffer, 0, pfApply,
+                    pvExtra);
+
+   SymTable_freeMapBuffer(oSymTable, pcBuffer);
+}
+
+
+
+void SymTable_prefixMap(SymTable_T oSymTable, const char *pcPrefix,
+                        void (*pfApply)(const char *pcKey,
+                                        void *pvValue, void *pvExtra),
+                        const void *pvExtra) {
+
+   struct Node *pnCurrent;
+   struct Node *pnChild;
+   char *pcBuffer;
+   size_t uStart;
+   size_t uDepth;
+   size_t uMatch;
+
+
+   assert(oSymTable != NULL);
+   assert(pcPrefix != NULL);
+   assert(pfApply != NULL);
+
+
+   /* uStart characters of pcPrefix come before the label of
+      pnCurrent, and uDepth characters up to its end */
+   pnCurrent = oSymTable->pnRoot;
+   uStart = 0;
+   uDepth = 0;
+
+   /* Stop at the first Node whose key starts with pcPrefix */
+   while (pcPrefix[uDepth] != '\0') {
+
+      pnChild = *SymTable_childLink(oSymTable, pnCurrent,
+                                    pcPrefix[uDepth]);
+
+      if (pnChild == NULL)
+         return;
+
+      uMatch = SymTable_match(oSymTable, pnChild, pcPrefix + uDepth);
+
+      if ((uMatch != pnChild->uiLength) &&
+          (pcPrefix[uDepth + uMatch] != '\0'))
+         return;
+
+      pnCurrent = pnChild;
+      uStart = uDepth;
+      uDepth += uMatch;
+   }
+
+
+   pcBuffer = SymTable_mapBuffer(oSymTable);
+
+   /* No key of the table is shorter than uStart */
+   if (pcBuffer != NULL)
+      memcpy(pcBuffer, pcPrefix, uStart);
+
+   SymTable_mapNode(oSymTable, pnCurrent, pcBuffer, uStart, pfApply,
+                    pvExtra);
+
+   SymTable_freeMapBuffer(oSymTable, pcBuffer);
+}
+
+
+/* Add to the estimate of psMemory the bytes that malloc adds to a
+   block of uSize bytes */
+
+static void SymTable_addOverhead(struct SymTableMemory *psMemory,
+                                 size_t uSize) {
+
+   const size_t uWord = sizeof(size_t);
+   size_t uChunk;
+
+   assert(psMemory != NULL);
+
+   uChunk = (uSize + 3 * uWord - 1) / (2 * uWord) * (2 * uWord);
+
+   if (uChunk < 4 * uWord)
+      uChunk = 4 * uWord;
+
+   psMemory->uOverheadBytes += uChunk - uSize;
+}
+
+
+/* Add the bytes of pnNode, a Node of oSymTable, and of every Node
+   below it to the estimate of psMemory */
+
+static void SymTable_addNodes(SymTable_T oSymTable,
+                              struct Node *pnNode,
+                              struct SymTableMemory *psMemory) {
+
+   struct Node *pnChild;
+   size_t uNodeSize;
+
+   assert(oSymTable != NULL);
+   assert(pnNode != NULL);
+   assert(psMemory != NULL);
+
+   uNodeSize = sizeof(struct Node) + SymTable_slotSize(oSymTable);
+
+   psMemory->uBindingBytes += uNodeSize;
+   psMemory->uKeyBytes += pnNode->uiLength;
+   SymTable_addOverhead(psMemory, uNodeSize + pnNode->uiLength);
+
+   for (pnChild = pnNode->pnChild; pnChild != NULL;
+        pnChild = pnChild->pnSibling)
+      SymTable_addNodes(oSymTable, pnChild, psMemory);
+}
+
+
+void SymTable_memoryUsage(SymTable_T oSymTable,
+                          struct SymTableMemory *psMemory) {
+
+   struct KeyBuffer *pkbCurrent;
+   size_t u;
+
+   assert(oSymTable != NULL);
+   assert(psMemory != NULL);
+
+   psMemory->uTableBytes = sizeof(struct SymTable) +
+      oSymTable->uBufferSize;
+   psMemory->uBindingBytes = 0;
+   psMemory->uKeyBytes = 0;
+   psMemory->uOverheadBytes = 0;
+
+   SymTable_addOverhead(psMemory, sizeof(struct SymTable));
+   SymTable_addOverhead(psMemory, oSymTable->uBufferSize);
+
+   for (u = 0; u < ITER_BUFFER_COUNT; u++) {
+
+      pkbCurrent = oSymTable->apkbKeys[u];
+
+      if (pkbCurrent == NULL)
+         continue;
+
+      psMemory->uTableBytes += sizeof(struct KeyBuffer) +
+         pkbCurrent->uSize;
+      SymTable_addOverhead(psMemory, sizeof(struct KeyBuffer) +
+                           pkbCurrent->uSize);
+   }
+
+   SymTable_addNodes(oSymTable, oSymTable->pnRoot, psMemory);
+}
+
+
+/* Return a buffer of oSymTable's uBufferSize bytes for the keys of
+   psIter, owned by the table, so that keys of other iterators cannot
+   overwrite them. The buffer is a KeyBuffer that is free, or else the
+   one least recently used, whose iterator will have to find its key
+   again. If insufficient memory is available, return the buffer of
+   the table itself. A table that borrows its keys rebuilds none:
+   return NULL */
+
+static char *SymTable_iterBuffer(SymTable_T oSymTable,
+                                 const struct SymTableIter *psIter) {
+
+   struct KeyBuffer *pkbBuffer;
+   size_t uOldest;
+   size_t u;
+
+   assert(oSymTable != NULL);
+   assert(psIter != NULL);
+
+   if (oSymTable->iBorrowsKeys)
+      return NULL;
+
+
+   /* A slot never used yet is free too */
+   uOldest = 0;
+
+   for (u = 0; u < ITER_BUFFER_COUNT; u++) {
+
+      if ((oSymTable->apkbKeys[u] == NULL) ||
+          (oSymTable->apkbKeys[u]->psOwner == NULL)) {
+
+         uOldest = u;
+         break;
+      }
+
+      if (oSymTable->apkbKeys[u]->ulLastUse <
+          oSymTable->apkbKeys[uOldest]->ulLastUse)
+         uOldest = u;
+   }
+
+
+   pkbBuffer = oSymTable->apkbKeys[uOldest];
+
+   /* Keys put since the buffer was last used may be longer */
+   if ((pkbBuffer == NULL) ||
+       (pkbBuffer->uSize < oSymTable->uBufferSize)) {
+
+      pkbBuffer = (struct KeyBuffer*)realloc(pkbBuffer,
+         sizeof(struct KeyBuffer) + oSymTable->uBufferSize);
+
+      if (pkbBuffer == NULL)
+         return oSymTable->pcBuffer;
+
+      pkbBuffer->uSize = oSymTable->uBufferSize;
+      oSymTable->apkbKeys[uOldest] = pkbBuffer;
+   }
+
+   pkbBuffer->psOwner = psIter;
+   pkbBuffer->ulLastUse = ++oSymTable->ulClock;
+
+   return (char*)(void*)(pkbBuffer + 1);
+}
+
+
+/* Return the KeyBuffer of oSymTable that holds the key of psIter, or
+   NULL if there is none: the key is in the buffer of the table
+   itself, or another iterator took the KeyBuffer */
+
+static struct KeyBuffer *SymTable_iterOwnBuffer(
+   SymTable_T oSymTable, const struct SymTableIter *psIter) {
+
+   struct KeyBuffer *pkbBuffer;
+   size_t u;
+
+   assert(oSymTable != NULL);
+   assert(psIter != NULL);
+
+   /* pcKey is only compared, since it may point into a KeyBuffer
+      that was taken and moved */
+   for (u = 0; u < ITER_BUFFER_COUNT; u++) {
+
+      pkbBuffer = oSymTable->apkbKeys[u];
+
+      if ((pkbBuffer != NULL) && (pkbBuffer->psOwner == psIter) &&
+          ((const char*)(void*)(pkbBuffer + 1) == psIter->pcKey))
+         return pkbBuffer;
+   }
+
+   return NULL;
+}
+
+
+/* Search the subtree whose root is pnNode, a Node of oSymTable, for
+   pnTarget, writing the labels on the path to it into pcBuffer. The
+   characters of the key before the label of pnNode, uDepth of them,
+   are already there. Return 1 (TRUE) if pnTarget is found, or 0
+   (FALSE) otherwise */
+
+static int SymTable_locate(SymTable_T oSymTable, struct Node *pnNode,
+                           struct Node *pnTarget, char *pcBuffer,
+                           size_t uDepth) {
+
+   struct Node *pnChild;
+   enum {FALSE, TRUE};
+
+   assert(oSymTable != NULL);
+   assert(pnNode != NULL);
+   assert(pnTarget != NULL);
+   assert(pcBuffer != NULL);
+
+   memcpy(pcBuffer + uDepth, SymTable_label(oSymTable, pnNode),
+          pnNode->uiLength);
+   uDepth += pnNode->uiLength;
+
+   if (pnNode == pnTarget)
+      return TRUE;
+
+   for (pnChild = pnNode->pnChild; pnChild != NULL;
+        pnChild = pnChild->pnSibling)
+      if (SymTable_locate(oSymTable, pnChild, pnTarget, pcBuffer,
+                          uDepth))
+         return TRUE;
+
+   return FALSE;
+}
+
+
+/* Position psIter at the first binding at or below pnNode, in
+   ascending key order, rebuilding its key in pcBuffer unless the
+   table borrows its keys. The characters of the key before the label
+   of pnNode, uDepth of them, are already there. There must be such a
+   binding */
+
+static void SymTable_iterAt(struct SymTableIter *psIter,
+                            char *pcBuffer, struct Node *pnNode,
+                            size_t uDepth) {
+
+   SymTable_T oSymTable;
+
+   assert(psIter != NULL);
+   assert(pnNode != NULL);
+
+   oSymTable = psIter->oSymTable;
+
+   for (;;) {
+
+      if (pcBuffer != NULL)
+         memcpy(pcBuffer + uDepth, SymTable_label(oSymTable, pnNode),
+                pnNode->uiLength);
+      uDepth += pnNode->uiLength;
+
+      if (pnNode->iIsKey)
+         break;
+
+      /* A Node that is not a binding has a child */
+      pnNode = pnNode->pnChild;
+      assert(pnNode != NULL);
+   }
+
+   if (pcBuffer != NULL)
+      pcBuffer[uDepth] = '\0';
+
+   /* uIndex is the length of the current key */
+   psIter->uIndex = uDepth;
+   psIter->pvPosition = pnNode;
+   psIter->pcKey = SymTable_key(oSymTable, pnNode, pcBuffer);
+   psIter->pvValue = pnNode->pvValue;
+}
+
+
+/* Position psIter at its end, freeing the buffer of its keys for
+   other iterators of its table */
+
+static void SymTable_iterFinish(struct SymTableIter *psIter) {
+
+   SymTable_T oSymTable;
+   struct KeyBuffer *pkbBuffer;
+
+   assert(psIter != NULL);
+
+   oSymTable = psIter->oSymTable;
+
+   if ((! oSymTable->iBorrowsKeys) && (psIter->pcKey != NULL)) {
+
+      pkbBuffer = SymTable_iterOwnBuffer(oSymTable, psIter);
+
+      if (pkbBuffer != NULL)
+         pkbBuffer->psOwner = NULL;
+   }
+
+   psIter->uIndex = 0;
+   psIter->pvPosition = NULL;
+   psIter->pcKey = NULL;
+   psIter->pvValue = NULL;
+}
+
+
+
+void SymTable_iterBegin(SymTable_T oSymTable,
+                        struct SymTableIter *psIter) {
+
+   struct Node *pnRoot;
+
+   assert(oSymTable != NULL);
+   assert(psIter != NULL);
+
+   psIter->oSymTable = oSymTable;
+   pnRoot = oSymTable->pnRoot;
+
+   if (pnRoot->iIsKey || (pnRoot->pnChild != NULL))
+      SymTable_iterAt(psIter, SymTable_iterBuffer(oSymTable, psIter),
+                      pnRoot, 0);
+
+   else {
+
+      /* There is no buffer to free */
+      psIter->pcKey = NULL;
+      SymTable_iterFinish(psIter);
+   }
+}
+
+void SymTable_iterNext(struct SymTableIter *psIter) {
+
+   SymTable_T oSymTable;
+   const char *pcKey;
+   struct Node *pnCurrent;
+   struct Node *pnNext;
+   size_t uNextDepth;
+   size_t uDepth;
+   char *pcBuffer;
+   struct KeyBuffer *pkbBuffer;
+   int iFound;
+
+   assert(psIter != NULL);
+   assert(psIter->pvPosition != NULL);
+
+   oSymTable = psIter->oSymTable;
+
+   /* The key of the next binding goes where the current one is. If
+      other iterators took the KeyBuffer that held it, find it again
+      in another one */
+   pcBuffer = NULL;
+
+   if (! oSymTable->iBorrowsKeys) {
+
+      pkbBuffer = SymTable_iterOwnBuffer(oSymTable, psIter);
+
+      if (pkbBuffer != NULL) {
+
+         pkbBuffer->ulLastUse = ++oSymTable->ulClock;
+         pcBuffer = (char*)(void*)(pkbBuffer + 1);
+      }
+      else if (psIter->pcKey == oSymTable->pcBuffer)
+         pcBuffer = oSymTable->pcBuffer;
+
+      else {
+
+         pcBuffer = SymTable_iterBuffer(oSymTable, psIter);
+         iFound = SymTable_locate(oSymTable, oSymTable->pnRoot,
+                                  (struct Node*)psIter->pvPosition,
+                                  pcBuffer, 0);
+         assert(iFound);
+         (void)iFound;
+      }
+
+      psIter->pcKey = pcBuffer;
+   }
+
+   pcKey = psIter->pcKey;
+
+
+   /* Descend along the current key, which is in the buffer of psIter
+      alone, remembering the deepest Node on its path that has a next
+      sibling: that sibling comes next unless the current binding has
+      children */
+   pnCurrent = oSymTable->pnRoot;
+   pnNext = NULL;
+   uNextDepth = 0;
+   uDepth = 0;
+
+   while (uDepth < psIter->uIndex) {
+
+      pnCurrent = *SymTable_childLink(oSymTable, pnCurrent,
+                                      pcKey[uDepth]);
+      assert(pnCurrent != NULL);
+
+      if (pnCurrent->pnSibling != NULL) {
+
+         pnNext = pnCurrent->pnSibling;
+         uNextDepth = uDepth;
+      }
+
+      uDepth += pnCurrent->uiLength;
+   }
+
+   assert(pnCurrent == psIter->pvPosition);
+
+
+   if (pnCurrent->pnChild != NULL)
+      SymTable_iterAt(psIter, pcBuffer, pnCurrent->pnChild, uDepth);
+
+   else if (pnNext != NULL)
+      SymTable_iterAt(psIter, pcBuffer, pnNext, uNextDepth);
+
+   else
+      SymTable_iterFinish(psIter);
+}
+
+int SymTable_iterEnd(const struct SymTableIter *psIter) {
+
+   assert(psIter != NULL);
+
+   return psIter->pvPosition == NULL;
+}
@@ -0,0 +1,56 @@
+/*--------------------------------------------------------------------*/
+/* symtableradix.h                                                    */
+/* Author: Julio Lins (jcclb)                                         */
+/*--------------------------------------------------------------------*/
+
+#ifndef SYMTABLERADIX_H
+#define SYMTABLERADIX_H
+
+/*--------------------------------------------------------------------*/
+
+#include "symtable.h"
+
+/*--------------------------------------------------------------------*/
+
+/* Operations provided by the radix tree implementation of symtable.h
+   (symtableradix.c). Its keys are not copied whole: the tree stores
+   each prefix that keys share once, and a lookup compares the key
+   with those prefixes alone, so no key is ever rebuilt to find it.
+   This suits long keys that share long prefixes, such as qualified
+   names like "pkg.module.Class.method".
+
+   SymTable_map and the iterator visit bindings in ascending key
+   order, as defined by strcmp. Since a key the table copied exists
+   only in pieces, the key they give the client is rebuilt in a buffer
+   of the table. Each call to SymTable_map or SymTable_prefixMap gets
+   one of its own, and its keys stay valid until it returns. The table
+   keeps 16 buffers for iterators, and an iterator that begins takes
+   one that is free or else the one least recently used, so an
+   iterator that stops early holds its buffer only until others need
+   it. The key of an iterator stays valid until it moves on, or until
+   another iterator needs a buffer while all 16 are in use and its
+   buffer is the least recently used, so up to 16 traversals may be
+   nested or interleaved. An iterator whose buffer was taken still
+   moves on correctly, but its next step takes time linear in the
+   size of the table. Should insufficient memory be available for a
+   buffer, one that the table shares is used instead, and the
+   traversal must then be the only one under way. Keys of a table that
+   borrows its keys are the client's and stay valid as long as it
+   wants */
+
+/*--------------------------------------------------------------------*/
+
+/* Applies function pfApply to each binding in oSymTable whose key
+   starts with pcPrefix, in ascending key order. Each binding's key
+   (pcKey) and value (pvValue) are passed as parameters, as well as
+   pvExtra as an extra parameter. Runs in O(p + k) time, where p is
+   the length of pcPrefix and k the number of Nodes below it */
+
+void SymTable_prefixMap(SymTable_T oSymTable, const char *pcPrefix,
+                        void (*pfApply)(const char *pcKey,
+                                        void *pvValue, void *pvExtra),
+                        const void *pvExtra);
+
+/*--------------------------------------------------------------------*/
+
+#endif
@@ -0,0 +1,803 @@
+/*--------------------------------------------------------------------*/
+/* symtablescope.c                                                    */
+/* author: Julio Lins (jcclb)                                         */
+/*--------------------------------------------------------------------*/
+
+#include "symtablescope.h"
+#include <assert.h>
+#include <string.h>
+#include <stdlib.h>
+
+/*--------------------------------------------------------------------*/
+
+/* Sequence of bucket counts for Symble Table expansion */
+
+static const size_t auBucketCount[] = {509, 1021, 2039, 4093, 8191,
+                                       16381, 32749, 65521};
+
+/* Initial number of scopes a Symble Table has room for */
+
+enum {MIN_SCOPE_CAPACITY = 8};
+
+
+/* Each key and respective value are stored in a Binding. Bindings
+   whose keys hash to the same code are linked to form a list, and
+   Bindings made in the same scope are linked to form that scope's
+   undo log */
+
+struct Binding {
+
+   /* key, owned by implementation through defensive copy unless
+      the table borrows its keys */
+   const char *pcKey;
+
+   /* value, owned by client */
+   void *pvValue;
+
+   /* full hash code of pcKey, kept so that growing the table never
+      rehashes a key */
+   size_t uHash;
+
+   /* number of the scope the Binding was made in */
+   size_t uDepth;
+
+   /* 1 (TRUE) if a Binding of the same key in an inner scope hides
+      this one */
+   int iIsShadowed;
+
+   /* Binding of the same key that this one hides, or NULL */
+   struct Binding *pbShadows;
+
+   /* The address of the next Binding on the list of same-hash-code
+      Bindings */
+   struct Binding *pbNext;
+
+   /* The next (older) and previous (newer) Bindings of the same
+      scope */
+   struct Binding *pbScopeNext;
+   struct Binding *pbScopePrev;
+};
+
+
+/* SymTable is a single hash table holding the Bindings of every
+   scope, plus a stack with the newest Binding of each scope */
+
+struct SymTable {
+
+   /* Index of auBucketCount[] leading to current bucket count for
+      SymTable object */
+   size_t uBucketIndex;
+
+   /* Pointer to the addresses of separate chains' first Bindings */
+   struct Binding **ppbBuckets;
+
+   /* # of Bindings in all scopes, shadowed ones included */
+   size_t uBindingCount;
+
+   /* size of Symble Table (total # of Bindings not shadowed) */
+   size_t uLength;
+
+   /* Newest Binding of each scope, indexed by scope number */
+   struct Binding **ppbScopes;
+
+   /* # of open scopes, the outermost one included */
+   size_t uScopeCount;
+
+   /* # of scopes ppbScopes has room for */
+   size_t uScopeCapacity;
+
+   /* 1 (TRUE) if keys are borrowed from the client rather than
+      owned through defensive copies */
+   int iBorrowsKeys;
+};
+
+
+
+/* Return the full hash code for pcKey, which is the key that will be
+   hashed. The caller reduces it modulo the bucket count */
+
+static size_t SymTable_hash(const char *pcKey)
+{
+   const size_t HASH_MULTIPLIER = 65599;
+   size_t u;
+   size_t uHash = 0;
+
+   assert(pcKey != NULL);
+
+   for (u = 0; pcKey[u] != '\0'; u++)
+      uHash = uHash * HASH_MULTIPLIER + (size_t)pcKey[u];
+
+   return uHash;
+}
+
+
+SymTable_T SymTable_new(void) {
+
+   SymTable_T oSymTable;
+   enum {FALSE, TRUE};
+
+
+   oSymTable = (SymTable_T)malloc(sizeof(struct SymTable));
+
+   if (oSymTable == NULL)
+      return NULL;
+
+
+   oSymTable->ppbBuckets = (struct Binding**)
+      calloc(sizeof(struct Binding*), auBucketCount[0]);
+
+   if (oSymTable->ppbBuckets == NULL) {
+
+      free(oSymTable);
+      return NULL;
+   }
+
+   oSymTable->ppbScopes = (struct Binding**)
+      malloc(sizeof(struct Binding*) * MIN_SCOPE_CAPACITY);
+
+   if (oSymTable->ppbScopes == NULL) {
+
+      free(oSymTable->ppbBuckets);
+      free(oSymTable);
+      return NULL;
+   }
+
+   oSymTable->ppbScopes[0] = NULL;
+   oSymTable->uScopeCount = 1;
+   oSymTable->uScopeCapacity = MIN_SCOPE_CAPACITY;
+
+   oSymTable->uBindingCount = 0;
+   oSymTable->uLength = 0;
+   oSymTable->uBucketIndex = 0;
+   oSymTable->iBorrowsKeys = FALSE;
+
+
+   return oSymTable;
+}
+
+
+
+SymTable_T SymTable_newBorrowedKeys(void) {
+
+   SymTable_T oSymTable;
+   enum {FALSE, TRUE};
+
+   oSymTable = SymTable_new();
+
+   if (oSymTable == NULL)
+      return NULL;
+
+   oSymTable->iBorrowsKeys = TRUE;
+
+   return oSymTable;
+}
+
+
+
+/* Helper function that frees every Binding of oSymTable, shadowed
+   ones included, and its key, also calling pfFreeValue on its value
+   unless pfFreeValue is NULL. oSymTable is left empty, with its
+   scopes still open and its bucket array in place */
+
+static void SymTable_freeBindings(SymTable_T oSymTable,
+                                  void (*pfFreeValue)(void *pvValue)) {
+
+   struct Binding *pbCurrent;
+   struct Binding *pbNext;
+   size_t i;
+
+
+   assert(oSymTable != NULL);
+
+
+   /* Every Binding is on exactly one scope's undo log */
+   for (i = 0; i < oSymTable->uScopeCount; i++) {
+
+      pbCurrent = oSymTable->ppbScopes[i];
+
+      while (pbCurrent != NULL) {
+
+         pbNext = pbCurrent->pbScopeNext;
+
+         if (! oSymTable->iBorrowsKeys)
+            free((void*)pbCurrent->pcKey);
+
+         if (pfFreeValue != NULL)
+            (*pfFreeValue)(pbCurrent->pvValue);
+
+         free(pbCurrent);
+
+         pbCurrent = pbNext;
+      }
+
+      oSymTable->ppbScopes[i] = NULL;
+   }
+
+   for (i = 0; i < auBucketCount[oSymTable->uBucketIndex]; i++)
+      oSymTable->ppbBuckets[i] = NULL;
+
+   oSymTable->uBindingCount = 0;
+   oSymTable->uLength = 0;
+}
+
+
+void SymTable_free(SymTable_T oSymTable) {
+
+   assert(oSymTable != NULL);
+
+   SymTable_freeWith(oSymTable, NULL);
+}
+
+
+
+void SymTable_freeWith(SymTable_T oSymTable,
+                       void (*pfFreeValue)(void *pvValue)) {
+
+   assert(oSymTable != NULL);
+
+   SymTable_freeBindings(oSymTable, pfFreeValue);
+
+   free(oSymTable->ppbScopes);
+   free(oSymTable->ppbBuckets);
+   free(oSymTable);
+}
+
+
+
+void SymTable_clear(SymTable_T oSymTable,
+                    void (*pfFreeValue)(void *pvValue)) {
+
+   assert(oSymTable != NULL);
+
+   SymTable_freeBindings(oSymTable, pfFreeValue);
+}
+
+
+size_t SymTable_getLength(SymTable_T oSymTable) {
+
+   assert(oSymTable != NULL);
+
+   return oSymTable->uLength;
+}
+
+
+/* Helper function that expands Symble Table to next bucket count.
+   oSymTable is a pointer to the Symble Table that will be expanded.
+   Bindings are relinked, not copied. If not enough memory for
+   expansion, oSymTable does not change */
+
+static void SymTable_grow(SymTable_T oSymTable) {
+
+   size_t uCurrentCount;
+   size_t uNextCount;
+   size_t uIndex;
+   size_t i;
+
+   struct Binding *pbCurrent;
+   struct Binding *pbNext;
+   struct Binding **ppbNewBuckets;
+
+
+   assert(oSymTable != NULL);
+
+
+   uCurrentCount = auBucketCount[oSymTable->uBucketIndex];
+   uNextCount = auBucketCount[oSymTable->uBucketIndex + 1];
+
+
+   ppbNewBuckets =
+      (struct Binding**)calloc(sizeof(struct Binding*), uNextCount);
+
+   if (ppbNewBuckets == NULL)
+      return;
+
+
+   for (i = 0; i < uCurrentCount; i++) {
+
+      pbCurrent = oSymTable->ppbBuckets[i];
+
+      while (pbCurrent != NULL) {
+
+         pbNext = pbCurrent->pbNext;
+
+         uIndex = pbCurrent->uHash % uNextCount;
+
+         pbCurrent->pbNext = ppbNewBuckets[uIndex];
+         ppbNewBuckets[uIndex] = pbCurrent;
+
+         pbCurrent = pbNext;
+      }
+   }
+
+
+   free(oSymTable->ppbBuckets);
+
+   oSymTable->ppbBuckets = ppbNewBuckets;
+   oSymTable->uBucketIndex++;
+}
+
+
+/* Return the nearest Binding of corresponding key, if found.
+   oSymTable is the Symble Table object of which pcKey might or might
+   not be a key. If a search hit, it returns a pointer to the Binding
+   of pcKey that is not shadowed. Else, it returns NULL */
+
+static struct Binding *SymTable_find(SymTable_T oSymTable,
+                                     const char *pcKey) {
+
+   size_t uHash;
+   struct Binding *pbCurrent;
+   enum {EQUAL};
+
+   /* redundant, but just so that critTer doesn't complain */
+   assert(oSymTable != NULL);
+   assert(pcKey != NULL);
+
+
+   uHash = SymTable_hash(pcKey);
+
+   pbCurrent = oSymTable->ppbBuckets[
+      uHash % auBucketCount[oSymTable->uBucketIndex]];
+
+
+   while (pbCurrent != NULL) {
+
+      if ((! pbCurrent->iIsShadowed) && (pbCurrent->uHash == uHash) &&
+          (strcmp(pbCurrent->pcKey, pcKey) == EQUAL))
+         return pbCurrent;
+
+      pbCurrent = pbCurrent->pbNext;
+   }
+
+   return NULL;
+}
+
+
+/* Helper function that unlinks pbBinding from both its separate chain
+   and its scope's undo log within oSymTable, uncovers the Binding it
+   shadows, if any, and frees it. pbBinding must not be shadowed */
+
+static void SymTable_unlink(SymTable_T oSymTable,
+                            struct Binding *pbBinding) {
+
+   struct Binding **ppbLink;
+
+   assert(oSymTable != NULL);
+   assert(pbBinding != NULL);
+   assert(! pbBinding->iIsShadowed);
+
+
+   ppbLink = &oSymTable->ppbBuckets[
+      pbBinding->uHash % auBucketCount[oSymTable->uBucketIndex]];
+
+   while (*ppbLink != pbBinding)
+      ppbLink = &(*ppbLink)->pbNext;
+
+   *ppbLink = pbBinding->pbNext;
+
+
+   if (pbBinding->pbScopePrev == NULL)
+      oSymTable->ppbScopes[pbBinding->uDepth] = pbBinding->pbScopeNext;
+   else
+      pbBinding->pbScopePrev->pbScopeNext = pbBinding->pbScopeNext;
+
+   if (pbBinding->pbScopeNext != NULL)
+      pbBinding->pbScopeNext->pbScopePrev = pbBinding->pbScopePrev;
+
+
+   if (pbBinding->pbShadows != NULL)
+      pbBinding->pbShadows->iIsShadowed = 0;
+   else
+      oSymTable->uLength--;
+
+   oSymTable->uBindingCount--;
+
+
+   if (! oSymTable->iBorrowsKeys)
+      free((void*)pbBinding->pcKey);
+
+   free(pbBinding);
+}
+
+
+int SymTable_put(SymTable_T oSymTable, const char *pcKey,
+                 const void *pvValue) {
+
+   size_t uMAX_INDEX;
+   size_t uDepth;
+   size_t uIndex;
+   char *pcCopy;
+   struct Binding *pbOld;
+   struct Binding *pbNewBinding;
+   enum {FALSE, TRUE};
+
+
+   assert(oSymTable != NULL);
+   assert(pcKey != NULL);
+
+
+   uDepth = oSymTable->uScopeCount - 1;
+
+   pbOld = SymTable_find(oSymTable, pcKey);
+
+   /* Only a binding made in the same scope is a duplicate */
+   if ((pbOld != NULL) && (pbOld->uDepth == uDepth))
+      return FALSE;
+
+
+   uMAX_INDEX = sizeof(auBucketCount)/sizeof(size_t) - 1;
+
+   if ((oSymTable->uBindingCount ==
+        auBucketCount[oSymTable->uBucketIndex]) &&
+       (oSymTable->uBucketIndex < uMAX_INDEX))
+      SymTable_grow(oSymTable);
+
+
+   pbNewBinding = (struct Binding*)malloc(sizeof(struct Binding));
+
+   if (pbNewBinding == NULL)
+      return FALSE;
+
+
+   /* Borrowed keys are stored as is */
+   if (oSymTable->iBorrowsKeys)
+      pcCopy = (char*)pcKey;
+
+   else {
+
+      pcCopy = (char*)malloc(strlen(pcKey) + 1);
+
+      if (pcCopy == NULL) {
+
+         free(pbNewBinding);
+
+         return FALSE;
+      }
+
+
+      pcCopy = strcpy(pcCopy, pcKey);
+   }
+
+
+   pbNewBinding->pcKey = pcCopy;
+   pbNewBinding->pvValue = (void*)pvValue;
+   pbNewBinding->uHash = SymTable_hash(pcKey);
+   pbNewBinding->uDepth = uDepth;
+   pbNewBinding->iIsShadowed = FALSE;
+   pbNewBinding->pbShadows = pbOld;
+
+
+   uIndex = pbNewBinding->uHash % auBucketCount[oSymTable->uBucketIndex];
+
+   pbNewBinding->pbNext = oSymTable->ppbBuckets[uIndex];
+   oSymTable->ppbBuckets[uIndex] = pbNewBinding;
+
+
+   /* Newest Binding goes first on its scope's undo log */
+   pbNewBinding->pbScopePrev = NULL;
+   pbNewBinding->pbScopeNext = oSymTable->ppbScopes[uDepth];
+
+   if (pbNewBinding->pbScopeNext != NULL)
+      pbNewBinding->pbScopeNext->pbScopePrev = pbNewBinding;
+
+   oSymTable->ppbScopes[uDepth] = pbNewBinding;
+
+
+   if (pbOld != NULL)
+      pbOld->iIsShadowed = TRUE;
+   else
+      oSymTable->uLength++;
+
+   oSymTable->uBindingCount++;
+
+
+   return TRUE;
+}
+
+
+void *SymTable_replace(SymTable_T oSymTable, const char *pcKey,
+                       const void *pvValue) {
+
+   struct Binding *pbResult;
+   void *pvPrevious;
+
+
+   assert(oSymTable != NULL);
+   assert(pcKey != NULL);
+
+   pbResult = SymTable_find(oSymTable, pcKey);
+
+   if (pbResult == NULL) return NULL;
+
+   pvPrevious = pbResult->pvValue;
+   pbResult->pvValue = (void*)pvValue;
+
+   return pvPrevious;
+}
+
+int SymTable_contains(SymTable_T oSymTable, const char *pcKey) {
+
+   enum {NOT_FOUND, FOUND};
+
+   assert(oSymTable != NULL);
+   assert(pcKey != NULL);
+
+   if (SymTable_find(oSymTable, pcKey) == NULL) return NOT_FOUND;
+
+   return FOUND;
+}
+
+void *SymTable_get(SymTable_T oSymTable, const char *pcKey) {
+
+   assert(oSymTable != NULL);
+   assert(pcKey != NULL);
+
+   return SymTable_lookupNearest(oSymTable, pcKey, NULL);
+}
+
+void *SymTable_lookupNearest(SymTable_T oSymTable, const char *pcKey,
+                             size_t *puDepth) {
+
+   struct Binding *pbResult;
+
+   assert(oSymTable != NULL);
+   assert(pcKey != NULL);
+
+   pbResult = SymTable_find(oSymTable, pcKey);
+
+   if (pbResult == NULL) return NULL;
+
+   if (puDepth != NULL)
+      *puDepth = pbResult->uDepth;
+
+   return pbResult->pvValue;
+}
+
+void *SymTable_remove(SymTable_T oSymTable, const char *pcKey) {
+
+   struct Binding *pbResult;
+   void *pvValue;
+
+
+   assert(oSymTable != NULL);
+   assert(pcKey != NULL);
+
+   pbResult = SymTable_find(oSymTable, pcKey);
+
+   if (pbResult == NULL) return NULL;
+
+   pvValue = pbResult->pvValue;
+
+   SymTable_unlink(oSymTable, pbResult);
+
+   return pvValue;
+}
+
+
+int SymTable_pushScope(SymTable_T oSymTable) {
+
+   struct Binding **ppbNewScopes;
+   size_t uNewCapacity;
+   enum {FALSE, TRUE};
+
+   assert(oSymTable != NULL);
+
+   if (oSymTable->uScopeCount == oSymTable->uScopeCapacity) {
+
+      uNewCapacity = 2 * oSymTable->uScopeCapacity;
+
+      ppbNewScopes = (struct Binding**)realloc(oSymTable->ppbScopes,
+         sizeof(struct Binding*) * uNewCapacity);
+
+      if (ppbNewScopes == NULL)
+         return FALSE;
+
+      oSymTable->ppbScopes = ppbNewScopes;
+      oSymTable->uScopeCapacity = uNewCapacity;
+   }
+
+   oSymTable->ppbScopes[oSymTable->uScopeCount] = NULL;
+   oSymTable->uScopeCount++;
+
+   return TRUE;
+}
+
+void SymTable_popScope(SymTable_T oSymTable) {
+
+   struct Binding *pbCurrent;
+   struct Binding *pbNext;
+
+   assert(oSymTable != NULL);
+   assert(oSymTable->uScopeCount > 1);
+
+
+   /* Newest first, so each Binding is undone before the ones it
+      could depend on */
+   pbCurrent = oSymTable->ppbScopes[oSymTable->uScopeCount - 1];
+
+   while (pbCurrent != NULL) {
+
+      pbNext = pbCurrent->pbScopeNext;
+
+      SymTable_unlink(oSymTable, pbCurrent);
+
+      pbCurrent = pbNext;
+   }
+
+   oSymTable->uScopeCount--;
+}
+
+size_t SymTable_getScopeDepth(SymTable_T oSymTable) {
+
+   assert(oSymTable != NULL);
+
+   return oSymTable->uScopeCount - 1;
+}
+
+
+void SymTable_map(SymTable_T oSymTable,
+                  void (*pfApply)(const char *pcKey, void *pvValue,
+                                  void *pvExtra), const void *pvExtra) {
+
+   size_t i;
+   size_t uBucketCount;
+   struct Binding *pbCurrent;
+
+   assert(oSymTable != NULL);
+   assert(pfApply != NULL);
+
+
+   uBucketCount = auBucketCount[oSymTable->uBucketIndex];
+
+
+   for (i = 0; i < uBucketCount; i++) {
+
+      pbCurrent = oSymTable->ppbBuckets[i];
+
+
+      while (pbCurrent != NULL) {
+
+         if (! pbCurrent->iIsShadowed)
+            (*pfApply)(pbCurrent->pcKey, pbCurrent->pvValue,
+                       (void*)pvExtra);
+
+         pbCurrent = pbCurrent->pbNext;
+      }
+   }
+}
+
+
+/* Add to the estimate of psMemory the bytes that malloc adds to a
+   block of uSize bytes */
+
+static void SymTable_addOverhead(struct SymTableMemory *psMemory,
+                                 size_t uSize) {
+
+   const size_t uWord = sizeof(size_t);
+   size_t uChunk;
+
+   assert(psMemory != NULL);
+
+   uChunk = (uSize + 3 * uWord - 1) / (2 * uWord) * (2 * uWord);
+
+   if (uChunk < 4 * uWord)
+      uChunk = 4 * uWord;
+
+   psMemory->uOverheadBytes += uChunk - uSize;
+}
+
+
+void SymTable_memoryUsage(SymTable_T oSymTable,
+                          struct SymTableMemory *psMemory) {
+
+   struct Binding *pbCurrent;
+   size_t uBucketCount;
+   size_t uKeySize;
+   size_t i;
+
+   assert(oSymTable != NULL);
+   assert(psMemory != NULL);
+
+   uBucketCount = auBucketCount[oSymTable->uBucketIndex];
+
+   psMemory->uTableBytes = sizeof(struct SymTable) +
+      sizeof(struct Binding*) * uBucketCount +
+      sizeof(struct Binding*) * oSymTable->uScopeCapacity;
+   psMemory->uBindingBytes = 0;
+   psMemory->uKeyBytes = 0;
+   psMemory->uOverheadBytes = 0;
+
+   SymTable_addOverhead(psMemory, sizeof(struct SymTable));
+   SymTable_addOverhead(psMemory,
+                        sizeof(struct Binding*) * uBucketCount);
+   SymTable_addOverhead(psMemory, sizeof(struct Binding*) *
+                        oSymTable->uScopeCapacity);
+
+   /* Every Binding, shadowed or not, is on the list of its scope */
+   for (i = 0; i < oSymTable->uScopeCount; i++) {
+
+      for (pbCurrent = oSymTable->ppbScopes[i]; pbCurrent != NULL;
+           pbCurrent = pbCurrent->pbScopeNext) {
+
+         psMemory->uBindingBytes += sizeof(struct Binding);
+         SymTable_addOverhead(psMemory, sizeof(struct Binding));
+
+         if (oSymTable->iBorrowsKeys)
+            continue;
+
+         uKeySize = strlen(pbCurrent->pcKey) + 1;
+         psMemory->uKeyBytes += uKeySize;
+         SymTable_addOverhead(psMemory, uKeySize);
+      }
+   }
+}
+
+
+/* Position psIter at the first Binding that is not shadowed, starting
+   from pbCurrent on the separate chain of bucket uIndex and going on
+   to the following buckets, or at its end if there is no such
+   Binding */
+
+static void SymTable_iterSeek(struct SymTableIter *psIter,
+                              size_t uIndex,
+                              struct Binding *pbCurrent) {
+
+   size_t uBucketCount;
+
+   assert(psIter != NULL);
+
+   uBucketCount = auBucketCount[psIter->oSymTable->uBucketIndex];
+
+   for (;;) {
+
+      while ((pbCurrent != NULL) && pbCurrent->iIsShadowed)
+         pbCurrent = pbCurrent->pbNext;
+
+      if (pbCurrent != NULL) {
+
+         psIter->uIndex = uIndex;
+         psIter->pvPosition = pbCurrent;
+         psIter->pcKey = pbCurrent->pcKey;
+         psIter->pvValue = pbCurrent->pvValue;
+         return;
+      }
+
+      if (++uIndex >= uBucketCount)
+         break;
+
+      pbCurrent = psIter->oSymTable->ppbBuckets[uIndex];
+   }
+
+   psIter->uIndex = uBucketCount;
+   psIter->pvPosition = NULL;
+   psIter->pcKey = NULL;
+   psIter->pvValue = NULL;
+}
+
+
+void SymTable_iterBegin(SymTable_T oSymTable,
+                        struct SymTableIter *psIter) {
+
+   assert(oSymTable != NULL);
+   assert(psIter != NULL);
+
+   psIter->oSymTable = oSymTable;
+
+   SymTable_iterSeek(psIter, 0, oSymTable->ppbBuckets[0]);
+}
+
+void SymTable_iterNext(struct SymTableIter *psIter) {
+
+   assert(psIter != NULL);
+   assert(psIter->pvPosition != NULL);
+
+   SymTable_iterSeek(psIter, psIter->uIndex,
+                     ((struct Binding*)psIter->pvPosition)->pbNext);
+}
+
+int SymTable_iterEnd(const struct SymTableIter *psIter) {
+
+   assert(psIter != NULL);
+
+   return psIter->pvPosition == NULL;
+}
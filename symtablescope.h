@@ -0,0 +1,61 @@
+/*--------------------------------------------------------------------*/
+/* symtablescope.h                                                    */
+/* Author: Julio Lins (jcclb)                                         */
+/*--------------------------------------------------------------------*/
+
+#ifndef SYMTABLESCOPE_H
+#define SYMTABLESCOPE_H
+
+/*--------------------------------------------------------------------*/
+
+#include "symtable.h"
+
+/*--------------------------------------------------------------------*/
+
+/* Scope operations provided by the scoped implementation of
+   symtable.h (symtablescope.c). A new SymTable_T object has a single,
+   outermost scope, numbered 0. SymTable_put binds pcKey in the
+   innermost scope, failing only if pcKey is already bound in that
+   same scope; a binding in an inner scope shadows the bindings of
+   pcKey in outer scopes. SymTable_get, SymTable_contains,
+   SymTable_replace and SymTable_remove act on the nearest binding of
+   pcKey. SymTable_getLength, SymTable_map and the iterator only see
+   bindings that are not shadowed. All scopes share one hash table, so
+   a lookup is one probe however deep the nesting is */
+
+/*--------------------------------------------------------------------*/
+
+/* Open a new innermost scope in oSymTable. Return 1 (TRUE) if
+   successful, or 0 (FALSE) if insufficient memory is available */
+
+int SymTable_pushScope(SymTable_T oSymTable);
+
+/*--------------------------------------------------------------------*/
+
+/* Close the innermost scope of oSymTable, removing the bindings made
+   in it, which uncovers any bindings they shadowed. Takes time
+   proportional to the number of bindings made in that scope only.
+   oSymTable must have a scope other than the outermost one */
+
+void SymTable_popScope(SymTable_T oSymTable);
+
+/*--------------------------------------------------------------------*/
+
+/* Return the number of the innermost scope of oSymTable, that is,
+   how many scopes are open besides the outermost one */
+
+size_t SymTable_getScopeDepth(SymTable_T oSymTable);
+
+/*--------------------------------------------------------------------*/
+
+/* Return the value of the nearest binding within oSymTable whose key
+   is pcKey, or NULL if no such binding exists. If found and puDepth
+   is not NULL, store in *puDepth the number of the scope the binding
+   was made in */
+
+void *SymTable_lookupNearest(SymTable_T oSymTable, const char *pcKey,
+                             size_t *puDepth);
+
+/*--------------------------------------------------------------------*/
+
+#endif
@@ -0,0 +1,616 @@
+/*--------------------------------------------------------------------*/
+/* symtableshared.c                                                   */
+/* author: Julio Lins (jcclb)                                         */
+/*--------------------------------------------------------------------*/
+
+/* shm_open, mmap and friends are POSIX, not ANSI C */
+#define _POSIX_C_SOURCE 200112L
+
+#include "symtableshared.h"
+#include <assert.h>
+#include <string.h>
+#include <stdlib.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+/*--------------------------------------------------------------------*/
+
+/* A segment is laid out as a Header, the bucket array, the Bindings
+   and the pool of values and keys. Every link within it is an offset
+   from the start of the segment, and offset 0, which is the Header's,
+   stands for no Binding */
+
+/* Tag at the start of every segment */
+
+static const char acMagic[8] = "SYMSHM1";
+
+/* Values are placed at multiples of VALUE_ALIGNMENT within the
+   segment, so that clients may store any type as a value */
+
+enum {VALUE_ALIGNMENT = 16};
+
+/* Offset stored instead of a value offset for a NULL value */
+
+#define OFFSET_NULL ((size_t)-1)
+
+/* Bucket counts a segment may have. It gets the first one that is
+   not less than its capacity, or the last one */
+
+static const size_t auBucketCount[] = {31, 61, 127, 251, 509, 1021,
+                                       2039, 4093, 8191, 16381, 32749,
+                                       65521, 131071, 262139, 524287,
+                                       1048573, 2097143, 4194301,
+                                       8388593, 16777213, 33554393,
+                                       67108859};
+
+/* Memory barrier between the writer's stores of a Binding and of the
+   link that publishes it, and between a reader's load of that link
+   and its loads of the Binding; likewise between the link and the
+   length, so that a reader that counts a Binding can find it */
+
+#if defined(__GNUC__)
+#define SymTable_barrier() __sync_synchronize()
+#else
+#error "symtableshared.c needs a memory barrier for this compiler"
+#endif
+
+
+struct Header {
+
+   /* acMagic, written last by the writer */
+   char acMagic[8];
+
+   /* sizeof(size_t) on the machine of the writer */
+   size_t uWordSize;
+
+   /* # of bytes in the segment */
+   size_t uSegmentSize;
+
+   /* # of buckets */
+   size_t uBucketCount;
+
+   /* # of Bindings in the segment, used or not */
+   size_t uCapacity;
+
+   /* offset of the first Binding */
+   size_t uBindingsOffset;
+
+   /* offset of the pool */
+   size_t uPoolOffset;
+
+   /* size of Symble Table (total # of Bindings in use), which are
+      the first ones */
+   volatile size_t uLength;
+
+   /* offset of the first unused byte of the pool */
+   size_t uPoolUsed;
+};
+
+
+/* Each key and respective value are referred to by a Binding.
+   Bindings whose keys hash to the same bucket are linked to form a
+   list, newest first */
+
+struct Binding {
+
+   /* full hash code of the key */
+   size_t uHash;
+
+   /* offset of the key in the pool */
+   size_t uKeyOffset;
+
+   /* offset of the value in the pool, or OFFSET_NULL */
+   size_t uValueOffset;
+
+   /* offset of the next Binding of the same bucket, or 0 */
+   size_t uNext;
+};
+
+
+/* SymTableShared is a structure that locates the parts of a mapped
+   segment */
+
+struct SymTableShared {
+
+   /* first byte of the mapped segment */
+   char *pcSegment;
+
+   /* Header at the start of the segment */
+   struct Header *psHeader;
+
+   /* offsets of the first Bindings of each bucket, or 0 */
+   volatile size_t *puBuckets;
+
+   /* 1 (TRUE) for the writer, which mapped the segment for writing,
+      or 0 (FALSE) for a reader */
+   int iWritable;
+};
+
+
+
+/* Return the full hash code for pcKey, which is the key that will be
+   hashed. The caller reduces it modulo the bucket count */
+
+static size_t SymTable_hash(const char *pcKey)
+{
+   const size_t HASH_MULTIPLIER = 65599;
+   size_t u;
+   size_t uHash = 0;
+
+   assert(pcKey != NULL);
+
+   for (u = 0; pcKey[u] != '\0'; u++)
+      uHash = uHash * HASH_MULTIPLIER + (size_t)pcKey[u];
+
+   return uHash;
+}
+
+
+/* Return uOffset rounded up to the next multiple of VALUE_ALIGNMENT,
+   or 0 if that does not fit in a size_t */
+
+static size_t SymTable_align(size_t uOffset) {
+
+   if (uOffset > (size_t)-1 - (VALUE_ALIGNMENT - 1))
+      return 0;
+
+   return (uOffset + VALUE_ALIGNMENT - 1) / VALUE_ALIGNMENT *
+      VALUE_ALIGNMENT;
+}
+
+
+/* Fill in psHeader, except its magic tag and counts, for a segment
+   with room for uCapacity bindings and uPoolSize bytes of pool.
+   Return 1 (TRUE) if successful, or 0 (FALSE) if the segment size
+   does not fit in a size_t */
+
+static int SymTable_layout(struct Header *psHeader, size_t uCapacity,
+                           size_t uPoolSize) {
+
+   size_t i;
+   size_t uLastIndex;
+   size_t uBindingsSize;
+   const size_t uMaxSize = (size_t)-1;
+   enum {FALSE, TRUE};
+
+
+   assert(psHeader != NULL);
+
+
+   uLastIndex = sizeof(auBucketCount) / sizeof(size_t) - 1;
+
+   for (i = 0; i < uLastIndex; i++)
+      if (auBucketCount[i] >= uCapacity)
+         break;
+
+   psHeader->uWordSize = sizeof(size_t);
+   psHeader->uBucketCount = auBucketCount[i];
+   psHeader->uCapacity = uCapacity;
+   psHeader->uBindingsOffset = sizeof(struct Header) +
+      sizeof(size_t) * psHeader->uBucketCount;
+
+
+   if (uCapacity > uMaxSize / sizeof(struct Binding))
+      return FALSE;
+
+   uBindingsSize = sizeof(struct Binding) * uCapacity;
+
+   if (uBindingsSize > uMaxSize - psHeader->uBindingsOffset)
+      return FALSE;
+
+   psHeader->uPoolOffset =
+      SymTable_align(psHeader->uBindingsOffset + uBindingsSize);
+
+   if ((psHeader->uPoolOffset == 0) ||
+       (uPoolSize > uMaxSize - psHeader->uPoolOffset))
+      return FALSE;
+
+   psHeader->uSegmentSize = psHeader->uPoolOffset + uPoolSize;
+
+   return TRUE;
+}
+
+
+/* Return a handle on the segment mapped at pvSegment, for writing if
+   iWritable is 1 (TRUE), or NULL if insufficient memory is
+   available */
+
+static SymTableShared_T SymTable_newHandle(void *pvSegment,
+                                           int iWritable) {
+
+   SymTableShared_T oSymTableShared;
+
+
+   assert(pvSegment != NULL);
+
+
+   oSymTableShared =
+      (SymTableShared_T)malloc(sizeof(struct SymTableShared));
+
+   if (oSymTableShared == NULL)
+      return NULL;
+
+
+   oSymTableShared->pcSegment = (char*)pvSegment;
+   oSymTableShared->psHeader = (struct Header*)pvSegment;
+   oSymTableShared->puBuckets = (volatile size_t*)(void*)
+      (oSymTableShared->pcSegment + sizeof(struct Header));
+   oSymTableShared->iWritable = iWritable;
+
+   return oSymTableShared;
+}
+
+
+
+SymTableShared_T SymTableShared_create(const char *pcName,
+                                       size_t uCapacity,
+                                       size_t uPoolSize) {
+
+   SymTableShared_T oSymTableShared;
+   struct Header sHeader;
+   struct Header *psHeader;
+   void *pvSegment;
+   int iFd;
+   enum {FALSE, TRUE};
+
+
+   assert(pcName != NULL);
+
+
+   if (! SymTable_layout(&sHeader, uCapacity, uPoolSize))
+      return NULL;
+
+
+   iFd = shm_open(pcName, O_RDWR | O_CREAT | O_EXCL, S_IRUSR | S_IWUSR);
+
+   if (iFd == -1)
+      return NULL;
+
+   /* A new segment is filled with zeros, so every bucket is empty */
+   if (ftruncate(iFd, (off_t)sHeader.uSegmentSize) == -1) {
+
+      close(iFd);
+      shm_unlink(pcName);
+      return NULL;
+   }
+
+   pvSegment = mmap(NULL, sHeader.uSegmentSize, PROT_READ | PROT_WRITE,
+                    MAP_SHARED, iFd, 0);
+
+   /* The mapping stays valid once the segment is closed */
+   close(iFd);
+
+   if (pvSegment == MAP_FAILED) {
+
+      shm_unlink(pcName);
+      return NULL;
+   }
+
+
+   oSymTableShared = SymTable_newHandle(pvSegment, TRUE);
+
+   if (oSymTableShared == NULL) {
+
+      munmap(pvSegment, sHeader.uSegmentSize);
+      shm_unlink(pcName);
+      return NULL;
+   }
+
+
+   psHeader = oSymTableShared->psHeader;
+
+   psHeader->uWordSize = sHeader.uWordSize;
+   psHeader->uSegmentSize = sHeader.uSegmentSize;
+   psHeader->uBucketCount = sHeader.uBucketCount;
+   psHeader->uCapacity = sHeader.uCapacity;
+   psHeader->uBindingsOffset = sHeader.uBindingsOffset;
+   psHeader->uPoolOffset = sHeader.uPoolOffset;
+   psHeader->uLength = 0;
+   psHeader->uPoolUsed = sHeader.uPoolOffset;
+
+   /* Readers accept the segment once they see the tag */
+   SymTable_barrier();
+   memcpy(psHeader->acMagic, acMagic, sizeof(acMagic));
+
+
+   return oSymTableShared;
+}
+
+
+/* Return 1 (TRUE) if the uSegmentSize bytes at pcSegment hold a
+   consistent segment, or 0 (FALSE) otherwise */
+
+static int SymTable_checkSegment(const char *pcSegment,
+                                 size_t uSegmentSize) {
+
+   const struct Header *psHeader;
+   struct Header sHeader;
+   enum {FALSE, TRUE};
+   enum {EQUAL};
+
+
+   assert(pcSegment != NULL);
+
+
+   if (uSegmentSize < sizeof(struct Header))
+      return FALSE;
+
+   psHeader = (const struct Header*)(const void*)pcSegment;
+
+   if (memcmp(psHeader->acMagic, acMagic, sizeof(acMagic)) != EQUAL)
+      return FALSE;
+
+   SymTable_barrier();
+
+   if (psHeader->uPoolOffset > uSegmentSize)
+      return FALSE;
+
+   /* The layout must be the one the writer would have computed */
+   if (! SymTable_layout(&sHeader, psHeader->uCapacity,
+                         uSegmentSize - psHeader->uPoolOffset))
+      return FALSE;
+
+   return (psHeader->uWordSize == sizeof(size_t)) &&
+      (psHeader->uSegmentSize == uSegmentSize) &&
+      (psHeader->uBucketCount == sHeader.uBucketCount) &&
+      (psHeader->uBindingsOffset == sHeader.uBindingsOffset) &&
+      (psHeader->uPoolOffset == sHeader.uPoolOffset) &&
+      (sHeader.uSegmentSize == uSegmentSize);
+}
+
+
+SymTableShared_T SymTableShared_open(const char *pcName) {
+
+   SymTableShared_T oSymTableShared;
+   struct stat sStat;
+   void *pvSegment;
+   size_t uSegmentSize;
+   int iFd;
+   enum {FALSE, TRUE};
+
+
+   assert(pcName != NULL);
+
+
+   iFd = shm_open(pcName, O_RDONLY, 0);
+
+   if (iFd == -1)
+      return NULL;
+
+   if ((fstat(iFd, &sStat) == -1) || (sStat.st_size <= 0)) {
+
+      close(iFd);
+      return NULL;
+   }
+
+   uSegmentSize = (size_t)sStat.st_size;
+
+   pvSegment = mmap(NULL, uSegmentSize, PROT_READ, MAP_SHARED, iFd, 0);
+
+   close(iFd);
+
+   if (pvSegment == MAP_FAILED)
+      return NULL;
+
+
+   if (! SymTable_checkSegment((const char*)pvSegment, uSegmentSize)) {
+
+      munmap(pvSegment, uSegmentSize);
+      return NULL;
+   }
+
+
+   oSymTableShared = SymTable_newHandle(pvSegment, FALSE);
+
+   if (oSymTableShared == NULL) {
+
+      munmap(pvSegment, uSegmentSize);
+      return NULL;
+   }
+
+   return oSymTableShared;
+}
+
+
+
+void SymTableShared_close(SymTableShared_T oSymTableShared) {
+
+   assert(oSymTableShared != NULL);
+
+   munmap(oSymTableShared->pcSegment,
+          oSymTableShared->psHeader->uSegmentSize);
+   free(oSymTableShared);
+}
+
+
+
+int SymTableShared_unlink(const char *pcName) {
+
+   assert(pcName != NULL);
+
+   return shm_unlink(pcName) == 0;
+}
+
+
+/* Return the Binding of pcKey, whose full hash code is uHash, within
+   oSymTableShared, if found. Else, it returns NULL */
+
+static const struct Binding *SymTable_find(
+   SymTableShared_T oSymTableShared, const char *pcKey, size_t uHash) {
+
+   const struct Header *psHeader;
+   const struct Binding *pbCurrent;
+   size_t uOffset;
+   enum {EQUAL};
+
+
+   assert(oSymTableShared != NULL);
+   assert(pcKey != NULL);
+
+
+   psHeader = oSymTableShared->psHeader;
+
+   uOffset = oSymTableShared->puBuckets[uHash % psHeader->uBucketCount];
+
+
+   while (uOffset != 0) {
+
+      /* The Binding was complete before its link was stored */
+      SymTable_barrier();
+
+      if ((uOffset < psHeader->uBindingsOffset) ||
+          (uOffset >= psHeader->uPoolOffset))
+         return NULL;
+
+      pbCurrent = (const struct Binding*)(const void*)
+         (oSymTableShared->pcSegment + uOffset);
+
+      if ((pbCurrent->uHash == uHash) &&
+          (pbCurrent->uKeyOffset < psHeader->uSegmentSize) &&
+          (strcmp(oSymTableShared->pcSegment + pbCurrent->uKeyOffset,
+                  pcKey) == EQUAL))
+         return pbCurrent;
+
+      uOffset = pbCurrent->uNext;
+   }
+
+   return NULL;
+}
+
+
+
+int SymTableShared_put(SymTableShared_T oSymTableShared,
+                       const char *pcKey, const void *pvValue,
+                       size_t uValueSize) {
+
+   struct Header *psHeader;
+   struct Binding *pbNewBinding;
+   size_t uHash;
+   size_t uBucket;
+   size_t uKeySize;
+   size_t uValueOffset;
+   size_t uKeyOffset;
+   enum {FALSE, TRUE};
+
+
+   assert(oSymTableShared != NULL);
+   assert(oSymTableShared->iWritable);
+   assert(pcKey != NULL);
+
+
+   psHeader = oSymTableShared->psHeader;
+
+   uHash = SymTable_hash(pcKey);
+
+   if (SymTable_find(oSymTableShared, pcKey, uHash) != NULL)
+      return FALSE;
+
+   if (psHeader->uLength == psHeader->uCapacity)
+      return FALSE;
+
+
+   /* Value first, aligned, then the key right after it */
+   uValueOffset = OFFSET_NULL;
+   uKeyOffset = psHeader->uPoolUsed;
+
+   if (pvValue != NULL) {
+
+      uValueOffset = SymTable_align(psHeader->uPoolUsed);
+
+      if ((uValueOffset == 0) ||
+          (uValueOffset > psHeader->uSegmentSize) ||
+          (uValueSize > psHeader->uSegmentSize - uValueOffset))
+         return FALSE;
+
+      uKeyOffset = uValueOffset + uValueSize;
+   }
+
+   uKeySize = strlen(pcKey) + 1;
+
+   if (uKeySize > psHeader->uSegmentSize - uKeyOffset)
+      return FALSE;
+
+
+   if (pvValue != NULL)
+      memcpy(oSymTableShared->pcSegment + uValueOffset, pvValue,
+             uValueSize);
+
+   memcpy(oSymTableShared->pcSegment + uKeyOffset, pcKey, uKeySize);
+
+   psHeader->uPoolUsed = uKeyOffset + uKeySize;
+
+
+   pbNewBinding = (struct Binding*)(void*)
+      (oSymTableShared->pcSegment + psHeader->uBindingsOffset) +
+      psHeader->uLength;
+
+   uBucket = uHash % psHeader->uBucketCount;
+
+   pbNewBinding->uHash = uHash;
+   pbNewBinding->uKeyOffset = uKeyOffset;
+   pbNewBinding->uValueOffset = uValueOffset;
+   pbNewBinding->uNext = oSymTableShared->puBuckets[uBucket];
+
+
+   /* Publish the Binding only once readers can see all of it */
+   SymTable_barrier();
+
+   oSymTableShared->puBuckets[uBucket] = (size_t)
+      ((char*)pbNewBinding - oSymTableShared->pcSegment);
+
+   /* Count the Binding only once readers can find it */
+   SymTable_barrier();
+
+   psHeader->uLength++;
+
+   return TRUE;
+}
+
+
+
+size_t SymTableShared_getLength(SymTableShared_T oSymTableShared) {
+
+   size_t uLength;
+
+   assert(oSymTableShared != NULL);
+
+   uLength = oSymTableShared->psHeader->uLength;
+
+   /* Later lookups see at least the bindings counted */
+   SymTable_barrier();
+
+   return uLength;
+}
+
+
+
+int SymTableShared_contains(SymTableShared_T oSymTableShared,
+                            const char *pcKey) {
+
+   assert(oSymTableShared != NULL);
+   assert(pcKey != NULL);
+
+   return SymTable_find(oSymTableShared, pcKey,
+                        SymTable_hash(pcKey)) != NULL;
+}
+
+
+
+const void *SymTableShared_get(SymTableShared_T oSymTableShared,
+                               const char *pcKey) {
+
+   const struct Binding *pbFound;
+
+   assert(oSymTableShared != NULL);
+   assert(pcKey != NULL);
+
+   pbFound = SymTable_find(oSymTableShared, pcKey,
+                           SymTable_hash(pcKey));
+
+   if ((pbFound == NULL) || (pbFound->uValueOffset == OFFSET_NULL))
+      return NULL;
+
+   return oSymTableShared->pcSegment + pbFound->uValueOffset;
+}
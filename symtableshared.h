@@ -0,0 +1,110 @@
+/*--------------------------------------------------------------------*/
+/* symtableshared.h                                                   */
+/* Author: Julio Lins (jcclb)                                         */
+/*--------------------------------------------------------------------*/
+
+#ifndef SYMTABLESHARED_H
+#define SYMTABLESHARED_H
+
+#include <stddef.h>
+
+/*--------------------------------------------------------------------*/
+
+/* A SymTableShared_T object is a handle on a Symble Table whose
+   buckets, bindings, keys and values all live in a named POSIX
+   shared-memory segment, so that processes on the same host share a
+   single copy of it. Every link within the segment is an offset from
+   its start, so each process may map it at any address.
+
+   One process, the writer, creates the segment and adds bindings to
+   it; any number of processes, the readers, open it read-only and
+   look keys up without locking, while the writer keeps adding
+   bindings. A reader sees each binding either completely or not at
+   all. Bindings are never removed or changed, so that keys and values
+   obtained by readers stay valid until they close the segment.
+
+   Keys and values are copied into the segment. The segment has a
+   fixed size, chosen when it is created, and can only be read on a
+   machine with the same word size and byte order as the writer's */
+
+typedef struct SymTableShared *SymTableShared_T;
+
+/*--------------------------------------------------------------------*/
+
+/* Create the shared-memory segment named pcName, which must start
+   with '/' and not exist yet, with room for uCapacity bindings and
+   uPoolSize bytes of keys and values, and return a writer handle on
+   it, or NULL if the segment cannot be created or insufficient memory
+   is available. Each key takes its length plus one byte, and each
+   value its size rounded up to 16 bytes. The segment can be read and
+   written by processes of the creator's user only */
+
+SymTableShared_T SymTableShared_create(const char *pcName,
+                                       size_t uCapacity,
+                                       size_t uPoolSize);
+
+/*--------------------------------------------------------------------*/
+
+/* Open the shared-memory segment named pcName, created by
+   SymTableShared_create, read-only and return a reader handle on it,
+   or NULL if it cannot be opened or does not hold a valid table */
+
+SymTableShared_T SymTableShared_open(const char *pcName);
+
+/*--------------------------------------------------------------------*/
+
+/* Unmap the segment of oSymTableShared and free memory allocated by
+   it. Keys and values obtained from it must no longer be used. The
+   segment itself outlives every handle until it is unlinked */
+
+void SymTableShared_close(SymTableShared_T oSymTableShared);
+
+/*--------------------------------------------------------------------*/
+
+/* Remove the name pcName of a shared-memory segment, which is freed
+   once every handle on it is closed. Return 1 (TRUE) if successful,
+   or 0 (FALSE) otherwise */
+
+int SymTableShared_unlink(const char *pcName);
+
+/*--------------------------------------------------------------------*/
+
+/* If oSymTableShared, a writer handle, does not contain a binding
+   with key pcKey, then add a binding with a copy of pcKey and a copy
+   of the uValueSize bytes at pvValue, or a NULL value if pvValue is
+   NULL, and return 1 (TRUE). Otherwise, or if the segment has no room
+   left for them, leave oSymTableShared unchanged and return 0
+   (FALSE) */
+
+int SymTableShared_put(SymTableShared_T oSymTableShared,
+                       const char *pcKey, const void *pvValue,
+                       size_t uValueSize);
+
+/*--------------------------------------------------------------------*/
+
+/* Return length of oSymTableShared (i.e., number of bindings). Every
+   binding counted can then be found, even while another process
+   puts */
+
+size_t SymTableShared_getLength(SymTableShared_T oSymTableShared);
+
+/*--------------------------------------------------------------------*/
+
+/* Return 1 (TRUE) if oSymTableShared contains a binding whose key is
+   pcKey, and 0 (FALSE) otherwise */
+
+int SymTableShared_contains(SymTableShared_T oSymTableShared,
+                            const char *pcKey);
+
+/*--------------------------------------------------------------------*/
+
+/* Return the copy of the value of the binding within oSymTableShared
+   whose key is pcKey, or NULL if no such binding exists or its value
+   is NULL. The copy is aligned for any type of up to 16 bytes */
+
+const void *SymTableShared_get(SymTableShared_T oSymTableShared,
+                               const char *pcKey);
+
+/*--------------------------------------------------------------------*/
+
+#endif
@@ -1,118 +1,373 @@
 /*--------------------------------------------------------------------*/
-/* symtablehash.c                                                     */
+/* symtablestatic.c                                                   */
 /* author: Julio Lins (jcclb)                                         */
 /*--------------------------------------------------------------------*/
 
-#include "symtable.h"
+#include "symtablestatic.h"
 #include <assert.h>
 #include <string.h>
 #include <stdlib.h>
 
 /*--------------------------------------------------------------------*/
 
-/* Sequence of bucket counts for Symble Table expansion */
+/* Bucket counts a Symble Table may have. It gets the first one that
+   is not less than its capacity, or the last one */
 
-static const size_t auBucketCount[] = {509, 1021, 2039, 4093, 8191,
-                                       16381, 32749, 65521};
+static const size_t auBucketCount[] = {31, 61, 127, 251, 509, 1021,
+                                       2039, 4093, 8191, 16381, 32749,
+                                       65521, 131071, 262139, 524287,
+                                       1048573, 2097143, 4194301,
+                                       8388593, 16777213, 33554393,
+                                       67108859};
+
+/* Capacity of a Symble Table made by SymTable_new, and the bytes of
+   key pool it gets per binding */
+
+enum {DEFAULT_CAPACITY = 16381};
+enum {DEFAULT_KEY_BYTES = 16};
+
+/* Owner stored in the record of a removed key */
+
+#define RECORD_DEAD ((size_t)-1)
 
 
 /* Each key and respective value are stored in a Binding. Bindings
-   whose keys hash to the same code are linked to form a list */
+   whose keys hash to the same code are linked to form a list, and
+   unused Bindings are linked to form the free list */
 
 struct Binding {
 
-   /* key, owned by implementation through defensive copy */
+   /* key, a record of the key pool unless the table borrows its
+      keys */
    const char *pcKey;
 
    /* value, owned by client */
    void *pvValue;
 
    /* The address of the next Binding on the list of same-hash-code
-      Bindings */
+      Bindings, or on the free list */
    struct Binding *pbNext;
 };
 
 
 /* SymTable is a structure that points to all separate chains' first
-   Bindings. That is, to all Bindings that are first on their list of
-   same-hash-code Bindings */
+   Bindings. It is the start of a single block of memory that also
+   holds the bucket array, the Bindings and the key pool.
+
+   The key pool is a sequence of records, each made of the position
+   of the Binding that owns it, or RECORD_DEAD, followed by the key
+   and padding up to a whole number of words */
 
 struct SymTable {
 
-   /* Index of auBucketCount[] leading to current bucket count for 
-      SymTable object */
-   size_t uBucketIndex;
+   /* # of buckets */
+   size_t uBucketCount;
 
    /* Pointer to the addresses of separate chains' first Bindings */
    struct Binding **ppbBuckets;
 
-   /* size of Symble Table (total # of Bindings) */
+   /* size of Symble Table (total # of Bindings in use) */
    size_t uLength;
+
+   /* # of Bindings in pbBindings */
+   size_t uCapacity;
+
+   /* all Bindings, used or not */
+   struct Binding *pbBindings;
+
+   /* first unused Binding, or NULL if the table is full */
+   struct Binding *pbFree;
+
+   /* key pool */
+   char *pcPool;
+
+   /* # of bytes of the key pool */
+   size_t uPoolSize;
+
+   /* # of bytes of the key pool holding records, dead ones included */
+   size_t uPoolUsed;
+
+   /* # of bytes of the key pool holding dead records */
+   size_t uPoolDead;
+
+   /* 1 (TRUE) if keys are borrowed from the client rather than
+      copied into the key pool */
+   int iBorrowsKeys;
+
+   /* 1 (TRUE) if the block was allocated by the implementation, 0
+      (FALSE) if it was provided by the client */
+   int iOwnsBlock;
 };
 
 
 
-SymTable_T SymTable_new(void) {
+/* Return u rounded up to a whole number of words */
+
+static size_t SymTable_roundUp(size_t u) {
+
+   return (u + sizeof(size_t) - 1) / sizeof(size_t) * sizeof(size_t);
+}
+
+
+/* Return the # of bytes of the key pool record of a key of
+   uKeyLength characters */
+
+static size_t SymTable_recordSize(size_t uKeyLength) {
+
+   return sizeof(size_t) + SymTable_roundUp(uKeyLength + 1);
+}
+
+
+/* Return the bucket count of a Symble Table with room for uCapacity
+   bindings */
+
+static size_t SymTable_bucketCount(size_t uCapacity) {
+
+   size_t i;
+   size_t uLastIndex;
+
+   uLastIndex = sizeof(auBucketCount) / sizeof(size_t) - 1;
+
+   for (i = 0; i < uLastIndex; i++)
+      if (auBucketCount[i] >= uCapacity)
+         break;
+
+   return auBucketCount[i];
+}
+
+
+/* Helper function that empties oSymTable: no chains, every Binding on
+   the free list and no records in the key pool */
+
+static void SymTable_reset(SymTable_T oSymTable) {
+
+   size_t i;
+
+   assert(oSymTable != NULL);
+
+   for (i = 0; i < oSymTable->uBucketCount; i++)
+      oSymTable->ppbBuckets[i] = NULL;
+
+   oSymTable->pbFree = NULL;
+
+   /* Link from the end, so that Bindings are used in order */
+   for (i = oSymTable->uCapacity; i > 0; i--) {
+
+      oSymTable->pbBindings[i - 1].pbNext = oSymTable->pbFree;
+      oSymTable->pbFree = &oSymTable->pbBindings[i - 1];
+   }
+
+   oSymTable->uLength = 0;
+   oSymTable->uPoolUsed = 0;
+   oSymTable->uPoolDead = 0;
+}
+
+
+/* Return the # of bytes of a block holding a Symble Table with room
+   for uCapacity bindings and a key pool of uPoolSize bytes, or 0 if
+   that # does not fit in a size_t. uPoolSize must be a whole number
+   of words */
+
+static size_t SymTable_blockSize(size_t uCapacity, size_t uPoolSize) {
+
+   size_t uBucketCount;
+   size_t uFixedSize;
+   const size_t uMaxSize = (size_t)-1;
+
+   uBucketCount = SymTable_bucketCount(uCapacity);
+
+   uFixedSize = sizeof(struct SymTable) +
+      sizeof(struct Binding*) * uBucketCount;
+
+   if ((uPoolSize > uMaxSize - uFixedSize) ||
+       (uCapacity > (uMaxSize - uFixedSize - uPoolSize) /
+        sizeof(struct Binding)))
+      return 0;
+
+   return uFixedSize + sizeof(struct Binding) * uCapacity + uPoolSize;
+}
+
+
+/* Lay out a Symble Table with room for uCapacity bindings and a key
+   pool of uPoolSize bytes in the block pvBlock, which must be
+   SymTable_blockSize(uCapacity, uPoolSize) bytes long and suitably
+   aligned for any object. Return the new, empty Symble Table */
+
+static SymTable_T SymTable_layout(void *pvBlock, size_t uCapacity,
+                                  size_t uPoolSize) {
 
    SymTable_T oSymTable;
+   enum {FALSE, TRUE};
 
+   assert(pvBlock != NULL);
+   assert(SymTable_blockSize(uCapacity, uPoolSize) != 0);
 
-   oSymTable = (SymTable_T)malloc(sizeof(struct SymTable));
+   oSymTable = (SymTable_T)pvBlock;
 
-   if (oSymTable == NULL)
+   oSymTable->uBucketCount = SymTable_bucketCount(uCapacity);
+   oSymTable->ppbBuckets = (struct Binding**)(void*)(oSymTable + 1);
+
+   oSymTable->uCapacity = uCapacity;
+   oSymTable->pbBindings = (struct Binding*)(void*)
+      (oSymTable->ppbBuckets + oSymTable->uBucketCount);
+
+   oSymTable->uPoolSize = uPoolSize;
+   oSymTable->pcPool = (char*)(void*)
+      (oSymTable->pbBindings + uCapacity);
+
+   oSymTable->iBorrowsKeys = FALSE;
+   oSymTable->iOwnsBlock = FALSE;
+
+   SymTable_reset(oSymTable);
+
+   return oSymTable;
+}
+
+
+
+SymTable_T SymTable_newFixed(size_t uCapacity, size_t uKeyPoolSize) {
+
+   size_t uBlockSize;
+   void *pvBlock;
+   SymTable_T oSymTable;
+   enum {FALSE, TRUE};
+
+
+   uBlockSize = SymTable_bufferSize(uCapacity, uKeyPoolSize);
+
+   if (uBlockSize == 0)
       return NULL;
 
 
-   oSymTable->ppbBuckets = (struct Binding**)
-      calloc(sizeof(struct Binding*), auBucketCount[0]);
+   pvBlock = malloc(uBlockSize);
 
-   if (oSymTable->ppbBuckets == NULL) {
-      
-      free(oSymTable);
+   if (pvBlock == NULL)
       return NULL;
-   }
 
-   oSymTable->uLength = 0;
-   oSymTable->uBucketIndex = 0;
 
-   
+   oSymTable = SymTable_layout(pvBlock, uCapacity,
+                               SymTable_roundUp(uKeyPoolSize));
+   oSymTable->iOwnsBlock = TRUE;
+
    return oSymTable;
 }
 
 
 
-void SymTable_free(SymTable_T oSymTable) {
+size_t SymTable_bufferSize(size_t uCapacity, size_t uKeyPoolSize) {
+
+   size_t uPoolSize;
+
+   uPoolSize = SymTable_roundUp(uKeyPoolSize);
+
+   if (uPoolSize < uKeyPoolSize)
+      return 0;
+
+   return SymTable_blockSize(uCapacity, uPoolSize);
+}
+
+
+
+SymTable_T SymTable_initInBuffer(void *pvBuffer, size_t uSize,
+                                 size_t uCapacity) {
+
+   size_t uFixedSize;
+   size_t uPoolSize;
+
+   assert(pvBuffer != NULL);
+
+   uFixedSize = SymTable_blockSize(uCapacity, 0);
+
+   if ((uFixedSize == 0) || (uSize < uFixedSize))
+      return NULL;
+
+   /* The rest of the buffer, in whole words, holds key copies */
+   uPoolSize = (uSize - uFixedSize) / sizeof(size_t) * sizeof(size_t);
+
+   return SymTable_layout(pvBuffer, uCapacity, uPoolSize);
+}
+
+
+
+SymTable_T SymTable_new(void) {
+
+   return SymTable_newFixed(DEFAULT_CAPACITY,
+                            DEFAULT_CAPACITY * DEFAULT_KEY_BYTES);
+}
+
+
+
+SymTable_T SymTable_newBorrowedKeys(void) {
+
+   SymTable_T oSymTable;
+   enum {FALSE, TRUE};
+
+   /* Borrowed keys need no key pool */
+   oSymTable = SymTable_newFixed(DEFAULT_CAPACITY, 0);
+
+   if (oSymTable == NULL)
+      return NULL;
+
+   oSymTable->iBorrowsKeys = TRUE;
+
+   return oSymTable;
+}
+
+
+
+/* Helper function that calls pfFreeValue on the value of every
+   Binding of oSymTable, unless pfFreeValue is NULL */
+
+static void SymTable_freeValues(SymTable_T oSymTable,
+                                void (*pfFreeValue)(void *pvValue)) {
 
    struct Binding *pbCurrent;
-   struct Binding *pbNext;
    size_t i;
 
-   
+
    assert(oSymTable != NULL);
 
-   
-   for (i = 0; i < auBucketCount[oSymTable->uBucketIndex]; i++) {
 
-      
-      pbCurrent = oSymTable->ppbBuckets[i];    
+   if (pfFreeValue != NULL)
+      for (i = 0; i < oSymTable->uBucketCount; i++)
+         for (pbCurrent = oSymTable->ppbBuckets[i]; pbCurrent != NULL;
+              pbCurrent = pbCurrent->pbNext)
+            (*pfFreeValue)(pbCurrent->pvValue);
+}
 
-      
-      while (pbCurrent != NULL) {
 
-         /* Save pointer to next Binding before freeing pbCurrent */
-         pbNext = pbCurrent->pbNext;
+void SymTable_free(SymTable_T oSymTable) {
 
-         
-         free((void*)pbCurrent->pcKey);
+   assert(oSymTable != NULL);
+
+   SymTable_freeWith(oSymTable, NULL);
+}
+
+
+
+void SymTable_freeWith(SymTable_T oSymTable,
+                       void (*pfFreeValue)(void *pvValue)) {
+
+   assert(oSymTable != NULL);
+
+   SymTable_freeValues(oSymTable, pfFreeValue);
+
+   /* Buckets, Bindings and key pool share the block, and a block
+      provided by the client stays with the client, who may reuse it
+      as is, so the table need not be emptied first */
+   if (oSymTable->iOwnsBlock)
+      free(oSymTable);
+}
 
-         free(pbCurrent);
 
-         pbCurrent = pbNext;
-      }
-   }
 
-   free(oSymTable->ppbBuckets);
-   free(oSymTable);
+void SymTable_clear(SymTable_T oSymTable,
+                    void (*pfFreeValue)(void *pvValue)) {
+
+   assert(oSymTable != NULL);
+
+   SymTable_freeValues(oSymTable, pfFreeValue);
+   SymTable_reset(oSymTable);
 }
 
 
@@ -124,6 +379,14 @@ size_t SymTable_getLength(SymTable_T oSymTable) {
 }
 
 
+size_t SymTable_getCapacity(SymTable_T oSymTable) {
+
+   assert(oSymTable != NULL);
+
+   return oSymTable->uCapacity;
+}
+
+
 
 /* Return a hash code for pcKey that is between 0 and uBucketCount-1,
    inclusive. pcKey is a pointer to the key which will be hashed.
@@ -144,16 +407,113 @@ static size_t SymTable_hash(const char *pcKey, size_t uBucketCount)
 }
 
 
+/* Helper function that slides the live records of the key pool of
+   oSymTable to its start, over the dead ones, and updates the keys of
+   their Bindings */
+
+static void SymTable_compact(SymTable_T oSymTable) {
+
+   size_t uRead;
+   size_t uWrite;
+   size_t uOwner;
+   size_t uRecordSize;
+   char *pcRecord;
+
+
+   assert(oSymTable != NULL);
+
+
+   uRead = 0;
+   uWrite = 0;
+
+   while (uRead < oSymTable->uPoolUsed) {
+
+      pcRecord = oSymTable->pcPool + uRead;
+
+      memcpy(&uOwner, pcRecord, sizeof(size_t));
+      uRecordSize = SymTable_recordSize(strlen(pcRecord +
+                                               sizeof(size_t)));
+
+      if (uOwner != RECORD_DEAD) {
+
+         if (uWrite != uRead)
+            memmove(oSymTable->pcPool + uWrite, pcRecord, uRecordSize);
+
+         oSymTable->pbBindings[uOwner].pcKey =
+            oSymTable->pcPool + uWrite + sizeof(size_t);
+
+         uWrite += uRecordSize;
+      }
+
+      uRead += uRecordSize;
+   }
+
+   oSymTable->uPoolUsed = uWrite;
+   oSymTable->uPoolDead = 0;
+}
+
+
+/* Copy pcKey into a new record of the key pool of oSymTable, owned by
+   the Binding at position uOwner, compacting the pool first if that
+   makes room. Return the copy, or NULL if the pool has no room for
+   it */
+
+static char *SymTable_copyKey(SymTable_T oSymTable, const char *pcKey,
+                              size_t uOwner) {
+
+   size_t uKeyLength;
+   size_t uRecordSize;
+   char *pcRecord;
+
+
+   assert(oSymTable != NULL);
+   assert(pcKey != NULL);
+
+
+   uKeyLength = strlen(pcKey);
+   uRecordSize = SymTable_recordSize(uKeyLength);
+
+   if (uRecordSize > oSymTable->uPoolSize - oSymTable->uPoolUsed) {
+
+      if (uRecordSize > oSymTable->uPoolSize - oSymTable->uPoolUsed +
+          oSymTable->uPoolDead)
+         return NULL;
+
+      SymTable_compact(oSymTable);
+   }
+
+
+   pcRecord = oSymTable->pcPool + oSymTable->uPoolUsed;
+
+   memcpy(pcRecord, &uOwner, sizeof(size_t));
+   memcpy(pcRecord + sizeof(size_t), pcKey, uKeyLength + 1);
+
+   oSymTable->uPoolUsed += uRecordSize;
+
+   return pcRecord + sizeof(size_t);
+}
+
+
+/* Mark the key pool record of pcKey, a key of oSymTable, dead */
+
+static void SymTable_releaseKey(SymTable_T oSymTable,
+                                const char *pcKey) {
+
+   const size_t uDead = RECORD_DEAD;
+
+   assert(oSymTable != NULL);
+   assert(pcKey != NULL);
+
+   memcpy((char*)pcKey - sizeof(size_t), &uDead, sizeof(size_t));
+
+   oSymTable->uPoolDead += SymTable_recordSize(strlen(pcKey));
+}
+
+
 
 int SymTable_put(SymTable_T oSymTable, const char *pcKey,
                  const void *pvValue) {
 
-   size_t uMAX_INDEX;
-   size_t uCurrentIndex;
-   size_t uBucketCount;
-   size_t uLength;
-   
-
    size_t uIndex;
    char *pcCopy;
    struct Binding *pbCurrent;
@@ -161,78 +521,58 @@ int SymTable_put(SymTable_T oSymTable, const char *pcKey,
    enum {FALSE, TRUE};
    enum {EQUAL};
 
-   
+
    assert(oSymTable != NULL);
    assert(pcKey != NULL);
 
-   
-   uMAX_INDEX = sizeof(auBucketCount)/sizeof(size_t) - 1;
-   
-   uCurrentIndex = oSymTable->uBucketIndex;
-   
-   uBucketCount = auBucketCount[uCurrentIndex];
-   
-   uLength = oSymTable->uLength;
-   
-
-   
-   if ((uLength == uBucketCount) && (uCurrentIndex < uMAX_INDEX)) {
-      
-      
-      uBucketCount = auBucketCount[oSymTable->uBucketIndex];
+
+   uIndex = SymTable_hash(pcKey, oSymTable->uBucketCount);
+
+
+   pbCurrent = oSymTable->ppbBuckets[uIndex];
+
+   while (pbCurrent != NULL) {
+
+      if (strcmp(pbCurrent->pcKey, pcKey) == EQUAL)
+         return FALSE;
+
+      pbCurrent = pbCurrent->pbNext;
    }
 
-   
-   
-   uIndex = SymTable_hash(pcKey, uBucketCount);
-   
-   
-   pbCurrent = (oSymTable->ppbBuckets[uIndex]);
-   
-      
-      while (pbCurrent != NULL) {
-      
-         if (strcmp(pbCurrent->pcKey, pcKey) == EQUAL)
-            return FALSE;
-      
-         pbCurrent = pbCurrent->pbNext;
-      }
-   
 
-   
-   pbNewBinding = (struct Binding*)malloc(sizeof(struct Binding));
+   /* Table is full */
+   pbNewBinding = oSymTable->pbFree;
 
    if (pbNewBinding == NULL)
       return FALSE;
 
-   
-   pcCopy = (char*)malloc(strlen(pcKey) + 1);
-   
-   if (pcCopy == NULL) {
 
-      free(pbNewBinding);
+   /* Borrowed keys are stored as is */
+   if (oSymTable->iBorrowsKeys)
+      pcCopy = (char*)pcKey;
 
-      return FALSE;
+   else {
+
+      pcCopy = SymTable_copyKey(oSymTable, pcKey,
+                                (size_t)(pbNewBinding -
+                                         oSymTable->pbBindings));
+
+      if (pcCopy == NULL)
+         return FALSE;
    }
 
 
-   pcCopy = strcpy(pcCopy, pcKey);
+   oSymTable->pbFree = pbNewBinding->pbNext;
 
-   
    pbNewBinding->pcKey = pcCopy;
-   
    pbNewBinding->pvValue = (void*)pvValue;
 
-
-
    pbNewBinding->pbNext = oSymTable->ppbBuckets[uIndex];
-
    oSymTable->ppbBuckets[uIndex] = pbNewBinding;
-   
- 
+
+
    oSymTable->uLength++;
 
-   
    return TRUE;
 }
 
@@ -245,23 +585,19 @@ static struct Binding *SymTable_find(SymTable_T oSymTable,
                                      const char *pcKey) {
 
    size_t uIndex;
-   size_t uBucketCount;
    struct Binding *pbCurrent;
    enum {EQUAL};
 
    /* redundant, but just so that critTer doesn't complain */
    assert(oSymTable != NULL);
    assert(pcKey != NULL);
-   
-   
-   uBucketCount = auBucketCount[oSymTable->uBucketIndex];
 
-                                
-   uIndex = SymTable_hash(pcKey, uBucketCount);
 
-   
+   uIndex = SymTable_hash(pcKey, oSymTable->uBucketCount);
+
+
    pbCurrent = oSymTable->ppbBuckets[uIndex];
-   
+
 
    while (pbCurrent != NULL) {
 
@@ -281,7 +617,7 @@ void *SymTable_replace(SymTable_T oSymTable, const char *pcKey,
    struct Binding *pbResult;
    void *pvPrevious;
 
-   
+
    assert(oSymTable != NULL);
    assert(pcKey != NULL);
 
@@ -293,12 +629,12 @@ void *SymTable_replace(SymTable_T oSymTable, const char *pcKey,
    pbResult->pvValue = (void*)pvValue;
 
    return pvPrevious;
-   
+
 }
 
 int SymTable_contains(SymTable_T oSymTable, const char *pcKey) {
 
-   
+
    struct Binding *pbResult;
    enum {NOT_FOUND, FOUND};
 
@@ -318,24 +654,23 @@ void *SymTable_get(SymTable_T oSymTable, const char *pcKey) {
 
    assert(oSymTable != NULL);
    assert(pcKey != NULL);
-   
+
 
    pbResult = SymTable_find(oSymTable, pcKey);
 
    if (pbResult == NULL) return NULL;
 
    return pbResult->pvValue;
-   
+
 }
 
 void *SymTable_remove(SymTable_T oSymTable, const char *pcKey) {
 
 
    size_t uIndex;
-   size_t uBucketCount;
    void *pvValue;
    enum {EQUAL};
-   
+
    struct Binding *pbPrev;
    struct Binding *pbCurrent;
 
@@ -343,18 +678,14 @@ void *SymTable_remove(SymTable_T oSymTable, const char *pcKey) {
    assert(oSymTable != NULL);
    assert(pcKey != NULL);
 
-   
-   uBucketCount = auBucketCount[oSymTable->uBucketIndex];
 
-   
-   uIndex = SymTable_hash(pcKey, uBucketCount);
+   uIndex = SymTable_hash(pcKey, oSymTable->uBucketCount);
 
 
-   
    pbCurrent = oSymTable->ppbBuckets[uIndex];
    pbPrev = NULL;
 
-   
+
    while (pbCurrent != NULL) {
 
       if(strcmp(pbCurrent->pcKey, pcKey) == EQUAL) {
@@ -366,12 +697,15 @@ void *SymTable_remove(SymTable_T oSymTable, const char *pcKey) {
          else
             pbPrev->pbNext = pbCurrent->pbNext;
 
-         
+
          pvValue = pbCurrent->pvValue;
 
-         free((void*)pbCurrent->pcKey);
-         
-         free(pbCurrent);
+         if (! oSymTable->iBorrowsKeys)
+            SymTable_releaseKey(oSymTable, pbCurrent->pcKey);
+
+         /* Binding goes back to the free list */
+         pbCurrent->pbNext = oSymTable->pbFree;
+         oSymTable->pbFree = pbCurrent;
 
          oSymTable->uLength--;
 
@@ -391,29 +725,140 @@ void SymTable_map(SymTable_T oSymTable,
                                   void *pvExtra), const void *pvExtra) {
 
    size_t i;
-   size_t uBucketCount;
    struct Binding *pbCurrent;
 
    assert(oSymTable != NULL);
    assert(pfApply != NULL);
 
-   
-   uBucketCount = auBucketCount[oSymTable->uBucketIndex];
 
-   
-   for (i = 0; i < uBucketCount; i++) {
+   for (i = 0; i < oSymTable->uBucketCount; i++) {
 
       pbCurrent = oSymTable->ppbBuckets[i];
 
-      
+
       while (pbCurrent != NULL) {
 
          (*pfApply)((void*)pbCurrent->pcKey,
                     (void*)pbCurrent->pvValue,
                     (void*)pvExtra);
-            
+
          pbCurrent = pbCurrent->pbNext;
-              
+
+      }
+   }
+}
+
+
+/* Add to the estimate of psMemory the bytes that malloc adds to a
+   block of uSize bytes */
+
+static void SymTable_addOverhead(struct SymTableMemory *psMemory,
+                                 size_t uSize) {
+
+   const size_t uWord = sizeof(size_t);
+   size_t uChunk;
+
+   assert(psMemory != NULL);
+
+   uChunk = (uSize + 3 * uWord - 1) / (2 * uWord) * (2 * uWord);
+
+   if (uChunk < 4 * uWord)
+      uChunk = 4 * uWord;
+
+   psMemory->uOverheadBytes += uChunk - uSize;
+}
+
+
+void SymTable_memoryUsage(SymTable_T oSymTable,
+                          struct SymTableMemory *psMemory) {
+
+   assert(oSymTable != NULL);
+   assert(psMemory != NULL);
+
+   /* Everything is in one block, whatever the length */
+   psMemory->uTableBytes = sizeof(struct SymTable) +
+      sizeof(struct Binding*) * oSymTable->uBucketCount;
+   psMemory->uBindingBytes =
+      sizeof(struct Binding) * oSymTable->uCapacity;
+   psMemory->uKeyBytes = oSymTable->uPoolSize;
+   psMemory->uOverheadBytes = 0;
+
+   if (oSymTable->iOwnsBlock)
+      SymTable_addOverhead(psMemory, psMemory->uTableBytes +
+                           psMemory->uBindingBytes +
+                           psMemory->uKeyBytes);
+}
+
+
+/* Position psIter at the first Binding found in a bucket whose index
+   is at least uIndex, or at its end if there is no such Binding */
+
+static void SymTable_iterSeek(struct SymTableIter *psIter,
+                              size_t uIndex) {
+
+   size_t uBucketCount;
+   struct Binding *pbCurrent;
+
+   assert(psIter != NULL);
+
+   uBucketCount = psIter->oSymTable->uBucketCount;
+
+   for (; uIndex < uBucketCount; uIndex++) {
+
+      pbCurrent = psIter->oSymTable->ppbBuckets[uIndex];
+
+      if (pbCurrent != NULL) {
+
+         psIter->uIndex = uIndex;
+         psIter->pvPosition = pbCurrent;
+         psIter->pcKey = pbCurrent->pcKey;
+         psIter->pvValue = pbCurrent->pvValue;
+         return;
       }
    }
+
+   psIter->uIndex = uBucketCount;
+   psIter->pvPosition = NULL;
+   psIter->pcKey = NULL;
+   psIter->pvValue = NULL;
+}
+
+
+void SymTable_iterBegin(SymTable_T oSymTable,
+                        struct SymTableIter *psIter) {
+
+   assert(oSymTable != NULL);
+   assert(psIter != NULL);
+
+   psIter->oSymTable = oSymTable;
+
+   SymTable_iterSeek(psIter, 0);
+}
+
+void SymTable_iterNext(struct SymTableIter *psIter) {
+
+   struct Binding *pbNext;
+
+   assert(psIter != NULL);
+   assert(psIter->pvPosition != NULL);
+
+   pbNext = ((struct Binding*)psIter->pvPosition)->pbNext;
+
+   /* Stay on the same separate chain while it lasts */
+   if (pbNext != NULL) {
+
+      psIter->pvPosition = pbNext;
+      psIter->pcKey = pbNext->pcKey;
+      psIter->pvValue = pbNext->pvValue;
+      return;
+   }
+
+   SymTable_iterSeek(psIter, psIter->uIndex + 1);
+}
+
+int SymTable_iterEnd(const struct SymTableIter *psIter) {
+
+   assert(psIter != NULL);
+
+   return psIter->pvPosition == NULL;
 }
@@ -0,0 +1,67 @@
+/*--------------------------------------------------------------------*/
+/* symtablestatic.h                                                   */
+/* Author: Julio Lins (jcclb)                                         */
+/*--------------------------------------------------------------------*/
+
+#ifndef SYMTABLESTATIC_H
+#define SYMTABLESTATIC_H
+
+/*--------------------------------------------------------------------*/
+
+#include "symtable.h"
+
+/*--------------------------------------------------------------------*/
+
+/* Operations provided by the fixed-capacity implementation of
+   symtable.h (symtablestatic.c). A SymTable_T object of this
+   implementation gets all of its memory when it is created: its
+   buckets, a pool of Bindings and a pool of bytes for key copies.
+   SymTable_put, SymTable_remove and SymTable_clear never allocate or
+   free memory; SymTable_put fails, returning 0 (FALSE), once the
+   table holds as many bindings as its capacity or its key pool has no
+   room left for a copy of pcKey. Space of removed keys is reclaimed
+   by compacting the key pool when it fills up. SymTable_new creates a
+   table with a default capacity of 16381 bindings and a key pool of
+   16 bytes per binding */
+
+/*--------------------------------------------------------------------*/
+
+/* Return a new SymTable_T object with room for uCapacity bindings and
+   uKeyPoolSize bytes of key copies, or NULL if insufficient memory is
+   available. Each key takes its length plus one byte, plus one word
+   of bookkeeping, rounded up to a whole number of words */
+
+SymTable_T SymTable_newFixed(size_t uCapacity, size_t uKeyPoolSize);
+
+/*--------------------------------------------------------------------*/
+
+/* Return the # of bytes of a buffer that holds a SymTable_T object
+   with room for uCapacity bindings and uKeyPoolSize bytes of key
+   copies, as SymTable_newFixed would allocate, or 0 if that # does
+   not fit in a size_t */
+
+size_t SymTable_bufferSize(size_t uCapacity, size_t uKeyPoolSize);
+
+/*--------------------------------------------------------------------*/
+
+/* Lay out a new SymTable_T object with room for uCapacity bindings in
+   the uSize bytes at pvBuffer, without allocating memory, and return
+   it, or NULL if uSize is too small. The bytes left over after the
+   bindings hold key copies. pvBuffer must be aligned for any object,
+   as memory returned by malloc is, and must not be used by the client
+   until the object is freed; SymTable_free and SymTable_freeWith
+   leave it to the client. The object stores addresses within
+   pvBuffer, so it must not be copied or mapped elsewhere */
+
+SymTable_T SymTable_initInBuffer(void *pvBuffer, size_t uSize,
+                                 size_t uCapacity);
+
+/*--------------------------------------------------------------------*/
+
+/* Return the # of bindings oSymTable has room for */
+
+size_t SymTable_getCapacity(SymTable_T oSymTable);
+
+/*--------------------------------------------------------------------*/
+
+#endif
@@ -0,0 +1,466 @@
+/*--------------------------------------------------------------------*/
+/* symtabletemplate.h                                                 */
+/* Author: Julio Lins (jcclb)                                         */
+/*--------------------------------------------------------------------*/
+
+#ifndef SYMTABLETEMPLATE_H
+#define SYMTABLETEMPLATE_H
+
+/*--------------------------------------------------------------------*/
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <assert.h>
+
+/*--------------------------------------------------------------------*/
+
+/* SYMTABLE_DEFINE(name, KeyT, ValT, hashfn, eqfn) defines a hash table
+   type name##_T whose keys are of type KeyT and whose values are of
+   type ValT, with its functions. It is the hash table of
+   symtablehash.c made for those types: it grows through the same
+   bucket counts, and its map and iterator visit bindings in the same
+   way. But keys and values are stored in the Bindings themselves, so
+   a binding takes one allocation whatever its types, and no value is
+   boxed behind a void*. Keys and values are copied by assignment; a
+   key that is a pointer is borrowed, as by SymTable_newBorrowedKeys.
+
+   hashfn(tKey) must return a size_t hash code for a KeyT, and
+   eqfn(tKey1, tKey2) nonzero if two KeyTs are equal, 0 otherwise.
+   Both may be functions or macros, and are called with KeyT values.
+
+   The functions are static, so that each translation unit that uses
+   SYMTABLE_DEFINE gets its own copy, which the compiler may inline.
+   Write SYMTABLE_DEFINE at file scope, followed by a semicolon as a
+   declaration is. For example,
+
+      SYMTABLE_DEFINE(IntTable, unsigned long, int, hashInt, equalInt);
+
+   defines IntTable_T and these functions, whose contracts are those
+   of the functions of symtable.h of the same names, except as noted:
+
+      IntTable_T IntTable_new(void);
+      void IntTable_free(IntTable_T oTable);
+      size_t IntTable_getLength(IntTable_T oTable);
+      int IntTable_put(IntTable_T oTable, unsigned long tKey,
+                       int tValue);
+      int IntTable_contains(IntTable_T oTable, unsigned long tKey);
+
+   Return the address of the value bound to tKey, in its Binding, or
+   NULL if no such binding exists. The value may be changed through
+   it, which does what SymTable_replace does, and it stays valid
+   until the binding is removed:
+
+      int *IntTable_find(IntTable_T oTable, unsigned long tKey);
+
+   If oTable contains a binding whose key is tKey, store its value in
+   *ptValue and return 1 (TRUE). Else, return 0 (FALSE):
+
+      int IntTable_get(IntTable_T oTable, unsigned long tKey,
+                       int *ptValue);
+
+   If oTable contains a binding whose key is tKey, remove it, store
+   its value in *ptValue unless ptValue is NULL, and return 1 (TRUE).
+   Else, leave oTable unchanged and return 0 (FALSE):
+
+      int IntTable_remove(IntTable_T oTable, unsigned long tKey,
+                          int *ptValue);
+
+   pfApply gets the address of each value, in its Binding:
+
+      void IntTable_map(IntTable_T oTable,
+         void (*pfApply)(unsigned long tKey, int *ptValue,
+                         void *pvExtra),
+         const void *pvExtra);
+
+   struct IntTable_Iter is used as a struct SymTableIter is, with tKey
+   and ptValue, the address of the value in its Binding, holding the
+   current binding while IntTable_iterEnd returns 0 (FALSE):
+
+      void IntTable_iterBegin(IntTable_T oTable,
+                              struct IntTable_Iter *psIter);
+      void IntTable_iterNext(struct IntTable_Iter *psIter);
+      int IntTable_iterEnd(const struct IntTable_Iter *psIter);
+
+   In the code SYMTABLE_DEFINE generates, the prefix t stands for a
+   KeyT or a ValT */
+
+/*--------------------------------------------------------------------*/
+
+/* Mark a function that a translation unit may well not call */
+
+#if defined(__GNUC__)
+#define SYMTABLE_UNUSED __attribute__((unused))
+#else
+#define SYMTABLE_UNUSED
+#endif
+
+/*--------------------------------------------------------------------*/
+
+/* Index of the last bucket count */
+
+enum {SYMTABLE_MAX_BUCKET_INDEX = 7};
+
+/* Return bucket count uIndex of the sequence for table expansion,
+   that of symtablehash.c */
+
+SYMTABLE_UNUSED static size_t SymTableTemplate_bucketCount(
+   size_t uIndex) {
+
+   static const size_t auBucketCount[] = {509, 1021, 2039, 4093, 8191,
+                                          16381, 32749, 65521};
+
+   assert(uIndex <= SYMTABLE_MAX_BUCKET_INDEX);
+
+   return auBucketCount[uIndex];
+}
+
+/*--------------------------------------------------------------------*/
+
+#define SYMTABLE_DEFINE(name, KeyT, ValT, hashfn, eqfn)                \
+                                                                       \
+typedef struct name##_Table *name##_T;                                 \
+                                                                       \
+struct name##_Binding {                                                \
+                                                                       \
+   /* key and value, stored in the Binding */                          \
+   KeyT tKey;                                                          \
+   ValT tValue;                                                        \
+                                                                       \
+   /* The address of the next Binding on the list of same-hash-code    \
+      Bindings */                                                      \
+   struct name##_Binding *pbNext;                                      \
+};                                                                     \
+                                                                       \
+struct name##_Table {                                                  \
+                                                                       \
+   /* Index of the bucket count, as given by                           \
+      SymTableTemplate_bucketCount */                                  \
+   size_t uBucketIndex;                                                \
+                                                                       \
+   /* Pointer to the addresses of separate chains' first Bindings */   \
+   struct name##_Binding **ppbBuckets;                                 \
+                                                                       \
+   /* size of the table (total # of Bindings) */                       \
+   size_t uLength;                                                     \
+};                                                                     \
+                                                                       \
+struct name##_Iter {                                                   \
+                                                                       \
+   /* key of the current binding */                                    \
+   KeyT tKey;                                                          \
+                                                                       \
+   /* value of the current binding, in the Binding itself */           \
+   ValT *ptValue;                                                      \
+                                                                       \
+   /* table being traversed */                                         \
+   name##_T oTable;                                                    \
+                                                                       \
+   /* index of the current bucket */                                   \
+   size_t uIndex;                                                      \
+                                                                       \
+   /* current Binding, or NULL at the end */                           \
+   struct name##_Binding *pbPosition;                                  \
+};                                                                     \
+                                                                       \
+SYMTABLE_UNUSED static name##_T name##_new(void) {                     \
+                                                                       \
+   name##_T oTable;                                                    \
+                                                                       \
+   oTable = (name##_T)malloc(sizeof(struct name##_Table));             \
+                                                                       \
+   if (oTable == NULL)                                                 \
+      return NULL;                                                     \
+                                                                       \
+   oTable->ppbBuckets = (struct name##_Binding**)                      \
+      calloc(sizeof(struct name##_Binding*),                           \
+             SymTableTemplate_bucketCount(0));                         \
+                                                                       \
+   if (oTable->ppbBuckets == NULL) {                                   \
+                                                                       \
+      free(oTable);                                                    \
+      return NULL;                                                     \
+   }                                                                   \
+                                                                       \
+   oTable->uBucketIndex = 0;                                           \
+   oTable->uLength = 0;                                                \
+                                                                       \
+   return oTable;                                                      \
+}                                                                      \
+                                                                       \
+SYMTABLE_UNUSED static void name##_free(name##_T oTable) {             \
+                                                                       \
+   struct name##_Binding *pbCurrent;                                   \
+   struct name##_Binding *pbNext;                                      \
+   size_t i;                                                           \
+                                                                       \
+   assert(oTable != NULL);                                             \
+                                                                       \
+   for (i = 0;                                                         \
+        i < SymTableTemplate_bucketCount(oTable->uBucketIndex); i++)   \
+      for (pbCurrent = oTable->ppbBuckets[i]; pbCurrent != NULL;       \
+           pbCurrent = pbNext) {                                       \
+                                                                       \
+         pbNext = pbCurrent->pbNext;                                   \
+         free(pbCurrent);                                              \
+      }                                                                \
+                                                                       \
+   free(oTable->ppbBuckets);                                           \
+   free(oTable);                                                       \
+}                                                                      \
+                                                                       \
+SYMTABLE_UNUSED static size_t name##_getLength(name##_T oTable) {      \
+                                                                       \
+   assert(oTable != NULL);                                             \
+                                                                       \
+   return oTable->uLength;                                             \
+}                                                                      \
+                                                                       \
+SYMTABLE_UNUSED static void name##_grow(name##_T oTable) {             \
+                                                                       \
+   struct name##_Binding **ppbNewBuckets;                              \
+   struct name##_Binding *pbCurrent;                                   \
+   struct name##_Binding *pbNext;                                      \
+   size_t uNewCount;                                                   \
+   size_t uIndex;                                                      \
+   size_t i;                                                           \
+                                                                       \
+   assert(oTable != NULL);                                             \
+                                                                       \
+   uNewCount = SymTableTemplate_bucketCount(oTable->uBucketIndex + 1); \
+                                                                       \
+   ppbNewBuckets = (struct name##_Binding**)                           \
+      calloc(sizeof(struct name##_Binding*), uNewCount);               \
+                                                                       \
+   if (ppbNewBuckets == NULL)                                          \
+      return;                                                          \
+                                                                       \
+   for (i = 0;                                                         \
+        i < SymTableTemplate_bucketCount(oTable->uBucketIndex); i++)   \
+      for (pbCurrent = oTable->ppbBuckets[i]; pbCurrent != NULL;       \
+           pbCurrent = pbNext) {                                       \
+                                                                       \
+         pbNext = pbCurrent->pbNext;                                   \
+                                                                       \
+         uIndex = (size_t)(hashfn(pbCurrent->tKey)) % uNewCount;       \
+                                                                       \
+         pbCurrent->pbNext = ppbNewBuckets[uIndex];                    \
+         ppbNewBuckets[uIndex] = pbCurrent;                            \
+      }                                                                \
+                                                                       \
+   free(oTable->ppbBuckets);                                           \
+                                                                       \
+   oTable->ppbBuckets = ppbNewBuckets;                                 \
+   oTable->uBucketIndex++;                                             \
+}                                                                      \
+                                                                       \
+SYMTABLE_UNUSED static ValT *name##_find(name##_T oTable,              \
+                                         KeyT tKey) {                  \
+                                                                       \
+   struct name##_Binding *pbCurrent;                                   \
+   size_t uIndex;                                                      \
+                                                                       \
+   assert(oTable != NULL);                                             \
+                                                                       \
+   uIndex = (size_t)(hashfn(tKey)) %                                   \
+      SymTableTemplate_bucketCount(oTable->uBucketIndex);              \
+                                                                       \
+   for (pbCurrent = oTable->ppbBuckets[uIndex]; pbCurrent != NULL;     \
+        pbCurrent = pbCurrent->pbNext)                                 \
+      if (eqfn(pbCurrent->tKey, tKey))                                 \
+         return &pbCurrent->tValue;                                    \
+                                                                       \
+   return NULL;                                                        \
+}                                                                      \
+                                                                       \
+SYMTABLE_UNUSED static int name##_put(name##_T oTable, KeyT tKey,      \
+                                      ValT tValue) {                   \
+                                                                       \
+   struct name##_Binding *pbNewBinding;                                \
+   size_t uIndex;                                                      \
+   enum {FALSE, TRUE};                                                 \
+                                                                       \
+   assert(oTable != NULL);                                             \
+                                                                       \
+   if (name##_find(oTable, tKey) != NULL)                              \
+      return FALSE;                                                    \
+                                                                       \
+   if ((oTable->uLength ==                                             \
+        SymTableTemplate_bucketCount(oTable->uBucketIndex)) &&         \
+       (oTable->uBucketIndex < SYMTABLE_MAX_BUCKET_INDEX))             \
+      name##_grow(oTable);                                             \
+                                                                       \
+   pbNewBinding = (struct name##_Binding*)                             \
+      malloc(sizeof(struct name##_Binding));                           \
+                                                                       \
+   if (pbNewBinding == NULL)                                           \
+      return FALSE;                                                    \
+                                                                       \
+   pbNewBinding->tKey = tKey;                                          \
+   pbNewBinding->tValue = tValue;                                      \
+                                                                       \
+   uIndex = (size_t)(hashfn(tKey)) %                                   \
+      SymTableTemplate_bucketCount(oTable->uBucketIndex);              \
+                                                                       \
+   pbNewBinding->pbNext = oTable->ppbBuckets[uIndex];                  \
+   oTable->ppbBuckets[uIndex] = pbNewBinding;                          \
+                                                                       \
+   oTable->uLength++;                                                  \
+                                                                       \
+   return TRUE;                                                        \
+}                                                                      \
+                                                                       \
+SYMTABLE_UNUSED static int name##_contains(name##_T oTable,            \
+                                           KeyT tKey) {                \
+                                                                       \
+   assert(oTable != NULL);                                             \
+                                                                       \
+   return name##_find(oTable, tKey) != NULL;                           \
+}                                                                      \
+                                                                       \
+SYMTABLE_UNUSED static int name##_get(name##_T oTable, KeyT tKey,      \
+                                      ValT *ptValue) {                 \
+                                                                       \
+   ValT *ptFound;                                                      \
+   enum {FALSE, TRUE};                                                 \
+                                                                       \
+   assert(oTable != NULL);                                             \
+   assert(ptValue != NULL);                                            \
+                                                                       \
+   ptFound = name##_find(oTable, tKey);                                \
+                                                                       \
+   if (ptFound == NULL)                                                \
+      return FALSE;                                                    \
+                                                                       \
+   *ptValue = *ptFound;                                                \
+                                                                       \
+   return TRUE;                                                        \
+}                                                                      \
+                                                                       \
+SYMTABLE_UNUSED static int name##_remove(name##_T oTable, KeyT tKey,   \
+                                         ValT *ptValue) {              \
+                                                                       \
+   struct name##_Binding **ppbLink;                                    \
+   struct name##_Binding *pbCurrent;                                   \
+   enum {FALSE, TRUE};                                                 \
+                                                                       \
+   assert(oTable != NULL);                                             \
+                                                                       \
+   ppbLink = &oTable->ppbBuckets[(size_t)(hashfn(tKey)) %              \
+      SymTableTemplate_bucketCount(oTable->uBucketIndex)];             \
+                                                                       \
+   for (pbCurrent = *ppbLink; pbCurrent != NULL;                       \
+        pbCurrent = *ppbLink) {                                        \
+                                                                       \
+      if (eqfn(pbCurrent->tKey, tKey)) {                               \
+                                                                       \
+         *ppbLink = pbCurrent->pbNext;                                 \
+                                                                       \
+         if (ptValue != NULL)                                          \
+            *ptValue = pbCurrent->tValue;                              \
+                                                                       \
+         free(pbCurrent);                                              \
+                                                                       \
+         oTable->uLength--;                                            \
+                                                                       \
+         return TRUE;                                                  \
+      }                                                                \
+                                                                       \
+      ppbLink = &pbCurrent->pbNext;                                    \
+   }                                                                   \
+                                                                       \
+   return FALSE;                                                       \
+}                                                                      \
+                                                                       \
+SYMTABLE_UNUSED static void name##_map(name##_T oTable,                \
+   void (*pfApply)(KeyT tKey, ValT *ptValue, void *pvExtra),           \
+   const void *pvExtra) {                                              \
+                                                                       \
+   struct name##_Binding *pbCurrent;                                   \
+   size_t i;                                                           \
+                                                                       \
+   assert(oTable != NULL);                                             \
+   assert(pfApply != NULL);                                            \
+                                                                       \
+   for (i = 0;                                                         \
+        i < SymTableTemplate_bucketCount(oTable->uBucketIndex); i++)   \
+      for (pbCurrent = oTable->ppbBuckets[i]; pbCurrent != NULL;       \
+           pbCurrent = pbCurrent->pbNext)                              \
+         (*pfApply)(pbCurrent->tKey, &pbCurrent->tValue,               \
+                    (void*)pvExtra);                                   \
+}                                                                      \
+                                                                       \
+SYMTABLE_UNUSED static void name##_iterSeek(                           \
+   struct name##_Iter *psIter, size_t uIndex) {                        \
+                                                                       \
+   size_t uBucketCount;                                                \
+   struct name##_Binding *pbCurrent;                                   \
+                                                                       \
+   assert(psIter != NULL);                                             \
+                                                                       \
+   uBucketCount =                                                      \
+      SymTableTemplate_bucketCount(psIter->oTable->uBucketIndex);      \
+                                                                       \
+   for (; uIndex < uBucketCount; uIndex++) {                           \
+                                                                       \
+      pbCurrent = psIter->oTable->ppbBuckets[uIndex];                  \
+                                                                       \
+      if (pbCurrent != NULL) {                                         \
+                                                                       \
+         psIter->uIndex = uIndex;                                      \
+         psIter->pbPosition = pbCurrent;                               \
+         psIter->tKey = pbCurrent->tKey;                               \
+         psIter->ptValue = &pbCurrent->tValue;                         \
+         return;                                                       \
+      }                                                                \
+   }                                                                   \
+                                                                       \
+   psIter->uIndex = uBucketCount;                                      \
+   psIter->pbPosition = NULL;                                          \
+   psIter->ptValue = NULL;                                             \
+}                                                                      \
+                                                                       \
+SYMTABLE_UNUSED static void name##_iterBegin(name##_T oTable,          \
+   struct name##_Iter *psIter) {                                       \
+                                                                       \
+   assert(oTable != NULL);                                             \
+   assert(psIter != NULL);                                             \
+                                                                       \
+   psIter->oTable = oTable;                                            \
+                                                                       \
+   name##_iterSeek(psIter, 0);                                         \
+}                                                                      \
+                                                                       \
+SYMTABLE_UNUSED static void name##_iterNext(                           \
+   struct name##_Iter *psIter) {                                       \
+                                                                       \
+   struct name##_Binding *pbNext;                                      \
+                                                                       \
+   assert(psIter != NULL);                                             \
+   assert(psIter->pbPosition != NULL);                                 \
+                                                                       \
+   pbNext = psIter->pbPosition->pbNext;                                \
+                                                                       \
+   if (pbNext != NULL) {                                               \
+                                                                       \
+      psIter->pbPosition = pbNext;                                     \
+      psIter->tKey = pbNext->tKey;                                     \
+      psIter->ptValue = &pbNext->tValue;                               \
+      return;                                                          \
+   }                                                                   \
+                                                                       \
+   name##_iterSeek(psIter, psIter->uIndex + 1);                        \
+}                                                                      \
+                                                                       \
+SYMTABLE_UNUSED static int name##_iterEnd(                             \
+   const struct name##_Iter *psIter) {                                 \
+                                                                       \
+   assert(psIter != NULL);                                             \
+                                                                       \
+   return psIter->pbPosition == NULL;                                  \
+}                                                                      \
+                                                                       \
+struct name##_Iter
+
+/*--------------------------------------------------------------------*/
+
+#endif
@@ -0,0 +1,1040 @@
+/*--------------------------------------------------------------------*/
+/* symtabletree.c                                                     */
+/* author: Julio Lins (jcclb)                                         */
+/*--------------------------------------------------------------------*/
+
+#include "symtabletree.h"
+#include <assert.h>
+#include <string.h>
+#include <stdlib.h>
+
+/*--------------------------------------------------------------------*/
+
+/* Minimum degree of the B-tree: every Node other than the root holds
+   between MIN_DEGREE - 1 and MAX_KEYS Bindings */
+
+enum {MIN_DEGREE = 16};
+enum {MAX_KEYS = 2 * MIN_DEGREE - 1};
+
+
+/* Each key and respective value are stored in a Binding */
+
+struct Binding {
+
+   /* key, owned by implementation through defensive copy unless
+      the table borrows its keys */
+   const char *pcKey;
+
+   /* value, owned by client */
+   void *pvValue;
+};
+
+
+/* A Node of the B-tree holds its Bindings sorted by key. An internal
+   Node with uCount Bindings has uCount + 1 children; all keys of
+   apnChildren[i] lie between abBindings[i - 1] and abBindings[i] */
+
+struct Node {
+
+   /* # of Bindings in use */
+   size_t uCount;
+
+   /* 1 (TRUE) if the Node has no children */
+   int iIsLeaf;
+
+   /* Bindings, in ascending key order */
+   struct Binding abBindings[MAX_KEYS];
+
+   /* children, meaningful only for internal Nodes */
+   struct Node *apnChildren[MAX_KEYS + 1];
+};
+
+
+/* SymTable is a structure that points to the root of the B-tree */
+
+struct SymTable {
+
+   /* root Node, never NULL */
+   struct Node *pnRoot;
+
+   /* size of Symble Table (total # of Bindings) */
+   size_t uLength;
+
+   /* 1 (TRUE) if keys are borrowed from the client rather than
+      owned through defensive copies */
+   int iBorrowsKeys;
+};
+
+
+
+/* Return a new, empty Node, or NULL if insufficient memory is
+   available. iIsLeaf tells whether the Node is a leaf */
+
+static struct Node *SymTable_newNode(int iIsLeaf) {
+
+   struct Node *pnNew;
+
+   pnNew = (struct Node*)malloc(sizeof(struct Node));
+
+   if (pnNew == NULL)
+      return NULL;
+
+   pnNew->uCount = 0;
+   pnNew->iIsLeaf = iIsLeaf;
+
+   return pnNew;
+}
+
+
+/* Return the position of the first Binding of pn whose key is not
+   less than pcKey, or pn->uCount if there is none. Set *piFound to 1
+   (TRUE) if that Binding's key is pcKey, 0 (FALSE) otherwise */
+
+static size_t SymTable_lowerBound(struct Node *pn, const char *pcKey,
+                                  int *piFound) {
+
+   size_t uLo;
+   size_t uHi;
+   size_t uMid;
+   enum {EQUAL};
+
+   assert(pn != NULL);
+   assert(pcKey != NULL);
+   assert(piFound != NULL);
+
+   uLo = 0;
+   uHi = pn->uCount;
+
+   while (uLo < uHi) {
+
+      uMid = uLo + (uHi - uLo) / 2;
+
+      if (strcmp(pn->abBindings[uMid].pcKey, pcKey) < 0)
+         uLo = uMid + 1;
+      else
+         uHi = uMid;
+   }
+
+   *piFound = (uLo < pn->uCount) &&
+      (strcmp(pn->abBindings[uLo].pcKey, pcKey) == EQUAL);
+
+   return uLo;
+}
+
+
+/* Helper function that splits the full child at position uIndex of
+   pnParent in two, moving its median Binding up into pnParent, which
+   must not be full. Return 1 (TRUE) if successful, or 0 (FALSE) if
+   not enough memory, in which case nothing changes */
+
+static int SymTable_splitChild(struct Node *pnParent, size_t uIndex) {
+
+   struct Node *pnLeft;
+   struct Node *pnRight;
+   size_t i;
+   enum {FALSE, TRUE};
+
+   assert(pnParent != NULL);
+   assert(pnParent->uCount < MAX_KEYS);
+
+   pnLeft = pnParent->apnChildren[uIndex];
+
+   assert(pnLeft->uCount == MAX_KEYS);
+
+   pnRight = SymTable_newNode(pnLeft->iIsLeaf);
+
+   if (pnRight == NULL)
+      return FALSE;
+
+   /* Upper half of pnLeft moves to pnRight */
+   for (i = 0; i < MIN_DEGREE - 1; i++)
+      pnRight->abBindings[i] = pnLeft->abBindings[i + MIN_DEGREE];
+
+   if (! pnLeft->iIsLeaf)
+      for (i = 0; i < MIN_DEGREE; i++)
+         pnRight->apnChildren[i] =
+            pnLeft->apnChildren[i + MIN_DEGREE];
+
+   pnRight->uCount = MIN_DEGREE - 1;
+   pnLeft->uCount = MIN_DEGREE - 1;
+
+   /* Median moves up, pnRight becomes its right child */
+   for (i = pnParent->uCount; i > uIndex; i--) {
+
+      pnParent->abBindings[i] = pnParent->abBindings[i - 1];
+      pnParent->apnChildren[i + 1] = pnParent->apnChildren[i];
+   }
+
+   pnParent->abBindings[uIndex] = pnLeft->abBindings[MIN_DEGREE - 1];
+   pnParent->apnChildren[uIndex + 1] = pnRight;
+   pnParent->uCount++;
+
+   return TRUE;
+}
+
+
+/* Helper function that moves the last Binding of the child at
+   position uIndex - 1 of pnParent up into pnParent, and the Binding
+   that separated both children down into the child at position
+   uIndex */
+
+static void SymTable_rotateRight(struct Node *pnParent, size_t uIndex) {
+
+   struct Node *pnChild;
+   struct Node *pnLeft;
+   size_t i;
+
+   assert(pnParent != NULL);
+   assert(uIndex > 0);
+
+   pnChild = pnParent->apnChildren[uIndex];
+   pnLeft = pnParent->apnChildren[uIndex - 1];
+
+   for (i = pnChild->uCount; i > 0; i--)
+      pnChild->abBindings[i] = pnChild->abBindings[i - 1];
+
+   if (! pnChild->iIsLeaf)
+      for (i = pnChild->uCount + 1; i > 0; i--)
+         pnChild->apnChildren[i] = pnChild->apnChildren[i - 1];
+
+   pnChild->abBindings[0] = pnParent->abBindings[uIndex - 1];
+
+   if (! pnChild->iIsLeaf)
+      pnChild->apnChildren[0] = pnLeft->apnChildren[pnLeft->uCount];
+
+   pnParent->abBindings[uIndex - 1] =
+      pnLeft->abBindings[pnLeft->uCount - 1];
+
+   pnLeft->uCount--;
+   pnChild->uCount++;
+}
+
+
+/* Helper function that moves the first Binding of the child at
+   position uIndex + 1 of pnParent up into pnParent, and the Binding
+   that separated both children down into the child at position
+   uIndex */
+
+static void SymTable_rotateLeft(struct Node *pnParent, size_t uIndex) {
+
+   struct Node *pnChild;
+   struct Node *pnRight;
+   size_t i;
+
+   assert(pnParent != NULL);
+   assert(uIndex < pnParent->uCount);
+
+   pnChild = pnParent->apnChildren[uIndex];
+   pnRight = pnParent->apnChildren[uIndex + 1];
+
+   pnChild->abBindings[pnChild->uCount] = pnParent->abBindings[uIndex];
+
+   if (! pnChild->iIsLeaf)
+      pnChild->apnChildren[pnChild->uCount + 1] =
+         pnRight->apnChildren[0];
+
+   pnChild->uCount++;
+
+   pnParent->abBindings[uIndex] = pnRight->abBindings[0];
+
+   for (i = 1; i < pnRight->uCount; i++)
+      pnRight->abBindings[i - 1] = pnRight->abBindings[i];
+
+   if (! pnRight->iIsLeaf)
+      for (i = 1; i <= pnRight->uCount; i++)
+         pnRight->apnChildren[i - 1] = pnRight->apnChildren[i];
+
+   pnRight->uCount--;
+}
+
+
+/* Helper function that merges the children at positions uIndex and
+   uIndex + 1 of pnParent, together with the Binding that separates
+   them, into the child at position uIndex. Frees the other child */
+
+static void SymTable_merge(struct Node *pnParent, size_t uIndex) {
+
+   struct Node *pnLeft;
+   struct Node *pnRight;
+   size_t i;
+
+   assert(pnParent != NULL);
+   assert(uIndex < pnParent->uCount);
+
+   pnLeft = pnParent->apnChildren[uIndex];
+   pnRight = pnParent->apnChildren[uIndex + 1];
+
+   assert(pnLeft->uCount + pnRight->uCount < MAX_KEYS);
+
+   pnLeft->abBindings[pnLeft->uCount] = pnParent->abBindings[uIndex];
+
+   for (i = 0; i < pnRight->uCount; i++)
+      pnLeft->abBindings[pnLeft->uCount + 1 + i] =
+         pnRight->abBindings[i];
+
+   if (! pnLeft->iIsLeaf)
+      for (i = 0; i <= pnRight->uCount; i++)
+         pnLeft->apnChildren[pnLeft->uCount + 1 + i] =
+            pnRight->apnChildren[i];
+
+   pnLeft->uCount += pnRight->uCount + 1;
+
+   for (i = uIndex + 1; i < pnParent->uCount; i++) {
+
+      pnParent->abBindings[i - 1] = pnParent->abBindings[i];
+      pnParent->apnChildren[i] = pnParent->apnChildren[i + 1];
+   }
+
+   pnParent->uCount--;
+
+   free(pnRight);
+}
+
+
+/* Helper function that makes sure the child at position uIndex of
+   pnParent holds at least MIN_DEGREE Bindings, borrowing from a
+   sibling or merging with one. Return the position of the child that
+   now covers the keys of the original child */
+
+static size_t SymTable_fixChild(struct Node *pnParent, size_t uIndex) {
+
+   assert(pnParent != NULL);
+
+   if ((uIndex > 0) &&
+       (pnParent->apnChildren[uIndex - 1]->uCount >= MIN_DEGREE)) {
+
+      SymTable_rotateRight(pnParent, uIndex);
+      return uIndex;
+   }
+
+   if ((uIndex < pnParent->uCount) &&
+       (pnParent->apnChildren[uIndex + 1]->uCount >= MIN_DEGREE)) {
+
+      SymTable_rotateLeft(pnParent, uIndex);
+      return uIndex;
+   }
+
+   if (uIndex < pnParent->uCount) {
+
+      SymTable_merge(pnParent, uIndex);
+      return uIndex;
+   }
+
+   SymTable_merge(pnParent, uIndex - 1);
+   return uIndex - 1;
+}
+
+
+/* Helper function that removes the Binding whose key is pcKey from
+   the subtree rooted at pn, which must hold at least MIN_DEGREE
+   Bindings unless it is the root. The removed Binding is stored in
+   *pbRemoved; its key is not freed. Return 1 (TRUE) if found, 0
+   (FALSE) otherwise */
+
+static int SymTable_removeFrom(struct Node *pn, const char *pcKey,
+                               struct Binding *pbRemoved) {
+
+   size_t uIndex;
+   int iFound;
+   struct Node *pnLeft;
+   struct Node *pnRight;
+   struct Node *pnCurrent;
+   struct Binding bReplacement;
+   enum {FALSE, TRUE};
+
+   assert(pn != NULL);
+   assert(pcKey != NULL);
+   assert(pbRemoved != NULL);
+
+   for (;;) {
+
+      uIndex = SymTable_lowerBound(pn, pcKey, &iFound);
+
+      if (iFound && pn->iIsLeaf) {
+
+         *pbRemoved = pn->abBindings[uIndex];
+
+         for (; uIndex + 1 < pn->uCount; uIndex++)
+            pn->abBindings[uIndex] = pn->abBindings[uIndex + 1];
+
+         pn->uCount--;
+         return TRUE;
+      }
+
+      if (iFound) {
+
+         pnLeft = pn->apnChildren[uIndex];
+         pnRight = pn->apnChildren[uIndex + 1];
+
+         /* Replace the Binding by its predecessor or successor, which
+            is then removed from the child that can spare it */
+         if (pnLeft->uCount >= MIN_DEGREE) {
+
+            pnCurrent = pnLeft;
+            while (! pnCurrent->iIsLeaf)
+               pnCurrent = pnCurrent->apnChildren[pnCurrent->uCount];
+
+            *pbRemoved = pn->abBindings[uIndex];
+            (void)SymTable_removeFrom(pnLeft,
+               pnCurrent->abBindings[pnCurrent->uCount - 1].pcKey,
+               &bReplacement);
+            pn->abBindings[uIndex] = bReplacement;
+            return TRUE;
+         }
+
+         if (pnRight->uCount >= MIN_DEGREE) {
+
+            pnCurrent = pnRight;
+            while (! pnCurrent->iIsLeaf)
+               pnCurrent = pnCurrent->apnChildren[0];
+
+            *pbRemoved = pn->abBindings[uIndex];
+            (void)SymTable_removeFrom(pnRight,
+               pnCurrent->abBindings[0].pcKey, &bReplacement);
+            pn->abBindings[uIndex] = bReplacement;
+            return TRUE;
+         }
+
+         /* Both children are minimal: merge them around the Binding
+            and keep looking in the merged child */
+         SymTable_merge(pn, uIndex);
+         pn = pnLeft;
+         continue;
+      }
+
+      if (pn->iIsLeaf)
+         return FALSE;
+
+      if (pn->apnChildren[uIndex]->uCount < MIN_DEGREE)
+         uIndex = SymTable_fixChild(pn, uIndex);
+
+      pn = pn->apnChildren[uIndex];
+   }
+}
+
+
+/* Helper function that frees all descendants of pn and empties pn,
+   which becomes a leaf. The keys of the Bindings are freed too if
+   iFreeKeys is 1 (TRUE), and pfFreeValue is called on their values
+   unless it is NULL */
+
+static void SymTable_emptyNode(struct Node *pn, int iFreeKeys,
+                               void (*pfFreeValue)(void *pvValue)) {
+
+   size_t i;
+   enum {FALSE, TRUE};
+
+   assert(pn != NULL);
+
+   for (i = 0; i < pn->uCount; i++) {
+
+      if (iFreeKeys)
+         free((void*)pn->abBindings[i].pcKey);
+
+      if (pfFreeValue != NULL)
+         (*pfFreeValue)(pn->abBindings[i].pvValue);
+   }
+
+   if (! pn->iIsLeaf)
+      for (i = 0; i <= pn->uCount; i++) {
+
+         SymTable_emptyNode(pn->apnChildren[i], iFreeKeys, pfFreeValue);
+         free(pn->apnChildren[i]);
+      }
+
+   pn->uCount = 0;
+   pn->iIsLeaf = TRUE;
+}
+
+
+
+SymTable_T SymTable_new(void) {
+
+   SymTable_T oSymTable;
+   enum {FALSE, TRUE};
+
+
+   oSymTable = (SymTable_T)malloc(sizeof(struct SymTable));
+
+   if (oSymTable == NULL)
+      return NULL;
+
+
+   oSymTable->pnRoot = SymTable_newNode(TRUE);
+
+   if (oSymTable->pnRoot == NULL) {
+
+      free(oSymTable);
+      return NULL;
+   }
+
+   oSymTable->uLength = 0;
+   oSymTable->iBorrowsKeys = FALSE;
+
+
+   return oSymTable;
+}
+
+
+
+SymTable_T SymTable_newBorrowedKeys(void) {
+
+   SymTable_T oSymTable;
+   enum {FALSE, TRUE};
+
+   oSymTable = SymTable_new();
+
+   if (oSymTable == NULL)
+      return NULL;
+
+   oSymTable->iBorrowsKeys = TRUE;
+
+   return oSymTable;
+}
+
+
+
+void SymTable_free(SymTable_T oSymTable) {
+
+   assert(oSymTable != NULL);
+
+   SymTable_freeWith(oSymTable, NULL);
+}
+
+
+
+void SymTable_freeWith(SymTable_T oSymTable,
+                       void (*pfFreeValue)(void *pvValue)) {
+
+   assert(oSymTable != NULL);
+
+   SymTable_emptyNode(oSymTable->pnRoot, ! oSymTable->iBorrowsKeys,
+                      pfFreeValue);
+
+   free(oSymTable->pnRoot);
+   free(oSymTable);
+}
+
+
+
+void SymTable_clear(SymTable_T oSymTable,
+                    void (*pfFreeValue)(void *pvValue)) {
+
+   assert(oSymTable != NULL);
+
+   SymTable_emptyNode(oSymTable->pnRoot, ! oSymTable->iBorrowsKeys,
+                      pfFreeValue);
+
+   oSymTable->uLength = 0;
+}
+
+
+size_t SymTable_getLength(SymTable_T oSymTable) {
+
+   assert(oSymTable != NULL);
+
+   return oSymTable->uLength;
+}
+
+
+/* Return Binding of corresponding key, if found. oSymTable is the
+   Symble Table object of which pcKey might or might not be a key. If
+   a search hit, it returns a pointer to pcKey's Binding. Else, it
+   returns NULL */
+
+static struct Binding *SymTable_find(SymTable_T oSymTable,
+                                     const char *pcKey) {
+
+   struct Node *pnCurrent;
+   size_t uIndex;
+   int iFound;
+
+   /* redundant, but just so that critTer doesn't complain */
+   assert(oSymTable != NULL);
+   assert(pcKey != NULL);
+
+
+   pnCurrent = oSymTable->pnRoot;
+
+   for (;;) {
+
+      uIndex = SymTable_lowerBound(pnCurrent, pcKey, &iFound);
+
+      if (iFound)
+         return &pnCurrent->abBindings[uIndex];
+
+      if (pnCurrent->iIsLeaf)
+         return NULL;
+
+      pnCurrent = pnCurrent->apnChildren[uIndex];
+   }
+}
+
+
+/* Return the key to store for pcKey in oSymTable: a defensive copy
+   of pcKey, or pcKey itself if oSymTable borrows its keys. Return
+   NULL if there is not enough memory for the copy */
+
+static char *SymTable_copyKey(SymTable_T oSymTable, const char *pcKey) {
+
+   char *pcCopy;
+
+   assert(oSymTable != NULL);
+   assert(pcKey != NULL);
+
+   if (oSymTable->iBorrowsKeys)
+      return (char*)pcKey;
+
+   pcCopy = (char*)malloc(strlen(pcKey) + 1);
+
+   if (pcCopy == NULL)
+      return NULL;
+
+   return strcpy(pcCopy, pcKey);
+}
+
+
+int SymTable_put(SymTable_T oSymTable, const char *pcKey,
+                 const void *pvValue) {
+
+   struct Node *pnCurrent;
+   struct Node *pnNewRoot;
+   size_t uIndex;
+   size_t i;
+   int iFound;
+   char *pcCopy;
+   enum {FALSE, TRUE};
+
+
+   assert(oSymTable != NULL);
+   assert(pcKey != NULL);
+
+
+   if (SymTable_find(oSymTable, pcKey) != NULL)
+      return FALSE;
+
+
+   pcCopy = SymTable_copyKey(oSymTable, pcKey);
+
+   if (pcCopy == NULL)
+      return FALSE;
+
+
+   /* A full root is split first, which is the only way the tree
+      grows taller */
+   if (oSymTable->pnRoot->uCount == MAX_KEYS) {
+
+      pnNewRoot = SymTable_newNode(FALSE);
+
+      if (pnNewRoot == NULL) {
+
+         if (! oSymTable->iBorrowsKeys)
+            free(pcCopy);
+         return FALSE;
+      }
+
+      pnNewRoot->apnChildren[0] = oSymTable->pnRoot;
+
+      if (! SymTable_splitChild(pnNewRoot, 0)) {
+
+         free(pnNewRoot);
+         if (! oSymTable->iBorrowsKeys)
+            free(pcCopy);
+         return FALSE;
+      }
+
+      oSymTable->pnRoot = pnNewRoot;
+   }
+
+
+   /* Descend to a leaf, splitting full Nodes on the way down so that
+      there is always room for a Binding moving up */
+   pnCurrent = oSymTable->pnRoot;
+
+   while (! pnCurrent->iIsLeaf) {
+
+      uIndex = SymTable_lowerBound(pnCurrent, pcKey, &iFound);
+
+      if (pnCurrent->apnChildren[uIndex]->uCount == MAX_KEYS) {
+
+         if (! SymTable_splitChild(pnCurrent, uIndex)) {
+
+            if (! oSymTable->iBorrowsKeys)
+               free(pcCopy);
+            return FALSE;
+         }
+
+         if (strcmp(pcKey, pnCurrent->abBindings[uIndex].pcKey) > 0)
+            uIndex++;
+      }
+
+      pnCurrent = pnCurrent->apnChildren[uIndex];
+   }
+
+
+   uIndex = SymTable_lowerBound(pnCurrent, pcKey, &iFound);
+
+   for (i = pnCurrent->uCount; i > uIndex; i--)
+      pnCurrent->abBindings[i] = pnCurrent->abBindings[i - 1];
+
+   pnCurrent->abBindings[uIndex].pcKey = pcCopy;
+   pnCurrent->abBindings[uIndex].pvValue = (void*)pvValue;
+   pnCurrent->uCount++;
+
+
+   oSymTable->uLength++;
+
+
+   return TRUE;
+}
+
+
+void *SymTable_replace(SymTable_T oSymTable, const char *pcKey,
+                       const void *pvValue) {
+
+   struct Binding *pbResult;
+   void *pvPrevious;
+
+
+   assert(oSymTable != NULL);
+   assert(pcKey != NULL);
+
+   pbResult = SymTable_find(oSymTable, pcKey);
+
+   if (pbResult == NULL) return NULL;
+
+   pvPrevious = pbResult->pvValue;
+   pbResult->pvValue = (void*)pvValue;
+
+   return pvPrevious;
+}
+
+int SymTable_contains(SymTable_T oSymTable, const char *pcKey) {
+
+   enum {NOT_FOUND, FOUND};
+
+   assert(oSymTable != NULL);
+   assert(pcKey != NULL);
+
+   if (SymTable_find(oSymTable, pcKey) == NULL) return NOT_FOUND;
+
+   return FOUND;
+}
+
+void *SymTable_get(SymTable_T oSymTable, const char *pcKey) {
+
+   struct Binding *pbResult;
+
+   assert(oSymTable != NULL);
+   assert(pcKey != NULL);
+
+   pbResult = SymTable_find(oSymTable, pcKey);
+
+   if (pbResult == NULL) return NULL;
+
+   return pbResult->pvValue;
+}
+
+void *SymTable_remove(SymTable_T oSymTable, const char *pcKey) {
+
+   struct Binding bRemoved;
+   struct Node *pnOldRoot;
+   int iFound;
+
+
+   assert(oSymTable != NULL);
+   assert(pcKey != NULL);
+
+
+   iFound = SymTable_removeFrom(oSymTable->pnRoot, pcKey, &bRemoved);
+
+   /* An emptied internal root gives way to its only child, which is
+      the only way the tree grows shorter. Children are merged on the
+      way down whether or not pcKey is found, so this is done in both
+      cases */
+   pnOldRoot = oSymTable->pnRoot;
+
+   if ((pnOldRoot->uCount == 0) && (! pnOldRoot->iIsLeaf)) {
+
+      oSymTable->pnRoot = pnOldRoot->apnChildren[0];
+      free(pnOldRoot);
+   }
+
+   if (! iFound)
+      return NULL;
+
+   if (! oSymTable->iBorrowsKeys)
+      free((void*)bRemoved.pcKey);
+
+   oSymTable->uLength--;
+
+   return bRemoved.pvValue;
+}
+
+
+/* Helper function that applies pfApply, with pvExtra, to each Binding
+   of the subtree rooted at pn whose key is at least pcLo, in
+   ascending key order, until it reaches a key whose first uHiLength
+   characters compare greater than pcHi. Return 1 (TRUE) if such a key
+   was reached, 0 (FALSE) otherwise */
+
+static int SymTable_walk(struct Node *pn, const char *pcLo,
+                         const char *pcHi, size_t uHiLength,
+                         void (*pfApply)(const char *pcKey,
+                                         void *pvValue,
+                                         void *pvExtra),
+                         const void *pvExtra) {
+
+   size_t uIndex;
+   int iFound;
+   struct Binding *pbCurrent;
+   enum {FALSE, TRUE};
+
+   assert(pn != NULL);
+   assert(pfApply != NULL);
+
+   uIndex = SymTable_lowerBound(pn, pcLo, &iFound);
+
+   for (;; uIndex++) {
+
+      if ((! pn->iIsLeaf) &&
+          SymTable_walk(pn->apnChildren[uIndex], pcLo, pcHi,
+                        uHiLength, pfApply, pvExtra))
+         return TRUE;
+
+      if (uIndex == pn->uCount)
+         return FALSE;
+
+      pbCurrent = &pn->abBindings[uIndex];
+
+      if (strncmp(pbCurrent->pcKey, pcHi, uHiLength) > 0)
+         return TRUE;
+
+      (*pfApply)(pbCurrent->pcKey, pbCurrent->pvValue, (void*)pvExtra);
+   }
+}
+
+
+void SymTable_map(SymTable_T oSymTable,
+                  void (*pfApply)(const char *pcKey, void *pvValue,
+                                  void *pvExtra), const void *pvExtra) {
+
+   assert(oSymTable != NULL);
+   assert(pfApply != NULL);
+
+   /* The empty prefix matches every key */
+   (void)SymTable_walk(oSymTable->pnRoot, "", "", 0, pfApply, pvExtra);
+}
+
+void SymTable_rangeMap(SymTable_T oSymTable, const char *pcLo,
+                       const char *pcHi,
+                       void (*pfApply)(const char *pcKey, void *pvValue,
+                                       void *pvExtra),
+                       const void *pvExtra) {
+
+   assert(oSymTable != NULL);
+   assert(pcLo != NULL);
+   assert(pcHi != NULL);
+   assert(pfApply != NULL);
+
+   /* Comparing the terminating '\0' too makes strncmp act as strcmp */
+   (void)SymTable_walk(oSymTable->pnRoot, pcLo, pcHi, strlen(pcHi) + 1,
+                       pfApply, pvExtra);
+}
+
+void SymTable_prefixMap(SymTable_T oSymTable, const char *pcPrefix,
+                        void (*pfApply)(const char *pcKey,
+                                        void *pvValue, void *pvExtra),
+                        const void *pvExtra) {
+
+   assert(oSymTable != NULL);
+   assert(pcPrefix != NULL);
+   assert(pfApply != NULL);
+
+   /* Keys starting with pcPrefix are exactly the keys not less than
+      pcPrefix whose first strlen(pcPrefix) characters do not compare
+      greater than it */
+   (void)SymTable_walk(oSymTable->pnRoot, pcPrefix, pcPrefix,
+                       strlen(pcPrefix), pfApply, pvExtra);
+}
+
+
+/* Add to the estimate of psMemory the bytes that malloc adds to a
+   block of uSize bytes */
+
+static void SymTable_addOverhead(struct SymTableMemory *psMemory,
+                                 size_t uSize) {
+
+   const size_t uWord = sizeof(size_t);
+   size_t uChunk;
+
+   assert(psMemory != NULL);
+
+   uChunk = (uSize + 3 * uWord - 1) / (2 * uWord) * (2 * uWord);
+
+   if (uChunk < 4 * uWord)
+      uChunk = 4 * uWord;
+
+   psMemory->uOverheadBytes += uChunk - uSize;
+}
+
+
+/* Add to psMemory Node pn and its descendants. iCountKeys tells
+   whether their keys are copies */
+
+static void SymTable_addNodes(struct Node *pn, int iCountKeys,
+                              struct SymTableMemory *psMemory) {
+
+   size_t uKeySize;
+   size_t i;
+
+   assert(pn != NULL);
+   assert(psMemory != NULL);
+
+   psMemory->uBindingBytes += sizeof(struct Node);
+   SymTable_addOverhead(psMemory, sizeof(struct Node));
+
+   if (iCountKeys)
+      for (i = 0; i < pn->uCount; i++) {
+
+         uKeySize = strlen(pn->abBindings[i].pcKey) + 1;
+         psMemory->uKeyBytes += uKeySize;
+         SymTable_addOverhead(psMemory, uKeySize);
+      }
+
+   if (! pn->iIsLeaf)
+      for (i = 0; i <= pn->uCount; i++)
+         SymTable_addNodes(pn->apnChildren[i], iCountKeys, psMemory);
+}
+
+void SymTable_memoryUsage(SymTable_T oSymTable,
+                          struct SymTableMemory *psMemory) {
+
+   assert(oSymTable != NULL);
+   assert(psMemory != NULL);
+
+   /* Nodes hold their Bindings inline */
+   psMemory->uTableBytes = sizeof(struct SymTable);
+   psMemory->uBindingBytes = 0;
+   psMemory->uKeyBytes = 0;
+   psMemory->uOverheadBytes = 0;
+
+   SymTable_addOverhead(psMemory, sizeof(struct SymTable));
+   SymTable_addNodes(oSymTable->pnRoot, ! oSymTable->iBorrowsKeys,
+                     psMemory);
+}
+
+/* Position psIter at Binding uIndex of pn, or at its end if pn is
+   NULL */
+
+static void SymTable_iterSeek(struct SymTableIter *psIter,
+                              struct Node *pn, size_t uIndex) {
+
+   assert(psIter != NULL);
+
+   psIter->pvPosition = pn;
+   psIter->uIndex = uIndex;
+
+   if (pn == NULL) {
+
+      psIter->pcKey = NULL;
+      psIter->pvValue = NULL;
+      return;
+   }
+
+   psIter->pcKey = pn->abBindings[uIndex].pcKey;
+   psIter->pvValue = pn->abBindings[uIndex].pvValue;
+}
+
+
+void SymTable_iterBegin(SymTable_T oSymTable,
+                        struct SymTableIter *psIter) {
+
+   struct Node *pnCurrent;
+
+   assert(oSymTable != NULL);
+   assert(psIter != NULL);
+
+   psIter->oSymTable = oSymTable;
+
+   pnCurrent = oSymTable->pnRoot;
+
+   if (pnCurrent->uCount == 0) {
+
+      SymTable_iterSeek(psIter, NULL, 0);
+      return;
+   }
+
+   while (! pnCurrent->iIsLeaf)
+      pnCurrent = pnCurrent->apnChildren[0];
+
+   SymTable_iterSeek(psIter, pnCurrent, 0);
+}
+
+void SymTable_iterNext(struct SymTableIter *psIter) {
+
+   struct Node *pnCurrent;
+   struct Node *pnNext;
+   size_t uIndex;
+   size_t uNextIndex;
+   int iFound;
+
+   assert(psIter != NULL);
+   assert(psIter->pvPosition != NULL);
+
+   pnCurrent = (struct Node*)psIter->pvPosition;
+   uIndex = psIter->uIndex;
+
+   /* Successor is the leftmost Binding of the right subtree */
+   if (! pnCurrent->iIsLeaf) {
+
+      pnCurrent = pnCurrent->apnChildren[uIndex + 1];
+
+      while (! pnCurrent->iIsLeaf)
+         pnCurrent = pnCurrent->apnChildren[0];
+
+      SymTable_iterSeek(psIter, pnCurrent, 0);
+      return;
+   }
+
+   if (uIndex + 1 < pnCurrent->uCount) {
+
+      SymTable_iterSeek(psIter, pnCurrent, uIndex + 1);
+      return;
+   }
+
+   /* Last Binding of a leaf: Nodes have no parent links, so search
+      from the root for the smallest key greater than the current
+      one. This happens once every MIN_DEGREE - 1 steps or so */
+   pnNext = NULL;
+   uNextIndex = 0;
+   pnCurrent = psIter->oSymTable->pnRoot;
+
+   for (;;) {
+
+      uIndex = SymTable_lowerBound(pnCurrent, psIter->pcKey, &iFound);
+
+      if (iFound)
+         uIndex++;
+
+      if (uIndex < pnCurrent->uCount) {
+
+         pnNext = pnCurrent;
+         uNextIndex = uIndex;
+      }
+
+      if (pnCurrent->iIsLeaf)
+         break;
+
+      pnCurrent = pnCurrent->apnChildren[uIndex];
+   }
+
+   SymTable_iterSeek(psIter, pnNext, uNextIndex);
+}
+
+int SymTable_iterEnd(const struct SymTableIter *psIter) {
+
+   assert(psIter != NULL);
+
+   return psIter->pvPosition == NULL;
+}
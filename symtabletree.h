@@ -0,0 +1,46 @@
+/*--------------------------------------------------------------------*/
+/* symtabletree.h                                                     */
+/* Author: Julio Lins (jcclb)                                         */
+/*--------------------------------------------------------------------*/
+
+#ifndef SYMTABLETREE_H
+#define SYMTABLETREE_H
+
+/*--------------------------------------------------------------------*/
+
+#include "symtable.h"
+
+/*--------------------------------------------------------------------*/
+
+/* Ordered operations provided by the B-tree implementation of
+   symtable.h (symtabletree.c). Its SymTable_map and iterator visit
+   bindings in ascending key order, as defined by strcmp */
+
+/*--------------------------------------------------------------------*/
+
+/* Applies function pfApply to each binding in oSymTable whose key is
+   between pcLo and pcHi, inclusive, in ascending key order. Each
+   binding's key (pcKey) and value (pvValue) are passed as parameters,
+   as well as pvExtra as an extra parameter. Runs in O(log n + k) time,
+   where k is the number of bindings visited */
+
+void SymTable_rangeMap(SymTable_T oSymTable, const char *pcLo,
+                       const char *pcHi,
+                       void (*pfApply)(const char *pcKey, void *pvValue,
+                                       void *pvExtra),
+                       const void *pvExtra);
+
+/*--------------------------------------------------------------------*/
+
+/* Applies function pfApply to each binding in oSymTable whose key
+   starts with pcPrefix, in ascending key order, passing the same
+   parameters as SymTable_rangeMap. Runs in O(log n + k) time */
+
+void SymTable_prefixMap(SymTable_T oSymTable, const char *pcPrefix,
+                        void (*pfApply)(const char *pcKey,
+                                        void *pvValue, void *pvExtra),
+                        const void *pvExtra);
+
+/*--------------------------------------------------------------------*/
+
+#endif
@@ -0,0 +1,174 @@
+/*--------------------------------------------------------------------*/
+/* testatom.c                                                         */
+/* Author: Julio Lins (jcclb)                                         */
+/*--------------------------------------------------------------------*/
+
+#include "atomtable.h"
+#include "symtableatom.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+/*--------------------------------------------------------------------*/
+
+#define ASSURE(i) assure(i, __LINE__)
+
+/*--------------------------------------------------------------------*/
+
+/* If !iSuccessful, print a message to stdout indicating that the
+   test at line iLineNum failed. */
+
+static void assure(int iSuccessful, int iLineNum)
+{
+   if (! iSuccessful)
+   {
+      printf("Test at line %d failed.\n", iLineNum);
+      fflush(stdout);
+   }
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Test the AtomTable functions. */
+
+static void testIntern(void)
+{
+   AtomTable_T oAtomTable;
+   char acJeter[] = "Jeter";
+   char acJeter2[] = "Jeter";
+   const char *pcAtom;
+   const char *pcAtom2;
+
+   printf("------------------------------------------------------\n");
+   printf("Testing string interning.\n");
+   printf("No output should appear here:\n");
+   fflush(stdout);
+
+   oAtomTable = AtomTable_new();
+   ASSURE(oAtomTable != NULL);
+   ASSURE(AtomTable_getLength(oAtomTable) == 0);
+   ASSURE(AtomTable_lookup(oAtomTable, "Jeter") == NULL);
+
+   /* Equal strings give the same atom, which is a copy. */
+   pcAtom = AtomTable_intern(oAtomTable, acJeter);
+   ASSURE(pcAtom != NULL);
+   ASSURE(pcAtom != acJeter);
+   ASSURE((pcAtom != NULL) && (strcmp(pcAtom, "Jeter") == 0));
+
+   pcAtom2 = AtomTable_intern(oAtomTable, acJeter2);
+   ASSURE(pcAtom2 == pcAtom);
+   ASSURE(AtomTable_getLength(oAtomTable) == 1);
+
+   strcpy(acJeter, "xxxxx");
+   ASSURE(AtomTable_lookup(oAtomTable, "Jeter") == pcAtom);
+
+   pcAtom2 = AtomTable_intern(oAtomTable, "Mantle");
+   ASSURE(pcAtom2 != NULL);
+   ASSURE(pcAtom2 != pcAtom);
+   ASSURE(AtomTable_getLength(oAtomTable) == 2);
+
+   /* The empty string is an atom like any other. */
+   pcAtom = AtomTable_intern(oAtomTable, "");
+   ASSURE((pcAtom != NULL) && (*pcAtom == '\0'));
+   ASSURE(AtomTable_intern(oAtomTable, "") == pcAtom);
+
+   AtomTable_free(oAtomTable);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Test a SymTableAtom object with iBindingCount atoms as keys. */
+
+static void testAtomKeys(int iBindingCount)
+{
+   enum {MAX_KEY_LENGTH = 16};
+
+   AtomTable_T oAtomTable;
+   SymTableAtom_T oSymTableAtom;
+   char acKey[MAX_KEY_LENGTH];
+   char acShortstop[] = "Shortstop";
+   char acCatcher[] = "Catcher";
+   const char *pcAtom;
+   char *pcValue;
+   int i;
+   int iSuccessful;
+
+   printf("------------------------------------------------------\n");
+   printf("Testing a SymTableAtom object with %d atoms.\n",
+          iBindingCount);
+   printf("No output should appear here:\n");
+   fflush(stdout);
+
+   oAtomTable = AtomTable_new();
+   ASSURE(oAtomTable != NULL);
+   oSymTableAtom = SymTableAtom_new();
+   ASSURE(oSymTableAtom != NULL);
+
+   for (i = 0; i < iBindingCount; i++)
+   {
+      sprintf(acKey, "%d", i);
+      pcAtom = AtomTable_intern(oAtomTable, acKey);
+      ASSURE(pcAtom != NULL);
+      iSuccessful = SymTableAtom_put(oSymTableAtom, pcAtom, acShortstop);
+      ASSURE(iSuccessful);
+      iSuccessful = SymTableAtom_put(oSymTableAtom, pcAtom, acCatcher);
+      ASSURE(! iSuccessful);
+   }
+   ASSURE(SymTableAtom_getLength(oSymTableAtom) ==
+          (size_t)iBindingCount);
+
+   for (i = 0; i < iBindingCount; i++)
+   {
+      sprintf(acKey, "%d", i);
+
+      /* Keys are compared by address, so a plain string that is not
+         the atom is not found. */
+      ASSURE(! SymTableAtom_contains(oSymTableAtom, acKey));
+
+      pcAtom = AtomTable_lookup(oAtomTable, acKey);
+      pcValue = (char*)SymTableAtom_get(oSymTableAtom, pcAtom);
+      ASSURE(pcValue == acShortstop);
+
+      if (i % 2 == 0)
+      {
+         pcValue = (char*)SymTableAtom_replace(oSymTableAtom, pcAtom,
+                                               acCatcher);
+         ASSURE(pcValue == acShortstop);
+         pcValue = (char*)SymTableAtom_remove(oSymTableAtom, pcAtom);
+         ASSURE(pcValue == acCatcher);
+      }
+   }
+   ASSURE(SymTableAtom_getLength(oSymTableAtom) ==
+          (size_t)(iBindingCount / 2));
+
+   SymTableAtom_free(oSymTableAtom);
+   AtomTable_free(oAtomTable);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Test the AtomTable and SymTableAtom ADTs. As always, argc is the
+   command-line argument count and argv contains the command-line
+   arguments. argv[1] is the number of atoms to create. Exit with
+   EXIT_FAILURE if argv[1] is missing or not numeric. Otherwise
+   return 0. */
+
+int main(int argc, char *argv[])
+{
+   int iBindingCount;
+
+   if ((argc != 2) || (sscanf(argv[1], "%d", &iBindingCount) != 1) ||
+       (iBindingCount < 0))
+   {
+      fprintf(stderr, "Usage: %s bindingcount\n", argv[0]);
+      exit(EXIT_FAILURE);
+   }
+
+   testIntern();
+   testAtomKeys(iBindingCount);
+
+   printf("------------------------------------------------------\n");
+   printf("End of %s.\n", argv[0]);
+   return 0;
+}
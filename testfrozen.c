@@ -0,0 +1,190 @@
+/*--------------------------------------------------------------------*/
+/* testfrozen.c                                                       */
+/* Author: Julio Lins (jcclb)                                         */
+/*--------------------------------------------------------------------*/
+
+#include "symtablefrozen.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+/*--------------------------------------------------------------------*/
+
+#define ASSURE(i) assure(i, __LINE__)
+
+/*--------------------------------------------------------------------*/
+
+/* If !iSuccessful, print a message to stdout indicating that the
+   test at line iLineNum failed. */
+
+static void assure(int iSuccessful, int iLineNum)
+{
+   if (! iSuccessful)
+   {
+      printf("Test at line %d failed.\n", iLineNum);
+      fflush(stdout);
+   }
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Increment the count that pvExtra points to.  pcKey and pvValue are
+   unused. */
+
+static void countBinding(const char *pcKey, void *pvValue,
+                         void *pvExtra)
+{
+   assert(pcKey != NULL);
+   assert(pvExtra != NULL);
+
+   (void)pvValue;
+
+   (*(size_t*)pvExtra)++;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Test freezing small and empty tables. */
+
+static void testBasics(void)
+{
+   SymTable_T oSymTable;
+   SymTableFrozen_T oSymTableFrozen;
+   char acKey[] = "Ruth";
+   char acRightField[] = "RightField";
+   char acFirstBase[] = "FirstBase";
+   size_t uCount;
+   int iSuccessful;
+
+   printf("------------------------------------------------------\n");
+   printf("Testing frozen tables.\n");
+   printf("No output should appear here:\n");
+   fflush(stdout);
+
+   /* An empty table freezes to an empty table. */
+   oSymTable = SymTable_new();
+   ASSURE(oSymTable != NULL);
+   oSymTableFrozen = SymTable_freeze(oSymTable);
+   ASSURE(oSymTableFrozen != NULL);
+   ASSURE(SymTableFrozen_getLength(oSymTableFrozen) == 0);
+   ASSURE(! SymTableFrozen_contains(oSymTableFrozen, "Ruth"));
+   ASSURE(SymTableFrozen_get(oSymTableFrozen, "") == NULL);
+   SymTableFrozen_free(oSymTableFrozen);
+
+   iSuccessful = SymTable_put(oSymTable, acKey, acRightField);
+   ASSURE(iSuccessful);
+   iSuccessful = SymTable_put(oSymTable, "Gehrig", acFirstBase);
+   ASSURE(iSuccessful);
+   iSuccessful = SymTable_put(oSymTable, "", NULL);
+   ASSURE(iSuccessful);
+   oSymTableFrozen = SymTable_freeze(oSymTable);
+   ASSURE(oSymTableFrozen != NULL);
+
+   /* The frozen table does not depend on the original one, nor on
+      its keys. */
+   strcpy(acKey, "xxx");
+   SymTable_free(oSymTable);
+
+   ASSURE(SymTableFrozen_getLength(oSymTableFrozen) == 3);
+   ASSURE(SymTableFrozen_get(oSymTableFrozen, "Ruth") == acRightField);
+   ASSURE(SymTableFrozen_get(oSymTableFrozen, "Gehrig") == acFirstBase);
+   ASSURE(SymTableFrozen_contains(oSymTableFrozen, ""));
+   ASSURE(SymTableFrozen_get(oSymTableFrozen, "") == NULL);
+   ASSURE(! SymTableFrozen_contains(oSymTableFrozen, "xxx"));
+   ASSURE(! SymTableFrozen_contains(oSymTableFrozen, "Ruthx"));
+
+   uCount = 0;
+   SymTableFrozen_map(oSymTableFrozen, countBinding, &uCount);
+   ASSURE(uCount == 3);
+
+   SymTableFrozen_free(oSymTableFrozen);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Test a frozen table of iBindingCount bindings.  Each binding's key
+   and value contain the same characters. */
+
+static void testLargeTable(int iBindingCount)
+{
+   enum {MAX_KEY_LENGTH = 16};
+
+   SymTable_T oSymTable;
+   SymTableFrozen_T oSymTableFrozen;
+   char acKey[MAX_KEY_LENGTH];
+   char *pcValue;
+   int iSuccessful;
+   int i;
+
+   printf("------------------------------------------------------\n");
+   printf("Testing a potentially large frozen table.\n");
+   printf("No output should appear here:\n");
+   fflush(stdout);
+
+   oSymTable = SymTable_new();
+   ASSURE(oSymTable != NULL);
+
+   for (i = 0; i < iBindingCount; i++)
+   {
+      sprintf(acKey, "%d", i);
+      pcValue = (char*)malloc(strlen(acKey) + 1);
+      ASSURE(pcValue != NULL);
+      strcpy(pcValue, acKey);
+      iSuccessful = SymTable_put(oSymTable, acKey, pcValue);
+      ASSURE(iSuccessful);
+   }
+
+   oSymTableFrozen = SymTable_freeze(oSymTable);
+   ASSURE(oSymTableFrozen != NULL);
+   if (oSymTableFrozen != NULL)
+   {
+      ASSURE(SymTableFrozen_getLength(oSymTableFrozen) ==
+             (size_t)iBindingCount);
+
+      for (i = 0; i < iBindingCount; i++)
+      {
+         sprintf(acKey, "%d", i);
+         pcValue = (char*)SymTableFrozen_get(oSymTableFrozen, acKey);
+         ASSURE((pcValue != NULL) && (strcmp(pcValue, acKey) == 0));
+      }
+
+      /* Keys that are not in the table must not be found. */
+      for (i = iBindingCount; i < 2 * iBindingCount; i++)
+      {
+         sprintf(acKey, "%d", i);
+         ASSURE(! SymTableFrozen_contains(oSymTableFrozen, acKey));
+      }
+
+      SymTableFrozen_free(oSymTableFrozen);
+   }
+
+   SymTable_freeWith(oSymTable, free);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Test the SymTableFrozen ADT. As always, argc is the command-line
+   argument count and argv contains the command-line arguments.
+   argv[1] is the number of bindings to freeze. Exit with
+   EXIT_FAILURE if argv[1] is missing or not numeric. Otherwise
+   return 0. */
+
+int main(int argc, char *argv[])
+{
+   int iBindingCount;
+
+   if ((argc != 2) || (sscanf(argv[1], "%d", &iBindingCount) != 1) ||
+       (iBindingCount < 0))
+   {
+      fprintf(stderr, "Usage: %s bindingcount\n", argv[0]);
+      exit(EXIT_FAILURE);
+   }
+
+   testBasics();
+   testLargeTable(iBindingCount);
+
+   printf("------------------------------------------------------\n");
+   printf("End of %s.\n", argv[0]);
+   return 0;
+}
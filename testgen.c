@@ -0,0 +1,87 @@
+/*--------------------------------------------------------------------*/
+/* testgen.c                                                          */
+/* Author: Julio Lins (jcclb)                                         */
+/*--------------------------------------------------------------------*/
+
+#include "symtablefrozen.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+/*--------------------------------------------------------------------*/
+
+#define ASSURE(i) assure(i, __LINE__)
+
+/* Table that symtablegen generates from keywords.txt */
+
+extern const struct SymTableConst sKeywords;
+
+/*--------------------------------------------------------------------*/
+
+/* If !iSuccessful, print a message to stdout indicating that the
+   test at line iLineNum failed. */
+
+static void assure(int iSuccessful, int iLineNum)
+{
+   if (! iSuccessful)
+   {
+      printf("Test at line %d failed.\n", iLineNum);
+      fflush(stdout);
+   }
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Test the generated table of C90 reserved words. */
+
+static void testKeywords(void)
+{
+   static const char *apcKeywords[] = {
+      "auto", "break", "case", "char", "const", "continue", "default",
+      "do", "double", "else", "enum", "extern", "float", "for", "goto",
+      "if", "int", "long", "register", "return", "short", "signed",
+      "sizeof", "static", "struct", "switch", "typedef", "union",
+      "unsigned", "void", "volatile", "while"
+   };
+   enum {KEYWORD_COUNT = sizeof(apcKeywords) / sizeof(apcKeywords[0])};
+
+   int i;
+
+   printf("------------------------------------------------------\n");
+   printf("Testing a generated constant table.\n");
+   printf("No output should appear here:\n");
+   fflush(stdout);
+
+   ASSURE(sKeywords.uLength == KEYWORD_COUNT);
+
+   /* Each keyword's value is its position in keywords.txt. */
+   for (i = 0; i < KEYWORD_COUNT; i++)
+   {
+      ASSURE(SymTableConst_contains(&sKeywords, apcKeywords[i]));
+      ASSURE(SymTableConst_get(&sKeywords, apcKeywords[i]) == i);
+   }
+
+   ASSURE(! SymTableConst_contains(&sKeywords, "main"));
+   ASSURE(! SymTableConst_contains(&sKeywords, ""));
+   ASSURE(! SymTableConst_contains(&sKeywords, "Int"));
+   ASSURE(! SymTableConst_contains(&sKeywords, "int "));
+   ASSURE(SymTableConst_get(&sKeywords, "inline") == -1);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Test the generated table. As always, argc is the command-line
+   argument count and argv contains the command-line arguments.
+   Return 0. */
+
+int main(int argc, char *argv[])
+{
+   (void)argc;
+
+   testKeywords();
+
+   printf("------------------------------------------------------\n");
+   printf("End of %s.\n", argv[0]);
+   return 0;
+}
@@ -0,0 +1,502 @@
+/*--------------------------------------------------------------------*/
+/* testhamt.c                                                         */
+/* Author: Julio Lins (jcclb)                                         */
+/*--------------------------------------------------------------------*/
+
+/* Threads are POSIX, not ANSI C */
+#define _POSIX_C_SOURCE 200112L
+
+#include "symtablehamt.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <time.h>
+#include <pthread.h>
+
+/*--------------------------------------------------------------------*/
+
+#define ASSURE(i) assure(i, __LINE__)
+
+/*--------------------------------------------------------------------*/
+
+/* Longest key used by the tests */
+
+enum {MAX_KEY_LENGTH = 16};
+
+/*--------------------------------------------------------------------*/
+
+/* If !iSuccessful, print a message to stdout indicating that the
+   test at line iLineNum failed. */
+
+static void assure(int iSuccessful, int iLineNum)
+{
+   if (! iSuccessful)
+   {
+      printf("Test at line %d failed.\n", iLineNum);
+      fflush(stdout);
+   }
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Check that the first iBindingCount keys of oSymTable, "0", "1" and
+   so on, are bound to the elements of piValues at the same position,
+   and that no other key is. */
+
+static void checkTable(SymTable_T oSymTable, int *piValues,
+                       int iBindingCount)
+{
+   struct SymTableIter sIter;
+   char acKey[MAX_KEY_LENGTH];
+   size_t uVisited = 0;
+   int i;
+
+   assert(oSymTable != NULL);
+   assert(piValues != NULL);
+
+   ASSURE(SymTable_getLength(oSymTable) == (size_t)iBindingCount);
+
+   for (i = 0; i < iBindingCount; i++)
+   {
+      sprintf(acKey, "%d", i);
+      ASSURE(SymTable_get(oSymTable, acKey) == &piValues[i]);
+   }
+
+   for (SymTable_iterBegin(oSymTable, &sIter);
+        ! SymTable_iterEnd(&sIter); SymTable_iterNext(&sIter))
+   {
+      ASSURE(SymTable_get(oSymTable, sIter.pcKey) == sIter.pvValue);
+      uVisited++;
+   }
+   ASSURE(uVisited == (size_t)iBindingCount);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Test that a snapshot of a table of iBindingCount bindings keeps
+   them while the table changes, and the other way around. */
+
+static void testSnapshot(int iBindingCount)
+{
+   SymTable_T oSymTable;
+   SymTable_T oSnapshot;
+   SymTable_T oSecond;
+   char acKey[MAX_KEY_LENGTH];
+   int *piValues;
+   int i;
+   int iSuccessful;
+
+   printf("------------------------------------------------------\n");
+   printf("Testing snapshots of %d bindings.\n", iBindingCount);
+   printf("No output should appear here:\n");
+   fflush(stdout);
+
+   piValues = (int*)calloc((size_t)iBindingCount + 1, sizeof(int));
+   ASSURE(piValues != NULL);
+   if (piValues == NULL)
+      return;
+
+   oSymTable = SymTable_new();
+   ASSURE(oSymTable != NULL);
+   if (oSymTable == NULL)
+      return;
+
+   for (i = 0; i < iBindingCount; i++)
+   {
+      sprintf(acKey, "%d", i);
+      iSuccessful = SymTable_put(oSymTable, acKey, &piValues[i]);
+      ASSURE(iSuccessful);
+   }
+
+   oSnapshot = SymTable_snapshot(oSymTable);
+   ASSURE(oSnapshot != NULL);
+   if (oSnapshot == NULL)
+      return;
+   checkTable(oSnapshot, piValues, iBindingCount);
+
+   /* Change every binding of the table, and add as many. */
+   for (i = 0; i < iBindingCount; i++)
+   {
+      sprintf(acKey, "%d", i);
+      if (i % 2 == 0)
+         ASSURE(SymTable_remove(oSymTable, acKey) == &piValues[i]);
+      else
+         ASSURE(SymTable_replace(oSymTable, acKey, &piValues[0]) ==
+                &piValues[i]);
+      sprintf(acKey, "new%d", i);
+      iSuccessful = SymTable_put(oSymTable, acKey, &piValues[i]);
+      ASSURE(iSuccessful);
+   }
+   ASSURE(SymTable_getLength(oSymTable) ==
+          (size_t)(iBindingCount + iBindingCount / 2));
+   checkTable(oSnapshot, piValues, iBindingCount);
+
+   /* A snapshot of the snapshot, then changes to the snapshot. */
+   oSecond = SymTable_snapshot(oSnapshot);
+   ASSURE(oSecond != NULL);
+   if (oSecond == NULL)
+      return;
+   for (i = 0; i < iBindingCount; i++)
+   {
+      sprintf(acKey, "%d", i);
+      ASSURE(SymTable_remove(oSnapshot, acKey) == &piValues[i]);
+   }
+   ASSURE(SymTable_getLength(oSnapshot) == 0);
+   checkTable(oSecond, piValues, iBindingCount);
+
+   for (i = 0; i < iBindingCount; i++)
+   {
+      sprintf(acKey, "%d", i);
+      if (i % 2 == 0)
+         ASSURE(! SymTable_contains(oSymTable, acKey));
+      else
+         ASSURE(SymTable_get(oSymTable, acKey) == &piValues[0]);
+      sprintf(acKey, "new%d", i);
+      ASSURE(SymTable_get(oSymTable, acKey) == &piValues[i]);
+   }
+
+   SymTable_free(oSymTable);
+   SymTable_free(oSnapshot);
+   checkTable(oSecond, piValues, iBindingCount);
+   SymTable_free(oSecond);
+   free(piValues);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Test that replacing the value of the current binding of an iterator
+   leaves the iterator valid, even where a snapshot shares the leaf
+   that holds it and is then freed. */
+
+static void testReplaceWhileIterating(void)
+{
+   enum {KEY_COUNT = 100};
+
+   SymTable_T oSymTable;
+   SymTable_T oSnapshot;
+   struct SymTableIter sIter;
+   char acKey[MAX_KEY_LENGTH];
+   int aiValues[KEY_COUNT];
+   int iReplaced;
+   size_t uVisited = 0;
+   int i;
+
+   printf("------------------------------------------------------\n");
+   printf("Testing replacements during iteration.\n");
+   printf("No output should appear here:\n");
+   fflush(stdout);
+
+   oSymTable = SymTable_new();
+   ASSURE(oSymTable != NULL);
+   if (oSymTable == NULL)
+      return;
+
+   for (i = 0; i < KEY_COUNT; i++)
+   {
+      sprintf(acKey, "%d", i);
+      ASSURE(SymTable_put(oSymTable, acKey, &aiValues[i]));
+   }
+
+   oSnapshot = SymTable_snapshot(oSymTable);
+   ASSURE(oSnapshot != NULL);
+   if (oSnapshot == NULL)
+      return;
+
+   /* Each replacement copies the leaf, which the snapshot shares. */
+   for (SymTable_iterBegin(oSymTable, &sIter);
+        ! SymTable_iterEnd(&sIter); SymTable_iterNext(&sIter))
+   {
+      ASSURE(SymTable_replace(oSymTable, sIter.pcKey, &iReplaced) ==
+             sIter.pvValue);
+      uVisited++;
+   }
+   ASSURE(uVisited == KEY_COUNT);
+
+   for (i = 0; i < KEY_COUNT; i++)
+   {
+      sprintf(acKey, "%d", i);
+      ASSURE(SymTable_get(oSymTable, acKey) == &iReplaced);
+   }
+   checkTable(oSnapshot, aiValues, KEY_COUNT);
+   SymTable_free(oSnapshot);
+
+   /* The current key outlives the copied leaf once the snapshot that
+      shared it is freed. */
+   uVisited = 0;
+   for (SymTable_iterBegin(oSymTable, &sIter);
+        ! SymTable_iterEnd(&sIter); SymTable_iterNext(&sIter))
+   {
+      oSnapshot = SymTable_snapshot(oSymTable);
+      ASSURE(oSnapshot != NULL);
+      if (oSnapshot == NULL)
+         return;
+      ASSURE(SymTable_replace(oSymTable, sIter.pcKey, &aiValues[0]) ==
+             &iReplaced);
+      SymTable_free(oSnapshot);
+      ASSURE(SymTable_get(oSymTable, sIter.pcKey) == &aiValues[0]);
+      uVisited++;
+   }
+   ASSURE(uVisited == KEY_COUNT);
+
+   SymTable_free(oSymTable);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Test that SymTable_freeWith only frees values that no snapshot still
+   holds. Leaks and double frees are left to the memory checker. */
+
+static void testFreeWith(void)
+{
+   SymTable_T oSymTable;
+   SymTable_T oSnapshot;
+   int iSuccessful;
+   void *pvValue;
+
+   printf("------------------------------------------------------\n");
+   printf("Testing freeing values shared with snapshots.\n");
+   printf("No output should appear here:\n");
+   fflush(stdout);
+
+   oSymTable = SymTable_newBorrowedKeys();
+   ASSURE(oSymTable != NULL);
+   if (oSymTable == NULL)
+      return;
+
+   iSuccessful = SymTable_put(oSymTable, "kept", malloc(1));
+   ASSURE(iSuccessful);
+   iSuccessful = SymTable_put(oSymTable, "replaced", malloc(1));
+   ASSURE(iSuccessful);
+   iSuccessful = SymTable_put(oSymTable, "removed", malloc(1));
+   ASSURE(iSuccessful);
+
+   oSnapshot = SymTable_snapshot(oSymTable);
+   ASSURE(oSnapshot != NULL);
+   if (oSnapshot == NULL)
+      return;
+
+   /* The old values are still bound in the snapshot. */
+   pvValue = SymTable_replace(oSymTable, "replaced", malloc(1));
+   ASSURE(pvValue == SymTable_get(oSnapshot, "replaced"));
+   pvValue = SymTable_remove(oSymTable, "removed");
+   ASSURE(pvValue == SymTable_get(oSnapshot, "removed"));
+
+   SymTable_freeWith(oSymTable, free);
+   ASSURE(SymTable_getLength(oSnapshot) == 3);
+   SymTable_freeWith(oSnapshot, free);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* A reader of a snapshot, running in a thread of its own */
+
+struct Reader {
+
+   /* snapshot read, freed by the reader */
+   SymTable_T oSnapshot;
+
+   /* the values of the snapshot, as in checkTable */
+   int *piValues;
+
+   /* # of bindings of the snapshot */
+   int iBindingCount;
+};
+
+/*--------------------------------------------------------------------*/
+
+/* Check and free the snapshot of the Reader pvReader. */
+
+static void *readSnapshot(void *pvReader)
+{
+   struct Reader *psReader = (struct Reader*)pvReader;
+   enum {PASS_COUNT = 4};
+   int i;
+
+   assert(psReader != NULL);
+
+   for (i = 0; i < PASS_COUNT; i++)
+      checkTable(psReader->oSnapshot, psReader->piValues,
+                 psReader->iBindingCount);
+   SymTable_free(psReader->oSnapshot);
+   return NULL;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Test reading and freeing snapshots of a table of iBindingCount
+   bindings in other threads, while the table keeps changing. */
+
+static void testConcurrentReaders(int iBindingCount)
+{
+   enum {READER_COUNT = 4};
+   struct Reader asReaders[READER_COUNT];
+   pthread_t aiThreads[READER_COUNT];
+   int aiStarted[READER_COUNT];
+   SymTable_T oSymTable;
+   char acKey[MAX_KEY_LENGTH];
+   int *piValues;
+   int i;
+   int iReader;
+
+   printf("------------------------------------------------------\n");
+   printf("Testing concurrent readers of snapshots.\n");
+   printf("No output should appear here:\n");
+   fflush(stdout);
+
+   piValues = (int*)calloc((size_t)iBindingCount + 1, sizeof(int));
+   ASSURE(piValues != NULL);
+   if (piValues == NULL)
+      return;
+
+   oSymTable = SymTable_new();
+   ASSURE(oSymTable != NULL);
+   if (oSymTable == NULL)
+      return;
+
+   for (i = 0; i < iBindingCount; i++)
+   {
+      sprintf(acKey, "%d", i);
+      ASSURE(SymTable_put(oSymTable, acKey, &piValues[i]));
+   }
+
+   /* Each reader sees the bindings put before it started. */
+   for (iReader = 0; iReader < READER_COUNT; iReader++)
+   {
+      asReaders[iReader].oSnapshot = SymTable_snapshot(oSymTable);
+      ASSURE(asReaders[iReader].oSnapshot != NULL);
+      asReaders[iReader].piValues = piValues;
+      asReaders[iReader].iBindingCount = iBindingCount;
+      aiStarted[iReader] =
+         pthread_create(&aiThreads[iReader], NULL, readSnapshot,
+                        &asReaders[iReader]) == 0;
+      if (! aiStarted[iReader])
+         readSnapshot(&asReaders[iReader]);
+
+      for (i = 0; i < iBindingCount; i++)
+      {
+         sprintf(acKey, "%d", i);
+         ASSURE(SymTable_replace(oSymTable, acKey, &piValues[0]) !=
+                NULL);
+         ASSURE(SymTable_replace(oSymTable, acKey, &piValues[i]) !=
+                NULL);
+      }
+      sprintf(acKey, "%d", iBindingCount);
+      ASSURE(SymTable_put(oSymTable, acKey, &piValues[iBindingCount]));
+      ASSURE(SymTable_remove(oSymTable, acKey) != NULL);
+   }
+
+   for (iReader = 0; iReader < READER_COUNT; iReader++)
+      if (aiStarted[iReader])
+         pthread_join(aiThreads[iReader], NULL);
+
+   checkTable(oSymTable, piValues, iBindingCount);
+   SymTable_free(oSymTable);
+   free(piValues);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Put the binding of pcKey to pvValue into the Symble Table
+   pvExtra. */
+
+static void copyBinding(const char *pcKey, void *pvValue,
+                        void *pvExtra)
+{
+   assert(pcKey != NULL);
+   assert(pvExtra != NULL);
+
+   ASSURE(SymTable_put((SymTable_T)pvExtra, pcKey, pvValue));
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Compare the time taken by a snapshot of a table of iBindingCount
+   bindings with that of a copy made through SymTable_map. */
+
+static void testPerformance(int iBindingCount)
+{
+   enum {REPEAT_COUNT = 100};
+   SymTable_T oSymTable;
+   SymTable_T oCopy;
+   char acKey[MAX_KEY_LENGTH];
+   clock_t iInitialClock;
+   clock_t iFinalClock;
+   int i;
+
+   printf("------------------------------------------------------\n");
+   printf("Testing performance of snapshots.\n");
+   printf("No lines other than timings should appear here:\n");
+   fflush(stdout);
+
+   oSymTable = SymTable_new();
+   ASSURE(oSymTable != NULL);
+   if (oSymTable == NULL)
+      return;
+   for (i = 0; i < iBindingCount; i++)
+   {
+      sprintf(acKey, "%d", i);
+      ASSURE(SymTable_put(oSymTable, acKey, NULL));
+   }
+
+   iInitialClock = clock();
+   for (i = 0; i < REPEAT_COUNT; i++)
+   {
+      oCopy = SymTable_new();
+      ASSURE(oCopy != NULL);
+      if (oCopy == NULL)
+         return;
+      SymTable_map(oSymTable, copyBinding, oCopy);
+      SymTable_free(oCopy);
+   }
+   iFinalClock = clock();
+   printf("CPU time (%d copies by map):  %f seconds\n", REPEAT_COUNT,
+      ((double)(iFinalClock - iInitialClock)) / CLOCKS_PER_SEC);
+
+   /* Each snapshot diverges from the table by one binding. */
+   iInitialClock = clock();
+   for (i = 0; i < REPEAT_COUNT; i++)
+   {
+      oCopy = SymTable_snapshot(oSymTable);
+      ASSURE(oCopy != NULL);
+      if (oCopy == NULL)
+         return;
+      SymTable_replace(oSymTable, "0", NULL);
+      SymTable_free(oCopy);
+   }
+   iFinalClock = clock();
+   printf("CPU time (%d snapshots):      %f seconds\n", REPEAT_COUNT,
+      ((double)(iFinalClock - iInitialClock)) / CLOCKS_PER_SEC);
+
+   SymTable_free(oSymTable);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Test snapshots of the hash array mapped trie implementation of
+   SymTable. As always, argc is the command-line argument count and
+   argv contains the command-line arguments. argv[1] is the number of
+   bindings to test with. Exit with EXIT_FAILURE if argv[1] is missing
+   or not numeric. Otherwise return 0. */
+
+int main(int argc, char *argv[])
+{
+   int iBindingCount;
+
+   if ((argc != 2) || (sscanf(argv[1], "%d", &iBindingCount) != 1) ||
+       (iBindingCount < 1))
+   {
+      fprintf(stderr, "Usage: %s bindingcount\n", argv[0]);
+      exit(EXIT_FAILURE);
+   }
+
+   testSnapshot(iBindingCount);
+   testReplaceWhileIterating();
+   testFreeWith();
+   testConcurrentReaders(iBindingCount);
+   testPerformance(iBindingCount);
+
+   printf("------------------------------------------------------\n");
+   printf("End of %s.\n", argv[0]);
+   return 0;
+}
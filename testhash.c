@@ -0,0 +1,377 @@
+/*--------------------------------------------------------------------*/
+/* testhash.c                                                         */
+/* Author: Julio Lins (jcclb)                                         */
+/*--------------------------------------------------------------------*/
+
+#include "symtablehash.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <time.h>
+
+/*--------------------------------------------------------------------*/
+
+#define ASSURE(i) assure(i, __LINE__)
+
+/*--------------------------------------------------------------------*/
+
+/* Longest key used by the tests */
+
+enum {MAX_KEY_LENGTH = 16};
+
+/*--------------------------------------------------------------------*/
+
+/* If !iSuccessful, print a message to stdout indicating that the
+   test at line iLineNum failed. */
+
+static void assure(int iSuccessful, int iLineNum)
+{
+   if (! iSuccessful)
+   {
+      printf("Test at line %d failed.\n", iLineNum);
+      fflush(stdout);
+   }
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Check that the binding of pcKey in the Symble Table pvExtra has
+   value pvValue. */
+
+static void checkBinding(const char *pcKey, void *pvValue,
+                         void *pvExtra)
+{
+   assert(pcKey != NULL);
+   assert(pvExtra != NULL);
+
+   ASSURE(SymTable_contains((SymTable_T)pvExtra, pcKey));
+   ASSURE(SymTable_get((SymTable_T)pvExtra, pcKey) == pvValue);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Test building a table of iBindingCount entries, a tenth of them
+   repeated, with several thread counts. */
+
+static void testBuildParallel(int iBindingCount)
+{
+   enum {THREAD_COUNT_COUNT = 4};
+   static const size_t auThreadCounts[THREAD_COUNT_COUNT] =
+      {0, 1, 3, 8};
+
+   SymTable_T oSymTable;
+   SymTable_T oExpected;
+   char *pcKeys;
+   const char **ppcKeys;
+   void **ppvValues;
+   size_t uEntryCount;
+   size_t u;
+   int i;
+   int iSuccessful;
+
+   printf("------------------------------------------------------\n");
+   printf("Testing parallel builds of %d bindings.\n", iBindingCount);
+   printf("No output should appear here:\n");
+   fflush(stdout);
+
+   uEntryCount = (size_t)iBindingCount + (size_t)iBindingCount / 10;
+
+   pcKeys = (char*)malloc(uEntryCount * MAX_KEY_LENGTH + 1);
+   ppcKeys = (const char**)malloc(sizeof(char*) * (uEntryCount + 1));
+   ppvValues = (void**)malloc(sizeof(void*) * (uEntryCount + 1));
+   ASSURE((pcKeys != NULL) && (ppcKeys != NULL) && (ppvValues != NULL));
+   if ((pcKeys == NULL) || (ppcKeys == NULL) || (ppvValues == NULL))
+      return;
+
+   /* The repeated keys come last, with other values, which must not
+      be bound. */
+   for (u = 0; u < uEntryCount; u++)
+   {
+      sprintf(pcKeys + u * MAX_KEY_LENGTH, "%lu",
+              (unsigned long)(u % (size_t)iBindingCount));
+      ppcKeys[u] = pcKeys + u * MAX_KEY_LENGTH;
+      ppvValues[u] = &ppvValues[u];
+   }
+
+   oExpected = SymTable_new();
+   ASSURE(oExpected != NULL);
+   for (u = 0; u < uEntryCount; u++)
+      (void)SymTable_put(oExpected, ppcKeys[u], ppvValues[u]);
+
+   for (i = 0; i < THREAD_COUNT_COUNT; i++)
+   {
+      oSymTable = SymTable_buildParallel(ppcKeys, ppvValues,
+                                         uEntryCount,
+                                         auThreadCounts[i]);
+      ASSURE(oSymTable != NULL);
+      if (oSymTable == NULL)
+         continue;
+
+      ASSURE(SymTable_getLength(oSymTable) ==
+             SymTable_getLength(oExpected));
+      SymTable_map(oExpected, checkBinding, oSymTable);
+      SymTable_map(oSymTable, checkBinding, oExpected);
+
+      /* The result is an ordinary table. */
+      iSuccessful = SymTable_put(oSymTable, "new", NULL);
+      ASSURE(iSuccessful);
+      ASSURE(SymTable_remove(oSymTable, ppcKeys[0]) == ppvValues[0]);
+      ASSURE(SymTable_getLength(oSymTable) ==
+             SymTable_getLength(oExpected));
+
+      SymTable_free(oSymTable);
+   }
+
+   /* Without values, every value is NULL. */
+   oSymTable = SymTable_buildParallel(ppcKeys, NULL, uEntryCount, 2);
+   ASSURE(oSymTable != NULL);
+   if (oSymTable != NULL)
+   {
+      ASSURE(SymTable_getLength(oSymTable) ==
+             SymTable_getLength(oExpected));
+      if (iBindingCount > 0)
+      {
+         ASSURE(SymTable_contains(oSymTable, ppcKeys[0]));
+         ASSURE(SymTable_get(oSymTable, ppcKeys[0]) == NULL);
+      }
+      SymTable_free(oSymTable);
+   }
+
+   /* An empty table, with more threads than entries. */
+   oSymTable = SymTable_buildParallel(ppcKeys, ppvValues, 0, 4);
+   ASSURE(oSymTable != NULL);
+   if (oSymTable != NULL)
+   {
+      ASSURE(SymTable_getLength(oSymTable) == 0);
+      SymTable_free(oSymTable);
+   }
+
+   SymTable_free(oExpected);
+   free(ppvValues);
+   free(ppcKeys);
+   free(pcKeys);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Put the binding of pcKey to pvValue into the Symble Table
+   pvExtra. */
+
+static void copyBinding(const char *pcKey, void *pvValue,
+                        void *pvExtra)
+{
+   assert(pcKey != NULL);
+   assert(pvExtra != NULL);
+
+   ASSURE(SymTable_put((SymTable_T)pvExtra, pcKey, pvValue));
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Test cloning a table of iBindingCount bindings, and compare the
+   time taken with that of a copy made through SymTable_map. */
+
+static void testClone(int iBindingCount)
+{
+   SymTable_T oSymTable;
+   SymTable_T oClone;
+   SymTable_T oCopy;
+   struct SymTableIter sIter;
+   struct SymTableIter sOther;
+   char acKey[MAX_KEY_LENGTH];
+   clock_t iInitialClock;
+   clock_t iFinalClock;
+   int i;
+   int iSuccessful;
+
+   printf("------------------------------------------------------\n");
+   printf("Testing clones of %d bindings.\n", iBindingCount);
+   printf("No lines other than timings should appear here:\n");
+   fflush(stdout);
+
+   oSymTable = SymTable_new();
+   ASSURE(oSymTable != NULL);
+   if (oSymTable == NULL)
+      return;
+   for (i = 0; i < iBindingCount; i++)
+   {
+      sprintf(acKey, "%d", i);
+      iSuccessful = SymTable_put(oSymTable, acKey, &acKey[i % 2]);
+      ASSURE(iSuccessful);
+   }
+
+   iInitialClock = clock();
+   oClone = SymTable_clone(oSymTable);
+   iFinalClock = clock();
+   ASSURE(oClone != NULL);
+   if (oClone == NULL)
+      return;
+   printf("CPU time (clone):         %f seconds\n",
+      ((double)(iFinalClock - iInitialClock)) / CLOCKS_PER_SEC);
+
+   iInitialClock = clock();
+   oCopy = SymTable_new();
+   ASSURE(oCopy != NULL);
+   if (oCopy == NULL)
+      return;
+   SymTable_map(oSymTable, copyBinding, oCopy);
+   iFinalClock = clock();
+   printf("CPU time (copy by map):   %f seconds\n",
+      ((double)(iFinalClock - iInitialClock)) / CLOCKS_PER_SEC);
+   SymTable_free(oCopy);
+
+   ASSURE(SymTable_getLength(oClone) == (size_t)iBindingCount);
+   SymTable_map(oSymTable, checkBinding, oClone);
+   SymTable_map(oClone, checkBinding, oSymTable);
+
+   /* The clone owns copies of the keys. */
+   iSuccessful = SymTable_put(oClone, "new", NULL);
+   ASSURE(iSuccessful);
+   ASSURE(! SymTable_contains(oSymTable, "new"));
+   SymTable_free(oSymTable);
+   if (iBindingCount > 0)
+      ASSURE(SymTable_remove(oClone, "0") == &acKey[0]);
+   ASSURE(SymTable_contains(oClone, "new"));
+   SymTable_free(oClone);
+
+   /* A clone of a table that borrows its keys borrows them too. */
+   oSymTable = SymTable_newBorrowedKeys();
+   ASSURE(oSymTable != NULL);
+   if (oSymTable == NULL)
+      return;
+   iSuccessful = SymTable_put(oSymTable, "borrowed", NULL);
+   ASSURE(iSuccessful);
+   oClone = SymTable_clone(oSymTable);
+   ASSURE(oClone != NULL);
+   if (oClone != NULL)
+   {
+      SymTable_iterBegin(oClone, &sIter);
+      ASSURE(! SymTable_iterEnd(&sIter));
+      ASSURE(strcmp(sIter.pcKey, "borrowed") == 0);
+      SymTable_iterBegin(oSymTable, &sOther);
+      ASSURE(sIter.pcKey == sOther.pcKey);
+      SymTable_free(oClone);
+   }
+   SymTable_free(oSymTable);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Test merging a table of iBindingCount bindings into one that has
+   half of them and as many others, with each policy. */
+
+static void testMerge(int iBindingCount)
+{
+   enum {POLICY_COUNT = 2};
+   static const enum SymTableMerge aeMerges[POLICY_COUNT] =
+      {SYMTABLE_KEEP, SYMTABLE_REPLACE};
+   SymTable_T oSrc;
+   SymTable_T oDst;
+   char acKey[MAX_KEY_LENGTH];
+   int aiValues[2];
+   int i;
+   int iPolicy;
+   int iSuccessful;
+
+   printf("------------------------------------------------------\n");
+   printf("Testing merges of %d bindings.\n", iBindingCount);
+   printf("No output should appear here:\n");
+   fflush(stdout);
+
+   oSrc = SymTable_new();
+   ASSURE(oSrc != NULL);
+   if (oSrc == NULL)
+      return;
+   for (i = 0; i < iBindingCount; i++)
+   {
+      sprintf(acKey, "%d", i);
+      iSuccessful = SymTable_put(oSrc, acKey, &aiValues[0]);
+      ASSURE(iSuccessful);
+   }
+
+   for (iPolicy = 0; iPolicy < POLICY_COUNT; iPolicy++)
+   {
+      oDst = SymTable_new();
+      ASSURE(oDst != NULL);
+      if (oDst == NULL)
+         return;
+      for (i = 0; i < iBindingCount; i += 2)
+      {
+         sprintf(acKey, "%d", i);
+         iSuccessful = SymTable_put(oDst, acKey, &aiValues[1]);
+         ASSURE(iSuccessful);
+         sprintf(acKey, "dst%d", i);
+         iSuccessful = SymTable_put(oDst, acKey, &aiValues[1]);
+         ASSURE(iSuccessful);
+      }
+
+      iSuccessful = SymTable_merge(oDst, oSrc, aeMerges[iPolicy]);
+      ASSURE(iSuccessful);
+      ASSURE(SymTable_getLength(oDst) ==
+             (size_t)(iBindingCount + (iBindingCount + 1) / 2));
+
+      for (i = 0; i < iBindingCount; i++)
+      {
+         sprintf(acKey, "%d", i);
+         if ((i % 2 == 0) && (aeMerges[iPolicy] == SYMTABLE_KEEP))
+            ASSURE(SymTable_get(oDst, acKey) == &aiValues[1]);
+         else
+            ASSURE(SymTable_get(oDst, acKey) == &aiValues[0]);
+      }
+      ASSURE(SymTable_getLength(oSrc) == (size_t)iBindingCount);
+
+      /* Merging again changes nothing. */
+      iSuccessful = SymTable_merge(oDst, oSrc, aeMerges[iPolicy]);
+      ASSURE(iSuccessful);
+      ASSURE(SymTable_getLength(oDst) ==
+             (size_t)(iBindingCount + (iBindingCount + 1) / 2));
+
+      /* The result is an ordinary table, with room to grow. */
+      iSuccessful = SymTable_put(oDst, "new", NULL);
+      ASSURE(iSuccessful);
+      SymTable_map(oDst, checkBinding, oDst);
+      SymTable_free(oDst);
+   }
+
+   /* A merge into an empty table copies the source. */
+   oDst = SymTable_new();
+   ASSURE(oDst != NULL);
+   if (oDst == NULL)
+      return;
+   iSuccessful = SymTable_merge(oDst, oSrc, SYMTABLE_KEEP);
+   ASSURE(iSuccessful);
+   ASSURE(SymTable_getLength(oDst) == (size_t)iBindingCount);
+   SymTable_map(oSrc, checkBinding, oDst);
+
+   SymTable_free(oDst);
+   SymTable_free(oSrc);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Test the bulk operations of the hash table SymTable
+   implementation. As always, argc is the command-line argument count
+   and argv contains the command-line arguments. argv[1] is the
+   number of bindings to build. Exit with EXIT_FAILURE if argv[1] is
+   missing or not numeric. Otherwise return 0. */
+
+int main(int argc, char *argv[])
+{
+   int iBindingCount;
+
+   if ((argc != 2) || (sscanf(argv[1], "%d", &iBindingCount) != 1) ||
+       (iBindingCount < 0))
+   {
+      fprintf(stderr, "Usage: %s bindingcount\n", argv[0]);
+      exit(EXIT_FAILURE);
+   }
+
+   testBuildParallel(iBindingCount);
+   testClone(iBindingCount);
+   testMerge(iBindingCount);
+
+   printf("------------------------------------------------------\n");
+   printf("End of %s.\n", argv[0]);
+   return 0;
+}
@@ -0,0 +1,246 @@
+/*--------------------------------------------------------------------*/
+/* testint.c                                                          */
+/* Author: Julio Lins (jcclb)                                         */
+/*--------------------------------------------------------------------*/
+
+#include "symtableint.h"
+#include "symtable.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <limits.h>
+#include <time.h>
+
+/*--------------------------------------------------------------------*/
+
+#define ASSURE(i) assure(i, __LINE__)
+
+/*--------------------------------------------------------------------*/
+
+/* Longest key used by the tests */
+
+enum {MAX_KEY_LENGTH = 24};
+
+/*--------------------------------------------------------------------*/
+
+/* If !iSuccessful, print a message to stdout indicating that the
+   test at line iLineNum failed. */
+
+static void assure(int iSuccessful, int iLineNum)
+{
+   if (! iSuccessful)
+   {
+      printf("Test at line %d failed.\n", iLineNum);
+      fflush(stdout);
+   }
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Test the basic functions on a few keys, the extremes included. */
+
+static void testBasics(void)
+{
+   SymTableInt_T oSymTableInt;
+   int aiValues[3];
+
+   printf("------------------------------------------------------\n");
+   printf("Testing the basic SymTableInt functions.\n");
+   printf("No output should appear here:\n");
+   fflush(stdout);
+
+   oSymTableInt = SymTableInt_new();
+   ASSURE(oSymTableInt != NULL);
+   if (oSymTableInt == NULL)
+      return;
+
+   ASSURE(SymTableInt_getLength(oSymTableInt) == 0);
+   ASSURE(SymTableInt_put(oSymTableInt, 0, &aiValues[0]));
+   ASSURE(SymTableInt_put(oSymTableInt, ULONG_MAX, &aiValues[1]));
+   ASSURE(SymTableInt_put(oSymTableInt, 509, NULL));
+   ASSURE(! SymTableInt_put(oSymTableInt, 0, &aiValues[2]));
+   ASSURE(SymTableInt_getLength(oSymTableInt) == 3);
+
+   ASSURE(SymTableInt_get(oSymTableInt, 0) == &aiValues[0]);
+   ASSURE(SymTableInt_get(oSymTableInt, ULONG_MAX) == &aiValues[1]);
+   ASSURE(SymTableInt_get(oSymTableInt, 509) == NULL);
+   ASSURE(SymTableInt_contains(oSymTableInt, 509));
+   ASSURE(! SymTableInt_contains(oSymTableInt, 1));
+   ASSURE(SymTableInt_get(oSymTableInt, 1) == NULL);
+
+   ASSURE(SymTableInt_replace(oSymTableInt, 509, &aiValues[2]) == NULL);
+   ASSURE(SymTableInt_get(oSymTableInt, 509) == &aiValues[2]);
+   ASSURE(SymTableInt_replace(oSymTableInt, 1, &aiValues[2]) == NULL);
+   ASSURE(! SymTableInt_contains(oSymTableInt, 1));
+
+   ASSURE(SymTableInt_remove(oSymTableInt, 0) == &aiValues[0]);
+   ASSURE(SymTableInt_remove(oSymTableInt, 0) == NULL);
+   ASSURE(! SymTableInt_contains(oSymTableInt, 0));
+   ASSURE(SymTableInt_getLength(oSymTableInt) == 2);
+
+   SymTableInt_free(oSymTableInt);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Add ulKey to the sum of keys pointed to by pvExtra. */
+
+static void sumKey(unsigned long ulKey, void *pvValue, void *pvExtra)
+{
+   assert(pvExtra != NULL);
+
+   ASSURE(pvValue == NULL);
+   *(unsigned long*)pvExtra += ulKey;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Test a table of iBindingCount bindings whose keys are multiples of
+   ulStride, so that it goes through every bucket count. */
+
+static void testLargeTable(int iBindingCount, unsigned long ulStride)
+{
+   SymTableInt_T oSymTableInt;
+   struct SymTableIntIter sIter;
+   unsigned long ulSum = 0;
+   unsigned long ulMapSum = 0;
+   unsigned long ulIterSum = 0;
+   size_t uVisited = 0;
+   int i;
+
+   printf("------------------------------------------------------\n");
+   printf("Testing %d keys with a stride of %lu.\n", iBindingCount,
+          ulStride);
+   printf("No output should appear here:\n");
+   fflush(stdout);
+
+   oSymTableInt = SymTableInt_new();
+   ASSURE(oSymTableInt != NULL);
+   if (oSymTableInt == NULL)
+      return;
+
+   for (i = 0; i < iBindingCount; i++)
+   {
+      ASSURE(SymTableInt_put(oSymTableInt, (unsigned long)i * ulStride,
+                             NULL));
+      ulSum += (unsigned long)i * ulStride;
+   }
+   ASSURE(SymTableInt_getLength(oSymTableInt) ==
+          (size_t)iBindingCount);
+
+   for (i = 0; i < iBindingCount; i++)
+   {
+      ASSURE(SymTableInt_contains(oSymTableInt,
+                                  (unsigned long)i * ulStride));
+      ASSURE(! SymTableInt_contains(oSymTableInt,
+         (unsigned long)(i + iBindingCount) * ulStride));
+   }
+
+   /* Map and iterator visit each binding once. */
+   SymTableInt_map(oSymTableInt, sumKey, &ulMapSum);
+   ASSURE(ulMapSum == ulSum);
+
+   for (SymTableInt_iterBegin(oSymTableInt, &sIter);
+        ! SymTableInt_iterEnd(&sIter); SymTableInt_iterNext(&sIter))
+   {
+      ASSURE(SymTableInt_contains(oSymTableInt, sIter.ulKey));
+      ulIterSum += sIter.ulKey;
+      uVisited++;
+   }
+   ASSURE(ulIterSum == ulSum);
+   ASSURE(uVisited == (size_t)iBindingCount);
+
+   for (i = 0; i < iBindingCount; i++)
+      ASSURE(SymTableInt_remove(oSymTableInt,
+                                (unsigned long)i * ulStride) == NULL);
+   ASSURE(SymTableInt_getLength(oSymTableInt) == 0);
+
+   SymTableInt_iterBegin(oSymTableInt, &sIter);
+   ASSURE(SymTableInt_iterEnd(&sIter));
+
+   SymTableInt_freeWith(oSymTableInt, free);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Compare the time taken to put and get iBindingCount integer keys
+   with that taken by the same keys formatted into strings for the
+   string-keyed hash table. */
+
+static void testPerformance(int iBindingCount)
+{
+   SymTable_T oSymTable;
+   SymTableInt_T oSymTableInt;
+   char acKey[MAX_KEY_LENGTH];
+   clock_t iInitialClock;
+   clock_t iFinalClock;
+   int i;
+
+   printf("------------------------------------------------------\n");
+   printf("Testing performance of integer keys.\n");
+   printf("No lines other than timings should appear here:\n");
+   fflush(stdout);
+
+   iInitialClock = clock();
+   oSymTable = SymTable_new();
+   ASSURE(oSymTable != NULL);
+   if (oSymTable == NULL)
+      return;
+   for (i = 0; i < iBindingCount; i++)
+   {
+      sprintf(acKey, "%d", i);
+      ASSURE(SymTable_put(oSymTable, acKey, NULL));
+   }
+   for (i = 0; i < iBindingCount; i++)
+   {
+      sprintf(acKey, "%d", i);
+      ASSURE(SymTable_contains(oSymTable, acKey));
+   }
+   SymTable_free(oSymTable);
+   iFinalClock = clock();
+   printf("CPU time (%d string keys):  %f seconds\n", iBindingCount,
+      ((double)(iFinalClock - iInitialClock)) / CLOCKS_PER_SEC);
+
+   iInitialClock = clock();
+   oSymTableInt = SymTableInt_new();
+   ASSURE(oSymTableInt != NULL);
+   if (oSymTableInt == NULL)
+      return;
+   for (i = 0; i < iBindingCount; i++)
+      ASSURE(SymTableInt_put(oSymTableInt, (unsigned long)i, NULL));
+   for (i = 0; i < iBindingCount; i++)
+      ASSURE(SymTableInt_contains(oSymTableInt, (unsigned long)i));
+   SymTableInt_free(oSymTableInt);
+   iFinalClock = clock();
+   printf("CPU time (%d integer keys): %f seconds\n", iBindingCount,
+      ((double)(iFinalClock - iInitialClock)) / CLOCKS_PER_SEC);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Test the integer-keyed SymTableInt. As always, argc is the
+   command-line argument count and argv contains the command-line
+   arguments. argv[1] is the number of bindings to test with. Exit
+   with EXIT_FAILURE if argv[1] is missing or not numeric. Otherwise
+   return 0. */
+
+int main(int argc, char *argv[])
+{
+   int iBindingCount;
+
+   if ((argc != 2) || (sscanf(argv[1], "%d", &iBindingCount) != 1) ||
+       (iBindingCount < 1))
+   {
+      fprintf(stderr, "Usage: %s bindingcount\n", argv[0]);
+      exit(EXIT_FAILURE);
+   }
+
+   testBasics();
+   testLargeTable(iBindingCount, 1);
+   testLargeTable(iBindingCount, 509UL * 1021UL);
+   testPerformance(iBindingCount);
+
+   printf("------------------------------------------------------\n");
+   printf("End of %s.\n", argv[0]);
+   return 0;
+}
@@ -0,0 +1,484 @@
+/*--------------------------------------------------------------------*/
+/* testjournal.c                                                      */
+/* Author: Julio Lins (jcclb)                                         */
+/*--------------------------------------------------------------------*/
+
+/* getpid and clock_gettime are POSIX, not ANSI C */
+#define _POSIX_C_SOURCE 200112L
+
+#include "symtablejournal.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <time.h>
+#include <unistd.h>
+
+/*--------------------------------------------------------------------*/
+
+#define ASSURE(i) assure(i, __LINE__)
+
+/*--------------------------------------------------------------------*/
+
+/* Longest name of a journal file used by the tests */
+
+enum {MAX_NAME_LENGTH = 64};
+
+/* Longest key used by the tests */
+
+enum {MAX_KEY_LENGTH = 16};
+
+/* Most commits, each waiting for the disk, timed by the tests */
+
+enum {MAX_COMMIT_COUNT = 1000};
+
+/*--------------------------------------------------------------------*/
+
+/* If !iSuccessful, print a message to stdout indicating that the
+   test at line iLineNum failed. */
+
+static void assure(int iSuccessful, int iLineNum)
+{
+   if (! iSuccessful)
+   {
+      printf("Test at line %d failed.\n", iLineNum);
+      fflush(stdout);
+   }
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Return a new int holding the uValueSize bytes at pcValue, which
+   must be the size of an int. pcKey and pvExtra are unused. */
+
+static void *makeValue(const char *pcKey, const char *pcValue,
+                       size_t uValueSize, void *pvExtra)
+{
+   int *piValue;
+
+   assert(pcKey != NULL);
+   assert(pcValue != NULL);
+   (void)pvExtra;
+
+   ASSURE(uValueSize == sizeof(int));
+
+   piValue = (int*)malloc(sizeof(int));
+   if (piValue != NULL)
+      memcpy(piValue, pcValue, sizeof(int));
+   return piValue;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Return the # of bytes of the file named pcFileName, or -1 if it
+   cannot be read. */
+
+static long fileSize(const char *pcFileName)
+{
+   FILE *psFile;
+   long lSize;
+
+   assert(pcFileName != NULL);
+
+   psFile = fopen(pcFileName, "rb");
+   if (psFile == NULL)
+      return -1;
+   fseek(psFile, 0L, SEEK_END);
+   lSize = ftell(psFile);
+   fclose(psFile);
+   return lSize;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Invert the bits of the byte at lOffset of the file named
+   pcFileName. Return 1 (TRUE) if successful, or 0 (FALSE)
+   otherwise. */
+
+static int flipByte(const char *pcFileName, long lOffset)
+{
+   FILE *psFile;
+   int iByte;
+   int iSuccessful;
+
+   assert(pcFileName != NULL);
+
+   psFile = fopen(pcFileName, "r+b");
+   if (psFile == NULL)
+      return 0;
+   iSuccessful = (fseek(psFile, lOffset, SEEK_SET) == 0) &&
+      ((iByte = getc(psFile)) != EOF) &&
+      (fseek(psFile, lOffset, SEEK_SET) == 0) &&
+      (putc(iByte ^ 0xff, psFile) != EOF);
+   if (fclose(psFile) != 0)
+      iSuccessful = 0;
+   return iSuccessful;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Test that iBindingCount puts, and some replacements and removals,
+   are replayed into a new table. */
+
+static void testReplay(const char *pcFileName, int iBindingCount)
+{
+   SymTable_T oSymTable;
+   SymTableJournal_T oSymTableJournal;
+   char acKey[MAX_KEY_LENGTH];
+   int *piValues;
+   int *piValue;
+   int iNegative;
+   int i;
+   int iSuccessful;
+
+   printf("------------------------------------------------------\n");
+   printf("Testing replay of %d bindings.\n", iBindingCount);
+   printf("No output should appear here:\n");
+   fflush(stdout);
+
+   piValues = (int*)calloc((size_t)iBindingCount + 1, sizeof(int));
+   ASSURE(piValues != NULL);
+   if (piValues == NULL)
+      return;
+
+   oSymTable = SymTable_new();
+   ASSURE(oSymTable != NULL);
+   oSymTableJournal = SymTableJournal_open(oSymTable, pcFileName,
+                                           makeValue, free, NULL);
+   ASSURE(oSymTableJournal != NULL);
+   if (oSymTableJournal == NULL)
+      return;
+
+   /* Every third value is negated, and every fifth key removed. */
+   for (i = 0; i < iBindingCount; i++)
+   {
+      piValues[i] = i;
+      sprintf(acKey, "%d", i);
+      iSuccessful = SymTableJournal_put(oSymTableJournal, acKey,
+                                        &piValues[i], sizeof(int));
+      ASSURE(iSuccessful);
+   }
+   iSuccessful = SymTableJournal_put(oSymTableJournal, "0",
+                                     &piValues[0], sizeof(int));
+   ASSURE(! iSuccessful);
+
+   for (i = 0; i < iBindingCount; i += 3)
+   {
+      piValues[i] = -i;
+      sprintf(acKey, "%d", i);
+      piValue = (int*)SymTableJournal_replace(oSymTableJournal, acKey,
+                                              &piValues[i],
+                                              sizeof(int));
+      ASSURE(piValue == &piValues[i]);
+   }
+
+   for (i = 0; i < iBindingCount; i += 5)
+   {
+      sprintf(acKey, "%d", i);
+      piValue = (int*)SymTableJournal_remove(oSymTableJournal, acKey);
+      ASSURE(piValue == &piValues[i]);
+   }
+   ASSURE(SymTableJournal_remove(oSymTableJournal, "none") == NULL);
+
+   iSuccessful = SymTableJournal_commit(oSymTableJournal);
+   ASSURE(iSuccessful);
+   iSuccessful = SymTableJournal_close(oSymTableJournal);
+   ASSURE(iSuccessful);
+
+   /* The values of the first table are the client's. */
+   SymTable_free(oSymTable);
+   free(piValues);
+
+
+   oSymTable = SymTable_new();
+   ASSURE(oSymTable != NULL);
+   oSymTableJournal = SymTableJournal_open(oSymTable, pcFileName,
+                                           makeValue, free, NULL);
+   ASSURE(oSymTableJournal != NULL);
+   if (oSymTableJournal == NULL)
+      return;
+
+   ASSURE(SymTable_getLength(oSymTable) ==
+          (size_t)(iBindingCount - (iBindingCount + 4) / 5));
+
+   for (i = 0; i < iBindingCount; i++)
+   {
+      sprintf(acKey, "%d", i);
+      piValue = (int*)SymTable_get(oSymTable, acKey);
+      if (i % 5 == 0)
+         ASSURE(piValue == NULL);
+      else
+         ASSURE((piValue != NULL) &&
+                (*piValue == ((i % 3 == 0) ? -i : i)));
+   }
+
+   /* Changes after a replay are appended to the same file. */
+   iNegative = -1;
+   iSuccessful = SymTableJournal_put(oSymTableJournal, "new",
+                                     &iNegative, sizeof(int));
+   ASSURE(iSuccessful);
+   iSuccessful = SymTableJournal_close(oSymTableJournal);
+   ASSURE(iSuccessful);
+   SymTable_remove(oSymTable, "new");
+   SymTable_freeWith(oSymTable, free);
+
+   oSymTable = SymTable_new();
+   ASSURE(oSymTable != NULL);
+   oSymTableJournal = SymTableJournal_open(oSymTable, pcFileName,
+                                           makeValue, free, NULL);
+   ASSURE(oSymTableJournal != NULL);
+   if (oSymTableJournal == NULL)
+      return;
+   piValue = (int*)SymTable_get(oSymTable, "new");
+   ASSURE((piValue != NULL) && (*piValue == -1));
+   SymTableJournal_close(oSymTableJournal);
+   SymTable_freeWith(oSymTable, free);
+
+   remove(pcFileName);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Test journal files cut short or damaged. */
+
+static void testRecovery(const char *pcFileName)
+{
+   SymTable_T oSymTable;
+   SymTableJournal_T oSymTableJournal;
+   FILE *psFile;
+   int iValue = 7;
+   long lSize;
+   int iSuccessful;
+
+   printf("------------------------------------------------------\n");
+   printf("Testing recovery of damaged journals.\n");
+   printf("No output should appear here:\n");
+   fflush(stdout);
+
+   oSymTable = SymTable_new();
+   ASSURE(oSymTable != NULL);
+   oSymTableJournal = SymTableJournal_open(oSymTable, pcFileName,
+                                           makeValue, free, NULL);
+   ASSURE(oSymTableJournal != NULL);
+   if (oSymTableJournal == NULL)
+      return;
+   iSuccessful = SymTableJournal_put(oSymTableJournal, "a", &iValue,
+                                     sizeof(int));
+   ASSURE(iSuccessful);
+   iSuccessful = SymTableJournal_put(oSymTableJournal, "b", &iValue,
+                                     sizeof(int));
+   ASSURE(iSuccessful);
+   iSuccessful = SymTableJournal_close(oSymTableJournal);
+   ASSURE(iSuccessful);
+   lSize = fileSize(pcFileName);
+
+   /* A record cut short by a crash is discarded. */
+   psFile = fopen(pcFileName, "ab");
+   ASSURE(psFile != NULL);
+   if (psFile == NULL)
+      return;
+   fputs("Pxyz", psFile);
+   fclose(psFile);
+
+   SymTable_clear(oSymTable, NULL);
+   oSymTableJournal = SymTableJournal_open(oSymTable, pcFileName,
+                                           makeValue, free, NULL);
+   ASSURE(oSymTableJournal != NULL);
+   if (oSymTableJournal == NULL)
+      return;
+   ASSURE(SymTable_getLength(oSymTable) == 2);
+   ASSURE(fileSize(pcFileName) == lSize);
+   iSuccessful = SymTableJournal_put(oSymTableJournal, "c", &iValue,
+                                     sizeof(int));
+   ASSURE(iSuccessful);
+   iSuccessful = SymTableJournal_close(oSymTableJournal);
+   ASSURE(iSuccessful);
+
+   /* A record whose checksum does not match is discarded, as are the
+      bytes after it. Flip the last byte of the value of "c". */
+   SymTable_remove(oSymTable, "c");
+   SymTable_clear(oSymTable, free);
+   ASSURE(flipByte(pcFileName,
+                   fileSize(pcFileName) - (long)sizeof(size_t) - 1));
+   oSymTableJournal = SymTableJournal_open(oSymTable, pcFileName,
+                                           makeValue, free, NULL);
+   ASSURE(oSymTableJournal != NULL);
+   if (oSymTableJournal == NULL)
+      return;
+   ASSURE(SymTable_getLength(oSymTable) == 2);
+   ASSURE(! SymTable_contains(oSymTable, "c"));
+   ASSURE(fileSize(pcFileName) == lSize);
+   iSuccessful = SymTableJournal_put(oSymTableJournal, "c", &iValue,
+                                     sizeof(int));
+   ASSURE(iSuccessful);
+   iSuccessful = SymTableJournal_close(oSymTableJournal);
+   ASSURE(iSuccessful);
+
+   /* The value of the last binding is the client's. */
+   SymTable_remove(oSymTable, "c");
+   SymTable_clear(oSymTable, free);
+   oSymTableJournal = SymTableJournal_open(oSymTable, pcFileName,
+                                           makeValue, free, NULL);
+   ASSURE(oSymTableJournal != NULL);
+   if (oSymTableJournal == NULL)
+      return;
+   ASSURE(SymTable_getLength(oSymTable) == 3);
+   SymTableJournal_close(oSymTableJournal);
+
+   /* Records that do not fit the table are not replayed. */
+   oSymTableJournal = SymTableJournal_open(oSymTable, pcFileName,
+                                           makeValue, free, NULL);
+   ASSURE(oSymTableJournal == NULL);
+   SymTable_clear(oSymTable, free);
+   remove(pcFileName);
+
+   /* A file that is not a journal is not replayed. */
+   psFile = fopen(pcFileName, "wb");
+   ASSURE(psFile != NULL);
+   if (psFile == NULL)
+      return;
+   fputs("not a journal at all", psFile);
+   fclose(psFile);
+   oSymTableJournal = SymTableJournal_open(oSymTable, pcFileName,
+                                           makeValue, free, NULL);
+   ASSURE(oSymTableJournal == NULL);
+   ASSURE(SymTable_getLength(oSymTable) == 0);
+
+   SymTable_free(oSymTable);
+   remove(pcFileName);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Return the seconds elapsed since some fixed point in the past. */
+
+static double wallClock(void)
+{
+   struct timespec sTime;
+
+   clock_gettime(CLOCK_MONOTONIC, &sTime);
+   return (double)sTime.tv_sec + (double)sTime.tv_nsec / 1e9;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Put iBindingCount bindings into a new table through a journal in
+   file pcFileName, committing after every iBatchSize puts, or into
+   the table alone if pcFileName is NULL. Print the elapsed time. */
+
+static void timePuts(const char *pcFileName, int iBindingCount,
+                     int iBatchSize)
+{
+   SymTable_T oSymTable;
+   SymTableJournal_T oSymTableJournal = NULL;
+   char acKey[MAX_KEY_LENGTH];
+   double dInitialTime;
+   double dFinalTime;
+   int i;
+   int iSuccessful;
+
+   assert(iBatchSize > 0);
+
+   oSymTable = SymTable_new();
+   ASSURE(oSymTable != NULL);
+   if (pcFileName != NULL)
+   {
+      oSymTableJournal = SymTableJournal_open(oSymTable, pcFileName,
+                                              makeValue, free, NULL);
+      ASSURE(oSymTableJournal != NULL);
+      if (oSymTableJournal == NULL)
+         return;
+   }
+
+   dInitialTime = wallClock();
+   for (i = 0; i < iBindingCount; i++)
+   {
+      sprintf(acKey, "%d", i);
+      if (oSymTableJournal == NULL)
+         iSuccessful = SymTable_put(oSymTable, acKey, &i);
+      else
+      {
+         iSuccessful = SymTableJournal_put(oSymTableJournal, acKey, &i,
+                                           sizeof(int));
+         if ((i + 1) % iBatchSize == 0)
+            ASSURE(SymTableJournal_commit(oSymTableJournal));
+      }
+      ASSURE(iSuccessful);
+   }
+   if (oSymTableJournal != NULL)
+      ASSURE(SymTableJournal_close(oSymTableJournal));
+   dFinalTime = wallClock();
+
+   if (pcFileName == NULL)
+      printf("Unlogged:                  ");
+   else
+      printf("Logged, commit every %5d: ", iBatchSize);
+   printf("%f seconds (%d puts)\n", dFinalTime - dInitialTime,
+          iBindingCount);
+
+   SymTable_free(oSymTable);
+   if (pcFileName != NULL)
+      remove(pcFileName);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Compare the time taken by iBindingCount puts with and without a
+   journal, for several commit batch sizes. A commit waits for the
+   disk, so at most MAX_COMMIT_COUNT of them are timed. */
+
+static void testPerformance(const char *pcFileName, int iBindingCount)
+{
+   static const int aiBatchSizes[] = {1, 16, 256, 4096};
+   int iCount;
+   size_t u;
+
+   printf("------------------------------------------------------\n");
+   printf("Testing performance of journaled puts.\n");
+   printf("No lines other than timings should appear here:\n");
+   fflush(stdout);
+
+   timePuts(NULL, iBindingCount, 1);
+   for (u = 0; u < sizeof(aiBatchSizes) / sizeof(aiBatchSizes[0]);
+        u++)
+   {
+      iCount = iBindingCount;
+      if (iCount / aiBatchSizes[u] > MAX_COMMIT_COUNT)
+         iCount = aiBatchSizes[u] * MAX_COMMIT_COUNT;
+      timePuts(pcFileName, iCount, aiBatchSizes[u]);
+   }
+   timePuts(pcFileName, iBindingCount,
+            (iBindingCount > 0) ? iBindingCount : 1);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Test the journal of SymTable changes. As always, argc is the
+   command-line argument count and argv contains the command-line
+   arguments. argv[1] is the number of bindings to journal. Exit with
+   EXIT_FAILURE if argv[1] is missing or not numeric. Otherwise
+   return 0. */
+
+int main(int argc, char *argv[])
+{
+   char acFileName[MAX_NAME_LENGTH];
+   int iBindingCount;
+
+   if ((argc != 2) || (sscanf(argv[1], "%d", &iBindingCount) != 1) ||
+       (iBindingCount < 0))
+   {
+      fprintf(stderr, "Usage: %s bindingcount\n", argv[0]);
+      exit(EXIT_FAILURE);
+   }
+
+   /* A name of its own, so that concurrent runs do not collide. */
+   sprintf(acFileName, "testjournal.%ld.log", (long)getpid());
+
+   testReplay(acFileName, iBindingCount);
+   testRecovery(acFileName);
+   testPerformance(acFileName, iBindingCount);
+
+   printf("------------------------------------------------------\n");
+   printf("End of %s.\n", argv[0]);
+   return 0;
+}
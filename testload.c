@@ -0,0 +1,396 @@
+/*--------------------------------------------------------------------*/
+/* testload.c                                                         */
+/* Author: Julio Lins (jcclb)                                         */
+/*--------------------------------------------------------------------*/
+
+#include "symtableload.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+/*--------------------------------------------------------------------*/
+
+#define ASSURE(i) assure(i, __LINE__)
+
+/*--------------------------------------------------------------------*/
+
+/* Longest key used by the tests */
+
+enum {MAX_KEY_LENGTH = 16};
+
+/* # of padding characters after each value of a text file, so that
+   the file takes several reads */
+
+enum {PADDING_LENGTH = 700};
+
+/* # of bytes of the longest line or record that can be loaded */
+
+enum {MAX_RECORD_SIZE = 1 << 16};
+
+/*--------------------------------------------------------------------*/
+
+/* If !iSuccessful, print a message to stdout indicating that the
+   test at line iLineNum failed. */
+
+static void assure(int iSuccessful, int iLineNum)
+{
+   if (! iSuccessful)
+   {
+      printf("Test at line %d failed.\n", iLineNum);
+      fflush(stdout);
+   }
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Return a new int holding the number at the start of pcValue, which
+   is followed by '\0' or padding. pcKey, uValueSize and pvExtra are
+   unused. */
+
+static void *makeTextValue(const char *pcKey, const char *pcValue,
+                           size_t uValueSize, void *pvExtra)
+{
+   int *piValue;
+
+   assert(pcKey != NULL);
+   assert(pcValue != NULL);
+   (void)uValueSize;
+   (void)pvExtra;
+
+   piValue = (int*)malloc(sizeof(int));
+   if (piValue != NULL)
+      *piValue = atoi(pcValue);
+   return piValue;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Return a new int holding the uValueSize bytes at pcValue, which
+   must be the size of an int, and count the call in *(int*)pvExtra.
+   pcKey is unused. */
+
+static void *makeBinaryValue(const char *pcKey, const char *pcValue,
+                             size_t uValueSize, void *pvExtra)
+{
+   int *piValue;
+
+   assert(pcKey != NULL);
+   assert(pcValue != NULL);
+   assert(pvExtra != NULL);
+
+   ASSURE(uValueSize == sizeof(int));
+   (*(int*)pvExtra)++;
+
+   piValue = (int*)malloc(sizeof(int));
+   if (piValue != NULL)
+      memcpy(piValue, pcValue, sizeof(int));
+   return piValue;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Write a record of the binary format with key pcKey and the
+   uValueSize bytes at pvValue to psFile. */
+
+static void writeRecord(FILE *psFile, const char *pcKey,
+                        const void *pvValue, size_t uValueSize)
+{
+   size_t uKeySize;
+
+   assert(psFile != NULL);
+   assert(pcKey != NULL);
+
+   uKeySize = strlen(pcKey) + 1;
+   fwrite(&uKeySize, sizeof(size_t), 1, psFile);
+   fwrite(&uValueSize, sizeof(size_t), 1, psFile);
+   fwrite(pcKey, 1, uKeySize, psFile);
+   fwrite(pvValue, 1, uValueSize, psFile);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Test loading a text file of iBindingCount lines. */
+
+static void testText(int iBindingCount)
+{
+   SymTable_T oSymTable;
+   FILE *psFile;
+   char acKey[MAX_KEY_LENGTH];
+   int *piValue;
+   int i;
+   int j;
+   int iSuccessful;
+
+   printf("------------------------------------------------------\n");
+   printf("Testing a text file of %d lines.\n", iBindingCount);
+   printf("No output should appear here:\n");
+   fflush(stdout);
+
+   psFile = tmpfile();
+   ASSURE(psFile != NULL);
+   if (psFile == NULL)
+      return;
+
+   /* Long, padded lines with empty ones in between, and no newline
+      at the end. */
+   for (i = 0; i < iBindingCount; i++)
+   {
+      if (i > 0)
+         fputc('\n', psFile);
+      if (i % 100 == 0)
+         fputc('\n', psFile);
+      fprintf(psFile, "key%d\t%d ", i, i);
+      for (j = 0; j < PADDING_LENGTH; j++)
+         fputc('x', psFile);
+   }
+   rewind(psFile);
+
+   oSymTable = SymTable_new();
+   ASSURE(oSymTable != NULL);
+
+   iSuccessful = SymTable_loadStream(oSymTable, psFile, SYMTABLE_TEXT,
+                                     makeTextValue, NULL);
+   ASSURE(iSuccessful);
+   ASSURE(SymTable_getLength(oSymTable) == (size_t)iBindingCount);
+
+   for (i = 0; i < iBindingCount; i++)
+   {
+      sprintf(acKey, "key%d", i);
+      piValue = (int*)SymTable_get(oSymTable, acKey);
+      ASSURE((piValue != NULL) && (*piValue == i));
+   }
+
+   SymTable_freeWith(oSymTable, free);
+   fclose(psFile);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Test loading a binary file of iBindingCount records. */
+
+static void testBinary(int iBindingCount)
+{
+   SymTable_T oSymTable;
+   FILE *psFile;
+   char acKey[MAX_KEY_LENGTH];
+   int *piValue;
+   int iMadeCount = 0;
+   int i;
+   int iSuccessful;
+
+   printf("------------------------------------------------------\n");
+   printf("Testing a binary file of %d records.\n", iBindingCount);
+   printf("No output should appear here:\n");
+   fflush(stdout);
+
+   psFile = tmpfile();
+   ASSURE(psFile != NULL);
+   if (psFile == NULL)
+      return;
+
+   for (i = 0; i < iBindingCount; i++)
+   {
+      sprintf(acKey, "%d", i);
+      writeRecord(psFile, acKey, &i, sizeof(int));
+   }
+   rewind(psFile);
+
+   oSymTable = SymTable_new();
+   ASSURE(oSymTable != NULL);
+
+   iSuccessful = SymTable_loadStream(oSymTable, psFile,
+                                     SYMTABLE_BINARY, makeBinaryValue,
+                                     &iMadeCount);
+   ASSURE(iSuccessful);
+   ASSURE(SymTable_getLength(oSymTable) == (size_t)iBindingCount);
+   ASSURE(iMadeCount == iBindingCount);
+
+   for (i = 0; i < iBindingCount; i++)
+   {
+      sprintf(acKey, "%d", i);
+      piValue = (int*)SymTable_get(oSymTable, acKey);
+      ASSURE((piValue != NULL) && (*piValue == i));
+   }
+
+   SymTable_freeWith(oSymTable, free);
+   fclose(psFile);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Test files that cannot be loaded. */
+
+static void testErrors(void)
+{
+   enum {LONG_LINE_LENGTH = 3 << 20};
+
+   SymTable_T oSymTable;
+   FILE *psFile;
+   char *pcValue;
+   size_t uKeySize;
+   size_t uValueSize;
+   int iValue = 7;
+   int iMadeCount = 0;
+   int i;
+   int iSuccessful;
+
+   printf("------------------------------------------------------\n");
+   printf("Testing files that cannot be loaded.\n");
+   printf("No output should appear here:\n");
+   fflush(stdout);
+
+   oSymTable = SymTable_new();
+   ASSURE(oSymTable != NULL);
+
+   /* A key that is already bound stops the load, but the lines
+      before it stay bound. */
+   psFile = tmpfile();
+   ASSURE(psFile != NULL);
+   if (psFile == NULL)
+      return;
+   fputs("a\t1\nb\nc\t3\na\t4\nd\t5\n", psFile);
+   rewind(psFile);
+   iSuccessful = SymTable_loadStream(oSymTable, psFile, SYMTABLE_TEXT,
+                                     NULL, NULL);
+   ASSURE(! iSuccessful);
+   ASSURE(SymTable_getLength(oSymTable) == 3);
+   ASSURE(SymTable_contains(oSymTable, "b"));
+   ASSURE(SymTable_get(oSymTable, "c") == NULL);
+   ASSURE(! SymTable_contains(oSymTable, "d"));
+   fclose(psFile);
+
+   /* A file may not end within a record. */
+   SymTable_clear(oSymTable, NULL);
+   psFile = tmpfile();
+   ASSURE(psFile != NULL);
+   if (psFile == NULL)
+      return;
+   writeRecord(psFile, "whole", &iValue, sizeof(int));
+   uKeySize = sizeof("cut");
+   uValueSize = sizeof(int);
+   fwrite(&uKeySize, sizeof(size_t), 1, psFile);
+   fwrite(&uValueSize, sizeof(size_t), 1, psFile);
+   fwrite("cut", 1, uKeySize, psFile);
+   fwrite(&iValue, 1, uValueSize - 1, psFile);
+   rewind(psFile);
+   iSuccessful = SymTable_loadStream(oSymTable, psFile,
+                                     SYMTABLE_BINARY, makeBinaryValue,
+                                     &iMadeCount);
+   ASSURE(! iSuccessful);
+   ASSURE(SymTable_getLength(oSymTable) == 1);
+   ASSURE(iMadeCount == 1);
+   SymTable_clear(oSymTable, free);
+   fclose(psFile);
+
+   /* A key must end with its '\0'. */
+   psFile = tmpfile();
+   ASSURE(psFile != NULL);
+   if (psFile == NULL)
+      return;
+   uKeySize = 2;
+   uValueSize = 0;
+   fwrite(&uKeySize, sizeof(size_t), 1, psFile);
+   fwrite(&uValueSize, sizeof(size_t), 1, psFile);
+   fwrite("ab", 1, uKeySize, psFile);
+   rewind(psFile);
+   iSuccessful = SymTable_loadStream(oSymTable, psFile,
+                                     SYMTABLE_BINARY, NULL, NULL);
+   ASSURE(! iSuccessful);
+   ASSURE(SymTable_getLength(oSymTable) == 0);
+   fclose(psFile);
+
+   /* A line that is too long to be parsed. */
+   psFile = tmpfile();
+   ASSURE(psFile != NULL);
+   if (psFile == NULL)
+      return;
+   fputs("short\t1\n", psFile);
+   for (i = 0; i < LONG_LINE_LENGTH; i++)
+      fputc('k', psFile);
+   fputs("\t2\n", psFile);
+   rewind(psFile);
+   iSuccessful = SymTable_loadStream(oSymTable, psFile, SYMTABLE_TEXT,
+                                     NULL, NULL);
+   ASSURE(! iSuccessful);
+   ASSURE(SymTable_contains(oSymTable, "short"));
+   fclose(psFile);
+
+   pcValue = (char*)malloc(MAX_RECORD_SIZE + 1);
+   ASSURE(pcValue != NULL);
+   if (pcValue == NULL)
+      return;
+   memset(pcValue, 'v', MAX_RECORD_SIZE);
+   pcValue[MAX_RECORD_SIZE] = '\0';
+
+   /* A line may take the whole limit, but no more, even when it fits
+      in one read. */
+   SymTable_clear(oSymTable, NULL);
+   psFile = tmpfile();
+   ASSURE(psFile != NULL);
+   if (psFile == NULL)
+      return;
+   fprintf(psFile, "full\t%s\n",
+           pcValue + sizeof("full\t") - 1);
+   fprintf(psFile, "over\t%s\n", pcValue + sizeof("over") - 1);
+   fputs("after\t3\n", psFile);
+   rewind(psFile);
+   iSuccessful = SymTable_loadStream(oSymTable, psFile, SYMTABLE_TEXT,
+                                     NULL, NULL);
+   ASSURE(! iSuccessful);
+   ASSURE(SymTable_contains(oSymTable, "full"));
+   ASSURE(! SymTable_contains(oSymTable, "over"));
+   ASSURE(! SymTable_contains(oSymTable, "after"));
+   fclose(psFile);
+
+   /* So may a record, its sizes included, though its key and value
+      are each within the limit. */
+   SymTable_clear(oSymTable, NULL);
+   psFile = tmpfile();
+   ASSURE(psFile != NULL);
+   if (psFile == NULL)
+      return;
+   writeRecord(psFile, "full", pcValue, MAX_RECORD_SIZE -
+               2 * sizeof(size_t) - sizeof("full"));
+   writeRecord(psFile, "over", pcValue, MAX_RECORD_SIZE -
+               2 * sizeof(size_t) - sizeof("over") + 1);
+   writeRecord(psFile, "after", &iValue, sizeof(int));
+   rewind(psFile);
+   iSuccessful = SymTable_loadStream(oSymTable, psFile,
+                                     SYMTABLE_BINARY, NULL, NULL);
+   ASSURE(! iSuccessful);
+   ASSURE(SymTable_getLength(oSymTable) == 1);
+   ASSURE(SymTable_contains(oSymTable, "full"));
+   fclose(psFile);
+
+   free(pcValue);
+   SymTable_free(oSymTable);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Test the streaming loader. As always, argc is the command-line
+   argument count and argv contains the command-line arguments.
+   argv[1] is the number of bindings of each file. Exit with
+   EXIT_FAILURE if argv[1] is missing or not numeric. Otherwise
+   return 0. */
+
+int main(int argc, char *argv[])
+{
+   int iBindingCount;
+
+   if ((argc != 2) || (sscanf(argv[1], "%d", &iBindingCount) != 1) ||
+       (iBindingCount < 0))
+   {
+      fprintf(stderr, "Usage: %s bindingcount\n", argv[0]);
+      exit(EXIT_FAILURE);
+   }
+
+   testText(iBindingCount);
+   testBinary(iBindingCount);
+   testErrors();
+
+   printf("------------------------------------------------------\n");
+   printf("End of %s.\n", argv[0]);
+   return 0;
+}
@@ -0,0 +1,324 @@
+/*--------------------------------------------------------------------*/
+/* testmapped.c                                                       */
+/* Author: Julio Lins (jcclb)                                         */
+/*--------------------------------------------------------------------*/
+
+#include "symtablemapped.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+/*--------------------------------------------------------------------*/
+
+#define ASSURE(i) assure(i, __LINE__)
+
+/* File the tests write their images to */
+
+static const char acImageFile[] = "testmapped.img";
+
+/*--------------------------------------------------------------------*/
+
+/* If !iSuccessful, print a message to stdout indicating that the
+   test at line iLineNum failed. */
+
+static void assure(int iSuccessful, int iLineNum)
+{
+   if (! iSuccessful)
+   {
+      printf("Test at line %d failed.\n", iLineNum);
+      fflush(stdout);
+   }
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Return the size of pvValue, a string, including its '\0'. pcKey is
+   unused. */
+
+static size_t stringSize(const char *pcKey, const void *pvValue)
+{
+   assert(pcKey != NULL);
+   assert(pvValue != NULL);
+
+   return strlen((const char*)pvValue) + 1;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Return the size of the double that pvValue points to.  pcKey is
+   unused. */
+
+static size_t doubleSize(const char *pcKey, const void *pvValue)
+{
+   assert(pcKey != NULL);
+   assert(pvValue != NULL);
+
+   return sizeof(double);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Test saving and mapping small and empty tables. */
+
+static void testBasics(void)
+{
+   SymTable_T oSymTable;
+   SymTableMapped_T oSymTableMapped;
+   double dAverage = 0.342;
+   const void *pvValue;
+   int iSuccessful;
+   FILE *psFile;
+
+   printf("------------------------------------------------------\n");
+   printf("Testing saved and mapped images.\n");
+   printf("No output should appear here:\n");
+   fflush(stdout);
+
+   /* An empty table maps to an empty view. */
+   oSymTable = SymTable_new();
+   ASSURE(oSymTable != NULL);
+   iSuccessful = SymTable_save(oSymTable, acImageFile, stringSize);
+   ASSURE(iSuccessful);
+   oSymTableMapped = SymTable_openMapped(acImageFile);
+   ASSURE(oSymTableMapped != NULL);
+   if (oSymTableMapped != NULL)
+   {
+      ASSURE(SymTableMapped_getLength(oSymTableMapped) == 0);
+      ASSURE(! SymTableMapped_contains(oSymTableMapped, "Ruth"));
+      SymTableMapped_close(oSymTableMapped);
+   }
+
+   /* Values are copied byte for byte, aligned, and NULL stays
+      NULL. */
+   iSuccessful = SymTable_put(oSymTable, "Ruth", &dAverage);
+   ASSURE(iSuccessful);
+   iSuccessful = SymTable_put(oSymTable, "", NULL);
+   ASSURE(iSuccessful);
+   iSuccessful = SymTable_save(oSymTable, acImageFile, doubleSize);
+   ASSURE(iSuccessful);
+   SymTable_free(oSymTable);
+
+   oSymTableMapped = SymTable_openMapped(acImageFile);
+   ASSURE(oSymTableMapped != NULL);
+   if (oSymTableMapped != NULL)
+   {
+      ASSURE(SymTableMapped_getLength(oSymTableMapped) == 2);
+      pvValue = SymTableMapped_get(oSymTableMapped, "Ruth");
+      ASSURE(pvValue != NULL);
+      ASSURE(pvValue != (const void*)&dAverage);
+      ASSURE((pvValue != NULL) && (*(const double*)pvValue == 0.342));
+      ASSURE(SymTableMapped_contains(oSymTableMapped, ""));
+      ASSURE(SymTableMapped_get(oSymTableMapped, "") == NULL);
+      ASSURE(! SymTableMapped_contains(oSymTableMapped, "Gehrig"));
+      ASSURE(SymTableMapped_get(oSymTableMapped, "Gehrig") == NULL);
+      SymTableMapped_close(oSymTableMapped);
+   }
+
+   /* A file that is not an image is rejected. */
+   psFile = fopen(acImageFile, "wb");
+   ASSURE(psFile != NULL);
+   if (psFile != NULL)
+   {
+      fputs("not an image", psFile);
+      fclose(psFile);
+   }
+   ASSURE(SymTable_openMapped(acImageFile) == NULL);
+
+   remove(acImageFile);
+   ASSURE(SymTable_openMapped(acImageFile) == NULL);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Save an image of the bindings of "a", "b" and "c" to "A", "B" and
+   "C", then overwrite the word at byte lOffset of the file with
+   uWord, and check that the image is rejected. */
+
+static void checkCorruptImage(long lOffset, size_t uWord)
+{
+   SymTable_T oSymTable;
+   FILE *psFile;
+
+   oSymTable = SymTable_new();
+   ASSURE(oSymTable != NULL);
+   if (oSymTable == NULL)
+      return;
+   ASSURE(SymTable_put(oSymTable, "a", "A"));
+   ASSURE(SymTable_put(oSymTable, "b", "B"));
+   ASSURE(SymTable_put(oSymTable, "c", "C"));
+   ASSURE(SymTable_save(oSymTable, acImageFile, stringSize));
+   SymTable_free(oSymTable);
+
+   psFile = fopen(acImageFile, "r+b");
+   ASSURE(psFile != NULL);
+   if (psFile == NULL)
+      return;
+   ASSURE(fseek(psFile, lOffset, SEEK_SET) == 0);
+   ASSURE(fwrite(&uWord, sizeof(size_t), 1, psFile) == 1);
+   fclose(psFile);
+
+   ASSURE(SymTable_openMapped(acImageFile) == NULL);
+   remove(acImageFile);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Test that images whose offsets lead out of them are rejected, and
+   that saving over a mapped image leaves the mapping as it was. */
+
+static void testCorruptImages(void)
+{
+   /* The layout of symtablemapped.c: a header of 8 characters and 4
+      words, 4 bucket starts for the 3 bindings, then Bindings of a
+      hash code, a key offset and a value offset, then values aligned
+      to 16 bytes */
+   const long lStarts = 8 + 4 * (long)sizeof(size_t);
+   const long lBindings = lStarts + 4 * (long)sizeof(size_t);
+   const long lValues = (lBindings + 9 * (long)sizeof(size_t) + 15) /
+      16 * 16;
+
+   SymTable_T oSymTable;
+   SymTableMapped_T oSymTableMapped;
+   const char *pcMapped;
+
+   printf("------------------------------------------------------\n");
+   printf("Testing corrupt and replaced images.\n");
+   printf("No output should appear here:\n");
+   fflush(stdout);
+
+   /* A bucket that starts past the Bindings or before the bucket
+      before it */
+   checkCorruptImage(lStarts + (long)sizeof(size_t), 1000);
+   checkCorruptImage(lStarts + 2 * (long)sizeof(size_t), 0);
+
+   /* Key and value offsets past the end of the image */
+   checkCorruptImage(lBindings + (long)sizeof(size_t), 100000);
+   checkCorruptImage(lBindings + 2 * (long)sizeof(size_t), 100000);
+
+   /* A misaligned value offset */
+   checkCorruptImage(lBindings + 2 * (long)sizeof(size_t),
+                     (size_t)lValues + 1);
+
+   /* The mapping of an image goes on reading it after a save. */
+   oSymTable = SymTable_new();
+   ASSURE(oSymTable != NULL);
+   if (oSymTable == NULL)
+      return;
+   ASSURE(SymTable_put(oSymTable, "old", "old"));
+   ASSURE(SymTable_save(oSymTable, acImageFile, stringSize));
+   oSymTableMapped = SymTable_openMapped(acImageFile);
+   ASSURE(oSymTableMapped != NULL);
+
+   ASSURE(SymTable_remove(oSymTable, "old") != NULL);
+   ASSURE(SymTable_put(oSymTable, "new", "new"));
+   ASSURE(SymTable_save(oSymTable, acImageFile, stringSize));
+   SymTable_free(oSymTable);
+
+   if (oSymTableMapped != NULL)
+   {
+      pcMapped = (const char*)SymTableMapped_get(oSymTableMapped,
+                                                 "old");
+      ASSURE((pcMapped != NULL) && (strcmp(pcMapped, "old") == 0));
+      ASSURE(! SymTableMapped_contains(oSymTableMapped, "new"));
+      SymTableMapped_close(oSymTableMapped);
+   }
+
+   oSymTableMapped = SymTable_openMapped(acImageFile);
+   ASSURE(oSymTableMapped != NULL);
+   if (oSymTableMapped != NULL)
+   {
+      ASSURE(SymTableMapped_contains(oSymTableMapped, "new"));
+      ASSURE(! SymTableMapped_contains(oSymTableMapped, "old"));
+      SymTableMapped_close(oSymTableMapped);
+   }
+   remove(acImageFile);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Test an image of iBindingCount bindings.  Each binding's key and
+   value contain the same characters. */
+
+static void testLargeImage(int iBindingCount)
+{
+   enum {MAX_KEY_LENGTH = 16};
+
+   SymTable_T oSymTable;
+   SymTableMapped_T oSymTableMapped;
+   char acKey[MAX_KEY_LENGTH];
+   char *pcValue;
+   const char *pcMapped;
+   int iSuccessful;
+   int i;
+
+   printf("------------------------------------------------------\n");
+   printf("Testing a potentially large image.\n");
+   printf("No output should appear here:\n");
+   fflush(stdout);
+
+   oSymTable = SymTable_new();
+   ASSURE(oSymTable != NULL);
+
+   for (i = 0; i < iBindingCount; i++)
+   {
+      sprintf(acKey, "%d", i);
+      pcValue = (char*)malloc(strlen(acKey) + 1);
+      ASSURE(pcValue != NULL);
+      strcpy(pcValue, acKey);
+      iSuccessful = SymTable_put(oSymTable, acKey, pcValue);
+      ASSURE(iSuccessful);
+   }
+
+   iSuccessful = SymTable_save(oSymTable, acImageFile, stringSize);
+   ASSURE(iSuccessful);
+   SymTable_freeWith(oSymTable, free);
+
+   oSymTableMapped = SymTable_openMapped(acImageFile);
+   ASSURE(oSymTableMapped != NULL);
+   if (oSymTableMapped == NULL)
+      return;
+
+   ASSURE(SymTableMapped_getLength(oSymTableMapped) ==
+          (size_t)iBindingCount);
+
+   for (i = 0; i < iBindingCount; i++)
+   {
+      sprintf(acKey, "%d", i);
+      pcMapped = (const char*)SymTableMapped_get(oSymTableMapped, acKey);
+      ASSURE((pcMapped != NULL) && (strcmp(pcMapped, acKey) == 0));
+   }
+   sprintf(acKey, "%d", -1);
+   ASSURE(! SymTableMapped_contains(oSymTableMapped, acKey));
+
+   SymTableMapped_close(oSymTableMapped);
+   remove(acImageFile);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Test the SymTable image functions. As always, argc is the
+   command-line argument count and argv contains the command-line
+   arguments. argv[1] is the number of bindings to save. Exit with
+   EXIT_FAILURE if argv[1] is missing or not numeric. Otherwise
+   return 0. */
+
+int main(int argc, char *argv[])
+{
+   int iBindingCount;
+
+   if ((argc != 2) || (sscanf(argv[1], "%d", &iBindingCount) != 1) ||
+       (iBindingCount < 0))
+   {
+      fprintf(stderr, "Usage: %s bindingcount\n", argv[0]);
+      exit(EXIT_FAILURE);
+   }
+
+   testBasics();
+   testCorruptImages();
+   testLargeImage(iBindingCount);
+
+   printf("------------------------------------------------------\n");
+   printf("End of %s.\n", argv[0]);
+   return 0;
+}
@@ -0,0 +1,314 @@
+/*--------------------------------------------------------------------*/
+/* testordered.c                                                      */
+/* Author: Julio Lins (jcclb)                                         */
+/*--------------------------------------------------------------------*/
+
+#include "symtableordered.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+/*--------------------------------------------------------------------*/
+
+#define ASSURE(i) assure(i, __LINE__)
+
+/*--------------------------------------------------------------------*/
+
+/* Longest key used by the tests */
+
+enum {MAX_KEY_LENGTH = 24};
+
+/*--------------------------------------------------------------------*/
+
+/* The order a table is expected to have: the ids of the keys in the
+   order they were put, each removed one marked by its position */
+
+struct Order
+{
+   /* ids, oldest first, with removed ones still in place */
+   int *piIds;
+
+   /* # of ids in piIds */
+   int iIdCount;
+
+   /* position in piIds of the binding of each id, or -1 if the id is
+      not bound */
+   int *piPositions;
+};
+
+/*--------------------------------------------------------------------*/
+
+/* A traversal in progress, checked against an Order */
+
+struct Visit
+{
+   /* expected order */
+   const struct Order *psOrder;
+
+   /* position in psOrder->piIds of the next binding expected */
+   int iNext;
+
+   /* # of bindings visited */
+   int iVisited;
+};
+
+/*--------------------------------------------------------------------*/
+
+/* If !iSuccessful, print a message to stdout indicating that the
+   test at line iLineNum failed. */
+
+static void assure(int iSuccessful, int iLineNum)
+{
+   if (! iSuccessful)
+   {
+      printf("Test at line %d failed.\n", iLineNum);
+      fflush(stdout);
+   }
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Write the key of id iId to acKey. */
+
+static void makeKey(char acKey[], int iId)
+{
+   assert(acKey != NULL);
+
+   sprintf(acKey, "key%d", iId);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Check that the binding whose key is pcKey and whose value, the
+   id of the key, is pvValue, is the next one expected by the Visit
+   pvExtra. */
+
+static void visitBinding(const char *pcKey, void *pvValue,
+                         void *pvExtra)
+{
+   struct Visit *psVisit;
+   const struct Order *psOrder;
+   char acKey[MAX_KEY_LENGTH];
+   int iId;
+
+   assert(pcKey != NULL);
+   assert(pvValue != NULL);
+   assert(pvExtra != NULL);
+
+   psVisit = (struct Visit*)pvExtra;
+   psOrder = psVisit->psOrder;
+
+   /* Skip the positions of removed bindings */
+   while ((psVisit->iNext < psOrder->iIdCount) &&
+          (psOrder->piPositions[psOrder->piIds[psVisit->iNext]] !=
+           psVisit->iNext))
+      psVisit->iNext++;
+
+   ASSURE(psVisit->iNext < psOrder->iIdCount);
+   if (psVisit->iNext >= psOrder->iIdCount)
+      return;
+
+   iId = psOrder->piIds[psVisit->iNext];
+   makeKey(acKey, iId);
+   ASSURE(strcmp(pcKey, acKey) == 0);
+   ASSURE(*(int*)pvValue == iId);
+
+   psVisit->iNext++;
+   psVisit->iVisited++;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Check that map and the iterator visit the bindings of oSymTable in
+   the order psOrder. */
+
+static void checkOrder(SymTable_T oSymTable,
+                       const struct Order *psOrder)
+{
+   struct SymTableIter sIter;
+   struct Visit sVisit;
+
+   assert(oSymTable != NULL);
+   assert(psOrder != NULL);
+
+   sVisit.psOrder = psOrder;
+   sVisit.iNext = 0;
+   sVisit.iVisited = 0;
+   SymTable_map(oSymTable, visitBinding, &sVisit);
+   ASSURE((size_t)sVisit.iVisited == SymTable_getLength(oSymTable));
+
+   sVisit.iNext = 0;
+   sVisit.iVisited = 0;
+   for (SymTable_iterBegin(oSymTable, &sIter);
+        ! SymTable_iterEnd(&sIter); SymTable_iterNext(&sIter))
+      visitBinding(sIter.pcKey, sIter.pvValue, &sVisit);
+   ASSURE((size_t)sVisit.iVisited == SymTable_getLength(oSymTable));
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Put the key of id iId into oSymTable, bound to piValues[iId], and
+   record it as the newest in psOrder. */
+
+static void putId(SymTable_T oSymTable, struct Order *psOrder,
+                  int *piValues, int iId)
+{
+   char acKey[MAX_KEY_LENGTH];
+
+   assert(oSymTable != NULL);
+   assert(psOrder != NULL);
+   assert(piValues != NULL);
+
+   makeKey(acKey, iId);
+   piValues[iId] = iId;
+   ASSURE(SymTable_put(oSymTable, acKey, &piValues[iId]));
+   psOrder->piPositions[iId] = psOrder->iIdCount;
+   psOrder->piIds[psOrder->iIdCount++] = iId;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Remove the key of id iId from oSymTable and from psOrder. */
+
+static void removeId(SymTable_T oSymTable, struct Order *psOrder,
+                     int iId)
+{
+   char acKey[MAX_KEY_LENGTH];
+
+   assert(oSymTable != NULL);
+   assert(psOrder != NULL);
+
+   makeKey(acKey, iId);
+   ASSURE(SymTable_remove(oSymTable, acKey) != NULL);
+   psOrder->piPositions[iId] = -1;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Test that a table of iBindingCount bindings keeps their insertion
+   order through replacements, removals, keys put again and the
+   rebuilds that squeeze out removed bindings. */
+
+static void testOrder(int iBindingCount)
+{
+   enum {ROUND_COUNT = 6};
+
+   SymTable_T oSymTable;
+   struct Order sOrder;
+   int *piValues;
+   int iReplaced = -1;
+   char acKey[MAX_KEY_LENGTH];
+   int iRound;
+   int i;
+
+   printf("------------------------------------------------------\n");
+   printf("Testing the order of %d bindings.\n", iBindingCount);
+   printf("No output should appear here:\n");
+   fflush(stdout);
+
+   /* Ids go up to twice the count, and each round puts at most as
+      many bindings as there are ids. */
+   sOrder.piIds = (int*)malloc(sizeof(int) * 2 * (ROUND_COUNT + 2) *
+                               (size_t)iBindingCount);
+   sOrder.piPositions = (int*)malloc(sizeof(int) * 2 *
+                                     (size_t)iBindingCount);
+   piValues = (int*)malloc(sizeof(int) * 2 * (size_t)iBindingCount);
+   ASSURE((sOrder.piIds != NULL) && (sOrder.piPositions != NULL) &&
+          (piValues != NULL));
+   if ((sOrder.piIds == NULL) || (sOrder.piPositions == NULL) ||
+       (piValues == NULL))
+      return;
+   sOrder.iIdCount = 0;
+   for (i = 0; i < 2 * iBindingCount; i++)
+      sOrder.piPositions[i] = -1;
+
+   oSymTable = SymTable_new();
+   ASSURE(oSymTable != NULL);
+   if (oSymTable == NULL)
+      return;
+
+   /* Keys are put in an order other than that of their ids. */
+   for (i = iBindingCount - 1; i >= 0; i--)
+      putId(oSymTable, &sOrder, piValues, i);
+   checkOrder(oSymTable, &sOrder);
+
+   /* A replacement keeps the place of its binding. */
+   for (i = 1; i < iBindingCount; i += 3)
+   {
+      makeKey(acKey, i);
+      ASSURE(SymTable_replace(oSymTable, acKey, &iReplaced) ==
+             &piValues[i]);
+      ASSURE(SymTable_replace(oSymTable, acKey, &piValues[i]) ==
+             &iReplaced);
+   }
+   checkOrder(oSymTable, &sOrder);
+
+   /* A removal leaves the others in place, and a key put again comes
+      last. */
+   for (i = 0; i < iBindingCount; i += 3)
+      removeId(oSymTable, &sOrder, i);
+   checkOrder(oSymTable, &sOrder);
+   for (i = 0; i < iBindingCount; i += 6)
+      putId(oSymTable, &sOrder, piValues, i);
+   checkOrder(oSymTable, &sOrder);
+
+   /* Removing most bindings, then putting keys again, fills the
+      table with removed ones, which rebuilds squeeze out. */
+   for (iRound = 0; iRound < ROUND_COUNT; iRound++)
+   {
+      for (i = 0; i < 2 * iBindingCount; i++)
+         if ((sOrder.piPositions[i] != -1) && (i % 4 != 0))
+            removeId(oSymTable, &sOrder, i);
+      checkOrder(oSymTable, &sOrder);
+      for (i = iBindingCount + iRound % 2; i < 2 * iBindingCount;
+           i += 2)
+         if (sOrder.piPositions[i] == -1)
+            putId(oSymTable, &sOrder, piValues, i);
+      checkOrder(oSymTable, &sOrder);
+      for (i = 1; i < iBindingCount; i += 4)
+         if (sOrder.piPositions[i] == -1)
+            putId(oSymTable, &sOrder, piValues, i);
+      checkOrder(oSymTable, &sOrder);
+   }
+
+   /* A cleared table starts a new order. */
+   SymTable_clear(oSymTable, NULL);
+   sOrder.iIdCount = 0;
+   for (i = 0; i < 2 * iBindingCount; i++)
+      sOrder.piPositions[i] = -1;
+   putId(oSymTable, &sOrder, piValues, 1);
+   putId(oSymTable, &sOrder, piValues, 0);
+   checkOrder(oSymTable, &sOrder);
+
+   SymTable_free(oSymTable);
+   free(sOrder.piIds);
+   free(sOrder.piPositions);
+   free(piValues);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Test the order of the insertion-ordered SymTable. As always, argc
+   is the command-line argument count and argv contains the
+   command-line arguments. argv[1] is the number of bindings to test
+   with. Exit with EXIT_FAILURE if argv[1] is missing or not numeric.
+   Otherwise return 0. */
+
+int main(int argc, char *argv[])
+{
+   int iBindingCount;
+
+   if ((argc != 2) || (sscanf(argv[1], "%d", &iBindingCount) != 1) ||
+       (iBindingCount < 1))
+   {
+      fprintf(stderr, "Usage: %s bindingcount\n", argv[0]);
+      exit(EXIT_FAILURE);
+   }
+
+   testOrder(iBindingCount);
+
+   printf("------------------------------------------------------\n");
+   printf("End of %s.\n", argv[0]);
+   return 0;
+}
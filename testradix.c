@@ -0,0 +1,477 @@
+/*--------------------------------------------------------------------*/
+/* testradix.c                                                        */
+/* Author: Julio Lins (jcclb)                                         */
+/*--------------------------------------------------------------------*/
+
+#include "symtableradix.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+/*--------------------------------------------------------------------*/
+
+#define ASSURE(i) assure(i, __LINE__)
+
+/*--------------------------------------------------------------------*/
+
+/* Longest key used by the tests */
+
+enum {MAX_KEY_LENGTH = 64};
+
+/*--------------------------------------------------------------------*/
+
+/* The keys a traversal has visited so far: how many, whether they
+   came in ascending order, and the last one */
+
+struct Visit
+{
+   size_t uCount;
+   int iInOrder;
+   char acLast[MAX_KEY_LENGTH];
+};
+
+/*--------------------------------------------------------------------*/
+
+/* If !iSuccessful, print a message to stdout indicating that the
+   test at line iLineNum failed. */
+
+static void assure(int iSuccessful, int iLineNum)
+{
+   if (! iSuccessful)
+   {
+      printf("Test at line %d failed.\n", iLineNum);
+      fflush(stdout);
+   }
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Write into acKey the qualified name of the i-th test key. Keys
+   share long prefixes, as names of methods in a package do. */
+
+static void makeKey(char acKey[], int i)
+{
+   assert(acKey != NULL);
+
+   sprintf(acKey, "org.example.project.module%d.Class%d.method%d",
+           i / 1000, i / 10 % 100, i % 10);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Record in the struct Visit pvExtra that the binding of pcKey was
+   visited. pvValue must be pcKey itself, as put by the tests. */
+
+static void visitBinding(const char *pcKey, void *pvValue,
+                         void *pvExtra)
+{
+   struct Visit *psVisit = (struct Visit*)pvExtra;
+
+   assert(pcKey != NULL);
+   assert(psVisit != NULL);
+
+   if (psVisit->uCount > 0 && strcmp(psVisit->acLast, pcKey) >= 0)
+      psVisit->iInOrder = 0;
+   ASSURE(strlen(pcKey) < MAX_KEY_LENGTH);
+   ASSURE(strcmp(pcKey, (const char*)pvValue) == 0);
+   strncpy(psVisit->acLast, pcKey, MAX_KEY_LENGTH - 1);
+   psVisit->acLast[MAX_KEY_LENGTH - 1] = '\0';
+   psVisit->uCount++;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Return the # of bindings of oSymTable whose keys start with
+   pcPrefix, checking that SymTable_prefixMap visits them in
+   ascending key order. */
+
+static size_t countPrefix(SymTable_T oSymTable, const char *pcPrefix)
+{
+   struct Visit sVisit;
+
+   assert(oSymTable != NULL);
+   assert(pcPrefix != NULL);
+
+   sVisit.uCount = 0;
+   sVisit.iInOrder = 1;
+   SymTable_prefixMap(oSymTable, pcPrefix, visitBinding, &sVisit);
+   ASSURE(sVisit.iInOrder);
+   return sVisit.uCount;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Test SymTable_prefixMap on keys that are prefixes of one another,
+   in a table made by pfNew. */
+
+static void testPrefixMap(SymTable_T (*pfNew)(void))
+{
+   static const char *apcKeys[] = {"pkg.a", "pkg.a.b", "pkg.ab",
+                                   "pkg.b", "pk", "", "qux"};
+   enum {KEY_COUNT = sizeof(apcKeys) / sizeof(apcKeys[0])};
+   SymTable_T oSymTable;
+   size_t u;
+
+   printf("------------------------------------------------------\n");
+   printf("Testing SymTable_prefixMap() with %s keys.\n",
+          pfNew == SymTable_new ? "copied" : "borrowed");
+   printf("No output should appear here:\n");
+   fflush(stdout);
+
+   oSymTable = (*pfNew)();
+   ASSURE(oSymTable != NULL);
+   if (oSymTable == NULL)
+      return;
+
+   for (u = 0; u < KEY_COUNT; u++)
+      ASSURE(SymTable_put(oSymTable, apcKeys[u], (void*)apcKeys[u]));
+
+   ASSURE(countPrefix(oSymTable, "") == KEY_COUNT);
+   ASSURE(countPrefix(oSymTable, "p") == 5);
+   ASSURE(countPrefix(oSymTable, "pkg") == 4);
+   ASSURE(countPrefix(oSymTable, "pkg.a") == 3);
+   ASSURE(countPrefix(oSymTable, "pkg.a.") == 1);
+   ASSURE(countPrefix(oSymTable, "pkg.a.b") == 1);
+   ASSURE(countPrefix(oSymTable, "pkg.a.b.c") == 0);
+   ASSURE(countPrefix(oSymTable, "pkg.c") == 0);
+   ASSURE(countPrefix(oSymTable, "q") == 1);
+   ASSURE(countPrefix(oSymTable, "z") == 0);
+
+   /* Removing "pkg.a" leaves a Node that is only a prefix. */
+   ASSURE(SymTable_remove(oSymTable, "pkg.a") == apcKeys[0]);
+   ASSURE(! SymTable_contains(oSymTable, "pkg.a"));
+   ASSURE(! SymTable_contains(oSymTable, "pkg."));
+   ASSURE(countPrefix(oSymTable, "pkg.a") == 2);
+   ASSURE(SymTable_remove(oSymTable, "pkg.a.b") == apcKeys[1]);
+   ASSURE(countPrefix(oSymTable, "pkg.a") == 1);
+   ASSURE(SymTable_get(oSymTable, "pkg.ab") == apcKeys[2]);
+   ASSURE(SymTable_get(oSymTable, "pk") == apcKeys[4]);
+   ASSURE(SymTable_get(oSymTable, "") == apcKeys[5]);
+
+   SymTable_free(oSymTable);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Check that pcKey is bound in the table pvExtra, then map over that
+   table from within this call, and check that pcKey is unchanged. */
+
+static void mapNested(const char *pcKey, void *pvValue, void *pvExtra)
+{
+   SymTable_T oSymTable = (SymTable_T)pvExtra;
+   struct Visit sVisit;
+   char acKey[MAX_KEY_LENGTH];
+
+   assert(pcKey != NULL);
+   assert(oSymTable != NULL);
+
+   (void)pvValue;
+
+   ASSURE(SymTable_contains(oSymTable, pcKey));
+   strcpy(acKey, pcKey);
+
+   sVisit.uCount = 0;
+   sVisit.iInOrder = 1;
+   SymTable_map(oSymTable, visitBinding, &sVisit);
+   ASSURE(sVisit.uCount == SymTable_getLength(oSymTable));
+
+   ASSURE(strcmp(pcKey, acKey) == 0);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Test that a map nested in another, and two iterators advanced in
+   turn, each give the right keys, on a table of iBindingCount
+   qualified names. */
+
+static void testNestedTraversals(int iBindingCount)
+{
+   SymTable_T oSymTable;
+   struct SymTableIter sIter1;
+   struct SymTableIter sIter2;
+   char *pcValue;
+   char acKey[MAX_KEY_LENGTH];
+   char acPrevious[MAX_KEY_LENGTH];
+   size_t uCount1 = 0;
+   size_t uCount2 = 0;
+   int i;
+
+   printf("------------------------------------------------------\n");
+   printf("Testing nested and interleaved traversals.\n");
+   printf("No output should appear here:\n");
+   fflush(stdout);
+
+   /* The nested map visits every binding for each one. */
+   if (iBindingCount > 200)
+      iBindingCount = 200;
+
+   oSymTable = SymTable_new();
+   ASSURE(oSymTable != NULL);
+   if (oSymTable == NULL)
+      return;
+
+   /* Values are the keys, as visitBinding expects. */
+   for (i = 0; i < iBindingCount; i++)
+   {
+      makeKey(acKey, i);
+      pcValue = (char*)malloc(strlen(acKey) + 1);
+      ASSURE(pcValue != NULL);
+      if (pcValue == NULL)
+         return;
+      strcpy(pcValue, acKey);
+      ASSURE(SymTable_put(oSymTable, acKey, pcValue));
+   }
+
+   SymTable_map(oSymTable, mapNested, oSymTable);
+
+   /* sIter2 moves two steps for each step of sIter1. */
+   SymTable_iterBegin(oSymTable, &sIter1);
+   SymTable_iterBegin(oSymTable, &sIter2);
+   acPrevious[0] = '\0';
+   while (! SymTable_iterEnd(&sIter1))
+   {
+      ASSURE(strcmp(sIter1.pcKey, (const char*)sIter1.pvValue) == 0);
+      ASSURE((uCount1 == 0) || (strcmp(acPrevious, sIter1.pcKey) < 0));
+      strcpy(acPrevious, sIter1.pcKey);
+      uCount1++;
+
+      for (i = 0; (i < 2) && ! SymTable_iterEnd(&sIter2); i++)
+      {
+         ASSURE(strcmp(sIter2.pcKey, (const char*)sIter2.pvValue)
+                == 0);
+         SymTable_iterNext(&sIter2);
+         uCount2++;
+      }
+
+      ASSURE(strcmp(sIter1.pcKey, acPrevious) == 0);
+      SymTable_iterNext(&sIter1);
+   }
+   ASSURE(uCount1 == (size_t)iBindingCount);
+   ASSURE(uCount2 == (size_t)iBindingCount);
+
+   SymTable_freeWith(oSymTable, free);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Test that iterators abandoned before their end do not make the
+   table grow, and that more iterators than the table keeps buffers
+   for still visit every binding, in order, when interleaved. Their
+   keys are not checked, since other iterators take their buffers. */
+
+static void testAbandonedIterators(int iBindingCount)
+{
+   enum {ABANDONED_COUNT = 10000};
+   enum {INTERLEAVED_COUNT = 20};
+
+   SymTable_T oSymTable;
+   struct SymTableIter *psIters;
+   struct SymTableMemory sMemory;
+   size_t uTableBytes;
+   char *pcValue;
+   char acKey[MAX_KEY_LENGTH];
+   size_t auCounts[INTERLEAVED_COUNT];
+   const char *apcPrevious[INTERLEAVED_COUNT];
+   int iMoved;
+   int i;
+   int j;
+
+   printf("------------------------------------------------------\n");
+   printf("Testing abandoned and interleaved iterators.\n");
+   printf("No output should appear here:\n");
+   fflush(stdout);
+
+   /* Interleaved iterators may each search the table at every step. */
+   if (iBindingCount > 200)
+      iBindingCount = 200;
+
+   psIters = (struct SymTableIter*)
+      calloc(ABANDONED_COUNT, sizeof(struct SymTableIter));
+   ASSURE(psIters != NULL);
+   if (psIters == NULL)
+      return;
+
+   oSymTable = SymTable_new();
+   ASSURE(oSymTable != NULL);
+   if (oSymTable == NULL)
+      return;
+
+   /* Values are the keys, as visitBinding expects. */
+   for (i = 0; i < iBindingCount; i++)
+   {
+      makeKey(acKey, i);
+      pcValue = (char*)malloc(strlen(acKey) + 1);
+      ASSURE(pcValue != NULL);
+      if (pcValue == NULL)
+         return;
+      strcpy(pcValue, acKey);
+      ASSURE(SymTable_put(oSymTable, acKey, pcValue));
+   }
+
+   /* Each iterator, at an address of its own, stops after a few
+      steps. Past the first few, the table stays the same size. */
+   uTableBytes = 0;
+   for (i = 0; i < ABANDONED_COUNT; i++)
+   {
+      SymTable_iterBegin(oSymTable, &psIters[i]);
+      for (j = 0; (j < i % 3) && ! SymTable_iterEnd(&psIters[i]); j++)
+         SymTable_iterNext(&psIters[i]);
+      if (i == INTERLEAVED_COUNT)
+      {
+         SymTable_memoryUsage(oSymTable, &sMemory);
+         uTableBytes = sMemory.uTableBytes;
+      }
+   }
+   SymTable_memoryUsage(oSymTable, &sMemory);
+   ASSURE(sMemory.uTableBytes == uTableBytes);
+
+   /* Each iterator moves in turn, so each finds its buffer taken. */
+   for (i = 0; i < INTERLEAVED_COUNT; i++)
+   {
+      SymTable_iterBegin(oSymTable, &psIters[i]);
+      auCounts[i] = 0;
+      apcPrevious[i] = "";
+   }
+   do
+   {
+      iMoved = 0;
+      for (i = 0; i < INTERLEAVED_COUNT; i++)
+      {
+         if (SymTable_iterEnd(&psIters[i]))
+            continue;
+         ASSURE(strcmp(apcPrevious[i],
+                       (const char*)psIters[i].pvValue) < 0);
+         apcPrevious[i] = (const char*)psIters[i].pvValue;
+         SymTable_iterNext(&psIters[i]);
+         auCounts[i]++;
+         iMoved = 1;
+      }
+   } while (iMoved);
+   for (i = 0; i < INTERLEAVED_COUNT; i++)
+      ASSURE(auCounts[i] == (size_t)iBindingCount);
+
+   SymTable_freeWith(oSymTable, free);
+   free(psIters);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Test a table of iBindingCount qualified names, and report the
+   memory it takes against that of the keys themselves. */
+
+static void testQualifiedNames(int iBindingCount)
+{
+   SymTable_T oSymTable;
+   struct SymTableIter sIter;
+   struct SymTableMemory sMemory;
+   struct Visit sVisit;
+   char acKey[MAX_KEY_LENGTH];
+   char **ppcKeys;
+   size_t uKeyBytes = 0;
+   size_t uTotal;
+   int i;
+
+   printf("------------------------------------------------------\n");
+   printf("Testing %d qualified names.\n", iBindingCount);
+   printf("No lines other than the memory report should appear "
+          "here:\n");
+   fflush(stdout);
+
+   ppcKeys = (char**)calloc((size_t)iBindingCount, sizeof(char*));
+   ASSURE(ppcKeys != NULL);
+   if (ppcKeys == NULL)
+      return;
+
+   oSymTable = SymTable_new();
+   ASSURE(oSymTable != NULL);
+   if (oSymTable == NULL)
+      return;
+
+   for (i = 0; i < iBindingCount; i++)
+   {
+      makeKey(acKey, i);
+      ppcKeys[i] = (char*)malloc(strlen(acKey) + 1);
+      ASSURE(ppcKeys[i] != NULL);
+      if (ppcKeys[i] == NULL)
+         return;
+      strcpy(ppcKeys[i], acKey);
+      uKeyBytes += strlen(acKey) + 1;
+      ASSURE(SymTable_put(oSymTable, acKey, ppcKeys[i]));
+      ASSURE(! SymTable_put(oSymTable, acKey, ppcKeys[i]));
+   }
+   ASSURE(SymTable_getLength(oSymTable) == (size_t)iBindingCount);
+
+   for (i = 0; i < iBindingCount; i++)
+      ASSURE(SymTable_get(oSymTable, ppcKeys[i]) == ppcKeys[i]);
+
+   /* The iterator and SymTable_map agree, in ascending order. */
+   sVisit.uCount = 0;
+   sVisit.iInOrder = 1;
+   for (SymTable_iterBegin(oSymTable, &sIter);
+        ! SymTable_iterEnd(&sIter); SymTable_iterNext(&sIter))
+      visitBinding(sIter.pcKey, sIter.pvValue, &sVisit);
+   ASSURE(sVisit.iInOrder);
+   ASSURE(sVisit.uCount == (size_t)iBindingCount);
+   ASSURE(countPrefix(oSymTable, "") == (size_t)iBindingCount);
+   ASSURE(countPrefix(oSymTable, "org.example.project.module0.") ==
+          (size_t)(iBindingCount < 1000 ? iBindingCount : 1000));
+
+   SymTable_memoryUsage(oSymTable, &sMemory);
+   uTotal = sMemory.uTableBytes + sMemory.uBindingBytes +
+      sMemory.uKeyBytes + sMemory.uOverheadBytes;
+   printf("Key characters:   %lu bytes\n", (unsigned long)uKeyBytes);
+   printf("Label characters: %lu bytes\n",
+          (unsigned long)sMemory.uKeyBytes);
+   printf("Whole table:      %lu bytes, %.1f per binding\n",
+          (unsigned long)uTotal, (double)uTotal / iBindingCount);
+
+   /* Remove every other key, then the rest. */
+   for (i = 0; i < iBindingCount; i += 2)
+      ASSURE(SymTable_remove(oSymTable, ppcKeys[i]) == ppcKeys[i]);
+   for (i = 0; i < iBindingCount; i++)
+      ASSURE(SymTable_contains(oSymTable, ppcKeys[i]) == (i % 2));
+   ASSURE(countPrefix(oSymTable, "") == (size_t)(iBindingCount / 2));
+   for (i = 1; i < iBindingCount; i += 2)
+      ASSURE(SymTable_remove(oSymTable, ppcKeys[i]) == ppcKeys[i]);
+   ASSURE(SymTable_getLength(oSymTable) == 0);
+
+   /* Only the root is left. */
+   SymTable_memoryUsage(oSymTable, &sMemory);
+   ASSURE(sMemory.uKeyBytes == 0);
+
+   SymTable_free(oSymTable);
+   for (i = 0; i < iBindingCount; i++)
+      free(ppcKeys[i]);
+   free(ppcKeys);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Test the radix tree implementation of SymTable. As always, argc is
+   the command-line argument count and argv contains the command-line
+   arguments. argv[1] is the number of bindings to test with. Exit
+   with EXIT_FAILURE if argv[1] is missing or not numeric. Otherwise
+   return 0. */
+
+int main(int argc, char *argv[])
+{
+   int iBindingCount;
+
+   if ((argc != 2) || (sscanf(argv[1], "%d", &iBindingCount) != 1) ||
+       (iBindingCount < 1))
+   {
+      fprintf(stderr, "Usage: %s bindingcount\n", argv[0]);
+      exit(EXIT_FAILURE);
+   }
+
+   testPrefixMap(SymTable_new);
+   testPrefixMap(SymTable_newBorrowedKeys);
+   testQualifiedNames(iBindingCount);
+   testNestedTraversals(iBindingCount);
+   testAbandonedIterators(iBindingCount);
+
+   printf("------------------------------------------------------\n");
+   printf("End of %s.\n", argv[0]);
+   return 0;
+}
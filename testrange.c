@@ -0,0 +1,294 @@
+/*--------------------------------------------------------------------*/
+/* testrange.c                                                        */
+/* Author: Julio Lins (jcclb)                                         */
+/*--------------------------------------------------------------------*/
+
+#include "symtabletree.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+/*--------------------------------------------------------------------*/
+
+#define ASSURE(i) assure(i, __LINE__)
+
+/*--------------------------------------------------------------------*/
+
+/* If !iSuccessful, print a message to stdout indicating that the
+   test at line iLineNum failed. */
+
+static void assure(int iSuccessful, int iLineNum)
+{
+   if (! iSuccessful)
+   {
+      printf("Test at line %d failed.\n", iLineNum);
+      fflush(stdout);
+   }
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Append pcKey and a space to the string buffer pvExtra. pvValue is
+   unused. */
+
+static void appendKey(const char *pcKey, void *pvValue, void *pvExtra)
+{
+   assert(pcKey != NULL);
+   assert(pvExtra != NULL);
+
+   (void)pvValue;
+
+   strcat((char*)pvExtra, pcKey);
+   strcat((char*)pvExtra, " ");
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Increment the counter of type size_t pointed to by pvExtra. pcKey
+   and pvValue are unused. */
+
+static void countBinding(const char *pcKey, void *pvValue,
+   void *pvExtra)
+{
+   assert(pcKey != NULL);
+   assert(pvExtra != NULL);
+
+   (void)pvValue;
+
+   (*(size_t*)pvExtra)++;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Test SymTable_rangeMap() and SymTable_prefixMap() on a few
+   words. */
+
+static void testWords(void)
+{
+   enum {BUFFER_LENGTH = 100};
+
+   SymTable_T oSymTable;
+   char acBuffer[BUFFER_LENGTH];
+   int iSuccessful;
+
+   printf("------------------------------------------------------\n");
+   printf("Testing range and prefix queries on a few words.\n");
+   printf("No output should appear here:\n");
+   fflush(stdout);
+
+   oSymTable = SymTable_new();
+   ASSURE(oSymTable != NULL);
+
+   iSuccessful = SymTable_put(oSymTable, "cane", NULL);
+   ASSURE(iSuccessful);
+   iSuccessful = SymTable_put(oSymTable, "band", NULL);
+   ASSURE(iSuccessful);
+   iSuccessful = SymTable_put(oSymTable, "apple", NULL);
+   ASSURE(iSuccessful);
+   iSuccessful = SymTable_put(oSymTable, "bandana", NULL);
+   ASSURE(iSuccessful);
+   iSuccessful = SymTable_put(oSymTable, "can", NULL);
+   ASSURE(iSuccessful);
+   iSuccessful = SymTable_put(oSymTable, "banana", NULL);
+   ASSURE(iSuccessful);
+   iSuccessful = SymTable_put(oSymTable, "apricot", NULL);
+   ASSURE(iSuccessful);
+
+   acBuffer[0] = '\0';
+   SymTable_map(oSymTable, appendKey, acBuffer);
+   ASSURE(strcmp(acBuffer,
+      "apple apricot banana band bandana can cane ") == 0);
+
+   acBuffer[0] = '\0';
+   SymTable_prefixMap(oSymTable, "ban", appendKey, acBuffer);
+   ASSURE(strcmp(acBuffer, "banana band bandana ") == 0);
+
+   acBuffer[0] = '\0';
+   SymTable_prefixMap(oSymTable, "band", appendKey, acBuffer);
+   ASSURE(strcmp(acBuffer, "band bandana ") == 0);
+
+   acBuffer[0] = '\0';
+   SymTable_prefixMap(oSymTable, "z", appendKey, acBuffer);
+   ASSURE(strcmp(acBuffer, "") == 0);
+
+   acBuffer[0] = '\0';
+   SymTable_prefixMap(oSymTable, "", appendKey, acBuffer);
+   ASSURE(strcmp(acBuffer,
+      "apple apricot banana band bandana can cane ") == 0);
+
+   acBuffer[0] = '\0';
+   SymTable_rangeMap(oSymTable, "apricot", "band", appendKey, acBuffer);
+   ASSURE(strcmp(acBuffer, "apricot banana band ") == 0);
+
+   acBuffer[0] = '\0';
+   SymTable_rangeMap(oSymTable, "b", "c", appendKey, acBuffer);
+   ASSURE(strcmp(acBuffer, "banana band bandana ") == 0);
+
+   acBuffer[0] = '\0';
+   SymTable_rangeMap(oSymTable, "d", "a", appendKey, acBuffer);
+   ASSURE(strcmp(acBuffer, "") == 0);
+
+   SymTable_free(oSymTable);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Test ordered traversal and range queries on a SymTable object with
+   iBindingCount bindings, enough to make the tree several levels
+   deep, while half of them are removed. */
+
+static void testManyKeys(int iBindingCount)
+{
+   enum {MAX_KEY_LENGTH = 16};
+
+   SymTable_T oSymTable;
+   struct SymTableIter sIter;
+   char acKey[MAX_KEY_LENGTH];
+   char acPrevious[MAX_KEY_LENGTH];
+   int i;
+   int iSuccessful;
+   size_t uCount;
+
+   printf("------------------------------------------------------\n");
+   printf("Testing ordered traversal of %d bindings.\n", iBindingCount);
+   printf("No output should appear here:\n");
+   fflush(stdout);
+
+   oSymTable = SymTable_new();
+   ASSURE(oSymTable != NULL);
+
+   /* Zero-padded keys sort in numeric order. */
+   for (i = 0; i < iBindingCount; i++)
+   {
+      sprintf(acKey, "%08d",
+              (int)(((long)i * 7919) % iBindingCount));
+      iSuccessful = SymTable_put(oSymTable, acKey, NULL);
+      ASSURE(iSuccessful);
+   }
+
+   for (i = 0; i < iBindingCount; i += 2)
+   {
+      sprintf(acKey, "%08d", i);
+      ASSURE(SymTable_contains(oSymTable, acKey));
+      (void)SymTable_remove(oSymTable, acKey);
+   }
+
+   uCount = 0;
+   acPrevious[0] = '\0';
+   for (SymTable_iterBegin(oSymTable, &sIter);
+        ! SymTable_iterEnd(&sIter);
+        SymTable_iterNext(&sIter))
+   {
+      ASSURE(strcmp(acPrevious, sIter.pcKey) < 0);
+      ASSURE(atoi(sIter.pcKey) % 2 == 1);
+      strcpy(acPrevious, sIter.pcKey);
+      uCount++;
+   }
+   ASSURE(uCount == SymTable_getLength(oSymTable));
+   ASSURE(uCount == (size_t)(iBindingCount / 2));
+
+   /* Keys 00000100 through 00000199 hold 50 odd numbers. */
+   if (iBindingCount >= 200)
+   {
+      uCount = 0;
+      SymTable_rangeMap(oSymTable, "00000100", "00000199",
+                        countBinding, &uCount);
+      ASSURE(uCount == 50);
+
+      uCount = 0;
+      SymTable_prefixMap(oSymTable, "000001", countBinding, &uCount);
+      ASSURE(uCount == 50);
+   }
+
+   SymTable_free(oSymTable);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Test that removing a key that is absent, after a removal has left
+   the root with the fewest Bindings allowed, keeps every binding
+   reachable by the iterator and map. */
+
+static void testRemoveAbsent(void)
+{
+   enum {MAX_KEY_LENGTH = 8};
+   enum {KEY_COUNT = 32};
+
+   SymTable_T oSymTable;
+   struct SymTableIter sIter;
+   char acKey[MAX_KEY_LENGTH];
+   int i;
+   size_t uCount;
+
+   printf("------------------------------------------------------\n");
+   printf("Testing removal of an absent key.\n");
+   printf("No output should appear here:\n");
+   fflush(stdout);
+
+   oSymTable = SymTable_new();
+   ASSURE(oSymTable != NULL);
+   if (oSymTable == NULL)
+      return;
+
+   /* 32 keys split the root into two minimal children. */
+   for (i = 0; i < KEY_COUNT; i++)
+   {
+      sprintf(acKey, "k%03d", i);
+      ASSURE(SymTable_put(oSymTable, acKey, NULL));
+   }
+   ASSURE(SymTable_remove(oSymTable, "k000") == NULL);
+   ASSURE(! SymTable_contains(oSymTable, "k000"));
+
+   /* The search for "zzz" merges the root's children. */
+   ASSURE(SymTable_remove(oSymTable, "zzz") == NULL);
+   ASSURE(SymTable_getLength(oSymTable) == KEY_COUNT - 1);
+
+   uCount = 0;
+   for (SymTable_iterBegin(oSymTable, &sIter);
+        ! SymTable_iterEnd(&sIter);
+        SymTable_iterNext(&sIter))
+      uCount++;
+   ASSURE(uCount == KEY_COUNT - 1);
+
+   uCount = 0;
+   SymTable_map(oSymTable, countBinding, &uCount);
+   ASSURE(uCount == KEY_COUNT - 1);
+
+   for (i = 1; i < KEY_COUNT; i++)
+   {
+      sprintf(acKey, "k%03d", i);
+      ASSURE(SymTable_contains(oSymTable, acKey));
+   }
+
+   SymTable_free(oSymTable);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Test the ordered operations of the B-tree SymTable implementation.
+   As always, argc is the command-line argument count and argv
+   contains the command-line arguments. argv[1] is the number of
+   bindings to put into a large SymTable object. Exit with
+   EXIT_FAILURE if argv[1] is missing or not numeric. Otherwise
+   return 0. */
+
+int main(int argc, char *argv[])
+{
+   int iBindingCount;
+
+   if ((argc != 2) || (sscanf(argv[1], "%d", &iBindingCount) != 1) ||
+       (iBindingCount < 0))
+   {
+      fprintf(stderr, "Usage: %s bindingcount\n", argv[0]);
+      exit(EXIT_FAILURE);
+   }
+
+   testWords();
+   testManyKeys(iBindingCount);
+   testRemoveAbsent();
+
+   printf("------------------------------------------------------\n");
+   printf("End of %s.\n", argv[0]);
+   return 0;
+}
@@ -0,0 +1,231 @@
+/*--------------------------------------------------------------------*/
+/* testscope.c                                                        */
+/* Author: Julio Lins (jcclb)                                         */
+/*--------------------------------------------------------------------*/
+
+#include "symtablescope.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+/*--------------------------------------------------------------------*/
+
+#define ASSURE(i) assure(i, __LINE__)
+
+/*--------------------------------------------------------------------*/
+
+/* If !iSuccessful, print a message to stdout indicating that the
+   test at line iLineNum failed. */
+
+static void assure(int iSuccessful, int iLineNum)
+{
+   if (! iSuccessful)
+   {
+      printf("Test at line %d failed.\n", iLineNum);
+      fflush(stdout);
+   }
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Test shadowing across nested scopes. */
+
+static void testShadowing(void)
+{
+   SymTable_T oSymTable;
+   char acGlobal[] = "global";
+   char acOuter[] = "outer";
+   char acInner[] = "inner";
+   char *pcValue;
+   size_t uDepth;
+   int iSuccessful;
+
+   printf("------------------------------------------------------\n");
+   printf("Testing shadowing across nested scopes.\n");
+   printf("No output should appear here:\n");
+   fflush(stdout);
+
+   oSymTable = SymTable_new();
+   ASSURE(oSymTable != NULL);
+   ASSURE(SymTable_getScopeDepth(oSymTable) == 0);
+
+   iSuccessful = SymTable_put(oSymTable, "x", acGlobal);
+   ASSURE(iSuccessful);
+   iSuccessful = SymTable_put(oSymTable, "y", acGlobal);
+   ASSURE(iSuccessful);
+
+   iSuccessful = SymTable_pushScope(oSymTable);
+   ASSURE(iSuccessful);
+   ASSURE(SymTable_getScopeDepth(oSymTable) == 1);
+
+   /* An inner scope may bind a key again, but only once. */
+   iSuccessful = SymTable_put(oSymTable, "x", acOuter);
+   ASSURE(iSuccessful);
+   iSuccessful = SymTable_put(oSymTable, "x", acOuter);
+   ASSURE(! iSuccessful);
+
+   iSuccessful = SymTable_pushScope(oSymTable);
+   ASSURE(iSuccessful);
+
+   iSuccessful = SymTable_put(oSymTable, "x", acInner);
+   ASSURE(iSuccessful);
+   iSuccessful = SymTable_put(oSymTable, "z", acInner);
+   ASSURE(iSuccessful);
+
+   pcValue = (char*)SymTable_lookupNearest(oSymTable, "x", &uDepth);
+   ASSURE(pcValue == acInner);
+   ASSURE(uDepth == 2);
+
+   pcValue = (char*)SymTable_lookupNearest(oSymTable, "y", &uDepth);
+   ASSURE(pcValue == acGlobal);
+   ASSURE(uDepth == 0);
+
+   pcValue = (char*)SymTable_get(oSymTable, "x");
+   ASSURE(pcValue == acInner);
+
+   /* Shadowed bindings are not counted. */
+   ASSURE(SymTable_getLength(oSymTable) == 3);
+
+   SymTable_popScope(oSymTable);
+   ASSURE(SymTable_getScopeDepth(oSymTable) == 1);
+
+   pcValue = (char*)SymTable_get(oSymTable, "x");
+   ASSURE(pcValue == acOuter);
+   ASSURE(! SymTable_contains(oSymTable, "z"));
+   ASSURE(SymTable_getLength(oSymTable) == 2);
+
+   /* Removing the nearest binding uncovers the one it shadows. */
+   pcValue = (char*)SymTable_remove(oSymTable, "x");
+   ASSURE(pcValue == acOuter);
+   pcValue = (char*)SymTable_get(oSymTable, "x");
+   ASSURE(pcValue == acGlobal);
+   ASSURE(SymTable_getLength(oSymTable) == 2);
+
+   SymTable_popScope(oSymTable);
+   ASSURE(SymTable_getScopeDepth(oSymTable) == 0);
+
+   pcValue = (char*)SymTable_get(oSymTable, "x");
+   ASSURE(pcValue == acGlobal);
+   ASSURE(SymTable_getLength(oSymTable) == 2);
+
+   /* Freeing with open scopes releases every binding. */
+   iSuccessful = SymTable_pushScope(oSymTable);
+   ASSURE(iSuccessful);
+   iSuccessful = SymTable_put(oSymTable, "y", acInner);
+   ASSURE(iSuccessful);
+
+   /* Clearing empties every scope but leaves them open. */
+   SymTable_clear(oSymTable, NULL);
+   ASSURE(SymTable_getLength(oSymTable) == 0);
+   ASSURE(SymTable_getScopeDepth(oSymTable) == 1);
+   ASSURE(! SymTable_contains(oSymTable, "x"));
+   iSuccessful = SymTable_put(oSymTable, "x", acInner);
+   ASSURE(iSuccessful);
+   SymTable_popScope(oSymTable);
+   ASSURE(SymTable_getLength(oSymTable) == 0);
+   iSuccessful = SymTable_put(oSymTable, "x", acGlobal);
+   ASSURE(iSuccessful);
+
+   SymTable_free(oSymTable);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Test iBindingCount bindings spread over deeply nested scopes. */
+
+static void testDeepNesting(int iBindingCount)
+{
+   enum {MAX_KEY_LENGTH = 16};
+   enum {SCOPE_COUNT = 100};
+
+   SymTable_T oSymTable;
+   struct SymTableIter sIter;
+   char acKey[MAX_KEY_LENGTH];
+   size_t uDepth;
+   size_t uCount;
+   int i;
+   int iScope;
+   int iSuccessful;
+
+   printf("------------------------------------------------------\n");
+   printf("Testing %d bindings in %d nested scopes.\n",
+          iBindingCount, SCOPE_COUNT);
+   printf("No output should appear here:\n");
+   fflush(stdout);
+
+   oSymTable = SymTable_new();
+   ASSURE(oSymTable != NULL);
+
+   /* Every scope binds "shared"; keys i are bound in scope i %
+      SCOPE_COUNT. */
+   for (iScope = 0; iScope < SCOPE_COUNT; iScope++)
+   {
+      if (iScope > 0)
+      {
+         iSuccessful = SymTable_pushScope(oSymTable);
+         ASSURE(iSuccessful);
+      }
+      iSuccessful = SymTable_put(oSymTable, "shared", NULL);
+      ASSURE(iSuccessful);
+      for (i = iScope; i < iBindingCount; i += SCOPE_COUNT)
+      {
+         sprintf(acKey, "%d", i);
+         iSuccessful = SymTable_put(oSymTable, acKey, NULL);
+         ASSURE(iSuccessful);
+      }
+   }
+
+   ASSURE(SymTable_getLength(oSymTable) == (size_t)iBindingCount + 1);
+
+   uCount = 0;
+   for (SymTable_iterBegin(oSymTable, &sIter);
+        ! SymTable_iterEnd(&sIter);
+        SymTable_iterNext(&sIter))
+      uCount++;
+   ASSURE(uCount == (size_t)iBindingCount + 1);
+
+   for (iScope = SCOPE_COUNT - 1; iScope > 0; iScope--)
+   {
+      (void)SymTable_lookupNearest(oSymTable, "shared", &uDepth);
+      ASSURE(uDepth == (size_t)iScope);
+      SymTable_popScope(oSymTable);
+      if (iScope < iBindingCount)
+      {
+         sprintf(acKey, "%d", iScope);
+         ASSURE(! SymTable_contains(oSymTable, acKey));
+      }
+   }
+
+   ASSURE(SymTable_getLength(oSymTable) ==
+          (size_t)((iBindingCount + SCOPE_COUNT - 1) / SCOPE_COUNT) + 1);
+
+   SymTable_free(oSymTable);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Test the scope operations of the scoped SymTable implementation.
+   As always, argc is the command-line argument count and argv
+   contains the command-line arguments. argv[1] is the number of
+   bindings to spread over the scopes. Exit with EXIT_FAILURE if
+   argv[1] is missing or not numeric. Otherwise return 0. */
+
+int main(int argc, char *argv[])
+{
+   int iBindingCount;
+
+   if ((argc != 2) || (sscanf(argv[1], "%d", &iBindingCount) != 1) ||
+       (iBindingCount < 0))
+   {
+      fprintf(stderr, "Usage: %s bindingcount\n", argv[0]);
+      exit(EXIT_FAILURE);
+   }
+
+   testShadowing();
+   testDeepNesting(iBindingCount);
+
+   printf("------------------------------------------------------\n");
+   printf("End of %s.\n", argv[0]);
+   return 0;
+}
@@ -0,0 +1,243 @@
+/*--------------------------------------------------------------------*/
+/* testshared.c                                                       */
+/* Author: Julio Lins (jcclb)                                         */
+/*--------------------------------------------------------------------*/
+
+/* getpid, fork and waitpid are POSIX, not ANSI C */
+#define _POSIX_C_SOURCE 200112L
+
+#include "symtableshared.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+
+/*--------------------------------------------------------------------*/
+
+#define ASSURE(i) assure(i, __LINE__)
+
+/*--------------------------------------------------------------------*/
+
+/* Longest name of a shared-memory segment used by the tests */
+
+enum {MAX_NAME_LENGTH = 64};
+
+/* Longest key used by the tests */
+
+enum {MAX_KEY_LENGTH = 16};
+
+/*--------------------------------------------------------------------*/
+
+/* If !iSuccessful, print a message to stdout indicating that the
+   test at line iLineNum failed. */
+
+static void assure(int iSuccessful, int iLineNum)
+{
+   if (! iSuccessful)
+   {
+      printf("Test at line %d failed.\n", iLineNum);
+      fflush(stdout);
+   }
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Test a writer and a reader of one segment within one process. */
+
+static void testBasics(const char *pcName)
+{
+   enum {CAPACITY = 4};
+   enum {POOL_SIZE = 256};
+
+   SymTableShared_T oWriter;
+   SymTableShared_T oReader;
+   double dValue = 2.5;
+   const double *pdValue;
+   int iSuccessful;
+
+   printf("------------------------------------------------------\n");
+   printf("Testing a shared table within one process.\n");
+   printf("No output should appear here:\n");
+   fflush(stdout);
+
+   oWriter = SymTableShared_create(pcName, CAPACITY, POOL_SIZE);
+   ASSURE(oWriter != NULL);
+   if (oWriter == NULL)
+      return;
+
+   /* The name is taken until it is unlinked. */
+   ASSURE(SymTableShared_create(pcName, CAPACITY, POOL_SIZE) == NULL);
+
+   oReader = SymTableShared_open(pcName);
+   ASSURE(oReader != NULL);
+   if (oReader == NULL)
+   {
+      SymTableShared_close(oWriter);
+      SymTableShared_unlink(pcName);
+      return;
+   }
+
+   ASSURE(SymTableShared_getLength(oReader) == 0);
+   ASSURE(! SymTableShared_contains(oReader, "pi"));
+
+   /* Bindings added by the writer show up in the reader. */
+   iSuccessful = SymTableShared_put(oWriter, "half", &dValue,
+                                    sizeof(dValue));
+   ASSURE(iSuccessful);
+   iSuccessful = SymTableShared_put(oWriter, "none", NULL, 0);
+   ASSURE(iSuccessful);
+   iSuccessful = SymTableShared_put(oWriter, "half", &dValue,
+                                    sizeof(dValue));
+   ASSURE(! iSuccessful);
+
+   ASSURE(SymTableShared_getLength(oReader) == 2);
+   pdValue = (const double*)SymTableShared_get(oReader, "half");
+   ASSURE((pdValue != NULL) && (*pdValue == 2.5));
+   ASSURE(SymTableShared_contains(oReader, "none"));
+   ASSURE(SymTableShared_get(oReader, "none") == NULL);
+
+   /* Values are copies. */
+   dValue = 0.0;
+   pdValue = (const double*)SymTableShared_get(oReader, "half");
+   ASSURE((pdValue != NULL) && (*pdValue == 2.5));
+
+   /* A full segment refuses new bindings. */
+   iSuccessful = SymTableShared_put(oWriter, "three", NULL, 0);
+   ASSURE(iSuccessful);
+   iSuccessful = SymTableShared_put(oWriter, "four", NULL, 0);
+   ASSURE(iSuccessful);
+   iSuccessful = SymTableShared_put(oWriter, "five", NULL, 0);
+   ASSURE(! iSuccessful);
+   ASSURE(SymTableShared_getLength(oWriter) == CAPACITY);
+
+   SymTableShared_close(oReader);
+   SymTableShared_close(oWriter);
+
+   ASSURE(SymTableShared_unlink(pcName));
+   ASSURE(SymTableShared_open(pcName) == NULL);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Look up the keys of the first bindings put by testProcesses in the
+   segment named pcName, while more are added, until all
+   iBindingCount of them are there. Return the # of failed lookups,
+   or -1 if the segment cannot be opened. */
+
+static int readWhileWriting(const char *pcName, int iBindingCount)
+{
+   SymTableShared_T oReader;
+   char acKey[MAX_KEY_LENGTH];
+   const int *piValue;
+   size_t uLength;
+   int i;
+   int iFails = 0;
+
+   oReader = SymTableShared_open(pcName);
+   if (oReader == NULL)
+      return -1;
+
+   do
+   {
+      uLength = SymTableShared_getLength(oReader);
+
+      /* Every binding counted so far must be complete. */
+      for (i = 0; i < (int)uLength; i++)
+      {
+         sprintf(acKey, "%d", i);
+         piValue = (const int*)SymTableShared_get(oReader, acKey);
+         if ((piValue == NULL) || (*piValue != i))
+            iFails++;
+      }
+   } while (uLength < (size_t)iBindingCount);
+
+   SymTableShared_close(oReader);
+   return iFails;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Test a writer process adding iBindingCount bindings while a reader
+   process looks them up. */
+
+static void testProcesses(const char *pcName, int iBindingCount)
+{
+   SymTableShared_T oWriter;
+   char acKey[MAX_KEY_LENGTH];
+   pid_t iPid;
+   int iStatus;
+   int i;
+   int iSuccessful;
+
+   printf("------------------------------------------------------\n");
+   printf("Testing %d bindings shared by two processes.\n",
+          iBindingCount);
+   printf("No output should appear here:\n");
+   fflush(stdout);
+
+   oWriter = SymTableShared_create(pcName, (size_t)iBindingCount,
+                                   (size_t)iBindingCount *
+                                   (MAX_KEY_LENGTH + 16));
+   ASSURE(oWriter != NULL);
+   if (oWriter == NULL)
+      return;
+
+   iPid = fork();
+   ASSURE(iPid != -1);
+
+   /* The child process is the reader. */
+   if (iPid == 0)
+      _exit(readWhileWriting(pcName, iBindingCount) == 0 ?
+            EXIT_SUCCESS : EXIT_FAILURE);
+
+   for (i = 0; i < iBindingCount; i++)
+   {
+      sprintf(acKey, "%d", i);
+      iSuccessful = SymTableShared_put(oWriter, acKey, &i, sizeof(i));
+      ASSURE(iSuccessful);
+   }
+
+   if (iPid != -1)
+   {
+      ASSURE(waitpid(iPid, &iStatus, 0) == iPid);
+      ASSURE(WIFEXITED(iStatus) &&
+             (WEXITSTATUS(iStatus) == EXIT_SUCCESS));
+   }
+
+   SymTableShared_close(oWriter);
+   ASSURE(SymTableShared_unlink(pcName));
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Test the shared-memory SymTable implementation. As always, argc is
+   the command-line argument count and argv contains the command-line
+   arguments. argv[1] is the number of bindings to share between
+   processes. Exit with EXIT_FAILURE if argv[1] is missing or not
+   numeric. Otherwise return 0. */
+
+int main(int argc, char *argv[])
+{
+   char acName[MAX_NAME_LENGTH];
+   int iBindingCount;
+
+   if ((argc != 2) || (sscanf(argv[1], "%d", &iBindingCount) != 1) ||
+       (iBindingCount < 0))
+   {
+      fprintf(stderr, "Usage: %s bindingcount\n", argv[0]);
+      exit(EXIT_FAILURE);
+   }
+
+   /* A name of its own, so that concurrent runs do not collide. */
+   sprintf(acName, "/testshared.%ld", (long)getpid());
+
+   testBasics(acName);
+   testProcesses(acName, iBindingCount);
+
+   printf("------------------------------------------------------\n");
+   printf("End of %s.\n", argv[0]);
+   return 0;
+}
@@ -0,0 +1,332 @@
+/*--------------------------------------------------------------------*/
+/* teststatic.c                                                       */
+/* Author: Julio Lins (jcclb)                                         */
+/*--------------------------------------------------------------------*/
+
+#include "symtablestatic.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+/*--------------------------------------------------------------------*/
+
+#define ASSURE(i) assure(i, __LINE__)
+
+/*--------------------------------------------------------------------*/
+
+/* If !iSuccessful, print a message to stdout indicating that the
+   test at line iLineNum failed. */
+
+static void assure(int iSuccessful, int iLineNum)
+{
+   if (! iSuccessful)
+   {
+      printf("Test at line %d failed.\n", iLineNum);
+      fflush(stdout);
+   }
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Test that a table holds no more bindings than its capacity, and
+   that removed and cleared bindings can be used again. */
+
+static void testCapacity(void)
+{
+   enum {CAPACITY = 4};
+   enum {KEY_POOL_SIZE = 256};
+
+   SymTable_T oSymTable;
+   char acValue[] = "value";
+   int iSuccessful;
+
+   printf("------------------------------------------------------\n");
+   printf("Testing a table of capacity %d.\n", CAPACITY);
+   printf("No output should appear here:\n");
+   fflush(stdout);
+
+   oSymTable = SymTable_newFixed(CAPACITY, KEY_POOL_SIZE);
+   ASSURE(oSymTable != NULL);
+   ASSURE(SymTable_getCapacity(oSymTable) == CAPACITY);
+
+   iSuccessful = SymTable_put(oSymTable, "a", acValue);
+   ASSURE(iSuccessful);
+   iSuccessful = SymTable_put(oSymTable, "b", acValue);
+   ASSURE(iSuccessful);
+   iSuccessful = SymTable_put(oSymTable, "c", acValue);
+   ASSURE(iSuccessful);
+   iSuccessful = SymTable_put(oSymTable, "d", acValue);
+   ASSURE(iSuccessful);
+
+   /* A full table refuses new keys and keeps the ones it has. */
+   iSuccessful = SymTable_put(oSymTable, "e", acValue);
+   ASSURE(! iSuccessful);
+   ASSURE(! SymTable_contains(oSymTable, "e"));
+   ASSURE(SymTable_getLength(oSymTable) == CAPACITY);
+   ASSURE(SymTable_get(oSymTable, "d") == acValue);
+
+   /* Removing a binding makes room for another. */
+   ASSURE(SymTable_remove(oSymTable, "b") == acValue);
+   iSuccessful = SymTable_put(oSymTable, "e", acValue);
+   ASSURE(iSuccessful);
+   ASSURE(SymTable_contains(oSymTable, "e"));
+   ASSURE(! SymTable_contains(oSymTable, "b"));
+   iSuccessful = SymTable_put(oSymTable, "b", acValue);
+   ASSURE(! iSuccessful);
+
+   /* Clearing frees every binding. */
+   SymTable_clear(oSymTable, NULL);
+   ASSURE(SymTable_getLength(oSymTable) == 0);
+   ASSURE(SymTable_getCapacity(oSymTable) == CAPACITY);
+   iSuccessful = SymTable_put(oSymTable, "w", acValue);
+   ASSURE(iSuccessful);
+   iSuccessful = SymTable_put(oSymTable, "x", acValue);
+   ASSURE(iSuccessful);
+   iSuccessful = SymTable_put(oSymTable, "y", acValue);
+   ASSURE(iSuccessful);
+   iSuccessful = SymTable_put(oSymTable, "z", acValue);
+   ASSURE(iSuccessful);
+   ASSURE(! SymTable_contains(oSymTable, "a"));
+   ASSURE(SymTable_getLength(oSymTable) == CAPACITY);
+
+   SymTable_free(oSymTable);
+
+   /* A table without room for bindings is still valid. */
+   oSymTable = SymTable_newFixed(0, 0);
+   ASSURE(oSymTable != NULL);
+   iSuccessful = SymTable_put(oSymTable, "a", acValue);
+   ASSURE(! iSuccessful);
+   ASSURE(SymTable_getLength(oSymTable) == 0);
+   SymTable_free(oSymTable);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Test that a full key pool refuses keys until removed ones are
+   compacted away. */
+
+static void testKeyPool(void)
+{
+   enum {CAPACITY = 8};
+
+   SymTable_T oSymTable;
+   struct SymTableIter sIter;
+   char acValue[] = "value";
+   char acKey[] = "ab";
+   size_t uCount;
+   int iSuccessful;
+
+   printf("------------------------------------------------------\n");
+   printf("Testing a full key pool.\n");
+   printf("No output should appear here:\n");
+   fflush(stdout);
+
+   /* Room for the records of exactly two short keys. */
+   oSymTable = SymTable_newFixed(CAPACITY, 4 * sizeof(size_t));
+   ASSURE(oSymTable != NULL);
+
+   iSuccessful = SymTable_put(oSymTable, "a", acValue);
+   ASSURE(iSuccessful);
+   iSuccessful = SymTable_put(oSymTable, "b", acValue);
+   ASSURE(iSuccessful);
+   iSuccessful = SymTable_put(oSymTable, "c", acValue);
+   ASSURE(! iSuccessful);
+   ASSURE(SymTable_getLength(oSymTable) == 2);
+
+   /* The record of "a" is reused once the pool is compacted. */
+   ASSURE(SymTable_remove(oSymTable, "a") == acValue);
+   iSuccessful = SymTable_put(oSymTable, "c", acValue);
+   ASSURE(iSuccessful);
+   ASSURE(SymTable_get(oSymTable, "b") == acValue);
+   ASSURE(SymTable_get(oSymTable, "c") == acValue);
+
+   uCount = 0;
+   for (SymTable_iterBegin(oSymTable, &sIter);
+        ! SymTable_iterEnd(&sIter);
+        SymTable_iterNext(&sIter))
+   {
+      ASSURE((strcmp(sIter.pcKey, "b") == 0) ||
+             (strcmp(sIter.pcKey, "c") == 0));
+      uCount++;
+   }
+   ASSURE(uCount == 2);
+
+   /* Keys are copies, so the client may change its own. */
+   ASSURE(SymTable_remove(oSymTable, "b") == acValue);
+   iSuccessful = SymTable_put(oSymTable, acKey, acValue);
+   ASSURE(iSuccessful);
+   acKey[0] = 'x';
+   ASSURE(SymTable_contains(oSymTable, "ab"));
+   ASSURE(! SymTable_contains(oSymTable, acKey));
+
+   SymTable_free(oSymTable);
+
+   /* Borrowed keys need no key pool. */
+   oSymTable = SymTable_newBorrowedKeys();
+   ASSURE(oSymTable != NULL);
+   iSuccessful = SymTable_put(oSymTable, "borrowed", acValue);
+   ASSURE(iSuccessful);
+   ASSURE(SymTable_get(oSymTable, "borrowed") == acValue);
+   SymTable_free(oSymTable);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Test a table laid out in a buffer provided by the client. */
+
+static void testInBuffer(void)
+{
+   enum {CAPACITY = 4};
+   enum {KEY_POOL_SIZE = 64};
+
+   SymTable_T oSymTable;
+   void *pvBuffer;
+   size_t uSize;
+   char acValue[] = "value";
+   int iSuccessful;
+
+   printf("------------------------------------------------------\n");
+   printf("Testing a table in a client buffer.\n");
+   printf("No output should appear here:\n");
+   fflush(stdout);
+
+   uSize = SymTable_bufferSize(CAPACITY, KEY_POOL_SIZE);
+   ASSURE(uSize > KEY_POOL_SIZE);
+   ASSURE(SymTable_bufferSize((size_t)-1, 0) == 0);
+
+   pvBuffer = malloc(uSize);
+   ASSURE(pvBuffer != NULL);
+   if (pvBuffer == NULL)
+      return;
+
+   /* A buffer without room for the bindings is refused. */
+   uSize -= KEY_POOL_SIZE + 1;
+   oSymTable = SymTable_initInBuffer(pvBuffer, uSize, CAPACITY);
+   ASSURE(oSymTable == NULL);
+   uSize += KEY_POOL_SIZE + 1;
+
+   oSymTable = SymTable_initInBuffer(pvBuffer, uSize, CAPACITY);
+   ASSURE(oSymTable != NULL);
+   ASSURE((void*)oSymTable == pvBuffer);
+   ASSURE(SymTable_getCapacity(oSymTable) == CAPACITY);
+
+   iSuccessful = SymTable_put(oSymTable, "alpha", acValue);
+   ASSURE(iSuccessful);
+   iSuccessful = SymTable_put(oSymTable, "beta", acValue);
+   ASSURE(iSuccessful);
+   ASSURE(SymTable_get(oSymTable, "alpha") == acValue);
+   ASSURE(SymTable_getLength(oSymTable) == 2);
+
+   /* Freeing the table leaves the buffer to the client, who may lay
+      out another table in it. */
+   SymTable_free(oSymTable);
+   oSymTable = SymTable_initInBuffer(pvBuffer, uSize, CAPACITY);
+   ASSURE(oSymTable != NULL);
+   ASSURE(SymTable_getLength(oSymTable) == 0);
+   ASSURE(! SymTable_contains(oSymTable, "alpha"));
+   SymTable_free(oSymTable);
+
+   /* A buffer with no room left for keys still holds the bindings,
+      but refuses key copies. */
+   oSymTable = SymTable_initInBuffer(pvBuffer, uSize - KEY_POOL_SIZE,
+                                     CAPACITY);
+   ASSURE(oSymTable != NULL);
+   iSuccessful = SymTable_put(oSymTable, "alpha", acValue);
+   ASSURE(! iSuccessful);
+   SymTable_free(oSymTable);
+
+   free(pvBuffer);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Test iBindingCount cycles of putting a key and removing the oldest
+   one in a small table, so that the key pool is compacted many
+   times. */
+
+static void testChurn(int iBindingCount)
+{
+   enum {CAPACITY = 16};
+   enum {MAX_KEY_LENGTH = 16};
+
+   SymTable_T oSymTable;
+   char acKey[MAX_KEY_LENGTH];
+   int *piValues;
+   int i;
+   int j;
+   int iSuccessful;
+
+   printf("------------------------------------------------------\n");
+   printf("Testing %d put/remove cycles.\n", iBindingCount);
+   printf("No output should appear here:\n");
+   fflush(stdout);
+
+   piValues = (int*)calloc((size_t)iBindingCount + 1, sizeof(int));
+   ASSURE(piValues != NULL);
+   if (piValues == NULL)
+      return;
+
+   /* Pool of just enough room for CAPACITY of the longest keys. */
+   oSymTable = SymTable_newFixed(CAPACITY,
+                                 CAPACITY * (sizeof(size_t) +
+                                             MAX_KEY_LENGTH));
+   ASSURE(oSymTable != NULL);
+
+   for (i = 0; i < iBindingCount; i++)
+   {
+      piValues[i] = i;
+      sprintf(acKey, "%d", i);
+      iSuccessful = SymTable_put(oSymTable, acKey, &piValues[i]);
+      ASSURE(iSuccessful);
+
+      if (i >= CAPACITY - 1)
+      {
+         sprintf(acKey, "%d", i - (CAPACITY - 1));
+         ASSURE(SymTable_remove(oSymTable, acKey) ==
+                &piValues[i - (CAPACITY - 1)]);
+      }
+   }
+
+   ASSURE(SymTable_getLength(oSymTable) <= CAPACITY - 1);
+
+   /* Every key that is left survived the compactions. */
+   for (j = iBindingCount - 1;
+        (j >= 0) && (j > iBindingCount - CAPACITY); j--)
+   {
+      sprintf(acKey, "%d", j);
+      ASSURE(SymTable_get(oSymTable, acKey) == &piValues[j]);
+   }
+
+   SymTable_free(oSymTable);
+   free(piValues);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Test the fixed-capacity SymTable implementation. As always, argc
+   is the command-line argument count and argv contains the
+   command-line arguments. argv[1] is the number of put/remove cycles
+   to run. Exit with EXIT_FAILURE if argv[1] is missing or not
+   numeric. Otherwise return 0. */
+
+int main(int argc, char *argv[])
+{
+   int iBindingCount;
+
+   if ((argc != 2) || (sscanf(argv[1], "%d", &iBindingCount) != 1) ||
+       (iBindingCount < 0))
+   {
+      fprintf(stderr, "Usage: %s bindingcount\n", argv[0]);
+      exit(EXIT_FAILURE);
+   }
+
+   testCapacity();
+   testKeyPool();
+   testInBuffer();
+   testChurn(iBindingCount);
+
+   printf("------------------------------------------------------\n");
+   printf("End of %s.\n", argv[0]);
+   return 0;
+}
@@ -301,6 +301,56 @@ static void testKeyOwnership(void)
 
 /*--------------------------------------------------------------------*/
 
+/* Test a SymTable object that borrows its keys. */
+
+static void testBorrowedKeys(void)
+{
+   enum {KEY_COUNT = 20, MAX_KEY_LENGTH = 10};
+
+   SymTable_T oSymTable;
+   char aacKeys[KEY_COUNT][MAX_KEY_LENGTH];
+   struct SymTableIter sIter;
+   size_t uCount;
+   int iSuccessful;
+   int i;
+
+   printf("------------------------------------------------------\n");
+   printf("Testing borrowed keys.\n");
+   printf("No output should appear here:\n");
+   fflush(stdout);
+
+   oSymTable = SymTable_newBorrowedKeys();
+   ASSURE(oSymTable != NULL);
+
+   for (i = 0; i < KEY_COUNT; i++)
+   {
+      sprintf(aacKeys[i], "key%d", i);
+      iSuccessful = SymTable_put(oSymTable, aacKeys[i], aacKeys[i]);
+      ASSURE(iSuccessful);
+   }
+   ASSURE(SymTable_getLength(oSymTable) == KEY_COUNT);
+
+   /* Each key must be the client's own string, not a copy. */
+   uCount = 0;
+   for (SymTable_iterBegin(oSymTable, &sIter);
+        ! SymTable_iterEnd(&sIter);
+        SymTable_iterNext(&sIter))
+   {
+      ASSURE(sIter.pcKey == (const char*)sIter.pvValue);
+      uCount++;
+   }
+   ASSURE(uCount == KEY_COUNT);
+
+   ASSURE(SymTable_remove(oSymTable, "key3") == aacKeys[3]);
+   ASSURE(! SymTable_contains(oSymTable, "key3"));
+   ASSURE(SymTable_get(oSymTable, "key19") == aacKeys[19]);
+
+   /* Must not free the keys, which are in automatic storage. */
+   SymTable_free(oSymTable);
+}
+
+/*--------------------------------------------------------------------*/
+
 /* Test the SymTable_remove() function. */
 
 static void testRemove(void)
@@ -432,6 +482,182 @@ static void testMap(void)
 
 /*--------------------------------------------------------------------*/
 
+/* Test the SymTable_iterBegin(), SymTable_iterNext(), and
+   SymTable_iterEnd() functions. */
+
+static void testIterator(void)
+{
+   enum {MAX_KEY_LENGTH = 10};
+   enum {ITER_BINDING_COUNT = 1000};
+
+   SymTable_T oSymTable;
+   struct SymTableIter sIter;
+   char acJeter[] = "Jeter";
+   char acMantle[] = "Mantle";
+   char acGehrig[] = "Gehrig";
+   char acRuth[] = "Ruth";
+   char acShortstop[] = "Shortstop";
+   char acCenterField[] = "Center Field";
+   char acFirstBase[] = "First Base";
+   char acRightField[] = "Right Field";
+   char acKey[MAX_KEY_LENGTH];
+   char *pcValue;
+   int iSuccessful;
+   int i;
+   size_t uCount;
+
+   printf("------------------------------------------------------\n");
+   printf("Testing the SymTable iterator functions.\n");
+   printf("No output should appear here:\n");
+   fflush(stdout);
+
+   oSymTable = SymTable_new();
+   ASSURE(oSymTable != NULL);
+
+   /* An empty table yields no bindings. */
+   SymTable_iterBegin(oSymTable, &sIter);
+   ASSURE(SymTable_iterEnd(&sIter));
+
+   iSuccessful = SymTable_put(oSymTable, acJeter, acShortstop);
+   ASSURE(iSuccessful);
+
+   iSuccessful = SymTable_put(oSymTable, acMantle, acCenterField);
+   ASSURE(iSuccessful);
+
+   iSuccessful = SymTable_put(oSymTable, acGehrig, acFirstBase);
+   ASSURE(iSuccessful);
+
+   iSuccessful = SymTable_put(oSymTable, acRuth, acRightField);
+   ASSURE(iSuccessful);
+
+   /* Each binding is visited exactly once. */
+   uCount = 0;
+   for (SymTable_iterBegin(oSymTable, &sIter);
+        ! SymTable_iterEnd(&sIter);
+        SymTable_iterNext(&sIter))
+   {
+      pcValue = (char*)SymTable_get(oSymTable, sIter.pcKey);
+      ASSURE(pcValue == sIter.pvValue);
+      uCount++;
+   }
+   ASSURE(uCount == 4);
+
+   /* Iteration can stop early, and SymTable_replace() does not
+      invalidate the iterator. */
+   for (SymTable_iterBegin(oSymTable, &sIter);
+        ! SymTable_iterEnd(&sIter);
+        SymTable_iterNext(&sIter))
+   {
+      if (strcmp(sIter.pcKey, "Gehrig") == 0)
+         break;
+      pcValue = (char*)SymTable_replace(oSymTable, sIter.pcKey,
+                                        sIter.pvValue);
+      ASSURE(pcValue == sIter.pvValue);
+   }
+   ASSURE(! SymTable_iterEnd(&sIter));
+   ASSURE(sIter.pvValue == acFirstBase);
+
+   SymTable_free(oSymTable);
+
+   /* Iterate over enough bindings to span many buckets. */
+   oSymTable = SymTable_new();
+   ASSURE(oSymTable != NULL);
+
+   for (i = 0; i < ITER_BINDING_COUNT; i++)
+   {
+      sprintf(acKey, "%d", i);
+      iSuccessful = SymTable_put(oSymTable, acKey, acShortstop);
+      ASSURE(iSuccessful);
+   }
+
+   uCount = 0;
+   for (SymTable_iterBegin(oSymTable, &sIter);
+        ! SymTable_iterEnd(&sIter);
+        SymTable_iterNext(&sIter))
+   {
+      ASSURE(sIter.pvValue == acShortstop);
+      uCount++;
+   }
+   ASSURE(uCount == ITER_BINDING_COUNT);
+
+   SymTable_free(oSymTable);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Test the SymTable_clear() and SymTable_freeWith() functions. */
+
+static void testFreeWith(void)
+{
+   enum {BINDING_COUNT = 100, MAX_KEY_LENGTH = 10};
+
+   SymTable_T oSymTable;
+   char acKey[MAX_KEY_LENGTH];
+   char *pcValue;
+   int iSuccessful;
+   int iRound;
+   int i;
+
+   printf("------------------------------------------------------\n");
+   printf("Testing the SymTable_clear() and SymTable_freeWith() "
+          "functions.\n");
+   printf("No output should appear here:\n");
+   fflush(stdout);
+
+   oSymTable = SymTable_new();
+   ASSURE(oSymTable != NULL);
+
+   /* Clearing an empty table leaves it empty. */
+   SymTable_clear(oSymTable, NULL);
+   ASSURE(SymTable_getLength(oSymTable) == 0);
+
+   /* Fill the table twice, clearing it in between.  Each value is
+      a malloc'd copy of its key, so every value must be freed
+      exactly once. */
+   for (iRound = 0; iRound < 2; iRound++)
+   {
+      for (i = 0; i < BINDING_COUNT; i++)
+      {
+         sprintf(acKey, "%d", i + iRound);
+         pcValue = (char*)malloc(strlen(acKey) + 1);
+         ASSURE(pcValue != NULL);
+         strcpy(pcValue, acKey);
+         iSuccessful = SymTable_put(oSymTable, acKey, pcValue);
+         ASSURE(iSuccessful);
+      }
+      ASSURE(SymTable_getLength(oSymTable) == BINDING_COUNT);
+
+      pcValue = (char*)SymTable_get(oSymTable, "7");
+      ASSURE((pcValue != NULL) && (strcmp(pcValue, "7") == 0));
+
+      if (iRound == 0)
+      {
+         SymTable_clear(oSymTable, free);
+         ASSURE(SymTable_getLength(oSymTable) == 0);
+         ASSURE(! SymTable_contains(oSymTable, "7"));
+         ASSURE(SymTable_get(oSymTable, "0") == NULL);
+      }
+   }
+
+   /* The second round's values are freed here, not by the clear. */
+   ASSURE(! SymTable_contains(oSymTable, "0"));
+   ASSURE(SymTable_contains(oSymTable, "100"));
+   SymTable_freeWith(oSymTable, free);
+
+   /* A NULL pfFreeValue leaves the values alone. */
+   oSymTable = SymTable_new();
+   ASSURE(oSymTable != NULL);
+   iSuccessful = SymTable_put(oSymTable, "Ruth", "RightField");
+   ASSURE(iSuccessful);
+   SymTable_clear(oSymTable, NULL);
+   ASSURE(SymTable_getLength(oSymTable) == 0);
+   iSuccessful = SymTable_put(oSymTable, "Ruth", "RightField");
+   ASSURE(iSuccessful);
+   SymTable_freeWith(oSymTable, NULL);
+}
+
+/*--------------------------------------------------------------------*/
+
 /* Test a SymTable object that contains no bindings. */
 
 static void testEmptyTable(void)
@@ -918,6 +1144,79 @@ static void testLargeTable(int iBindingCount)
 
 /*--------------------------------------------------------------------*/
 
+/* Report the memory used by SymTable objects of 1, 10, 100 and so on
+   bindings, up to iBindingCount bindings, so that implementations can
+   be compared by the bytes they take per binding. Define
+   SYMTABLE_SHARES_PREFIXES for implementations that store a prefix
+   shared by keys once, and so report fewer key bytes than there are
+   key characters. */
+
+static void testMemoryUsage(int iBindingCount)
+{
+   enum {MAX_KEY_LENGTH = 12};
+
+   SymTable_T oSymTable;
+   struct SymTableMemory sMemory;
+   char acKey[MAX_KEY_LENGTH];
+   int i;
+   int iSize;
+   int iSuccessful;
+   size_t uKeyBytes;
+   size_t uTotal;
+   size_t uPreviousTotal = 0;
+
+   printf("------------------------------------------------------\n");
+   printf("Testing the memory usage of SymTable objects.\n");
+   printf("No output except the memory report should appear here:\n");
+   printf("  bindings      bytes  per binding     table  bindings"
+          "      keys  overhead\n");
+   fflush(stdout);
+
+   for (iSize = 1; iSize > 0; iSize = (iSize == iBindingCount) ? 0 :
+        (iSize > iBindingCount / 10) ? iBindingCount : iSize * 10)
+   {
+      oSymTable = SymTable_new();
+      ASSURE(oSymTable != NULL);
+      if (oSymTable == NULL)
+         return;
+
+      uKeyBytes = 0;
+      for (i = 0; i < iSize; i++)
+      {
+         sprintf(acKey, "%d", i);
+         iSuccessful = SymTable_put(oSymTable, acKey, NULL);
+         ASSURE(iSuccessful);
+         uKeyBytes += strlen(acKey) + 1;
+      }
+
+      SymTable_memoryUsage(oSymTable, &sMemory);
+      uTotal = sMemory.uTableBytes + sMemory.uBindingBytes +
+         sMemory.uKeyBytes + sMemory.uOverheadBytes;
+      ASSURE(sMemory.uTableBytes > 0);
+#ifdef SYMTABLE_SHARES_PREFIXES
+      /* Keys share their prefixes, so some are stored only once */
+      ASSURE((sMemory.uKeyBytes > 0) &&
+             (sMemory.uKeyBytes < uKeyBytes));
+#else
+      ASSURE(sMemory.uKeyBytes >= uKeyBytes);
+#endif
+      ASSURE(uTotal >= uPreviousTotal);
+      uPreviousTotal = uTotal;
+
+      printf("%10d %10lu %12.1f %9lu %9lu %9lu %9lu\n", iSize,
+             (unsigned long)uTotal, (double)uTotal / iSize,
+             (unsigned long)sMemory.uTableBytes,
+             (unsigned long)sMemory.uBindingBytes,
+             (unsigned long)sMemory.uKeyBytes,
+             (unsigned long)sMemory.uOverheadBytes);
+
+      SymTable_free(oSymTable);
+   }
+   fflush(stdout);
+}
+
+/*--------------------------------------------------------------------*/
+
 /* Test the SymTable ADT.  Write the output of the tests to stdout.
    As always, argc is the command-line argument count, argv contains
    the command-line arguments, and argv[0] is the name of the
@@ -945,6 +1244,17 @@ int main(int argc, char *argv[])
       fprintf(stderr, "bindingcount cannot be negative\n");
       exit(EXIT_FAILURE);
    }
+
+#ifdef SYMTABLE_MAX_BINDINGS
+   /* The tables of the implementation have room for no more */
+   if (iBindingCount > SYMTABLE_MAX_BINDINGS)
+   {
+      printf("Testing %d bindings, the most a table can hold.\n",
+             SYMTABLE_MAX_BINDINGS);
+      fflush(stdout);
+      iBindingCount = SYMTABLE_MAX_BINDINGS;
+   }
+#endif
    
 #ifndef S_SPLINT_S
    setCpuTimeLimit();
@@ -953,8 +1263,11 @@ int main(int argc, char *argv[])
    testBasics();
    testKeyComparison();
    testKeyOwnership();
+   testBorrowedKeys();
    testRemove();
    testMap();
+   testIterator();
+   testFreeWith();
    testEmptyTable();
    testEmptyKey();
    testNullValue();
@@ -962,6 +1275,7 @@ int main(int argc, char *argv[])
    testTableOfTables();
    testCollisions();
    testLargeTable(iBindingCount);
+   testMemoryUsage(iBindingCount);
 
    printf("------------------------------------------------------\n");
    printf("End of %s.\n", argv[0]);
@@ -0,0 +1,329 @@
+/*--------------------------------------------------------------------*/
+/* testtemplate.c                                                     */
+/* Author: Julio Lins (jcclb)                                         */
+/*--------------------------------------------------------------------*/
+
+#include "symtabletemplate.h"
+#include "symtable.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <time.h>
+
+/*--------------------------------------------------------------------*/
+
+#define ASSURE(i) assure(i, __LINE__)
+
+/*--------------------------------------------------------------------*/
+
+/* Longest key used by the tests */
+
+enum {MAX_KEY_LENGTH = 16};
+
+/*--------------------------------------------------------------------*/
+
+/* A small value, stored as is in the Bindings of a PointTable */
+
+struct Point
+{
+   int iX;
+   int iY;
+};
+
+/*--------------------------------------------------------------------*/
+
+/* Return a hash code for the integer key ulKey. */
+
+static size_t hashInt(unsigned long ulKey)
+{
+   return (size_t)ulKey;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Return a hash code for the string key pcKey, as symtablehash.c
+   does. */
+
+static size_t hashString(const char *pcKey)
+{
+   const size_t HASH_MULTIPLIER = 65599;
+   size_t u;
+   size_t uHash = 0;
+
+   assert(pcKey != NULL);
+
+   for (u = 0; pcKey[u] != '\0'; u++)
+      uHash = uHash * HASH_MULTIPLIER + (size_t)pcKey[u];
+
+   return uHash;
+}
+
+/*--------------------------------------------------------------------*/
+
+#define EQUAL_INTS(ulKey1, ulKey2) ((ulKey1) == (ulKey2))
+#define EQUAL_STRINGS(pcKey1, pcKey2) (strcmp(pcKey1, pcKey2) == 0)
+
+SYMTABLE_DEFINE(IntTable, unsigned long, int, hashInt, EQUAL_INTS);
+SYMTABLE_DEFINE(PointTable, const char*, struct Point, hashString,
+                EQUAL_STRINGS);
+
+/*--------------------------------------------------------------------*/
+
+/* If !iSuccessful, print a message to stdout indicating that the
+   test at line iLineNum failed. */
+
+static void assure(int iSuccessful, int iLineNum)
+{
+   if (! iSuccessful)
+   {
+      printf("Test at line %d failed.\n", iLineNum);
+      fflush(stdout);
+   }
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Add *piValue to the sum pointed to by pvExtra, then double
+   *piValue in its Binding. */
+
+static void sumAndDouble(unsigned long ulKey, int *piValue,
+                         void *pvExtra)
+{
+   assert(piValue != NULL);
+   assert(pvExtra != NULL);
+
+   ASSURE((unsigned long)*piValue == ulKey);
+   *(long*)pvExtra += *piValue;
+   *piValue *= 2;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Test an IntTable of iBindingCount bindings, each key bound to
+   itself. */
+
+static void testIntTable(int iBindingCount)
+{
+   IntTable_T oTable;
+   struct IntTable_Iter sIter;
+   long lSum = 0;
+   long lMapSum = 0;
+   size_t uVisited = 0;
+   int iValue = 0;
+   int *piValue;
+   int i;
+
+   printf("------------------------------------------------------\n");
+   printf("Testing a table of %d integer keys and values.\n",
+          iBindingCount);
+   printf("No output should appear here:\n");
+   fflush(stdout);
+
+   oTable = IntTable_new();
+   ASSURE(oTable != NULL);
+   if (oTable == NULL)
+      return;
+
+   for (i = 0; i < iBindingCount; i++)
+   {
+      ASSURE(IntTable_put(oTable, (unsigned long)i, i));
+      lSum += i;
+   }
+   ASSURE(! IntTable_put(oTable, 0, -1));
+   ASSURE(IntTable_getLength(oTable) == (size_t)iBindingCount);
+
+   for (i = 0; i < iBindingCount; i++)
+   {
+      ASSURE(IntTable_get(oTable, (unsigned long)i, &iValue));
+      ASSURE(iValue == i);
+   }
+   ASSURE(! IntTable_get(oTable, (unsigned long)iBindingCount,
+                         &iValue));
+   ASSURE(! IntTable_contains(oTable, (unsigned long)iBindingCount));
+
+   /* Values change in place, through map and find. */
+   IntTable_map(oTable, sumAndDouble, &lMapSum);
+   ASSURE(lMapSum == lSum);
+   piValue = IntTable_find(oTable, 1);
+   ASSURE((piValue == NULL) == (iBindingCount < 2));
+   if (piValue != NULL)
+   {
+      ASSURE(*piValue == 2);
+      *piValue = 1;
+   }
+
+   for (IntTable_iterBegin(oTable, &sIter); ! IntTable_iterEnd(&sIter);
+        IntTable_iterNext(&sIter))
+   {
+      ASSURE(IntTable_find(oTable, sIter.tKey) == sIter.ptValue);
+      ASSURE(*sIter.ptValue == (sIter.tKey == 1 ? 1 :
+                                (int)sIter.tKey * 2));
+      uVisited++;
+   }
+   ASSURE(uVisited == (size_t)iBindingCount);
+
+   for (i = 0; i < iBindingCount; i += 2)
+   {
+      ASSURE(IntTable_remove(oTable, (unsigned long)i, &iValue));
+      ASSURE(iValue == i * 2);
+      ASSURE(! IntTable_remove(oTable, (unsigned long)i, NULL));
+   }
+   ASSURE(IntTable_getLength(oTable) == (size_t)(iBindingCount / 2));
+   for (i = 0; i < iBindingCount; i++)
+      ASSURE(IntTable_contains(oTable, (unsigned long)i) == (i % 2));
+
+   IntTable_free(oTable);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Test a PointTable, whose string keys are borrowed and whose values
+   are structures. */
+
+static void testPointTable(void)
+{
+   PointTable_T oTable;
+   struct PointTable_Iter sIter;
+   struct Point sPoint;
+   char acKey[MAX_KEY_LENGTH];
+
+   printf("------------------------------------------------------\n");
+   printf("Testing a table of structure values.\n");
+   printf("No output should appear here:\n");
+   fflush(stdout);
+
+   oTable = PointTable_new();
+   ASSURE(oTable != NULL);
+   if (oTable == NULL)
+      return;
+
+   sPoint.iX = 1;
+   sPoint.iY = 2;
+   ASSURE(PointTable_put(oTable, "origin", sPoint));
+   sPoint.iX = 3;
+   ASSURE(! PointTable_put(oTable, "origin", sPoint));
+   ASSURE(PointTable_put(oTable, "corner", sPoint));
+
+   /* Lookups compare strings, not pointers. */
+   strcpy(acKey, "origin");
+   ASSURE(PointTable_get(oTable, acKey, &sPoint));
+   ASSURE((sPoint.iX == 1) && (sPoint.iY == 2));
+   PointTable_find(oTable, acKey)->iY = 5;
+
+   /* A borrowed key is the very pointer that was put. */
+   for (PointTable_iterBegin(oTable, &sIter);
+        ! PointTable_iterEnd(&sIter); PointTable_iterNext(&sIter))
+   {
+      if (strcmp(sIter.tKey, "origin") == 0)
+         ASSURE(sIter.ptValue->iY == 5);
+      else
+         ASSURE(sIter.ptValue->iX == 3);
+      ASSURE(sIter.tKey != acKey);
+   }
+
+   ASSURE(PointTable_remove(oTable, "corner", &sPoint));
+   ASSURE((sPoint.iX == 3) && (sPoint.iY == 2));
+   ASSURE(PointTable_getLength(oTable) == 1);
+
+   PointTable_free(oTable);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Compare the time taken to put, read and free iBindingCount int
+   values boxed for SymTable with that taken by an IntTable, whose
+   values are in its Bindings. Keys are formatted into strings for
+   SymTable. */
+
+static void testPerformance(int iBindingCount)
+{
+   SymTable_T oSymTable;
+   IntTable_T oTable;
+   char acKey[MAX_KEY_LENGTH];
+   clock_t iInitialClock;
+   clock_t iFinalClock;
+   long lSum;
+   int *piValue;
+   int iValue = 0;
+   int i;
+
+   printf("------------------------------------------------------\n");
+   printf("Testing performance of inline values.\n");
+   printf("No lines other than timings should appear here:\n");
+   fflush(stdout);
+
+   iInitialClock = clock();
+   oSymTable = SymTable_new();
+   ASSURE(oSymTable != NULL);
+   if (oSymTable == NULL)
+      return;
+   for (i = 0; i < iBindingCount; i++)
+   {
+      piValue = (int*)malloc(sizeof(int));
+      ASSURE(piValue != NULL);
+      if (piValue == NULL)
+         return;
+      *piValue = i;
+      sprintf(acKey, "%d", i);
+      ASSURE(SymTable_put(oSymTable, acKey, piValue));
+   }
+   lSum = 0;
+   for (i = 0; i < iBindingCount; i++)
+   {
+      sprintf(acKey, "%d", i);
+      lSum += *(int*)SymTable_get(oSymTable, acKey);
+   }
+   SymTable_freeWith(oSymTable, free);
+   iFinalClock = clock();
+   ASSURE(lSum == (long)iBindingCount * (iBindingCount - 1) / 2);
+   printf("CPU time (%d boxed values):  %f seconds\n", iBindingCount,
+      ((double)(iFinalClock - iInitialClock)) / CLOCKS_PER_SEC);
+
+   iInitialClock = clock();
+   oTable = IntTable_new();
+   ASSURE(oTable != NULL);
+   if (oTable == NULL)
+      return;
+   for (i = 0; i < iBindingCount; i++)
+      ASSURE(IntTable_put(oTable, (unsigned long)i, i));
+   lSum = 0;
+   for (i = 0; i < iBindingCount; i++)
+   {
+      ASSURE(IntTable_get(oTable, (unsigned long)i, &iValue));
+      lSum += iValue;
+   }
+   IntTable_free(oTable);
+   iFinalClock = clock();
+   ASSURE(lSum == (long)iBindingCount * (iBindingCount - 1) / 2);
+   printf("CPU time (%d inline values): %f seconds\n", iBindingCount,
+      ((double)(iFinalClock - iInitialClock)) / CLOCKS_PER_SEC);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Test tables defined by SYMTABLE_DEFINE. As always, argc is the
+   command-line argument count and argv contains the command-line
+   arguments. argv[1] is the number of bindings to test with. Exit
+   with EXIT_FAILURE if argv[1] is missing or not numeric. Otherwise
+   return 0. */
+
+int main(int argc, char *argv[])
+{
+   int iBindingCount;
+
+   if ((argc != 2) || (sscanf(argv[1], "%d", &iBindingCount) != 1) ||
+       (iBindingCount < 1))
+   {
+      fprintf(stderr, "Usage: %s bindingcount\n", argv[0]);
+      exit(EXIT_FAILURE);
+   }
+
+   testIntTable(iBindingCount);
+   testPointTable();
+   testPerformance(iBindingCount);
+
+   printf("------------------------------------------------------\n");
+   printf("End of %s.\n", argv[0]);
+   return 0;
+}